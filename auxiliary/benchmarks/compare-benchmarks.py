@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+
+#--------------------------------------------------------------------------------
+# Compare two sets of results from signalflow-benchmark --json.
+#
+# Prints the change in time per frame for each benchmark present in both
+# files, and flags any benchmark that is slower than the baseline by more than
+# the threshold. Exits with status 1 if any regression is found, so that it
+# can be used as a check in CI.
+#
+# Usage: compare-benchmarks.py BASELINE.json CURRENT.json [--threshold 0.1]
+#--------------------------------------------------------------------------------
+
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument("baseline", help="Results to compare against")
+parser.add_argument("current", help="Results to check")
+parser.add_argument("--threshold", type=float, default=0.1,
+                    help="Proportional slowdown above which a benchmark is flagged (default: 0.1)")
+parser.add_argument("--filter", type=str, default="", help="Only compare benchmarks whose name contains this string")
+args = parser.parse_args()
+
+def load_results(path):
+    with open(path) as fd:
+        results = json.load(fd)
+    return {benchmark["name"]: benchmark for benchmark in results["benchmarks"]}
+
+baseline = load_results(args.baseline)
+current = load_results(args.current)
+
+regressions = []
+print("%-48s %12s %12s %9s" % ("Benchmark", "Baseline", "Current", "Change"))
+for name in sorted(set(baseline) | set(current)):
+    if args.filter not in name:
+        continue
+    if name not in baseline or name not in current:
+        print("%-48s %s" % (name, "(only in baseline)" if name in baseline else "(new)"))
+        continue
+
+    before = baseline[name]["ns_per_frame"]
+    after = current[name]["ns_per_frame"]
+    if before > 0:
+        change = (after - before) / before
+    else:
+        change = 0.0 if after == before else float("inf")
+    flag = ""
+    if change > args.threshold:
+        flag = "  REGRESSION"
+        regressions.append(name)
+    elif change < -args.threshold:
+        flag = "  improvement"
+    print("%-48s %9.2f ns %9.2f ns %+8.1f%%%s" % (name, before, after, change * 100, flag))
+
+if regressions:
+    print("\n%d benchmark(s) slower by more than %.0f%%:" % (len(regressions), args.threshold * 100))
+    for name in regressions:
+        print("  %s" % name)
+    sys.exit(1)
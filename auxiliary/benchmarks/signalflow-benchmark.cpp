@@ -0,0 +1,639 @@
+/*------------------------------------------------------------------------
+ * SignalFlow benchmark suite.
+ *
+ * Measures the throughput of:
+ *  - every registered Node class, processing blocks in isolation
+ *  - a set of canonical whole-graph scenarios, rendered offline through
+ *    AudioOut_Dummy
+ *
+ * Each benchmark is run for at least --min-time seconds, repeated
+ * --repetitions times, and the median is reported. Results can be written
+ * to JSON with --json, and two JSON files compared with
+ * compare-benchmarks.py to flag regressions.
+ *
+ * Usage: signalflow-benchmark [--filter SUBSTRING] [--json PATH]
+ *                             [--block-size FRAMES] [--min-time SECONDS]
+ *                             [--repetitions N]
+ *-----------------------------------------------------------------------*/
+
+#include <signalflow/signalflow.h>
+
+#include "json11/json11.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+using namespace signalflow;
+
+/*------------------------------------------------------------------------
+ * Nodes that cannot be processed in isolation: audio I/O, nodes that are
+ * only meaningful inside a Patch or a feedback loop, nodes that render
+ * their own input (FFTContinuousPhaseVocoder), and nodes whose default
+ * parameters are not processable (CrossCorrelate's hop_size,
+ * GrainSegments' and SegmentPlayer's properties).
+ *-----------------------------------------------------------------------*/
+static const std::vector<std::string> excluded_nodes = {
+    "audioin-soundio",
+    "audioout-dummy",
+    "audioout-soundio",
+    "cross-correlate",
+    "fft-continuous-pv",
+    "grain-segments",
+    "feedback-buffer-reader",
+    "feedback-buffer-writer",
+    "patch-node",
+    "segment-player",
+    "stream-input",
+    "voice-allocator",
+    "vamp-analysis"
+};
+
+struct BenchmarkOptions
+{
+    std::string filter;
+    std::string json_path;
+    int block_size = 256;
+    double min_time = 0.2;
+    int repetitions = 3;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string kind;
+    long iterations;
+    double ns_per_block;
+    double ns_per_frame;
+    double realtime_factor;
+};
+
+/*------------------------------------------------------------------------
+ * Run `block` repeatedly for at least min_time seconds, and return the
+ * mean time per call, in nanoseconds.
+ *-----------------------------------------------------------------------*/
+static double time_iterations(std::function<void()> block, double min_time, long &iterations)
+{
+    typedef std::chrono::steady_clock clock;
+    long batch = 1;
+    iterations = 0;
+    auto t0 = clock::now();
+    double elapsed = 0.0;
+    while (elapsed < min_time)
+    {
+        for (long i = 0; i < batch; i++)
+        {
+            block();
+        }
+        iterations += batch;
+        elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+        batch *= 2;
+    }
+    return elapsed * 1e9 / iterations;
+}
+
+static BenchmarkResult run_benchmark(std::string name,
+                                     std::string kind,
+                                     std::function<void()> block,
+                                     BenchmarkOptions &options,
+                                     int sample_rate)
+{
+    /*------------------------------------------------------------------------
+     * Warm up caches and any lazily-allocated state before timing.
+     *-----------------------------------------------------------------------*/
+    for (int i = 0; i < 16; i++)
+    {
+        block();
+    }
+
+    std::vector<double> times;
+    long iterations = 0;
+    for (int repetition = 0; repetition < options.repetitions; repetition++)
+    {
+        long repetition_iterations;
+        times.push_back(time_iterations(block, options.min_time, repetition_iterations));
+        iterations += repetition_iterations;
+    }
+    std::sort(times.begin(), times.end());
+    double ns_per_block = times[times.size() / 2];
+
+    BenchmarkResult result;
+    result.name = name;
+    result.kind = kind;
+    result.iterations = iterations;
+    result.ns_per_block = ns_per_block;
+    result.ns_per_frame = ns_per_block / options.block_size;
+    result.realtime_factor = (1e9 * options.block_size / sample_rate) / ns_per_block;
+
+    printf("%-48s %12.1f ns/block %10.2f ns/frame %10.1fx realtime\n",
+           name.c_str(), result.ns_per_block, result.ns_per_frame, result.realtime_factor);
+    fflush(stdout);
+    return result;
+}
+
+/*------------------------------------------------------------------------
+ * Node benchmarks.
+ *
+ * Each node is created with its default inputs, except that any input
+ * named "input" is fed with white noise, and any buffer is populated with
+ * noise. Nodes whose defaults do no meaningful work (for example, FFT
+ * operations, which need an FFT input) are instead created by a factory
+ * below. The inputs are rendered for long enough to fill an FFT frame, and
+ * then only the node's own process() is timed.
+ *-----------------------------------------------------------------------*/
+static void benchmark_nodes(BenchmarkOptions &options, std::vector<BenchmarkResult> &results)
+{
+    AudioGraphConfig config;
+    config.set_output_buffer_size(options.block_size);
+    AudioGraphRef graph = new AudioGraph(&config, new AudioOut_Dummy(2));
+    AudioGraphContext context(graph.get());
+
+    /*------------------------------------------------------------------------
+     * Nodes are processed directly rather than through AudioGraph::render(),
+     * so apply the graph's floating-point state here.
+     *-----------------------------------------------------------------------*/
+    ScopedFlushDenormals flush_denormals(graph->get_config().get_flush_denormals());
+
+    int sample_rate = graph->get_sample_rate();
+    BufferRef noise_buffer = new Buffer(2, sample_rate);
+    for (int channel = 0; channel < 2; channel++)
+    {
+        for (int frame = 0; frame < sample_rate; frame++)
+        {
+            noise_buffer->data[channel][frame] = random_uniform(-1, 1);
+        }
+    }
+
+    BufferRef mono_noise_buffer = new Buffer(std::vector<float>(noise_buffer->data[0], noise_buffer->data[0] + sample_rate));
+
+    std::unordered_map<std::string, std::function<NodeRef()>> factories = {
+        { "buffer-recorder", [&]() -> NodeRef { return new BufferRecorder(noise_buffer, new WhiteNoise(), 0.0, true); } },
+        { "channel-select", [&]() -> NodeRef { return new ChannelSelect(new WhiteNoise(), 0, 1); } },
+        { "envelope", [&]() -> NodeRef { return new Envelope({ 0.0, 1.0, 0.0 }, { 0.01, 0.01 }, {}, new Impulse(10)); } },
+        { "fft-find-peaks", [&]() -> NodeRef { return new FFTFindPeaks(new FFT(new WhiteNoise()), 1.0, 0.000001, 8); } },
+        { "fft-lpf", [&]() -> NodeRef { return new FFTLPF(new FFT(new WhiteNoise())); } },
+        { "fft-spectral-features", [&]() -> NodeRef { return new FFTSpectralFeatures(new FFT(new WhiteNoise())); } },
+        { "fft-tonality", [&]() -> NodeRef { return new FFTTonality(new FFT(new WhiteNoise())); } },
+        { "fft_noise_gate", [&]() -> NodeRef { return new FFTNoiseGate(new FFT(new WhiteNoise())); } },
+        { "fft_phase_vocoder", [&]() -> NodeRef { return new FFTPhaseVocoder(new FFT(new WhiteNoise())); } },
+        { "granulator", [&]() -> NodeRef { return new Granulator(noise_buffer, new RandomImpulse(400), new WhiteNoise(1.0, 0, 0.9), 0.2); } },
+        { "ifft", [&]() -> NodeRef { return new IFFT(new FFT(new WhiteNoise())); } },
+        { "index", [&]() -> NodeRef { return new Index(std::vector<float>({ 0, 1, 2, 3 }), new RandomUniform(0, 4)); } },
+        { "random-choice", [&]() -> NodeRef { return new RandomChoice({ 0, 1, 2, 3 }, new Impulse(100)); } },
+        { "waveshaper", [&]() -> NodeRef { return new WaveShaper(new WhiteNoise(), new WaveShaperBuffer()); } },
+        { "wavetable", [&]() -> NodeRef { return new Wavetable(noise_buffer, 440); } },
+        { "wavetable2d", [&]() -> NodeRef { return new Wavetable2D(new Buffer2D({ mono_noise_buffer, mono_noise_buffer }), 440, new WhiteNoise(1.0, 0, 1)); } },
+        { "wetdry", [&]() -> NodeRef { return new WetDry(new WhiteNoise(), new WhiteNoise(), 0.5); } },
+    };
+
+    for (std::string name : NodeRegistry::global()->get_names())
+    {
+        std::string benchmark_name = "node/" + name;
+        if (std::find(excluded_nodes.begin(), excluded_nodes.end(), name) != excluded_nodes.end())
+        {
+            continue;
+        }
+        if (benchmark_name.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        try
+        {
+            NodeRef node;
+            auto factory = factories.find(name);
+            if (factory != factories.end())
+            {
+                node = factory->second();
+            }
+            else
+            {
+                node = NodeRegistry::global()->create(name);
+                if (node->get_input_index("input") >= 0)
+                {
+                    node->set_input("input", new WhiteNoise());
+                }
+                for (auto buffer : node->buffers)
+                {
+                    node->set_buffer(buffer.first, noise_buffer);
+                }
+            }
+
+            for (int frame = 0; frame <= SIGNALFLOW_DEFAULT_FFT_SIZE; frame += options.block_size)
+            {
+                for (NodeRef *input : node->input_slots)
+                {
+                    NodeRef input_node = *input;
+                    if (input_node)
+                    {
+                        graph->reset_subgraph(input_node);
+                        graph->render_subgraph(input_node, options.block_size);
+                    }
+                }
+            }
+
+            int block_size = options.block_size;
+            results.push_back(run_benchmark(
+                benchmark_name, "node", [&]() { node->process(block_size); }, options, sample_rate));
+        }
+        catch (std::exception &e)
+        {
+            printf("%-48s skipped (%s)\n", benchmark_name.c_str(), e.what());
+        }
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Whole-graph scenarios. Each is constructed within its own graph, and
+ * timed by rendering the full graph one block at a time.
+ *-----------------------------------------------------------------------*/
+static void build_additive(AudioGraphRef graph)
+{
+    std::vector<NodeRef> partials;
+    for (int partial = 1; partial <= 256; partial++)
+    {
+        NodeRef sine = new SineOscillator(55.0 * partial);
+        partials.push_back(sine * (1.0 / partial));
+    }
+    graph->play(new Sum(partials));
+}
+
+static void build_granular(AudioGraphRef graph)
+{
+    BufferRef buffer = new Buffer(1, graph->get_sample_rate() * 4);
+    for (int frame = 0; frame < (int) buffer->get_num_frames(); frame++)
+    {
+        buffer->data[0][frame] = random_uniform(-1, 1);
+    }
+    NodeRef clock = new RandomImpulse(400);
+    NodeRef pos = new WhiteNoise(1.0, 0, 3.5);
+    NodeRef pan = new WhiteNoise(10.0, -1, 1);
+    NodeRef granulator = new Granulator(buffer, clock, pos, 0.2, pan);
+    graph->play(granulator * 0.05);
+}
+
+static void build_spectral(AudioGraphRef graph)
+{
+    NodeRef fft = new FFT(new WhiteNoise(), 1024, 256);
+    NodeRef tonality = new FFTTonality(fft);
+    NodeRef lpf = new FFTLPF(tonality, new SineLFO(0.5, 200, 4000));
+    graph->play(new IFFT(lpf));
+}
+
+static void build_polyphony(AudioGraphRef graph)
+{
+    for (int voice = 0; voice < 128; voice++)
+    {
+        NodeRef saw = new SawOscillator(new MidiNoteToFrequency(36 + voice % 48));
+        NodeRef cutoff = new SineLFO(0.1 + voice * 0.01, 200, 4000);
+        NodeRef filter = new SVFFilter(saw, SIGNALFLOW_FILTER_TYPE_LOW_PASS, cutoff, 0.5);
+        graph->play(new LinearPanner(2, filter * 0.01, new SineLFO(0.2, 0, 1)));
+    }
+}
+
+static NodeRef build_operator_tree(int depth, int &index)
+{
+    if (depth == 0)
+    {
+        return new SineOscillator(100 + index++);
+    }
+    NodeRef a = build_operator_tree(depth - 1, index);
+    NodeRef b = build_operator_tree(depth - 1, index);
+    return (depth % 2) ? (a + b) * 0.5 : a * b;
+}
+
+static NodeRef build_operator_chain()
+{
+    int index = 0;
+    NodeRef tree = build_operator_tree(8, index);
+    for (int link = 0; link < 256; link++)
+    {
+        tree = tree * 0.999 + 0.001;
+    }
+    return tree;
+}
+
+static void build_operators(AudioGraphRef graph)
+{
+    graph->play(build_operator_chain());
+}
+
+static void build_operators_optimised(AudioGraphRef graph)
+{
+    PatchRef patch = new Patch();
+    patch->set_output(build_operator_chain());
+    patch->optimise();
+    graph->play(patch);
+}
+
+static void build_noise_bed(AudioGraphRef graph)
+{
+    NodeRef noise = new WhiteNoise(0.0, std::vector<float>(64, -1.0), 1.0);
+    graph->play(new ChannelMixer(2, noise * 0.01));
+}
+
+/*------------------------------------------------------------------------
+ * A stem of num_channels harmonics, under a shared amplitude LFO.
+ *-----------------------------------------------------------------------*/
+static NodeRef build_stem(int num_channels)
+{
+    std::vector<float> frequencies;
+    for (int channel = 0; channel < num_channels; channel++)
+    {
+        frequencies.push_back(55.0 * (channel + 1));
+    }
+    NodeRef sine = new SineOscillator(frequencies);
+    return sine * new SineLFO(0.3, 0.5, 2.0);
+}
+
+/*------------------------------------------------------------------------
+ * A 32-channel stem limited with linked and unlinked detection.
+ *-----------------------------------------------------------------------*/
+static void build_limiter_linked(AudioGraphRef graph)
+{
+    NodeRef limiter = new Limiter(build_stem(32), 0.9, 0.05, 0.005, true);
+    graph->play(new ChannelMixer(2, limiter * 0.05));
+}
+
+static void build_limiter_unlinked(AudioGraphRef graph)
+{
+    NodeRef limiter = new Limiter(build_stem(32), 0.9, 0.05, 0.005, false);
+    graph->play(new ChannelMixer(2, limiter * 0.05));
+}
+
+/*------------------------------------------------------------------------
+ * 64 sources spread across a 32-speaker array, through the sparse matrix
+ * mixer and through the dense channel mixer.
+ *-----------------------------------------------------------------------*/
+static void build_matrix_mixer(AudioGraphRef graph)
+{
+    NodeRef mixer = new MatrixMixer(32, build_stem(64), SIGNALFLOW_MIXER_PRESET_SPREAD);
+    graph->play(new ChannelMixer(2, mixer * 0.05));
+}
+
+static void build_channel_mixer(AudioGraphRef graph)
+{
+    NodeRef mixer = new ChannelMixer(32, build_stem(64), true);
+    graph->play(new ChannelMixer(2, mixer * 0.05));
+}
+
+/*------------------------------------------------------------------------
+ * 500 moving sources on a 48-speaker dome, by VBAP and by third-order
+ * ambisonics. Each source is a copy of the same oscillator, so that the
+ * cost measured is that of the spatialisation.
+ *-----------------------------------------------------------------------*/
+static void build_dome_layout(std::vector<float> &azimuths, std::vector<float> &elevations)
+{
+    int rings[3][2] = { { 24, 0 }, { 16, 30 }, { 8, 60 } };
+    for (auto ring : rings)
+    {
+        for (int speaker = 0; speaker < ring[0]; speaker++)
+        {
+            azimuths.push_back(-180.0 + 360.0 * speaker / ring[0]);
+            elevations.push_back(ring[1]);
+        }
+    }
+}
+
+static void build_moving_sources(int num_sources, NodeRef &azimuth, NodeRef &elevation)
+{
+    std::vector<float> rates;
+    for (int source = 0; source < num_sources; source++)
+    {
+        rates.push_back(0.05 + source * 0.001);
+    }
+    azimuth = new SawLFO(rates, -180, 180);
+    elevation = new SineLFO(rates, 0, 60);
+}
+
+static void build_vbap(AudioGraphRef graph)
+{
+    std::vector<float> azimuths, elevations;
+    build_dome_layout(azimuths, elevations);
+    NodeRef azimuth, elevation;
+    build_moving_sources(500, azimuth, elevation);
+    NodeRef source = new SineOscillator(440);
+    NodeRef panner = new VBAPPanner(azimuths, elevations, source * 0.01, azimuth, elevation);
+    graph->play(new ChannelMixer(2, panner));
+}
+
+static void build_ambisonics(AudioGraphRef graph)
+{
+    std::vector<float> azimuths, elevations;
+    build_dome_layout(azimuths, elevations);
+    NodeRef azimuth, elevation;
+    build_moving_sources(500, azimuth, elevation);
+    NodeRef source = new SineOscillator(440);
+    NodeRef encoder = new AmbisonicEncoder(3, source * 0.01, azimuth, elevation);
+    NodeRef decoder = new AmbisonicDecoder(azimuths, elevations, encoder);
+    graph->play(new ChannelMixer(2, decoder));
+}
+
+/*------------------------------------------------------------------------
+ * Impulse-excited feedback and filter tails, decayed into the denormal
+ * range before timing begins. Compare with and without denormal flushing.
+ *-----------------------------------------------------------------------*/
+static void build_decaying_feedback(AudioGraphRef graph)
+{
+    for (int voice = 0; voice < 32; voice++)
+    {
+        NodeRef impulse = new Impulse(0.001);
+        NodeRef comb = new CombDelay(impulse, 0.002 + voice * 0.0001, 0.8);
+        NodeRef biquad = new BiquadFilter(comb, SIGNALFLOW_FILTER_TYPE_LOW_PASS, 2000 + voice * 50, 0.5);
+        NodeRef svf = new SVFFilter(biquad, SIGNALFLOW_FILTER_TYPE_LOW_PASS, 1000, 0.5);
+        NodeRef moog = new MoogVCF(svf, 800, 0.5);
+        NodeRef compressor = new Compressor(moog, 0.01, 4, 0.01, 0.5);
+        graph->play(compressor * 0.03);
+    }
+
+    int block_size = graph->get_config().get_output_buffer_size();
+    for (int frame = 0; frame < graph->get_sample_rate() * 2; frame += block_size)
+    {
+        graph->render(block_size);
+    }
+}
+
+static void build_decaying_feedback_unflushed(AudioGraphRef graph)
+{
+    graph->get_config().set_flush_denormals(false);
+    build_decaying_feedback(graph);
+}
+
+static void benchmark_graphs(BenchmarkOptions &options, std::vector<BenchmarkResult> &results)
+{
+    std::vector<std::pair<std::string, std::function<void(AudioGraphRef)>>> scenarios = {
+        { "graph/additive-256-partials", build_additive },
+        { "graph/granular-cloud", build_granular },
+        { "graph/spectral-chain", build_spectral },
+        { "graph/polyphony-128-voices", build_polyphony },
+        { "graph/operator-tree", build_operators },
+        { "graph/operator-tree-optimised", build_operators_optimised },
+        { "graph/noise-bed-64-channels", build_noise_bed },
+        { "graph/limiter-32-channels-linked", build_limiter_linked },
+        { "graph/limiter-32-channels-unlinked", build_limiter_unlinked },
+        { "graph/matrix-mixer-64-to-32", build_matrix_mixer },
+        { "graph/channel-mixer-64-to-32", build_channel_mixer },
+        { "graph/vbap-500-sources-48-speakers", build_vbap },
+        { "graph/ambisonics-500-sources-48-speakers", build_ambisonics },
+        { "graph/decaying-feedback", build_decaying_feedback },
+        { "graph/decaying-feedback-unflushed", build_decaying_feedback_unflushed },
+    };
+
+    for (auto scenario : scenarios)
+    {
+        if (scenario.first.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        AudioGraphConfig config;
+        config.set_output_buffer_size(options.block_size);
+        AudioGraphRef graph = new AudioGraph(&config, new AudioOut_Dummy(2));
+        AudioGraphContext context(graph.get());
+        scenario.second(graph);
+
+        int block_size = options.block_size;
+        results.push_back(run_benchmark(
+            scenario.first, "graph", [&]() { graph->render(block_size); }, options, graph->get_sample_rate()));
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Patch benchmarks.
+ *
+ * Each iteration creates and destroys one instance of a typical voice
+ * patch, or rebinds one of its inputs, so ns/block is the cost of a
+ * single operation.
+ *-----------------------------------------------------------------------*/
+static PatchRef build_voice_prototype()
+{
+    PatchRef prototype = new Patch();
+    NodeRef frequency = prototype->add_input("frequency", 440);
+    NodeRef gate = prototype->add_input("gate", 1);
+    NodeRef oscillator = prototype->add_node(new SawOscillator(frequency));
+    NodeRef envelope = prototype->add_node(new EnvelopeADSR(0.01, 0.1, 0.5, 0.2, gate));
+    NodeRef filter = prototype->add_node(new SVFFilter(oscillator, SIGNALFLOW_FILTER_TYPE_LOW_PASS, envelope * 2000 + 200, 0.5));
+    prototype->set_output(prototype->add_node(new LinearPanner(2, filter * envelope * 0.1, new SineLFO(0.2, 0, 1))));
+    return prototype;
+}
+
+static void benchmark_patches(BenchmarkOptions &options, std::vector<BenchmarkResult> &results)
+{
+    AudioGraphConfig config;
+    config.set_output_buffer_size(options.block_size);
+    AudioGraphRef graph = new AudioGraph(&config, new AudioOut_Dummy(2));
+    AudioGraphContext context(graph.get());
+
+    PatchRef prototype = build_voice_prototype();
+    PatchSpecRef spec = prototype->create_spec();
+    PatchRef voice = new Patch(spec);
+    std::vector<NodeRef> frequencies = { new Constant(220), new Constant(330) };
+    int frequency_index = 0;
+
+    std::vector<std::pair<std::string, std::function<void()>>> scenarios = {
+        { "patch/spawn-from-spec", [&]() { PatchRef patch = new Patch(spec); } },
+        { "patch/spawn-from-patch", [&]() { PatchRef patch = new Patch(prototype); } },
+        { "patch/set-input", [&]() { voice->set_input("frequency", frequencies[frequency_index++ % 2]); } },
+    };
+
+    for (auto scenario : scenarios)
+    {
+        if (scenario.first.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+        results.push_back(run_benchmark(scenario.first, "patch", scenario.second, options, graph->get_sample_rate()));
+    }
+}
+
+static void write_json(std::string path, BenchmarkOptions &options, std::vector<BenchmarkResult> &results)
+{
+    json11::Json::array benchmarks;
+    for (auto &result : results)
+    {
+        benchmarks.push_back(json11::Json::object {
+            { "name", result.name },
+            { "kind", result.kind },
+            { "iterations", (double) result.iterations },
+            { "ns_per_block", result.ns_per_block },
+            { "ns_per_frame", result.ns_per_frame },
+            { "realtime_factor", result.realtime_factor },
+        });
+    }
+
+    json11::Json json = json11::Json::object {
+        { "context", json11::Json::object {
+                         { "block_size", options.block_size },
+                         { "min_time", options.min_time },
+                         { "repetitions", options.repetitions },
+                         { "timestamp", (double) std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() },
+                     } },
+        { "benchmarks", benchmarks },
+    };
+
+    std::ofstream stream(path);
+    if (!stream.good())
+    {
+        throw std::runtime_error("Couldn't write benchmark results to " + path);
+    }
+    stream << json.dump() << std::endl;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--filter SUBSTRING] [--json PATH] [--block-size FRAMES] [--min-time SECONDS] [--repetitions N]\n", program);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    for (int index = 1; index < argc; index++)
+    {
+        std::string arg = argv[index];
+        if (index + 1 >= argc)
+        {
+            usage(argv[0]);
+        }
+        std::string value = argv[++index];
+        if (arg == "--filter")
+            options.filter = value;
+        else if (arg == "--json")
+            options.json_path = value;
+        else if (arg == "--block-size")
+            options.block_size = std::stoi(value);
+        else if (arg == "--min-time")
+            options.min_time = std::stod(value);
+        else if (arg == "--repetitions")
+            options.repetitions = std::stoi(value);
+        else
+            usage(argv[0]);
+    }
+    if (options.block_size < 1 || options.block_size > SIGNALFLOW_NODE_BUFFER_SIZE || options.repetitions < 1)
+    {
+        usage(argv[0]);
+    }
+
+    /*------------------------------------------------------------------------
+     * Seed the random number generator, so that stochastic nodes and
+     * scenarios do the same work on every run.
+     *-----------------------------------------------------------------------*/
+    random_seed(0);
+
+    std::vector<BenchmarkResult> results;
+    benchmark_nodes(options, results);
+    benchmark_graphs(options, results);
+    benchmark_patches(options, results);
+
+    if (!options.json_path.empty())
+    {
+        write_json(options.json_path, options, results);
+    }
+
+    return 0;
+}
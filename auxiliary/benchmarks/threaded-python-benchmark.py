@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+
+#--------------------------------------------------------------------------------
+# Benchmark: concurrency of SignalFlow calls across Python threads.
+#
+# Long-running SignalFlow calls (rendering, buffer I/O, node construction)
+# release the GIL, and each thread can render its own AudioGraph, so they run
+# concurrently with each other and with other Python threads. This benchmark
+# times each workload with 1..N threads, and reports the speedup relative to
+# running the same total work serially.
+# With the GIL released, speedup should scale close to linearly with the
+# thread count, up to the number of available cores.
+#
+# Usage: threaded-python-benchmark.py [--threads N] [--duration SECONDS]
+#--------------------------------------------------------------------------------
+
+from signalflow import *
+import numpy as np
+import argparse
+import tempfile
+import threading
+import time
+import os
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--threads", type=int, default=os.cpu_count())
+parser.add_argument("--duration", type=float, default=10.0, help="Seconds of audio to process per task")
+args = parser.parse_args()
+
+graph = AudioGraph(output_device=AudioOut_Dummy(2))
+sample_rate = graph.sample_rate
+tempdir = tempfile.mkdtemp()
+
+def run_threads(task, num_threads):
+    threads = [threading.Thread(target=task, args=(index,)) for index in range(num_threads)]
+    t0 = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return time.perf_counter() - t0
+
+def benchmark(name, task):
+    task(0)
+    t_single = run_threads(task, 1)
+    print("%s:" % name)
+    num_threads = 1
+    while num_threads <= args.threads:
+        t = run_threads(task, num_threads)
+        print("  %2d threads: %.3fs (speedup %.2fx)" % (num_threads, t, num_threads * t_single / t))
+        num_threads *= 2
+
+#--------------------------------------------------------------------------------
+# Offline rendering, with each thread rendering its own AudioGraph.
+#--------------------------------------------------------------------------------
+def render_task(index):
+    graph = AudioGraph(output_device=AudioOut_Dummy(2))
+    with graph:
+        saw = SawOscillator([80 + index, 81 + index])
+        graph.play(SVFFilter(saw, "low_pass", 1000, 0.5) * 0.5)
+        output = np.zeros((2, int(args.duration * sample_rate)), dtype=np.float32)
+        graph.render_to_array(output)
+
+#--------------------------------------------------------------------------------
+# Offline processing of a node subgraph that is not connected to the
+# graph's output, with each thread processing its own subgraph.
+#--------------------------------------------------------------------------------
+def process_task(index):
+    sine = SineOscillator(440 + index)
+    filtered = SVFFilter(sine, "low_pass", 1000)
+    output = Buffer(1, 1024)
+    for block in range(int(args.duration * sample_rate / len(output))):
+        sine.process(len(output))
+        filtered.process(output)
+
+#--------------------------------------------------------------------------------
+# Buffer file I/O, with each thread writing and reading its own file.
+#--------------------------------------------------------------------------------
+def buffer_io_task(index):
+    path = os.path.join(tempdir, "buffer-%d.wav" % index)
+    buf = Buffer(2, int(args.duration * sample_rate))
+    buf.save(path)
+    Buffer(path)
+
+#--------------------------------------------------------------------------------
+# Node construction, which includes allocating each node's output buffers.
+#--------------------------------------------------------------------------------
+def construction_task(index):
+    for n in range(int(args.duration * 100)):
+        CombDelay(0, 0.1, 0.5, 1.0)
+
+benchmark("Graph rendering", render_task)
+benchmark("Node processing", process_task)
+benchmark("Buffer save/load", buffer_io_task)
+benchmark("Node construction", construction_task)
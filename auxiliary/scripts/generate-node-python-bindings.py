@@ -50,7 +50,8 @@ def generate_class_bindings(class_name, parameter_sets, superclass="Node"):
     output = 'py::class_<{class_name}, {superclass}, NodeRefTemplate<{class_name}>>(m, "{class_name}")\n'.format(class_name=class_name, superclass=superclass)
     for parameter_set in parameter_sets:
         parameter_type_list = ", ".join([ parameter["type"] for parameter in parameter_set ])
-        output += '    .def(py::init<{parameter_type_list}>()'.format(parameter_type_list=parameter_type_list);
+        # Release the GIL while constructing, as some nodes allocate large buffers
+        output += '    .def(py::init<{parameter_type_list}>(), py::call_guard<py::gil_scoped_release>()'.format(parameter_type_list=parameter_type_list);
         for parameter in parameter_set:
             if parameter["default"] is not None:
                 default = parameter["default"]
@@ -14,14 +14,11 @@ note_interval = 0.125
 
 #--------------------------------------------------------------------------------
 # Karplus-Strong synthesis requires a short delay line whose delay time
-# is 1/F of the synthesized frequency. Because SignalFlow reads and writes
-# buffers (including the feedback notes) on a block-by-block basis, this delay
-# time can only be as short as the graph's global block size, so set a small
-# block size so we can render a reasonable range of frequencies.
-#--------------------------------------------------------------------------------
-config = AudioGraphConfig()
-config.output_buffer_size = 128
-graph = AudioGraph(config=config, start=True)
+# is 1/F of the synthesized frequency. When the delay is shorter than the
+# graph's block size, the graph renders the feedback loop in correspondingly
+# shorter sub-blocks, so any block size can be used.
+#--------------------------------------------------------------------------------
+graph = AudioGraph(start=True)
 graph.show_status(2)
 
 #--------------------------------------------------------------------------------
@@ -42,7 +39,7 @@ feedback_reader = FeedbackBufferReader(feedback_buf)
 # it will only generate when triggered.
 #--------------------------------------------------------------------------------
 random_frequency = RandomExponential(1, 6, clock=0)
-rounded_frequency = Round(random_frequency) * 50
+rounded_frequency = Round(random_frequency) * 100
 
 #--------------------------------------------------------------------------------
 # Write to the feedback buffer.
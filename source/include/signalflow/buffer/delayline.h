@@ -0,0 +1,105 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file delayline.h
+ * @brief DelayLine is a single-channel circular buffer for delay-based
+ *        processors. Its capacity is a power of two, so that positions wrap
+ *        with a bitmask rather than a modulo, and it supports reading and
+ *        writing whole blocks as well as single samples.
+ *
+ * All reads are specified relative to the write head: a delay of 1 reads the
+ * most recently written sample. Block reads return, for each frame, the
+ * sample `delay` samples before the position that frame would be written to,
+ * so that a block read followed by a block write of the same length behaves
+ * identically to reading and writing sample by sample.
+ *
+ * Fractional delays are linearly interpolated.
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/core/constants.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+class DelayLine
+{
+public:
+    /**------------------------------------------------------------------------
+     * Create a delay line that can be read at delays of up to
+     * `max_delay_samples` samples. The delay line is initially silent.
+     *
+     *------------------------------------------------------------------------*/
+    DelayLine(int max_delay_samples = 0);
+
+    /**------------------------------------------------------------------------
+     * Returns the maximum delay that can be read, in samples. This may be
+     * greater than the maximum requested at construction.
+     *
+     *------------------------------------------------------------------------*/
+    int get_max_delay();
+
+    /**------------------------------------------------------------------------
+     * Reset the contents of the delay line to silence.
+     *
+     *------------------------------------------------------------------------*/
+    void clear();
+
+    /**------------------------------------------------------------------------
+     * Write a sample at the write head, and advance the write head.
+     *
+     *------------------------------------------------------------------------*/
+    inline void write(sample value)
+    {
+        this->data[this->write_position] = value;
+        this->write_position = (this->write_position + 1) & this->mask;
+    }
+
+    /**------------------------------------------------------------------------
+     * Write a block of samples, and advance the write head past them.
+     *
+     *------------------------------------------------------------------------*/
+    void write(const sample *in, int num_frames);
+
+    /**------------------------------------------------------------------------
+     * Read the sample `delay` samples before the write head.
+     *
+     *------------------------------------------------------------------------*/
+    inline sample read(float delay)
+    {
+        int delay_int = (int) delay;
+        float delay_frac = delay - delay_int;
+        int index = (this->write_position - delay_int) & this->mask;
+        sample a = this->data[index];
+        sample b = this->data[(index - 1) & this->mask];
+        return a + delay_frac * (b - a);
+    }
+
+    /**------------------------------------------------------------------------
+     * Read a block of samples at a fixed delay. Integer delays are copied
+     * directly from the buffer.
+     *
+     * Frames that have not yet been written must not be read: that is,
+     * `num_frames` must not exceed `delay`, unless the block has already
+     * been written, in which case the delay should include `num_frames`.
+     *
+     *------------------------------------------------------------------------*/
+    void read(float delay, sample *out, int num_frames);
+
+    /**------------------------------------------------------------------------
+     * Read a block of samples with a separate delay for each frame, for
+     * modulated delays. The same constraint applies as for fixed delays:
+     * frame `n` must have a delay greater than `n`, unless the block has
+     * already been written.
+     *
+     *------------------------------------------------------------------------*/
+    void read(const float *delays, sample *out, int num_frames);
+
+private:
+    std::vector<sample> data;
+    int mask;
+    int write_position;
+};
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file wavetablebuffer.h
+ * @brief WavetableBuffer stores a single-cycle waveform alongside a set of
+ *        bandlimited copies (mip levels), one per octave, so that it can be
+ *        played back at any pitch without aliasing.
+ *
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/buffer/buffer.h"
+
+#include <string>
+#include <vector>
+
+#define SIGNALFLOW_DEFAULT_WAVETABLE_BUFFER_LENGTH 2048
+
+namespace signalflow
+{
+
+class WavetableBuffer : public Buffer
+{
+public:
+    /**------------------------------------------------------------------------
+     * Construct a wavetable from a single cycle of a waveform.
+     * The length of `data` must be a power of two.
+     *
+     *------------------------------------------------------------------------*/
+    WavetableBuffer(std::vector<sample> data);
+
+    /**------------------------------------------------------------------------
+     * Construct a wavetable from the first channel of `buffer`.
+     * The length of `buffer` must be a power of two.
+     *
+     *------------------------------------------------------------------------*/
+    WavetableBuffer(BufferRef buffer);
+
+    /**------------------------------------------------------------------------
+     * Construct a wavetable containing one of the classic waveforms.
+     *
+     * The list of supported waveform names:
+     *
+     *   sine, saw, square, triangle
+     *
+     * @param name One of the recognised names above
+     * @param num_frames Length of buffer. Must be a power of two.
+     *
+     *------------------------------------------------------------------------*/
+    WavetableBuffer(std::string name, int num_frames = SIGNALFLOW_DEFAULT_WAVETABLE_BUFFER_LENGTH);
+
+    /**------------------------------------------------------------------------
+     * Get the number of mip levels. Level 0 contains every harmonic of the
+     * original waveform; each subsequent level contains half as many.
+     *
+     * @returns The number of levels.
+     *
+     *------------------------------------------------------------------------*/
+    int get_num_levels();
+
+    /**------------------------------------------------------------------------
+     * Read a block of samples from the bandlimited tables.
+     *
+     * For each frame, the pair of mip levels that contain no harmonics above
+     * the Nyquist frequency is selected, based on the per-sample phase
+     * increment, and the two are crossfaded by frequency within the octave.
+     *
+     * @param phases Read position for each frame, in the range [0, 1).
+     * @param increments Phase increment for each frame (frequency / sample_rate).
+     * @param out The output samples.
+     * @param num_frames The number of frames to read.
+     *
+     *------------------------------------------------------------------------*/
+    void read(const float *phases, const float *increments, sample *out, int num_frames);
+
+private:
+    void generate_levels();
+
+    int num_levels;
+
+    /*------------------------------------------------------------------------
+     * Each level holds num_frames + 2 samples, with the first two samples
+     * repeated at the end so that interpolated reads never need to wrap.
+     *-----------------------------------------------------------------------*/
+    std::vector<std::vector<sample>> levels;
+};
+
+typedef BufferRefTemplate<WavetableBuffer> WavetableBufferRef;
+
+}
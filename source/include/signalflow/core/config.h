@@ -109,6 +109,26 @@ public:
      *--------------------------------------------------------------------------------*/
     void set_output_device_name(const std::string &name);
 
+    /**--------------------------------------------------------------------------------
+     * Query whether denormal floats are flushed to zero while the graph renders.
+     *
+     * @returns true if denormals are flushed (the default).
+     *
+     *--------------------------------------------------------------------------------*/
+    bool get_flush_denormals() const;
+
+    /**--------------------------------------------------------------------------------
+     * Set whether denormal floats are flushed to zero while the graph renders.
+     * Decaying filter and feedback tails can otherwise spend long periods in the
+     * denormal range, which is very slow to process on most CPUs. Flushing is
+     * applied to whichever thread calls AudioGraph::render(), and the previous
+     * floating-point state is restored afterwards.
+     *
+     * @param flush_denormals If true, flush denormals to zero.
+     *
+     *--------------------------------------------------------------------------------*/
+    void set_flush_denormals(bool flush_denormals);
+
     /**--------------------------------------------------------------------------------
      * Print the current config to stdout.
      *
@@ -121,6 +141,7 @@ private:
     unsigned int output_buffer_size = 0;
     std::string input_device_name;
     std::string output_device_name;
+    bool flush_denormals = true;
 };
 
 } /* namespace signalflow */
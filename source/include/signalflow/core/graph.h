@@ -5,6 +5,12 @@
  * @brief AudioGraph encapsulates the entire signal processing graph, containing
  *        Nodes, Patches, audio inputs and outputs.
  *
+ * Multiple graphs may exist at once, each with its own output, clock and sample
+ * rate. Nodes, Patches and Buffers are bound to the graph that is current
+ * when they are created: that is, the graph most recently made current on the
+ * creating thread (see AudioGraph::make_current and AudioGraphContext), or
+ * otherwise the most recently created graph.
+ *
  *--------------------------------------------------------------------------------*/
 
 #include "signalflow/core/config.h"
@@ -12,13 +18,46 @@
 #include "signalflow/node/node.h"
 #include "signalflow/patch/patch.h"
 
+#include <atomic>
+#include <list>
+#include <mutex>
 #include <sndfile.h>
+#include <unordered_map>
+#include <vector>
 
 namespace signalflow
 {
 
 class AudioGraphMonitor;
 
+typedef enum
+{
+    SIGNALFLOW_GRAPH_EVENT_TRIGGER,
+    SIGNALFLOW_GRAPH_EVENT_SET_INPUT,
+    SIGNALFLOW_GRAPH_EVENT_RESET_PATCH
+} signalflow_graph_event_type_t;
+
+/**--------------------------------------------------------------------------------
+ * A trigger, input change or patch reset, scheduled to take effect at a given
+ * frame of the graph's clock. For an input change, node is the Constant whose
+ * value is set.
+ *--------------------------------------------------------------------------------*/
+class AudioGraphEvent
+{
+public:
+    AudioGraphEvent(long long frame, signalflow_graph_event_type_t type, NodeRef node, std::string name, float value)
+        : frame(frame), type(type), node(node), name(name), value(value) {}
+    AudioGraphEvent(long long frame, PatchRef patch)
+        : frame(frame), type(SIGNALFLOW_GRAPH_EVENT_RESET_PATCH), patch(patch), value(0.0) {}
+
+    long long frame;
+    signalflow_graph_event_type_t type;
+    NodeRef node;
+    PatchRef patch;
+    std::string name;
+    float value;
+};
+
 class AudioGraph
 {
 public:
@@ -28,6 +67,20 @@ public:
 
     virtual ~AudioGraph();
 
+    /**--------------------------------------------------------------------------------
+     * Returns the graph that new Nodes, Patches and Buffers created on the calling
+     * thread are bound to, or nullptr if no graph exists.
+     *
+     *--------------------------------------------------------------------------------*/
+    static AudioGraph *get_current();
+
+    /**--------------------------------------------------------------------------------
+     * Bind Nodes, Patches and Buffers subsequently created on the calling thread
+     * to this graph. A new graph is made current on the thread that creates it.
+     *
+     *--------------------------------------------------------------------------------*/
+    void make_current();
+
     /**--------------------------------------------------------------------------------
      * Begin audio I/O.
      *
@@ -128,6 +181,87 @@ public:
      *--------------------------------------------------------------------------------*/
     void render_to_buffer(BufferRef buffer, int block_size = SIGNALFLOW_DEFAULT_BLOCK_SIZE);
 
+    /**--------------------------------------------------------------------------------
+     * Schedule a trigger to be sent to a node at a given time on the graph's clock.
+     * When render() is called, the block is divided into sub-blocks at the frames
+     * of any events that fall within it, so that each event takes effect at the
+     * exact frame at which it is scheduled. Events scheduled in the past take
+     * effect at the start of the next block.
+     *
+     * @param node The node to trigger.
+     * @param time The time to trigger the node, in seconds (see get_time()).
+     * @param name The name of the trigger.
+     * @param value The trigger value.
+     *
+     *--------------------------------------------------------------------------------*/
+    void schedule_trigger(NodeRef node,
+                          double time,
+                          std::string name = SIGNALFLOW_DEFAULT_TRIGGER,
+                          float value = 1.0);
+
+    /**--------------------------------------------------------------------------------
+     * Schedule a node's input to be set to a value at a given time on the graph's
+     * clock, with the same sample accuracy as schedule_trigger(). The input must
+     * be a Constant, whose value is changed when the event takes effect, so that
+     * no nodes are created or connected while rendering.
+     *
+     * @param node The node whose input to set.
+     * @param time The time to set the input, in seconds (see get_time()).
+     * @param name The name of the input.
+     * @param value The value to set.
+     *
+     *--------------------------------------------------------------------------------*/
+    void schedule_set_input(NodeRef node, double time, std::string name, float value);
+
+    /**--------------------------------------------------------------------------------
+     * Schedule the value of a Constant to be set at a given time on the graph's
+     * clock, with the same sample accuracy as schedule_trigger().
+     *
+     * @param constant The Constant whose value to set.
+     * @param time The time to set the value, in seconds (see get_time()).
+     * @param value The value to set.
+     *
+     *--------------------------------------------------------------------------------*/
+    void schedule_set_value(NodeRef constant, double time, float value);
+
+    /**--------------------------------------------------------------------------------
+     * Schedule a patch to be reset (see Patch::reset()) at a given time on the
+     * graph's clock, with the same sample accuracy as schedule_trigger().
+     *
+     * @param patch The patch to reset.
+     * @param time The time to reset the patch, in seconds (see get_time()).
+     *
+     *--------------------------------------------------------------------------------*/
+    void schedule_patch_reset(PatchRef patch, double time);
+
+    /**--------------------------------------------------------------------------------
+     * Apply the inputs queued on a patch with Patch::queue_input() at the start
+     * of the next block. The queued inputs of every patch are applied together,
+     * before any node is rendered. Called by Patch.
+     *
+     * @param patch The patch with queued inputs.
+     *
+     *--------------------------------------------------------------------------------*/
+    void schedule_patch_inputs(Patch *patch);
+
+    /**--------------------------------------------------------------------------------
+     * Stop applying a patch's queued inputs. Called by Patch when it is
+     * destroyed.
+     *
+     * @param patch The patch.
+     *
+     *--------------------------------------------------------------------------------*/
+    void cancel_patch_inputs(Patch *patch);
+
+    /**--------------------------------------------------------------------------------
+     * Get the time on the graph's clock, in seconds: that is, the total duration
+     * of the blocks rendered so far.
+     *
+     * @return The time, in seconds.
+     *
+     *--------------------------------------------------------------------------------*/
+    double get_time();
+
     /**--------------------------------------------------------------------------------
      * Reset the audio graph:
      *  - do garbage collection on any nodes/patches that are scheduled to be removed
@@ -317,6 +451,15 @@ public:
       *--------------------------------------------------------------------------------*/
     AudioGraphConfig &get_config();
 
+    /**--------------------------------------------------------------------------------
+      * Mark the connections between the graph's nodes as changed, so that
+      * anything the graph caches about its topology is rebuilt before the
+      * next block is rendered. Called by Node whenever an input or buffer is
+      * created, removed or set.
+      *
+      *--------------------------------------------------------------------------------*/
+    void invalidate_topology();
+
 private:
     std::set<NodeRef> scheduled_nodes;
     std::set<NodeRef> nodes_to_remove;
@@ -325,6 +468,100 @@ private:
     std::set<Patch *> patches_to_remove;
 
     void show_structure(NodeRef &root, int depth);
+
+    /*------------------------------------------------------------------------
+     * Render one block of the graph, without reference to scheduled events.
+     *-----------------------------------------------------------------------*/
+    void render_block(int num_frames);
+
+    /*------------------------------------------------------------------------
+     * Scheduled events. Events are added to events_pending under
+     * events_mutex, and moved into events, which is ordered by frame and
+     * only accessed by the rendering thread, at the start of a block if
+     * the mutex is free. Events are moved between lists by splicing, so
+     * the rendering thread never allocates or frees them: dispatched
+     * events are handed back in events_to_release, and freed by the next
+     * call to schedule_event() or clear().
+     *-----------------------------------------------------------------------*/
+    void schedule_event(const AudioGraphEvent &event);
+    void collect_events();
+    void dispatch_events(long long frame);
+    std::list<AudioGraphEvent> events;
+    std::list<AudioGraphEvent> events_dispatched;
+    std::list<AudioGraphEvent> events_pending;
+    std::list<AudioGraphEvent> events_to_release;
+    bool events_cleared;
+    std::mutex events_mutex;
+
+    /*------------------------------------------------------------------------
+     * When a block is divided into sub-blocks, each sub-block is rendered
+     * in place, by advancing the output pointers of every node by the
+     * frames already rendered (see Node::block_offset), and rewinding
+     * them once the block is complete.
+     *-----------------------------------------------------------------------*/
+    void offset_subgraph(Node *node, int offset, int last_num_frames);
+    void offset_graph(int offset, int last_num_frames);
+
+    /*------------------------------------------------------------------------
+     * A block is only divided if every node in the graph supports
+     * sub-blocks. Otherwise, the events within it are dispatched at its
+     * start. This is checked once per topology, marking each node visited
+     * with sub_block_check.
+     *-----------------------------------------------------------------------*/
+    bool can_divide_blocks();
+    bool subgraph_supports_sub_blocks(Node *node);
+    bool supports_sub_blocks;
+    unsigned int sub_blocks_version;
+    long sub_block_check;
+
+    /*------------------------------------------------------------------------
+     * Patches with inputs queued by Patch::queue_input(). A vector, so that
+     * the rendering thread can remove patches without freeing memory.
+     *-----------------------------------------------------------------------*/
+    std::vector<Patch *> patches_with_queued_inputs;
+    std::mutex patch_inputs_mutex;
+    long long frames_rendered;
+
+    /*------------------------------------------------------------------------
+     * Up-mix the output of input_node to the number of channels that
+     * node expects.
+     *-----------------------------------------------------------------------*/
+    void upmix_input(Node *node, Node *input_node, int num_frames);
+
+    /*------------------------------------------------------------------------
+     * Feedback loops whose delay is shorter than the block size are
+     * rendered in sub-blocks. See render_feedback_subgraph.
+     *-----------------------------------------------------------------------*/
+    struct FeedbackRegion
+    {
+        bool isolated;
+        std::vector<Node *> nodes;
+        std::vector<NodeRef *> inputs;
+    };
+    bool render_feedback_subgraph(const NodeRef &writer, int num_frames);
+    void build_feedback_region(FeedbackRegion &region, const NodeRef &writer, Buffer *buffer);
+    bool find_feedback_region(FeedbackRegion &region, Node *node, Buffer *buffer);
+    void offset_feedback_region(FeedbackRegion &region, int num_frames);
+    std::unordered_map<Node *, FeedbackRegion> feedback_regions;
+    std::unordered_map<Node *, bool> feedback_region_visited;
+    std::vector<float> feedback_saved_last_sample;
+
+    /*------------------------------------------------------------------------
+     * Incremented by invalidate_topology(). The cached feedback regions are
+     * discarded when this no longer matches feedback_regions_version.
+     *-----------------------------------------------------------------------*/
+    std::atomic<unsigned int> topology_version;
+    unsigned int feedback_regions_version;
+
+    /*------------------------------------------------------------------------
+     * Determine whether a node can be rendered at control rate in the
+     * current block: that is, whether every node it feeds reads it at
+     * control rate, or is itself rendered at control rate. The result is
+     * cached on the node until control_rate_block next changes.
+     *-----------------------------------------------------------------------*/
+    bool resolve_control_rate(Node *node);
+    long control_rate_block;
+
     AudioGraphMonitor *monitor;
     int sample_rate;
     int node_count;
@@ -340,6 +577,24 @@ private:
     int recording_num_channels;
 };
 
+/**--------------------------------------------------------------------------------
+ * Makes a graph current on the calling thread for the lifetime of the context,
+ * and then restores the graph that was previously current.
+ *
+ *   AudioGraphContext context(graph);
+ *   NodeRef sine = new SineOscillator(440);
+ *
+ *--------------------------------------------------------------------------------*/
+class AudioGraphContext
+{
+public:
+    AudioGraphContext(AudioGraph *graph);
+    ~AudioGraphContext();
+
+private:
+    AudioGraph *previous;
+};
+
 class AudioGraphRef : public std::shared_ptr<AudioGraph>
 {
 public:
@@ -4,6 +4,14 @@
 
 #pragma once
 
+#include <stdint.h>
+
+/*--------------------------------------------------------------------*
+ * Number of counters that RandomStream generates together. Each lane
+ * is independent, so the compiler can vectorise across lanes.
+ *--------------------------------------------------------------------*/
+#define SIGNALFLOW_RANDOM_STREAM_LANES 8
+
 namespace signalflow
 {
 
@@ -19,4 +27,55 @@ bool random_coin(double limit);
 void random_shuffle(int *values, int count);
 float random_exponential(float mu);
 
+/*--------------------------------------------------------------------*
+ * RandomStream: Counter-based random number generator (Philox4x32-10).
+ *
+ * Each output is a pure function of (seed, stream, position), so a
+ * stream can be seeked to any position in constant time, and separate
+ * streams with the same seed are independent. Drawing values one at a
+ * time or filling a block gives identical sequences, regardless of the
+ * block size.
+ *
+ * Each uniform or exponential value consumes one 32-bit word, and each
+ * gaussian value consumes two.
+ *--------------------------------------------------------------------*/
+class RandomStream
+{
+public:
+    RandomStream(uint64_t seed = 0, uint32_t stream = 0);
+
+    void seed(uint64_t seed, uint32_t stream = 0);
+    void seek(uint64_t position);
+    uint64_t get_position() const;
+
+    uint32_t next();
+    float uniform();
+    float uniform(float from, float to);
+    float gaussian(float mean = 0.0, float sigma = 1.0);
+    float exponential(float lambda = 1.0);
+
+    /*--------------------------------------------------------------------*
+     * Random integer in [0, count).
+     *--------------------------------------------------------------------*/
+    uint32_t integer(uint32_t count);
+
+    void fill(uint32_t *out, int count);
+    void fill_uniform(float *out, int count, float from = 0.0, float to = 1.0);
+    void fill_gaussian(float *out, int count, float mean = 0.0, float sigma = 1.0);
+
+private:
+    void generate(uint64_t counter, uint32_t *out, int num_counters);
+
+    uint32_t key[2];
+    uint32_t stream;
+
+    /*--------------------------------------------------------------------*
+     * Words generated from SIGNALFLOW_RANDOM_STREAM_LANES consecutive
+     * counters, starting at buffer_counter.
+     *--------------------------------------------------------------------*/
+    uint32_t buffer[SIGNALFLOW_RANDOM_STREAM_LANES * 4];
+    uint64_t buffer_counter;
+    int buffer_position;
+};
+
 }
@@ -34,9 +34,41 @@ float signalflow_midi_note_to_frequency(float midi);
 float signalflow_db_to_amplitude(float db);
 float signalflow_amplitude_to_db(float amp);
 
+/*--------------------------------------------------------------------*
+ * Equal-power pan across a line of num_channels channels, where
+ * pan = -1 is the first channel and pan = 1 is the last. Returns the
+ * index of the lower of the two channels that the signal falls between,
+ * and sets the gains of that channel and the next.
+ *--------------------------------------------------------------------*/
+int signalflow_pan_equal_power(float pan, int num_channels, float &gain_lower, float &gain_upper);
+
 void signalflow_save_block_to_text_file(sample *block, int num_samples, std::string filename);
 void signalflow_save_block_to_wav_file(sample *block, int num_samples, std::string filename);
 
 std::vector<int> signalflow_binary_sequence_to_vector(std::string binary);
 
+/*--------------------------------------------------------------------*
+ * Query or set whether denormal floats are flushed to zero on the
+ * calling thread (FTZ and DAZ on x86, FZ on ARM). On other
+ * architectures, this has no effect.
+ *--------------------------------------------------------------------*/
+bool signalflow_get_flush_denormals();
+void signalflow_set_flush_denormals(bool enabled);
+
+/*--------------------------------------------------------------------*
+ * Flushes denormals on the calling thread for the lifetime of the
+ * object, restoring the previous floating-point state on destruction.
+ * If enabled is false, the floating-point state is left unchanged.
+ *--------------------------------------------------------------------*/
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals(bool enabled = true);
+    ~ScopedFlushDenormals();
+
+private:
+    bool enabled;
+    unsigned long previous_state;
+};
+
 }
@@ -1,3 +1,4 @@
+#include "signalflow/buffer/delayline.h"
 #include "signalflow/node/node.h"
 
 namespace signalflow
@@ -13,7 +14,7 @@ public:
     virtual void process(Buffer &out, int num_frames);
 
 private:
-    SampleRingBuffer *ring_buffer;
+    DelayLine delay_line;
 };
 
 REGISTER(CrossCorrelate, "cross-correlate")
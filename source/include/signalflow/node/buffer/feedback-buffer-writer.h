@@ -4,6 +4,13 @@
 
 namespace signalflow
 {
+/**--------------------------------------------------------------------------------
+ * Write `input` into `buffer`, `delay_time` seconds ahead of the position
+ * read by FeedbackBufferReader nodes of the same buffer, forming a feedback
+ * loop. The delay can be as short as a single sample: if it is shorter than
+ * the block size, the AudioGraph renders the loop in sub-blocks no longer
+ * than the delay.
+ *--------------------------------------------------------------------------------*/
 class FeedbackBufferWriter : public Node
 {
 public:
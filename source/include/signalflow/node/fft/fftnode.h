@@ -25,8 +25,9 @@ class FFTOpNode : public FFTNode
 public:
     FFTOpNode(NodeRef input = nullptr);
 
-    virtual void set_input(std::string name, const NodeRef &node);
-
     NodeRef input;
+
+protected:
+    virtual void input_changed(int index, const NodeRef &previous);
 };
 }
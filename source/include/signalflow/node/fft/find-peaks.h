@@ -1,6 +1,9 @@
 #pragma once
 
 #include "signalflow/node/fft/fftnode.h"
+#include "signalflow/node/fft/spectral-statistics.h"
+
+#include <vector>
 
 namespace signalflow
 {
@@ -17,6 +20,10 @@ public:
     NodeRef threshold = nullptr;
     int count;
     bool interpolate;
+
+private:
+    SpectralStatistics statistics;
+    std::vector<SpectralPeak> peaks;
 };
 
 REGISTER(FFTFindPeaks, "fft-find-peaks")
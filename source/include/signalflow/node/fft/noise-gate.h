@@ -1,6 +1,7 @@
 #pragma once
 
 #include "signalflow/node/fft/fftnode.h"
+#include "signalflow/node/fft/spectral-statistics.h"
 
 namespace signalflow
 {
@@ -14,7 +15,7 @@ public:
     NodeRef threshold = nullptr;
 
 private:
-    float mags[SIGNALFLOW_MAX_FFT_SIZE / 2];
+    SpectralStatistics statistics;
 };
 
 REGISTER(FFTNoiseGate, "fft_noise_gate")
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "signalflow/node/fft/fftnode.h"
+#include "signalflow/node/fft/spectral-statistics.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Outputs four descriptors of the most recent FFT frame, each held until
+ * the next frame arrives:
+ *
+ *  0. Spectral centroid, in Hz
+ *  1. Spectral flux: the total increase in amplitude across bins since the
+ *     previous frame
+ *  2. Spectral rolloff: the frequency in Hz below which `rolloff` of the
+ *     frame's energy lies
+ *  3. Spectral flatness, between 0 (tonal) and 1 (noisy)
+ *--------------------------------------------------------------------------------*/
+class FFTSpectralFeatures : public FFTOpNode
+{
+public:
+    FFTSpectralFeatures(NodeRef input = 0, NodeRef rolloff = 0.85);
+    virtual void process(Buffer &out, int num_frames);
+
+    NodeRef rolloff = nullptr;
+
+private:
+    SpectralStatistics statistics;
+    std::vector<sample> previous_magnitudes;
+    float centroid;
+    float flux;
+    float rolloff_frequency;
+    float flatness;
+};
+
+REGISTER(FFTSpectralFeatures, "fft-spectral-features")
+
+}
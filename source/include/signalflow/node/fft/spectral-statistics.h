@@ -0,0 +1,113 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file spectral-statistics.h
+ * @brief Statistics over a frame of FFT magnitudes, shared by the FFT
+ *        operation and analysis nodes.
+ *
+ * A SpectralStatistics object is created for a fixed number of bins, and
+ * allocates all of its working memory up front, so that none of its methods
+ * allocate during processing. Each method takes a pointer to `num_bins`
+ * magnitudes, as laid out in the output of an FFT node.
+ *
+ * All methods are linear in the number of bins, except find_peaks(), which
+ * additionally sorts the peaks that it returns.
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/core/constants.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+class SpectralPeak
+{
+public:
+    /*------------------------------------------------------------------------
+     * Bin index, with a fractional offset if interpolated.
+     *-----------------------------------------------------------------------*/
+    float bin;
+    float magnitude;
+
+    /*------------------------------------------------------------------------
+     * Ratio of the peak's magnitude to the higher of the lowest points
+     * between it and the nearest higher bin on either side.
+     *-----------------------------------------------------------------------*/
+    float prominence;
+};
+
+class SpectralStatistics
+{
+public:
+    SpectralStatistics(int num_bins = 0);
+
+    int get_num_bins();
+
+    /**------------------------------------------------------------------------
+     * Returns the magnitude at the given proportion (0..1) of the way
+     * through the magnitudes in ascending order, by linear-time selection.
+     *
+     *------------------------------------------------------------------------*/
+    float percentile(const sample *magnitudes, float proportion);
+
+    /**------------------------------------------------------------------------
+     * Find local maxima above `threshold` with at least `min_prominence`,
+     * excluding the DC and Nyquist bins. Up to `max_peaks` peaks are written
+     * to `peaks`, in descending order of magnitude; returns the number found.
+     *
+     * If `interpolate` is true, peak positions are refined by fitting a
+     * parabola to the log magnitudes of each peak and its neighbours.
+     *
+     *------------------------------------------------------------------------*/
+    int find_peaks(const sample *magnitudes,
+                   float threshold,
+                   float min_prominence,
+                   SpectralPeak *peaks,
+                   int max_peaks,
+                   bool interpolate = true);
+
+    /**------------------------------------------------------------------------
+     * Magnitude-weighted mean bin index. Returns 0 for a silent frame.
+     *
+     *------------------------------------------------------------------------*/
+    float centroid(const sample *magnitudes);
+
+    /**------------------------------------------------------------------------
+     * Sum of the increases in magnitude since `previous`, ignoring decreases.
+     *
+     *------------------------------------------------------------------------*/
+    float flux(const sample *magnitudes, const sample *previous);
+
+    /**------------------------------------------------------------------------
+     * Lowest bin index below which `proportion` of the frame's energy lies.
+     *
+     *------------------------------------------------------------------------*/
+    float rolloff(const sample *magnitudes, float proportion);
+
+    /**------------------------------------------------------------------------
+     * Ratio of the geometric mean to the arithmetic mean of the power
+     * spectrum: close to 1 for noise, close to 0 for a pure tone.
+     *
+     *------------------------------------------------------------------------*/
+    float flatness(const sample *magnitudes);
+
+    /**------------------------------------------------------------------------
+     * Smooth magnitudes across bins with a zero-phase one-pole filter
+     * (a forward then a backward pass), with coefficient `smoothing`.
+     * `out` may be the same as `magnitudes`.
+     *
+     *------------------------------------------------------------------------*/
+    void smooth(const sample *magnitudes, sample *out, float smoothing);
+
+private:
+    int num_bins;
+    std::vector<sample> scratch;
+    std::vector<sample> right_bases;
+    std::vector<sample> stack_minima;
+    std::vector<int> stack;
+    std::vector<unsigned char> candidates;
+    std::vector<SpectralPeak> all_peaks;
+};
+
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "signalflow/node/fft/fftnode.h"
+#include "signalflow/node/fft/spectral-statistics.h"
+
+#include <vector>
 
 namespace signalflow
 {
@@ -15,7 +18,8 @@ public:
     NodeRef smoothing = nullptr;
 
 private:
-    float mags_smoothed[SIGNALFLOW_MAX_FFT_SIZE / 2];
+    SpectralStatistics statistics;
+    std::vector<sample> mags_smoothed;
 };
 
 REGISTER(FFTTonality, "fft-tonality")
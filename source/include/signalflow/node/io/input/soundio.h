@@ -4,6 +4,7 @@
 
 #define AudioIn AudioIn_SoundIO
 
+#include <atomic>
 #include <soundio/soundio.h>
 #include <vector>
 
@@ -32,6 +33,11 @@ public:
     Buffer *buffer;
     int read_pos;
     int write_pos;
+
+    /*------------------------------------------------------------------------
+     * Set while the audio thread is inside the read callback.
+     *-----------------------------------------------------------------------*/
+    std::atomic<bool> is_processing;
 };
 
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+
+#include <atomic>
+#include <vector>
+
+/*------------------------------------------------------------------------
+ * Default capacity of a StreamInput's queue, in frames.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_STREAM_INPUT_DEFAULT_CAPACITY 65536
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Outputs audio that is pushed to it from outside the graph, for example
+ * from NumPy arrays in Python.
+ *
+ * Frames are queued with write() and consumed as the node is rendered.
+ * The queue is a single-producer, single-consumer ring buffer, so one
+ * thread may write while another renders, without locking. If not enough
+ * frames are queued when the node is rendered, the remainder of the block
+ * is filled with silence, and the underrun is counted.
+ *
+ * Sending the reset trigger discards any queued frames.
+ *--------------------------------------------------------------------------------*/
+class StreamInput : public Node
+{
+public:
+    StreamInput(int num_channels = 1, int capacity = SIGNALFLOW_STREAM_INPUT_DEFAULT_CAPACITY);
+
+    /**--------------------------------------------------------------------------------
+     * Queue `num_frames` frames of planar audio, with channel `c` starting at
+     * `data + c * num_frames`. If `num_channels` is less than the node's
+     * channel count, channels are repeated.
+     *
+     * @return The number of frames queued, which is less than `num_frames`
+     *         if the queue does not have enough space.
+     *--------------------------------------------------------------------------------*/
+    int write(const sample *data, int num_channels, int num_frames);
+
+    /**--------------------------------------------------------------------------------
+     * Returns the number of frames queued and not yet rendered.
+     *--------------------------------------------------------------------------------*/
+    int get_num_frames_queued();
+
+    /**--------------------------------------------------------------------------------
+     * Returns the number of frames that can be written without overflowing.
+     *--------------------------------------------------------------------------------*/
+    int get_num_frames_free();
+
+    int get_capacity();
+    int get_num_underruns();
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
+
+private:
+    std::vector<sample> data;
+    int capacity;
+    int mask;
+
+    /*------------------------------------------------------------------------
+     * Running totals of frames written and read. Each is only modified by
+     * one side of the queue.
+     *-----------------------------------------------------------------------*/
+    std::atomic<long> frames_written;
+    std::atomic<long> frames_read;
+
+    /*------------------------------------------------------------------------
+     * Set by the reset trigger to the value of frames_written at the time,
+     * and consumed by process(), or -1 if no reset is pending.
+     *-----------------------------------------------------------------------*/
+    std::atomic<long> reset_position;
+    std::atomic<int> num_underruns;
+};
+
+REGISTER(StreamInput, "stream-input")
+}
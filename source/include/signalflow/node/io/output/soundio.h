@@ -4,6 +4,7 @@
 
 #define AudioOut AudioOut_SoundIO
 
+#include <atomic>
 #include <soundio/soundio.h>
 #include <vector>
 
@@ -31,6 +32,11 @@ public:
     struct SoundIoDevice *device;
     struct SoundIoOutStream *outstream;
 
+    /*------------------------------------------------------------------------
+     * Set while the audio thread is inside the write callback.
+     *-----------------------------------------------------------------------*/
+    std::atomic<bool> is_processing;
+
 private:
     std::string device_name;
 };
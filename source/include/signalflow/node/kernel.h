@@ -0,0 +1,194 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file kernel.h
+ * @brief Node kernels separate a node's per-sample maths from the loops that
+ *        drive it, so that the loops can be specialised at compile time.
+ *
+ * A kernel is a class that declares its per-sample maths once:
+ *
+ *   class MultiplyKernel : public NodeKernel
+ *   {
+ *   public:
+ *       inline sample process(sample a, sample b) { return a * b; }
+ *   };
+ *
+ * Kernels that carry per-channel state (phase, filter history) also override
+ * begin_channel(), to load the state for a channel into member variables, and
+ * end_channel(), to store it back. Values that are invariant over a block,
+ * such as the sample rate and anything derived from it, should be computed
+ * once when the kernel is constructed, rather than per sample.
+ *
+ * signalflow_process_kernel() then selects a loop specialised for:
+ *
+ *  - the kind of each input: audio-rate inputs are read per sample, whereas
+ *    Constant inputs are read once per channel per block
+ *  - the channel count: 1, 2 and 8 channels have a fixed loop bound, with
+ *    other counts handled by a generic loop
+ *
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/node/node.h"
+
+#include <type_traits>
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Base class for kernels, with no per-channel state.
+ *--------------------------------------------------------------------------------*/
+class NodeKernel
+{
+public:
+    inline void begin_channel(int channel) {}
+    inline void end_channel(int channel) {}
+};
+
+/**--------------------------------------------------------------------------------
+ * Base class for oscillator kernels, which keep a phase per channel.
+ * The phase of the current channel is held in `phase`, and the phase increment
+ * for a frequency is frequency / sample_rate.
+ *
+ * To render a block at control rate (see Node::process_control), construct the
+ * kernel with a sample rate of sample_rate / num_frames and process a single
+ * frame: the phase then advances by the duration of the whole block.
+ *--------------------------------------------------------------------------------*/
+class OscillatorKernel : public NodeKernel
+{
+public:
+    OscillatorKernel(float *phases, float sample_rate)
+        : phases(phases), sample_rate(sample_rate) {}
+
+    inline void begin_channel(int channel) { this->phase = this->phases[channel]; }
+    inline void end_channel(int channel) { this->phases[channel] = this->phase; }
+
+protected:
+    float *phases;
+    float sample_rate;
+    float phase = 0.0;
+};
+
+/**--------------------------------------------------------------------------------
+ * An input whose value may change every sample.
+ *--------------------------------------------------------------------------------*/
+class AudioRateInput
+{
+public:
+    AudioRateInput(Node *node, int channel)
+        : data(node->out[channel]) {}
+
+    inline sample operator[](int frame) const { return this->data[frame]; }
+
+private:
+    const sample *data;
+};
+
+/**--------------------------------------------------------------------------------
+ * An input whose value is fixed for the duration of the block.
+ *--------------------------------------------------------------------------------*/
+class ConstantInput
+{
+public:
+    ConstantInput(Node *node, int channel)
+        : value(node->out[channel][0]) {}
+
+    inline sample operator[](int frame) const { return this->value; }
+
+private:
+    sample value;
+};
+
+template <int NumChannels, typename Kernel>
+class NodeKernelLoop
+{
+public:
+    template <typename... Inputs, typename... Nodes>
+    static void process(Kernel &kernel, Buffer &out, int num_channels, int num_frames, Nodes... nodes)
+    {
+        /*--------------------------------------------------------------------------------
+         * NumChannels == 0 denotes a channel count that is only known at run time.
+         *--------------------------------------------------------------------------------*/
+        const int channels = NumChannels ? NumChannels : num_channels;
+        for (int channel = 0; channel < channels; channel++)
+        {
+            process_channel(kernel, out[channel], channel, num_frames, Inputs(nodes, channel)...);
+        }
+    }
+
+private:
+    template <typename... Inputs>
+    static inline void process_channel(Kernel &kernel, sample *out, int channel, int num_frames, Inputs... inputs)
+    {
+        kernel.begin_channel(channel);
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] = kernel.process(inputs[frame]...);
+        }
+        kernel.end_channel(channel);
+    }
+};
+
+template <typename Kernel, typename... Inputs>
+class NodeKernelDispatch
+{
+public:
+    /*--------------------------------------------------------------------------------
+     * Every input's kind has been resolved: select the loop for the channel count.
+     *--------------------------------------------------------------------------------*/
+    template <typename... Nodes>
+    static typename std::enable_if<(sizeof...(Inputs) == sizeof...(Nodes))>::type
+    process(Kernel &kernel, Buffer &out, int num_channels, int num_frames, Nodes... nodes)
+    {
+        switch (num_channels)
+        {
+            case 1:
+                NodeKernelLoop<1, Kernel>::template process<Inputs...>(kernel, out, num_channels, num_frames, nodes...);
+                break;
+            case 2:
+                NodeKernelLoop<2, Kernel>::template process<Inputs...>(kernel, out, num_channels, num_frames, nodes...);
+                break;
+            case 8:
+                NodeKernelLoop<8, Kernel>::template process<Inputs...>(kernel, out, num_channels, num_frames, nodes...);
+                break;
+            default:
+                NodeKernelLoop<0, Kernel>::template process<Inputs...>(kernel, out, num_channels, num_frames, nodes...);
+                break;
+        }
+    }
+
+    /*--------------------------------------------------------------------------------
+     * Resolve the kind of the next input, and rotate it to the end of the
+     * argument list, so that once all inputs are resolved, they are back in
+     * their original order.
+     *--------------------------------------------------------------------------------*/
+    template <typename... Nodes>
+    static typename std::enable_if<(sizeof...(Inputs) <= sizeof...(Nodes))>::type
+    process(Kernel &kernel, Buffer &out, int num_channels, int num_frames, Node *next, Nodes... rest)
+    {
+        if (next->is_constant)
+        {
+            NodeKernelDispatch<Kernel, Inputs..., ConstantInput>::process(kernel, out, num_channels, num_frames, rest..., next);
+        }
+        else
+        {
+            NodeKernelDispatch<Kernel, Inputs..., AudioRateInput>::process(kernel, out, num_channels, num_frames, rest..., next);
+        }
+    }
+};
+
+/**--------------------------------------------------------------------------------
+ * Process `num_frames` frames of `num_channels` channels of `out` by applying
+ * `kernel` to each frame of `inputs`, which are passed to kernel.process()
+ * in the order given.
+ *
+ * Every input must have at least `num_channels` channels allocated, which is
+ * the case for any input of a Node with matching input/output channel counts.
+ *--------------------------------------------------------------------------------*/
+template <typename Kernel, typename... Inputs>
+inline void signalflow_process_kernel(Kernel &kernel, Buffer &out, int num_channels, int num_frames, const Inputs &...inputs)
+{
+    NodeKernelDispatch<Kernel>::process(kernel, out, num_channels, num_frames, inputs.get()...);
+}
+
+}
@@ -30,6 +30,19 @@ typedef enum
     SIGNALFLOW_NODE_STATE_STOPPED
 } signalflow_node_state_t;
 
+typedef enum
+{
+    /*------------------------------------------------------------------------
+     * The input may be read at any frame of the block.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_INPUT_RATE_AUDIO,
+
+    /*------------------------------------------------------------------------
+     * Only the first frame of each block is read from the input.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_INPUT_RATE_CONTROL
+} signalflow_input_rate_t;
+
 /*------------------------------------------------------------------------
  * Allows us to use a float (or direct node ptr) in place of a NodeRef
  * by specifying conversion constructors.
@@ -41,7 +54,7 @@ public:
     NodeRefTemplate()
         : std::shared_ptr<T>(nullptr) {}
     NodeRefTemplate(T *ptr)
-        : std::shared_ptr<T>(ptr) {}
+        : std::shared_ptr<T>(ptr ? std::shared_ptr<T>(ptr, NodeRefTemplate::destroy) : std::shared_ptr<T>()) {}
     NodeRefTemplate(double x);
     NodeRefTemplate(int x);
     NodeRefTemplate(std::initializer_list<NodeRefTemplate> x);
@@ -59,6 +72,21 @@ public:
     sample operator[](int index);
 
     NodeRefTemplate scale(float from, float to, signalflow_scale_t scale = SIGNALFLOW_SCALE_LIN_LIN);
+
+private:
+    /*------------------------------------------------------------------------
+     * Remove a node from its inputs' lists of outputs before it is deleted,
+     * while the subclass members that hold its inputs still exist, so that
+     * no input is left with a dangling output.
+     *-----------------------------------------------------------------------*/
+    static void destroy(T *node)
+    {
+        if (node)
+        {
+            node->detach_from_inputs();
+            delete node;
+        }
+    }
 };
 
 typedef NodeRefTemplate<Node> NodeRef;
@@ -105,6 +133,30 @@ public:
      * to modulate the destination node.
      *-----------------------------------------------------------------------*/
     virtual NodeRef get_input(std::string name);
+
+    /*------------------------------------------------------------------------
+     * Get/set inputs by slot index (see input_slots), without looking up
+     * their names. The input must already exist, so the subclass overrides
+     * of set_input() that create missing inputs are not needed.
+     *
+     * set_input(int) is not virtual, and is called by set_input(std::string)
+     * once the input has been found or created. Subclasses that need to
+     * respond to an input changing override input_changed() instead.
+     *-----------------------------------------------------------------------*/
+    NodeRef get_input(int index);
+    void set_input(int index, const NodeRef &input);
+
+    /*------------------------------------------------------------------------
+     * Returns the slot index of the named input, or -1 if there is none.
+     *-----------------------------------------------------------------------*/
+    int get_input_index(const std::string &name);
+
+    /*------------------------------------------------------------------------
+     * Get the rate at which the named input, or the input at the given
+     * slot index, is read.
+     *-----------------------------------------------------------------------*/
+    signalflow_input_rate_t get_input_rate(const std::string &name);
+    signalflow_input_rate_t get_input_rate(int index);
     virtual void set_input(std::string name, const NodeRef &input);
     virtual void set_input(std::string name, float value);
 
@@ -120,12 +172,13 @@ public:
     virtual void remove_input(NodeRef input);
 
     /*------------------------------------------------------------------------
-     * Register an output. Should be called in the Node's constructor.
+     * Register an output, identified by the target node and the slot index
+     * of its input. Should be called in the Node's constructor.
      * Note that this must be mirrored with a call to `set_input` on the
      * output node.
      *-----------------------------------------------------------------------*/
-    virtual void add_output(Node *target, std::string name);
-    virtual void remove_output(Node *target, std::string name);
+    virtual void add_output(Node *target, int index);
+    virtual void remove_output(Node *target, int index);
 
     /**------------------------------------------------------------------------
      * Disconnect inputs. Called when removing a node from the graph.
@@ -188,7 +241,12 @@ public:
     virtual void set_buffer(std::string name, BufferRef buffer);
 
     /*------------------------------------------------------------------------
-     * Generic trigger method. 
+     * Generic trigger method.
+     *
+     * Every node accepts the SIGNALFLOW_TRIGGER_RESET trigger, which clears
+     * its output history so that downstream trigger detection starts afresh.
+     * Nodes with internal state (oscillators, envelopes) additionally return
+     * that state to its initial values.
      *-----------------------------------------------------------------------*/
     virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER,
                          float value = 1);
@@ -203,6 +261,25 @@ public:
      *-----------------------------------------------------------------------*/
     int get_output_buffer_length();
 
+    /*------------------------------------------------------------------------
+     * Query whether the node's most recent output block was entirely silent.
+     *-----------------------------------------------------------------------*/
+    bool get_is_silent();
+
+    /*------------------------------------------------------------------------
+     * Query whether the node's most recent output block was rendered at
+     * control rate. See supports_control_rate.
+     *-----------------------------------------------------------------------*/
+    bool get_is_control_rate();
+
+    /*------------------------------------------------------------------------
+     * Get the number of denormal samples that this node has output.
+     * Only counted in debug builds (with DEBUG defined); otherwise, always 0.
+     * Denormals are normally flushed to zero during rendering, so this is
+     * most useful with AudioGraphConfig::set_flush_denormals(false).
+     *-----------------------------------------------------------------------*/
+    unsigned long get_denormal_count();
+
     /*------------------------------------------------------------------------
      * Get the Patch that this node is part of.
      *-----------------------------------------------------------------------*/
@@ -219,26 +296,39 @@ public:
     std::string name;
 
     /*------------------------------------------------------------------------
-     * Hash table of parameters: (name, pointer to NodeRef)
-     * Must be a pointer, rather than the NodeRef itself, as the actual
+     * Set by Constant, so that nodes can tell that an input holds a fixed
+     * value without comparing its name.
+     *-----------------------------------------------------------------------*/
+    bool is_constant;
+
+    /*------------------------------------------------------------------------
+     * Input slots: pointers to the NodeRefs that hold the node's inputs,
+     * in the order in which the inputs were created.
+     * Must be pointers, rather than the NodeRefs themselves, as the actual
      * storage for the pointer is held directly in the node's named
-     * parameter field (e.g. node->frequency, node->pan). The inputs
-     * dict is a lookup table which stores pointers to the fields, so that
-     * they can be populated when the node is instantiated, such as from
-     * a graph of NodeDefs.
+     * parameter field (e.g. node->frequency, node->pan), so that the fields
+     * can be populated when the node is instantiated, such as from a graph
+     * of NodeDefs.
+     *
+     * Graph traversal iterates over the slots directly. input_names holds
+     * the name of each slot, and input_indices maps each name to its slot,
+     * for looking inputs up by name. A slot's index only changes if an
+     * earlier input is destroyed.
      *-----------------------------------------------------------------------*/
-    std::unordered_map<std::string, NodeRef *> inputs;
+    std::vector<NodeRef *> input_slots;
+    std::vector<std::string> input_names;
+    std::unordered_map<std::string, int> input_indices;
 
     /*------------------------------------------------------------------------
      * Set of outputs.
      * Each output is a std::pair containing 
      *  - a reference to the Node connected outwards to
-     *  - a string containing the name of the parameter that this node
+     *  - the slot index (see input_slots) of the parameter that this node
      *    modulates.
      * Note that a node may modulate two different parameters of the same
      * node.
      *-----------------------------------------------------------------------*/
-    std::set<std::pair<Node *, std::string>> outputs;
+    std::set<std::pair<Node *, int>> outputs;
 
     /*------------------------------------------------------------------------
      * Hash table of properties: (name, PropertyRef *)
@@ -320,22 +410,48 @@ protected:
      *-----------------------------------------------------------------------*/
     virtual void resize_output_buffers(int output_buffer_count);
 
+    /*------------------------------------------------------------------------
+     * Ensure that every input has at least num_channels output buffers
+     * allocated, so that it can be upmixed to num_channels.
+     *-----------------------------------------------------------------------*/
+    virtual void resize_input_buffers(int num_channels);
+
     /*------------------------------------------------------------------------
      * Allocate memory for other dynamic node storage.
      *-----------------------------------------------------------------------*/
     virtual void alloc();
     virtual void free();
 
+    /*------------------------------------------------------------------------
+     * Render a single frame representing the whole of a `num_frames` block,
+     * advancing any internal state (such as phase) by `num_frames` frames.
+     * The AudioGraph then holds this value across the rest of the block.
+     *
+     * The default implementation processes a single frame, which is correct
+     * for any node whose output depends only on its current inputs.
+     *-----------------------------------------------------------------------*/
+    virtual void process_control(Buffer &out, int num_frames);
+
     /*------------------------------------------------------------------------
      * Set node run state.
      *-----------------------------------------------------------------------*/
     virtual void set_state(signalflow_node_state_t state);
 
+    /*------------------------------------------------------------------------
+     * For nodes with a finite lifetime, called at the end of process().
+     * Sets is_silent if the node is stopped and its output block is zero.
+     *-----------------------------------------------------------------------*/
+    void set_silent_if_stopped(Buffer &out, int num_frames);
+
     /*------------------------------------------------------------------------
      * Creates a new named input.
      * Should only ever be used in the class constructor.
+     *
+     * Inputs that are only read at the first frame of each block should be
+     * created with SIGNALFLOW_INPUT_RATE_CONTROL, which allows the nodes that
+     * feed them to be rendered at control rate.
      *-----------------------------------------------------------------------*/
-    virtual void create_input(std::string name, NodeRef &input);
+    virtual void create_input(std::string name, NodeRef &input, signalflow_input_rate_t rate = SIGNALFLOW_INPUT_RATE_AUDIO);
 
     /*------------------------------------------------------------------------
      * Removing an input is only done by special classes
@@ -358,6 +474,27 @@ protected:
      *-----------------------------------------------------------------------*/
     virtual void set_patch(Patch *patch);
 
+    /*------------------------------------------------------------------------
+     * Called by set_input() after the input at `index` has been set.
+     * `previous` is the node that it replaced, which may be null.
+     *-----------------------------------------------------------------------*/
+    virtual void input_changed(int index, const NodeRef &previous);
+
+    /*------------------------------------------------------------------------
+     * Called by prepare_input(), before the input at `index` is set to
+     * `input` on the audio thread. Subclasses whose input_changed()
+     * allocates should do that work here, so that it can be skipped when
+     * the input is applied.
+     *-----------------------------------------------------------------------*/
+    virtual void input_changing(int index, const NodeRef &input);
+
+    /*------------------------------------------------------------------------
+     * If skips_inputs is set, called by the AudioGraph before rendering the
+     * input at `index`. Returns true if process() will not read the input
+     * in this block, so that it need not be rendered.
+     *-----------------------------------------------------------------------*/
+    virtual bool skip_input(int index);
+
     /*------------------------------------------------------------------------
      * Output buffer length, in samples.
      *-----------------------------------------------------------------------*/
@@ -395,6 +532,55 @@ protected:
      *-----------------------------------------------------------------------*/
     bool has_variable_inputs;
 
+    /*------------------------------------------------------------------------
+     * Flag indicating that every channel of the node's most recent output
+     * block is zero. Cleared before each call to process(); nodes that can
+     * cheaply determine that their output is silent (for example, a stopped
+     * envelope) set it during process().
+     *-----------------------------------------------------------------------*/
+    bool is_silent;
+
+    /*------------------------------------------------------------------------
+     * If set, the node's output is silent whenever any one of its inputs is
+     * silent (e.g. Multiply). The AudioGraph then stops rendering the node's
+     * inputs as soon as a silent input is found, skipping the remaining
+     * subgraphs entirely, and fills the node's output with zeros.
+     *-----------------------------------------------------------------------*/
+    bool silent_if_any_input_silent;
+
+    /*------------------------------------------------------------------------
+     * If set, the AudioGraph calls skip_input() before rendering each of
+     * the node's inputs, and skips the subgraph of any input that is not
+     * needed in the current block (e.g. the idle voices of a
+     * VoiceAllocator).
+     *-----------------------------------------------------------------------*/
+    bool skips_inputs;
+
+    /*------------------------------------------------------------------------
+     * If set, the node implements process_control(). When every node that
+     * the node's output feeds reads it at control rate (or is itself
+     * rendered at control rate), the AudioGraph renders the node once per
+     * block with process_control(), rather than every frame.
+     *
+     * Envelopes do not support control rate, as they respond to triggers
+     * on any frame of their clock input, which would be missed.
+     *-----------------------------------------------------------------------*/
+    bool supports_control_rate;
+
+    /*------------------------------------------------------------------------
+     * If set (the default), the node only writes the frames it is asked to
+     * render, from the start of its output pointers. The AudioGraph can
+     * then render a block in sub-blocks by advancing the pointers (for
+     * scheduled events and short feedback loops). FFT nodes use their whole
+     * output buffer, and so a block is not divided while any are rendered.
+     *-----------------------------------------------------------------------*/
+    bool supports_sub_blocks;
+
+    /*------------------------------------------------------------------------
+     * The rate at which each input is read, indexed by slot.
+     *-----------------------------------------------------------------------*/
+    std::vector<signalflow_input_rate_t> input_rates;
+
     /*------------------------------------------------------------------------
      * Number of actual in/out channels. This should always reflect
      * the number of audio channels in use.
@@ -419,16 +605,76 @@ private:
      *-----------------------------------------------------------------------*/
     virtual void _process(Buffer &out, int num_frames);
 
+    /*------------------------------------------------------------------------
+     * Called by AudioGraph in place of _process() when the node's output
+     * is known to be silent. Fills the output with zeros.
+     *-----------------------------------------------------------------------*/
+    void _process_silence(Buffer &out, int num_frames);
+
+    /*------------------------------------------------------------------------
+     * Called by AudioGraph in place of _process() when the node is rendered
+     * at control rate. Calls process_control() and holds its output across
+     * the block.
+     *-----------------------------------------------------------------------*/
+    void _process_control(Buffer &out, int num_frames);
+
+    /*------------------------------------------------------------------------
+     * Whether the node is rendered at control rate, and the AudioGraph
+     * block for which this was last resolved.
+     *-----------------------------------------------------------------------*/
+    bool is_control_rate;
+    long control_rate_block;
+
+    /*------------------------------------------------------------------------
+     * The number of frames by which the AudioGraph has advanced the output
+     * pointers, while rendering a block in sub-blocks.
+     *-----------------------------------------------------------------------*/
+    int block_offset;
+
+    /*------------------------------------------------------------------------
+     * The AudioGraph sub_block_check for which this node was last visited.
+     *-----------------------------------------------------------------------*/
+    long sub_block_check;
+
+    /*------------------------------------------------------------------------
+     * In debug builds, count denormal samples in a rendered output block.
+     *-----------------------------------------------------------------------*/
+    void count_denormals(Buffer &out, int num_frames);
+    unsigned long denormal_count;
+
     /*------------------------------------------------------------------------
      * Pointer to the Patch that this node is a part of, if any.
      *-----------------------------------------------------------------------*/
     Patch *patch = nullptr;
 
+    /*------------------------------------------------------------------------
+     * Remove this node from the list of outputs of each of its inputs.
+     * Called when the last NodeRef to the node is released.
+     *-----------------------------------------------------------------------*/
+    void detach_from_inputs();
+
+    /*------------------------------------------------------------------------
+     * Set an input in two steps, so that it can be set from the audio
+     * thread without allocating, for inputs queued by Patch::queue_input().
+     *
+     * prepare_input() is called first, on the thread that queued the
+     * input. It makes the checks that setting the input would make, adds
+     * this node to the input's outputs, and calls input_changing().
+     *
+     * apply_input() then sets the input, returning the node that it
+     * replaced in `previous`. This node is left in the outputs of
+     * `previous`, for the caller to remove once it is off the audio thread.
+     *-----------------------------------------------------------------------*/
+    void prepare_input(int index, const NodeRef &input);
+    void apply_input(int index, const NodeRef &input, NodeRef &previous);
+
     /*------------------------------------------------------------------------
      * Allow friends to access private methods
      *-----------------------------------------------------------------------*/
     friend class AudioGraph;
     friend class Patch;
+    template <class T>
+    friend class NodeRefTemplate;
 };
 
 class UnaryOpNode : public Node
@@ -4,6 +4,7 @@
 #include "signalflow/node/node.h"
 
 #include <list>
+#include <vector>
 
 namespace signalflow
 {
@@ -23,6 +24,13 @@ public:
     int channels;
     bool amplitude_compensation;
     float amplitude_compensation_level;
+
+private:
+    /*------------------------------------------------------------------------
+     * Gain from each input channel to each output channel,
+     * [out_channel * num_input_channels + in_channel].
+     *-----------------------------------------------------------------------*/
+    std::vector<float> channel_amps;
 };
 
 REGISTER(ChannelMixer, "channel-mixer")
@@ -0,0 +1,300 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file expression.h
+ * @brief Elementwise expressions over a node's inputs, evaluated by a single
+ *        node.
+ *
+ * An expression is a tree of operations whose leaves are constants and
+ * numbered inputs. Its text form is a prefix expression, in which each
+ * operation is named after the node that performs it, and $n is input n:
+ *
+ *   (add (multiply $0 0.5) 0.2)
+ *
+ * computes the same output as Add(Multiply(input0, 0.5), 0.2).
+ *
+ * The supported operations are arithmetic (add, subtract, multiply, divide,
+ * pow, modulo), comparisons (equals, not-equal, greater-than, ...), abs,
+ * round, sin, cos, tan, tanh, clip, wrap, fold, if, scale-lin-lin and
+ * scale-lin-exp. Each takes its operands in the order of the node's inputs.
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define SIGNALFLOW_EXPRESSION_MAX_OPERANDS 5
+
+namespace signalflow
+{
+
+typedef enum
+{
+    SIGNALFLOW_EXPRESSION_CONSTANT,
+    SIGNALFLOW_EXPRESSION_INPUT,
+    SIGNALFLOW_EXPRESSION_ADD,
+    SIGNALFLOW_EXPRESSION_SUBTRACT,
+    SIGNALFLOW_EXPRESSION_MULTIPLY,
+    SIGNALFLOW_EXPRESSION_DIVIDE,
+    SIGNALFLOW_EXPRESSION_POW,
+    SIGNALFLOW_EXPRESSION_MODULO,
+    SIGNALFLOW_EXPRESSION_EQUAL,
+    SIGNALFLOW_EXPRESSION_NOT_EQUAL,
+    SIGNALFLOW_EXPRESSION_GREATER_THAN,
+    SIGNALFLOW_EXPRESSION_GREATER_THAN_OR_EQUAL,
+    SIGNALFLOW_EXPRESSION_LESS_THAN,
+    SIGNALFLOW_EXPRESSION_LESS_THAN_OR_EQUAL,
+    SIGNALFLOW_EXPRESSION_ABS,
+    SIGNALFLOW_EXPRESSION_ROUND,
+    SIGNALFLOW_EXPRESSION_SIN,
+    SIGNALFLOW_EXPRESSION_COS,
+    SIGNALFLOW_EXPRESSION_TAN,
+    SIGNALFLOW_EXPRESSION_TANH,
+    SIGNALFLOW_EXPRESSION_CLIP,
+    SIGNALFLOW_EXPRESSION_WRAP,
+    SIGNALFLOW_EXPRESSION_FOLD,
+    SIGNALFLOW_EXPRESSION_IF,
+    SIGNALFLOW_EXPRESSION_SCALE_LIN_LIN,
+    SIGNALFLOW_EXPRESSION_SCALE_LIN_EXP
+} signalflow_expression_op_t;
+
+/**--------------------------------------------------------------------------------
+ * A node of an expression tree: a constant, an input, or an operation
+ * applied to a list of operands.
+ *
+ * Operations whose operands are all constant are evaluated when the tree is
+ * constructed, so a tree never contains a constant subexpression.
+ *--------------------------------------------------------------------------------*/
+class ExpressionTree
+{
+public:
+    ExpressionTree(float value = 0.0);
+    ExpressionTree(signalflow_expression_op_t op, std::vector<ExpressionTree> operands);
+
+    /**------------------------------------------------------------------------
+     * Returns a tree that reads input `index`.
+     *
+     *------------------------------------------------------------------------*/
+    static ExpressionTree input(int index);
+
+    /**------------------------------------------------------------------------
+     * Parse the text form of an expression. Throws if the text is not a
+     * valid expression.
+     *
+     *------------------------------------------------------------------------*/
+    static ExpressionTree parse(std::string text);
+
+    /**------------------------------------------------------------------------
+     * Find the operation performed by the node with the given registry name
+     * (for example, "multiply"), and the names of the node's inputs that
+     * supply its operands, in order. Returns false if the node does not
+     * perform an elementwise operation.
+     *
+     *------------------------------------------------------------------------*/
+    static bool get_node_operation(std::string node_name,
+                                   signalflow_expression_op_t &op,
+                                   std::vector<std::string> &input_names);
+
+    /**------------------------------------------------------------------------
+     * Returns the registry name of the node that performs `op`.
+     *
+     *------------------------------------------------------------------------*/
+    static std::string get_op_name(signalflow_expression_op_t op);
+
+    /**------------------------------------------------------------------------
+     * Apply `op` to a single set of operand values.
+     *
+     *------------------------------------------------------------------------*/
+    static sample apply(signalflow_expression_op_t op, const sample *operands);
+
+    signalflow_expression_op_t get_op() const;
+    float get_value() const;
+    int get_input_index() const;
+    const std::vector<ExpressionTree> &get_operands() const;
+    bool is_constant() const;
+
+    /**------------------------------------------------------------------------
+     * Returns the number of operations in the tree, excluding constants and
+     * inputs.
+     *
+     *------------------------------------------------------------------------*/
+    int get_num_operations() const;
+
+    /**------------------------------------------------------------------------
+     * Returns one more than the highest input index read by the tree.
+     *
+     *------------------------------------------------------------------------*/
+    int get_num_inputs() const;
+
+    /**------------------------------------------------------------------------
+     * Returns a copy of the tree in which each input n is replaced by
+     * inputs[n]. Operations whose operands become constant are folded.
+     *
+     *------------------------------------------------------------------------*/
+    ExpressionTree substitute(const std::vector<ExpressionTree> &inputs) const;
+
+    std::string to_string() const;
+
+private:
+    signalflow_expression_op_t op;
+    float value;
+    int input_index;
+    std::vector<ExpressionTree> operands;
+};
+
+/**--------------------------------------------------------------------------------
+ * Evaluate an expression over inputs input0...inputN, in a single node.
+ *
+ * The expression is compiled to a sequence of instructions, each of which
+ * processes a whole block. Intermediate values are held in a small set of
+ * block-sized registers, rather than in the output buffers of separate
+ * nodes, so a chain of operators costs one node and one pass over each
+ * of its inputs.
+ *
+ * Expressions are usually created by fusing operator nodes with
+ * PatchSpec::optimise(), Patch::optimise() or Expression::fuse(). The
+ * expression is compiled whenever it is set, and the compiled program is
+ * picked up by the audio thread at the start of the next block.
+ *--------------------------------------------------------------------------------*/
+class Expression : public Node
+{
+public:
+    Expression(std::string expression = "0", std::vector<NodeRef> inputs = {});
+    Expression(ExpressionTree expression, std::vector<NodeRef> inputs = {});
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void set_input(std::string name, const NodeRef &node) override;
+    virtual void set_property(std::string name, const PropertyRef &value) override;
+
+    ExpressionTree get_expression();
+
+    /**------------------------------------------------------------------------
+     * Returns a single node that computes the same output as `node`, by
+     * merging `node` and the operator and Expression nodes that feed it into
+     * one Expression. An operand is merged only if `node` (or the node being
+     * merged that reads it) is its only output; otherwise it becomes an
+     * input of the Expression. Constant inputs that are not referenced
+     * elsewhere become literals.
+     *
+     * The nodes that are merged are left unchanged, and later changes to
+     * them do not affect the Expression. If `node` is not an operator or
+     * Expression node, it is returned as it is.
+     *
+     *------------------------------------------------------------------------*/
+    static NodeRef fuse(NodeRef node);
+
+protected:
+    virtual void input_changing(int index, const NodeRef &input) override;
+    virtual void input_changed(int index, const NodeRef &previous) override;
+
+private:
+    void compile(ExpressionTree tree);
+    void compile(ExpressionTree tree, const std::vector<bool> &constant_inputs);
+    void create_inputs(int num_inputs);
+
+    typedef enum
+    {
+        OPERAND_CONSTANT,
+        OPERAND_INPUT,
+
+        /*------------------------------------------------------------------------
+         * An input that is connected to a Constant node, and so is read as a
+         * single value per block.
+         *-----------------------------------------------------------------------*/
+        OPERAND_CONSTANT_INPUT,
+        OPERAND_REGISTER
+    } operand_kind_t;
+
+    class Operand
+    {
+    public:
+        operand_kind_t kind;
+        int index;
+        float value;
+    };
+
+    class Instruction
+    {
+    public:
+        signalflow_expression_op_t op;
+        int num_operands;
+        Operand operands[SIGNALFLOW_EXPRESSION_MAX_OPERANDS];
+
+        /*------------------------------------------------------------------------
+         * Register that receives the result, or -1 for the node's output.
+         *-----------------------------------------------------------------------*/
+        int destination;
+    };
+
+    /*------------------------------------------------------------------------
+     * Everything that process() reads, so that a recompiled expression can
+     * be swapped in as a whole.
+     *-----------------------------------------------------------------------*/
+    class Program
+    {
+    public:
+        ExpressionTree tree;
+        std::vector<NodeRef *> inputs;
+
+        /*------------------------------------------------------------------------
+         * Whether each input is read as a single value per block.
+         *-----------------------------------------------------------------------*/
+        std::vector<bool> constant_inputs;
+        std::vector<Instruction> instructions;
+        int num_registers = 0;
+        int length = 0;
+        std::vector<sample> registers;
+
+        /*------------------------------------------------------------------------
+         * Per-operand blocks for broadcasting constant operands of operations
+         * that take more than two operands.
+         *-----------------------------------------------------------------------*/
+        std::vector<sample> broadcasts;
+    };
+
+    Operand compile_operand(Program &program, const ExpressionTree &tree, int depth);
+    bool can_run(const Program &program);
+
+    static bool merge(const NodeRef &node, std::vector<NodeRef> &leaves, ExpressionTree &tree, bool is_root);
+    static ExpressionTree merge_operand(const NodeRef &node, std::vector<NodeRef> &leaves);
+    static ExpressionTree merge_leaf(const NodeRef &node, std::vector<NodeRef> &leaves);
+
+    PropertyRef expression;
+    ExpressionTree tree;
+
+    /*------------------------------------------------------------------------
+     * The constant_inputs of the last program compiled, which may be ahead
+     * of the inputs while a queued input is waiting to be set.
+     *-----------------------------------------------------------------------*/
+    std::vector<bool> constant_inputs;
+
+    /*------------------------------------------------------------------------
+     * Inputs are held in a list, so that the NodeRefs registered with
+     * create_input() do not move as inputs are added.
+     *-----------------------------------------------------------------------*/
+    std::list<NodeRef> input_list;
+    std::vector<NodeRef *> input_refs;
+
+    /*------------------------------------------------------------------------
+     * The program being run, and the next program to run. A new program is
+     * written to next_program under program_mutex. When program_changed is
+     * set, the audio thread swaps it in if it can take the lock without
+     * waiting and the inputs that it reads as constants are now Constants,
+     * leaving the old program in next_program to be freed by the next call
+     * to compile().
+     *-----------------------------------------------------------------------*/
+    std::unique_ptr<Program> program;
+    std::unique_ptr<Program> next_program;
+    std::atomic<bool> program_changed;
+    std::mutex program_mutex;
+};
+
+REGISTER(Expression, "expression")
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace signalflow
+{
+
+typedef enum
+{
+    /*------------------------------------------------------------------------
+     * All gains are zero. Set gains with set_gain(), set_gains() or set_pan().
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_MIXER_PRESET_NONE,
+
+    /*------------------------------------------------------------------------
+     * Each input channel is routed to the output channel with the same
+     * index, if there is one.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_MIXER_PRESET_IDENTITY,
+
+    /*------------------------------------------------------------------------
+     * Input channels are spread evenly across the output channels, each
+     * panned with equal power between its two nearest outputs.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_MIXER_PRESET_SPREAD,
+
+    /*------------------------------------------------------------------------
+     * Stereo downmix of 5.1 (L, R, C, LFE, Ls, Rs) or 7.1 (L, R, C, LFE, Ls,
+     * Rs, Lb, Rb) input, following ITU-R BS.775: centre and surround
+     * channels are mixed in at -3dB, and LFE is discarded.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1,
+    SIGNALFLOW_MIXER_PRESET_DOWNMIX_7_1
+} signalflow_mixer_preset_t;
+
+/**--------------------------------------------------------------------------------
+ * Mix `input` to `channels` output channels through a matrix of gains,
+ * initialised from `preset`.
+ *
+ * Only non-zero gains are processed, so that sparse routings (such as
+ * panning many sources across a large speaker array) cost in proportion to
+ * the number of active routes rather than the size of the matrix. Gain
+ * changes are ramped linearly over `smoothing_time` seconds.
+ *
+ * Gains may be changed from any thread: each change is applied to the
+ * matrix as a whole, and the new matrix is picked up at the start of the
+ * next block.
+ *--------------------------------------------------------------------------------*/
+class MatrixMixer : public UnaryOpNode
+{
+public:
+    MatrixMixer(int channels = 2,
+                NodeRef input = 0,
+                signalflow_mixer_preset_t preset = SIGNALFLOW_MIXER_PRESET_SPREAD,
+                float smoothing_time = 0.02);
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void update_channels() override;
+
+    /**------------------------------------------------------------------------
+     * Set the gain from one input channel to one output channel.
+     *
+     *------------------------------------------------------------------------*/
+    void set_gain(int input_channel, int output_channel, float gain);
+    float get_gain(int input_channel, int output_channel);
+
+    /**------------------------------------------------------------------------
+     * Set the whole matrix, as a list of rows, one per output channel,
+     * each with one gain per input channel.
+     *
+     *------------------------------------------------------------------------*/
+    void set_gains(std::vector<std::vector<float>> gains);
+    std::vector<std::vector<float>> get_gains();
+
+    /**------------------------------------------------------------------------
+     * Route one input channel to the output channels with equal-power
+     * panning, replacing its existing gains. -1 is the first output channel,
+     * and 1 the last.
+     *
+     *------------------------------------------------------------------------*/
+    void set_pan(int input_channel, float pan);
+
+    /**------------------------------------------------------------------------
+     * Replace all gains with those of the given preset.
+     *
+     *------------------------------------------------------------------------*/
+    void set_preset(signalflow_mixer_preset_t preset);
+
+    /**------------------------------------------------------------------------
+     * Returns the number of non-zero routes currently being processed.
+     *
+     *------------------------------------------------------------------------*/
+    int get_num_routes();
+
+private:
+    void check_channels(int input_channel, int output_channel);
+    void apply_preset(signalflow_mixer_preset_t preset);
+    void update_routes();
+
+    class Route
+    {
+    public:
+        int input_channel;
+        int output_channel;
+        float gain;
+        float target;
+        float step;
+        int steps_remaining;
+    };
+
+    int channels;
+    signalflow_mixer_preset_t preset;
+    float smoothing_time;
+
+    /*------------------------------------------------------------------------
+     * Target gains, [output_channel][input_channel], written under
+     * gains_mutex. When gains_changed is set, the audio thread copies them
+     * into active_gains if it can take the lock without waiting, and
+     * rebuilds the routes from active_gains. active_gains and the routes
+     * are only accessed by the audio thread, which resizes them itself when
+     * the number of channels changes.
+     *-----------------------------------------------------------------------*/
+    std::vector<std::vector<float>> gains;
+    std::vector<std::vector<float>> active_gains;
+    std::atomic<bool> gains_changed;
+    std::mutex gains_mutex;
+
+    /*------------------------------------------------------------------------
+     * Active routes, ordered by output channel. Capacity for every entry
+     * in the matrix is reserved, so that rebuilding does not allocate
+     * unless the matrix has grown.
+     *-----------------------------------------------------------------------*/
+    std::vector<Route> routes;
+    std::vector<Route> next_routes;
+};
+
+REGISTER(MatrixMixer, "matrix-mixer")
+
+}
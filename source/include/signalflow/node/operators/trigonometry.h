@@ -6,6 +6,33 @@
 namespace signalflow
 {
 
+class Sin : public UnaryOpNode
+{
+
+public:
+    Sin(NodeRef a = 0);
+
+    virtual void process(Buffer &out, int num_frames) override;
+};
+
+class Cos : public UnaryOpNode
+{
+
+public:
+    Cos(NodeRef a = 0);
+
+    virtual void process(Buffer &out, int num_frames) override;
+};
+
+class Tan : public UnaryOpNode
+{
+
+public:
+    Tan(NodeRef a = 0);
+
+    virtual void process(Buffer &out, int num_frames) override;
+};
+
 class Tanh : public UnaryOpNode
 {
 
@@ -15,6 +42,9 @@ public:
     virtual void process(Buffer &out, int num_frames) override;
 };
 
+REGISTER(Sin, "sin")
+REGISTER(Cos, "cos")
+REGISTER(Tan, "tan")
 REGISTER(Tanh, "tanh")
 
 }
@@ -0,0 +1,57 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file polyblep.h
+ * @brief Polynomial bandlimited step (polyBLEP) and ramp (polyBLAMP) residuals,
+ *        used to suppress aliasing at the discontinuities of classic waveforms.
+ *
+ * Both take the phase `t` in [0, 1) relative to the discontinuity, and the
+ * per-sample phase increment `dt`. The correction is non-zero only within one
+ * sample either side of the discontinuity.
+ *
+ * Source: Välimäki et al., "Perceptually informed synthesis of bandlimited
+ *         classical waveforms using integrated polynomial interpolation" (2012)
+ *--------------------------------------------------------------------------------*/
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Residual of a step of height 2 (from -1 to +1). Add it to a waveform with a
+ * rising step at t = 0, or subtract it for a falling step.
+ *--------------------------------------------------------------------------------*/
+inline float signalflow_poly_blep(float t, float dt)
+{
+    if (t < dt)
+    {
+        t = t / dt;
+        return t + t - t * t - 1.0f;
+    }
+    else if (t > 1.0f - dt)
+    {
+        t = (t - 1.0f) / dt;
+        return t * t + t + t + 1.0f;
+    }
+    return 0.0f;
+}
+
+/**--------------------------------------------------------------------------------
+ * Residual of a unit change in slope (per sample) at t = 0. Multiply by the
+ * change in slope per sample of the waveform's corner.
+ *--------------------------------------------------------------------------------*/
+inline float signalflow_poly_blamp(float t, float dt)
+{
+    if (t < dt)
+    {
+        t = 1.0f - t / dt;
+        return t * t * t / 6.0f;
+    }
+    else if (t > 1.0f - dt)
+    {
+        t = 1.0f + (t - 1.0f) / dt;
+        return t * t * t / 6.0f;
+    }
+    return 0.0f;
+}
+
+}
@@ -11,6 +11,7 @@ public:
 
     virtual void alloc() override;
     virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
 
     NodeRef frequency;
 
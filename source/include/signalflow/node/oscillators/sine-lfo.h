@@ -9,6 +9,7 @@ class SineLFO : public LFO
 public:
     SineLFO(NodeRef frequency = 1.0, NodeRef min = 0.0, NodeRef max = 1.0);
     virtual void process(Buffer &out, int num_frames) override;
+    virtual void process_control(Buffer &out, int num_frames) override;
 };
 
 REGISTER(SineLFO, "sine-lfo")
@@ -10,6 +10,8 @@ public:
     SineOscillator(NodeRef frequency = 440);
 
     virtual void process(Buffer &out, int num_frames) override;
+    virtual void process_control(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
     virtual void alloc() override;
 
     NodeRef frequency;
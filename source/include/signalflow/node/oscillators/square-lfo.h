@@ -9,6 +9,7 @@ class SquareLFO : public LFO
 public:
     SquareLFO(NodeRef frequency = 1.0, NodeRef min = 0.0, NodeRef max = 1.0, NodeRef width = 0.5);
     virtual void process(Buffer &out, int num_frames) override;
+    virtual void process_control(Buffer &out, int num_frames) override;
 
 protected:
     NodeRef width;
@@ -2,6 +2,7 @@
 
 #include "signalflow/buffer/buffer.h"
 #include "signalflow/buffer/buffer2d.h"
+#include "signalflow/buffer/wavetablebuffer.h"
 #include "signalflow/node/node.h"
 
 namespace signalflow
@@ -26,6 +27,13 @@ private:
     BufferRef phase_map;
 
     std::vector<float> current_phase;
+
+    /*--------------------------------------------------------------------------------
+     * Per-frame read positions and phase increments, filled for each channel
+     * before the samples are read from the table in a single block.
+     *--------------------------------------------------------------------------------*/
+    std::vector<float> read_phases;
+    std::vector<float> read_increments;
 };
 
 class Wavetable2D : public Node
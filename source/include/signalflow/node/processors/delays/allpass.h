@@ -1,6 +1,6 @@
 #pragma once
 
-#include "signalflow/buffer/ringbuffer.h"
+#include "signalflow/buffer/delayline.h"
 #include "signalflow/core/constants.h"
 #include "signalflow/core/graph.h"
 #include "signalflow/node/node.h"
@@ -13,15 +13,18 @@ class AllpassDelay : public UnaryOpNode
 {
 public:
     AllpassDelay(NodeRef input = 0.0, NodeRef delay_time = 0.1, NodeRef feedback = 0.5, float max_delay_time = 0.5);
-    ~AllpassDelay() override;
 
+    virtual void alloc() override;
     virtual void process(Buffer &out, int num_frames) override;
 
 private:
     NodeRef delay_time;
     NodeRef feedback;
+    float max_delay_time;
 
-    std::vector<SampleRingBuffer *> buffers;
+    std::vector<DelayLine> buffers;
+    std::vector<sample> delayed;
+    std::vector<sample> written;
 };
 
 REGISTER(AllpassDelay, "allpass-delay")
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "signalflow/buffer/delayline.h"
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+typedef enum
+{
+    /*------------------------------------------------------------------------
+     * Hadamard matrix: maximally dense mixing, applied as a fast
+     * Walsh-Hadamard transform.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_FDN_MATRIX_HADAMARD,
+
+    /*------------------------------------------------------------------------
+     * Householder reflection (I - 2/N): each line feeds back mostly into
+     * itself, giving a slower build-up of echo density.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_FDN_MATRIX_HOUSEHOLDER
+} signalflow_fdn_matrix_t;
+
+/**--------------------------------------------------------------------------------
+ * Feedback delay network reverb, with `num_lines` (8, 16 or 32) delay lines
+ * mixed through an orthogonal feedback matrix.
+ *
+ * Each line has a one-pole lowpass damping filter and a gain set so that the
+ * reverb tail decays by 60dB over `decay_time` seconds. Line read positions
+ * can be modulated by up to `modulation_depth` seconds at around
+ * `modulation_rate` Hz, to reduce metallic resonances. `size` scales the
+ * lengths of all delay lines.
+ *
+ * Input is stereo (mono input is upmixed), and is distributed across the
+ * lines; even-numbered lines feed the left output and odd-numbered lines the
+ * right. The output is wet-only: use WetDry to mix with the dry signal.
+ *
+ * decay_time, damping, modulation_depth and modulation_rate are read once
+ * per block.
+ *--------------------------------------------------------------------------------*/
+class FDNReverb : public UnaryOpNode
+{
+public:
+    FDNReverb(NodeRef input = 0.0,
+              NodeRef decay_time = 2.0,
+              NodeRef damping = 0.3,
+              NodeRef modulation_depth = 0.0,
+              NodeRef modulation_rate = 0.5,
+              int num_lines = 8,
+              signalflow_fdn_matrix_t matrix_type = SIGNALFLOW_FDN_MATRIX_HADAMARD,
+              float size = 1.0);
+
+    virtual void alloc() override;
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
+
+private:
+    template <int NumLines>
+    void process_lines(Buffer &out, int num_frames);
+
+    NodeRef decay_time;
+    NodeRef damping;
+    NodeRef modulation_depth;
+    NodeRef modulation_rate;
+
+    int num_lines;
+    signalflow_fdn_matrix_t matrix_type;
+    float size;
+
+    std::vector<DelayLine> lines;
+    std::vector<float> line_lengths;
+    std::vector<float> line_gains;
+    std::vector<float> damping_state;
+    std::vector<float> modulation_phase;
+
+    /*------------------------------------------------------------------------
+     * Scratch space for a block of each line's output, stored contiguously
+     * per line so that matrix mixing can be vectorised across frames.
+     *-----------------------------------------------------------------------*/
+    std::vector<sample> line_outputs;
+    std::vector<float> scratch;
+};
+
+REGISTER(FDNReverb, "fdn-reverb")
+}
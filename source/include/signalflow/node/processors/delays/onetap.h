@@ -1,6 +1,6 @@
 #pragma once
 
-#include "signalflow/buffer/ringbuffer.h"
+#include "signalflow/buffer/delayline.h"
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
 
@@ -12,14 +12,16 @@ class OneTapDelay : public UnaryOpNode
 {
 public:
     OneTapDelay(NodeRef input = 0.0, NodeRef delay_time = 0.1, float max_delay_time = 0.5);
-    ~OneTapDelay() override;
 
+    virtual void alloc() override;
     virtual void process(Buffer &out, int num_frames) override;
 
 private:
     NodeRef delay_time;
+    float max_delay_time;
 
-    std::vector<SampleRingBuffer *> buffers;
+    std::vector<DelayLine> buffers;
+    std::vector<float> delays;
 };
 
 REGISTER(OneTapDelay, "one-tap-delay")
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "signalflow/buffer/ringbuffer.h"
+#include "signalflow/buffer/delayline.h"
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
 
@@ -16,7 +16,6 @@ public:
             NodeRef stutter_count = 1,
             NodeRef clock = nullptr,
             float max_stutter_time = 1.0);
-    ~Stutter() override;
 
     virtual void alloc() override;
     virtual void process(Buffer &out, int num_frames) override;
@@ -28,7 +27,7 @@ private:
     NodeRef clock;
     float max_stutter_time;
 
-    std::vector<SampleRingBuffer *> buffers;
+    std::vector<DelayLine> buffers;
     std::vector<int> stutter_index;
     std::vector<int> stutters_to_do;
     std::vector<int> stutter_sample_buffer_offset;
@@ -2,9 +2,21 @@
 
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
+#include "signalflow/node/processors/dynamics/dynamics-engine.h"
 
 namespace signalflow
 {
+
+/**--------------------------------------------------------------------------------
+ * Feed-forward compressor. When the level of the input (or of `sidechain`,
+ * if given) exceeds `threshold`, the excess is reduced by `ratio`.
+ * The detected level rises over `attack_time` and falls over `release_time`.
+ *
+ * If `linked` is true, a single gain is computed from the peak across all
+ * channels. Otherwise, each channel is compressed independently.
+ *
+ * threshold, ratio, attack_time and release_time are read once per block.
+ *--------------------------------------------------------------------------------*/
 class Compressor : public UnaryOpNode
 {
 public:
@@ -13,9 +25,12 @@ public:
                NodeRef ratio = 2,
                NodeRef attack_time = 0.01,
                NodeRef release_time = 0.1,
-               NodeRef sidechain = nullptr);
+               NodeRef sidechain = nullptr,
+               bool linked = true);
 
-    virtual void process(Buffer &out, int num_frames);
+    virtual void alloc() override;
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
 
     NodeRef threshold;
     NodeRef ratio;
@@ -24,7 +39,8 @@ public:
     NodeRef sidechain;
 
 private:
-    float current_ratio;
+    DynamicsEngine engine;
+    EnvelopeFollower follower;
 };
 
 REGISTER(Compressor, "compressor")
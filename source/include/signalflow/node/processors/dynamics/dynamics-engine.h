@@ -0,0 +1,167 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file dynamics-engine.h
+ * @brief Building blocks shared by the dynamics processors (Limiter,
+ *        Compressor and Gate): level detection, envelope following,
+ *        look-ahead peak hold, gain smoothing and gain application.
+ *
+ * Processing is split into stages that each operate on a block of at most
+ * SIGNALFLOW_DYNAMICS_BLOCK_SIZE frames. Detector levels are stored
+ * frame-major, with one value per detector per frame, so that each stage is a
+ * flat loop over every detector and frame, and a gain computer can be written
+ * as a single element-wise pass over get_levels().
+ *
+ * Detection is either linked, in which case a single detector follows the
+ * peak across all channels and the same gain is applied to every channel
+ * (preserving the stereo image), or unlinked, with one detector per channel.
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/buffer/buffer.h"
+#include "signalflow/buffer/delayline.h"
+#include "signalflow/core/constants.h"
+
+#include <vector>
+
+/*------------------------------------------------------------------------
+ * Maximum number of frames processed by each stage at once.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_DYNAMICS_BLOCK_SIZE 256
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Running maximum over the last `window` values of a signal, using a
+ * monotonic deque so that each value costs amortised O(1) regardless of the
+ * window length.
+ *--------------------------------------------------------------------------------*/
+class SlidingMax
+{
+public:
+    SlidingMax(int max_window = 1);
+
+    /**------------------------------------------------------------------------
+     * Set the window length, which must not exceed the maximum window given
+     * at construction. Clears the history.
+     *
+     *------------------------------------------------------------------------*/
+    void set_window(int window);
+    void clear();
+
+    /**------------------------------------------------------------------------
+     * Replace each of `num_frames` values (spaced `stride` apart) with the
+     * maximum of the window ending at that value.
+     *
+     *------------------------------------------------------------------------*/
+    void process(float *values, int num_frames, int stride = 1);
+
+private:
+    std::vector<float> values;
+    std::vector<unsigned int> positions;
+    unsigned int head;
+    unsigned int tail;
+    unsigned int mask;
+    unsigned int position;
+    unsigned int window;
+};
+
+/**--------------------------------------------------------------------------------
+ * One-pole smoother with separate time constants for rising (attack) and
+ * falling (release) values, applied independently to each of a number of
+ * interleaved detectors. An attack or release time of zero follows the input
+ * immediately in that direction.
+ *--------------------------------------------------------------------------------*/
+class EnvelopeFollower
+{
+public:
+    EnvelopeFollower();
+
+    void alloc(int num_detectors);
+    void clear(float value = 0.0);
+    void set_times(float attack_time, float release_time, float sample_rate);
+
+    /**------------------------------------------------------------------------
+     * Smooth `num_frames` frames of `num_detectors` interleaved values,
+     * in place.
+     *
+     *------------------------------------------------------------------------*/
+    void process(float *values, int num_detectors, int num_frames);
+
+private:
+    std::vector<float> state;
+    float attack_coefficient;
+    float release_coefficient;
+};
+
+class DynamicsEngine
+{
+public:
+    /**------------------------------------------------------------------------
+     * Create an engine, with linked or unlinked detection, that delays its
+     * output by `lookahead` frames relative to its detector.
+     *
+     *------------------------------------------------------------------------*/
+    DynamicsEngine(bool linked = true, int lookahead = 0);
+
+    /**------------------------------------------------------------------------
+     * Allocate state for up to `num_channels` channels.
+     *
+     *------------------------------------------------------------------------*/
+    void alloc(int num_channels);
+    void clear();
+
+    int get_lookahead();
+    int get_num_detectors(int num_channels);
+
+    /**------------------------------------------------------------------------
+     * Returns the detector levels for the current block, frame-major.
+     * Stages operate on this buffer in place.
+     *
+     *------------------------------------------------------------------------*/
+    float *get_levels();
+
+    /**------------------------------------------------------------------------
+     * Populate the levels with the absolute value of `num_frames` frames of
+     * `in`, starting at frame `offset`. `in` may be a sidechain.
+     *
+     *------------------------------------------------------------------------*/
+    void detect(Buffer &in, int num_channels, int offset, int num_frames);
+
+    /**------------------------------------------------------------------------
+     * Replace each level with its maximum over the look-ahead window, so that
+     * a peak is seen by the gain computer `lookahead` frames before the
+     * corresponding frame is output.
+     *
+     *------------------------------------------------------------------------*/
+    void hold(int num_channels, int num_frames);
+
+    /**------------------------------------------------------------------------
+     * Replace each gain with its mean over the look-ahead window. Following
+     * hold(), this ramps the gain down over the look-ahead period, reaching
+     * the held gain no later than the peak that caused it.
+     *
+     *------------------------------------------------------------------------*/
+    void smooth(int num_channels, int num_frames);
+
+    /**------------------------------------------------------------------------
+     * Write `in`, delayed by the look-ahead and multiplied by the gains
+     * now held in the levels buffer, to `out`.
+     *
+     *------------------------------------------------------------------------*/
+    void apply(Buffer &in, Buffer &out, int num_channels, int offset, int num_frames);
+
+private:
+    bool linked;
+    int lookahead;
+    int num_channels_allocated;
+
+    std::vector<float> levels;
+    std::vector<SlidingMax> holds;
+    std::vector<float> smoothing_history;
+    std::vector<double> smoothing_sums;
+    int smoothing_position;
+    std::vector<DelayLine> delays;
+};
+
+}
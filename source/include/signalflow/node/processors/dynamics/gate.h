@@ -2,20 +2,45 @@
 
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
+#include "signalflow/node/processors/dynamics/dynamics-engine.h"
 
 namespace signalflow
 {
+
+/**--------------------------------------------------------------------------------
+ * Noise gate. Passes the input while its peak level (or that of `sidechain`,
+ * if given) is above `threshold`, and silences it otherwise. The gate opens
+ * over `attack_time` seconds. Once the level falls below the threshold,
+ * the detected peak decays and the gate closes, each over `release_time`.
+ *
+ * If `linked` is true, all channels are gated together, based on the peak
+ * across all channels. Otherwise, each channel is gated independently.
+ *
+ * threshold, attack_time and release_time are read once per block.
+ *--------------------------------------------------------------------------------*/
 class Gate : public UnaryOpNode
 {
 public:
-    Gate(NodeRef input = 0.0, NodeRef threshold = 0.1);
+    Gate(NodeRef input = 0.0,
+         NodeRef threshold = 0.1,
+         NodeRef attack_time = 0.001,
+         NodeRef release_time = 0.05,
+         NodeRef sidechain = nullptr,
+         bool linked = true);
 
-    virtual void process(Buffer &out, int num_frames);
+    virtual void alloc() override;
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
 
     NodeRef threshold;
+    NodeRef attack_time;
+    NodeRef release_time;
+    NodeRef sidechain;
 
 private:
-    float level;
+    DynamicsEngine engine;
+    EnvelopeFollower level_follower;
+    EnvelopeFollower gain_follower;
 };
 
 REGISTER(Gate, "gate")
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+#include "signalflow/node/processors/dynamics/dynamics-engine.h"
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Look-ahead brickwall limiter. The output is delayed by `lookahead_time`
+ * seconds, during which the gain ramps down ahead of each peak, so that the
+ * output never exceeds `ceiling` without clipping the waveform. Gain then
+ * recovers over `release_time` seconds.
+ *
+ * If `linked` is true, the same gain is applied to every channel, based on
+ * the peak across all channels. Otherwise, each channel is limited
+ * independently.
+ *
+ * ceiling and release_time are read once per block.
+ *--------------------------------------------------------------------------------*/
+class Limiter : public UnaryOpNode
+{
+public:
+    Limiter(NodeRef input = 0.0,
+            NodeRef ceiling = 1.0,
+            NodeRef release_time = 0.05,
+            float lookahead_time = 0.005,
+            bool linked = true);
+
+    virtual void alloc() override;
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
+
+    NodeRef ceiling;
+    NodeRef release_time;
+
+private:
+    DynamicsEngine engine;
+    EnvelopeFollower follower;
+};
+
+REGISTER(Limiter, "limiter")
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file biquad-engine.h
+ * @brief BiquadEngine processes a cascade of biquad sections across many
+ *        channels at once, ramping coefficients between parameter updates.
+ *
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/buffer/buffer.h"
+#include "signalflow/core/constants.h"
+
+#include <vector>
+
+/*------------------------------------------------------------------------
+ * Number of frames between filter coefficient updates. Filter parameters
+ * are sampled once per sub-block, and the engine ramps linearly from the
+ * previous coefficients to the new ones over the course of the sub-block.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE 32
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Coefficients of a single biquad section, in transposed direct form II.
+ * a0..a2 are the feedforward coefficients, b1..b2 the feedback coefficients
+ * (normalised so that b0 == 1).
+ *
+ * Source: https://www.earlevel.com/main/2012/11/26/biquad-c-source-code/
+ *--------------------------------------------------------------------------------*/
+class BiquadCoefficients
+{
+public:
+    BiquadCoefficients(float a0 = 1.0, float a1 = 0.0, float a2 = 0.0, float b1 = 0.0, float b2 = 0.0);
+
+    /**--------------------------------------------------------------------------------
+     * Calculate the coefficients for one of the standard filter types.
+     *
+     * @param filter_type The filter type.
+     * @param cutoff The cutoff frequency, in Hz.
+     * @param resonance The filter Q.
+     * @param peak_gain The gain for peak and shelf filters, in dB.
+     * @param sample_rate The sample rate, in Hz.
+     *
+     *--------------------------------------------------------------------------------*/
+    static BiquadCoefficients from_filter_type(signalflow_filter_type_t filter_type,
+                                               float cutoff,
+                                               float resonance,
+                                               float peak_gain,
+                                               float sample_rate);
+
+    float a0, a1, a2, b1, b2;
+};
+
+class BiquadEngine
+{
+public:
+    BiquadEngine(int num_channels = 0, int num_sections = 1);
+
+    /**--------------------------------------------------------------------------------
+     * Set the number of channels and cascaded sections. Existing filter state
+     * and coefficients for channels that are retained are preserved.
+     *
+     *--------------------------------------------------------------------------------*/
+    void resize(int num_channels, int num_sections = 1);
+
+    /**--------------------------------------------------------------------------------
+     * Clear the filter history of all channels.
+     *
+     *--------------------------------------------------------------------------------*/
+    void reset();
+
+    /**--------------------------------------------------------------------------------
+     * Set the target coefficients of one section of one channel. Over the
+     * course of the next call to process(), the coefficients are ramped
+     * towards the target. The first coefficients set after construction or
+     * reset() are applied immediately.
+     *
+     *--------------------------------------------------------------------------------*/
+    void set_coefficients(int channel, int section, const BiquadCoefficients &coefficients);
+
+    /**--------------------------------------------------------------------------------
+     * Filter `num_frames` frames of `input`, beginning at `offset`, into the
+     * same region of `output`. Each section of the cascade is applied in turn.
+     *
+     * Multichannel input is interleaved so that the recursion of every channel
+     * is performed in parallel, in SIMD lanes where available.
+     *
+     *--------------------------------------------------------------------------------*/
+    void process(Buffer &input, Buffer &output, int num_channels, int offset, int num_frames);
+
+    int get_num_channels();
+    int get_num_sections();
+
+private:
+    void process_interleaved(sample *data, int num_channels, int num_frames, bool ramp);
+
+    int num_channels;
+    int num_sections;
+
+    /*------------------------------------------------------------------------
+     * Coefficients and state are stored section-major, with channels
+     * contiguous: index = section * num_channels + channel.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> a0, a1, a2, b1, b2;
+    std::vector<float> target_a0, target_a1, target_a2, target_b1, target_b2;
+    std::vector<float> delta_a0, delta_a1, delta_a2, delta_b1, delta_b2;
+    std::vector<float> z1, z2;
+
+    /*------------------------------------------------------------------------
+     * Scratch space for interleaved (frame-major) samples.
+     *-----------------------------------------------------------------------*/
+    std::vector<sample> interleaved;
+
+    bool is_ramping;
+    bool has_coefficients;
+};
+
+}
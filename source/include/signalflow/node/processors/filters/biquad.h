@@ -2,6 +2,7 @@
 
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
+#include "signalflow/node/processors/filters/biquad-engine.h"
 
 namespace signalflow
 {
@@ -23,9 +24,15 @@ private:
     NodeRef resonance;
     NodeRef peak_gain;
 
-    virtual void _recalculate();
+    virtual void _recalculate(int frame);
 
-    std::vector<float> a0, a1, a2, b1, b2, z1, z2;
+    BiquadEngine engine;
+
+    /*------------------------------------------------------------------------
+     * Parameter values used in the last coefficient calculation, so that
+     * coefficients are only recalculated when the inputs change.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> last_cutoff, last_resonance, last_peak_gain;
 };
 
 REGISTER(BiquadFilter, "biquad-filter")
@@ -2,6 +2,7 @@
 
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
+#include "signalflow/node/processors/filters/biquad-engine.h"
 
 namespace signalflow
 {
@@ -21,8 +22,15 @@ public:
     NodeRef high_freq;
 
 private:
-    std::vector<float> f1p0, f1p1, f1p2, f1p3;
-    std::vector<float> f2p0, f2p1, f2p2, f2p3;
+    virtual void _recalculate(int frame);
+
+    /*------------------------------------------------------------------------
+     * Each band edge is a 4-pole low-pass filter, made up of two cascaded
+     * biquad sections.
+     *-----------------------------------------------------------------------*/
+    BiquadEngine low_engine, high_engine;
+    Buffer low_buffer, high_buffer;
+    std::vector<float> last_low_freq, last_high_freq;
     std::vector<float> sdm1, sdm2, sdm3;
 };
 
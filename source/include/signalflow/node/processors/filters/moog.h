@@ -17,6 +17,8 @@ public:
     virtual void process(Buffer &out, int num_frames) override;
 
 private:
+    friend class MoogVCFKernel;
+
     std::vector<float> out1, out2, out3, out4;
     std::vector<float> in1, in2, in3, in4;
 };
@@ -2,6 +2,7 @@
 
 #include "signalflow/core/constants.h"
 #include "signalflow/node/node.h"
+#include "signalflow/node/processors/filters/biquad-engine.h"
 
 namespace signalflow
 {
@@ -28,7 +29,8 @@ private:
 
     virtual void _recalculate(int frame);
 
-    std::vector<float> ic1eq, ic2eq, g, k, a1, a2, a3;
+    BiquadEngine engine;
+    std::vector<float> last_cutoff, last_resonance;
 };
 
 REGISTER(SVFFilter, "svf-filter")
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+#include "signalflow/node/processors/panning/spatial.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Decode an ambisonic signal (ACN order, SN3D normalisation) to a speaker
+ * array, given as lists of speaker azimuths and elevations in degrees. If no
+ * elevations are given, the array is horizontal.
+ *
+ * The order is taken from the number of input channels. Decoding uses a
+ * sampling decoder, which suits arrays whose speakers are spread evenly
+ * around the listener; for horizontal arrays, only the horizontal components
+ * are decoded. If `max_re` is true, higher orders are weighted to maximise
+ * the energy vector, which narrows each source's spread at the expense of
+ * some low-frequency accuracy.
+ *--------------------------------------------------------------------------------*/
+class AmbisonicDecoder : public UnaryOpNode
+{
+public:
+    AmbisonicDecoder(std::vector<float> speaker_azimuths = { 30.0, -30.0 },
+                     std::vector<float> speaker_elevations = std::vector<float>(),
+                     NodeRef input = 0,
+                     bool max_re = true);
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void update_channels() override;
+
+private:
+    std::vector<float> speaker_azimuths;
+    std::vector<float> speaker_elevations;
+    bool max_re;
+    int order;
+
+    /*------------------------------------------------------------------------
+     * Decoding gains, [speaker * num_input_channels + input_channel].
+     *-----------------------------------------------------------------------*/
+    std::vector<float> matrix;
+};
+
+REGISTER(AmbisonicDecoder, "ambisonic-decoder")
+}
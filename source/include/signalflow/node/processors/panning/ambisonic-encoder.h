@@ -0,0 +1,60 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+#include "signalflow/node/processors/panning/spatial.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Encode any number of sources into a single ambisonic signal of the given
+ * order, with (order + 1)^2 channels in ACN order with SN3D normalisation.
+ *
+ * Each channel of `input` is a source, encoded as a plane wave from the
+ * direction given by the corresponding channels of `azimuth` and
+ * `elevation`, in degrees, which are read once per block. When a source
+ * moves, its coefficients are interpolated linearly across the block.
+ *--------------------------------------------------------------------------------*/
+class AmbisonicEncoder : public Node
+{
+public:
+    AmbisonicEncoder(int order = 1,
+                     NodeRef input = 0,
+                     NodeRef azimuth = 0.0,
+                     NodeRef elevation = 0.0);
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void update_channels() override;
+
+    NodeRef input;
+    NodeRef azimuth;
+    NodeRef elevation;
+
+private:
+    int order;
+    int num_ambisonic_channels;
+
+    /*------------------------------------------------------------------------
+     * Per source: whether it has been positioned yet, its last direction,
+     * and its coefficients at the end of the last block,
+     * [source * num_ambisonic_channels + channel].
+     *-----------------------------------------------------------------------*/
+    std::vector<bool> positioned;
+    std::vector<float> azimuths;
+    std::vector<float> elevations;
+    std::vector<float> coefficients;
+
+    /*------------------------------------------------------------------------
+     * Coefficients at the end of this block, in the same layout, and
+     * pointers to each source's input, so that all sources can be mixed
+     * into each output channel in one pass.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> next_coefficients;
+    std::vector<const sample *> inputs;
+};
+
+REGISTER(AmbisonicEncoder, "ambisonic-encoder")
+}
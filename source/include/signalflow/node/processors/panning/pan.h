@@ -4,6 +4,12 @@
 
 namespace signalflow
 {
+
+/**--------------------------------------------------------------------------------
+ * Pan a mono input across `channels` outputs arranged in a line, with
+ * equal-power panning between each adjacent pair. A `pan` of -1 is the first
+ * channel and 1 is the last.
+ *--------------------------------------------------------------------------------*/
 class LinearPanner : public Node
 {
 public:
@@ -0,0 +1,123 @@
+#pragma once
+
+/**--------------------------------------------------------------------------------
+ * @file spatial.h
+ * @brief Speaker triangulation and spherical harmonics, shared by the VBAP
+ *        and ambisonic nodes.
+ *
+ * Directions are given in degrees. An azimuth of 0 is straight ahead, and
+ * azimuth increases anticlockwise, so that 90 is hard left. An elevation of
+ * 0 is the horizontal plane, and 90 is straight up.
+ *
+ * Ambisonic signals use ACN channel ordering and SN3D normalisation.
+ *--------------------------------------------------------------------------------*/
+
+#include "signalflow/core/constants.h"
+
+#include <vector>
+
+#define SIGNALFLOW_AMBISONIC_MAX_ORDER 7
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Returns the number of channels in an ambisonic signal of the given order.
+ *--------------------------------------------------------------------------------*/
+int signalflow_ambisonic_num_channels(int order);
+
+/**--------------------------------------------------------------------------------
+ * Write the ambisonic coefficients of a plane wave from the given direction
+ * to `coefficients`, which must have space for
+ * signalflow_ambisonic_num_channels(order) values.
+ *--------------------------------------------------------------------------------*/
+void signalflow_ambisonic_encode(int order, float azimuth, float elevation, float *coefficients);
+
+/**--------------------------------------------------------------------------------
+ * Add `in` to `out` with a gain that ramps linearly from `gain_from` to
+ * `gain_to` across the block, reaching `gain_to` on the last frame.
+ *--------------------------------------------------------------------------------*/
+void signalflow_spatial_accumulate(const sample *in, sample *out, float gain_from, float gain_to, int num_frames);
+
+/**--------------------------------------------------------------------------------
+ * Add the weighted sum of `num_inputs` inputs to `out`, with each input's
+ * gain ramping as in signalflow_spatial_accumulate(). The gains for input i
+ * are read from gains_from[i * gain_stride] and gains_to[i * gain_stride].
+ *
+ * Inputs are mixed in groups, so that each pass over `out` accumulates
+ * several inputs at once.
+ *--------------------------------------------------------------------------------*/
+void signalflow_spatial_mix(const sample *const *inputs,
+                            int num_inputs,
+                            const float *gains_from,
+                            const float *gains_to,
+                            int gain_stride,
+                            sample *out,
+                            int num_frames);
+
+/**--------------------------------------------------------------------------------
+ * A speaker layout divided into regions for vector-based amplitude panning.
+ *
+ * If every speaker is on the horizontal plane, each region is a pair of
+ * adjacent speakers. Otherwise, the speakers are triangulated following
+ * Pulkki's method: all non-degenerate triplets that enclose no other speaker
+ * are found, and where the edges of two triplets cross, the longer edge is
+ * discarded. This allows for partial arrays such as domes, in which the
+ * triangulation does not cover the whole sphere.
+ *
+ * The inverse of each region's speaker matrix is computed up front, so that
+ * finding the gains for a direction needs only a search over the regions.
+ *--------------------------------------------------------------------------------*/
+class VBAPLayout
+{
+public:
+    VBAPLayout(std::vector<float> azimuths, std::vector<float> elevations = std::vector<float>());
+
+    int get_num_speakers();
+    int get_num_regions();
+    bool is_horizontal();
+
+    /**------------------------------------------------------------------------
+     * Find the gains for a source in the given direction. Up to three
+     * speaker indices and gains are written to `speakers` and `gains`;
+     * unused entries have an index of -1 and a gain of 0. Gains are
+     * normalised to unit power.
+     *
+     * `hint` is the index of a region to try first, typically the region
+     * returned for the same source on the previous block. Returns the
+     * index of the region used.
+     *
+     * Directions outside the area covered by the layout are panned to the
+     * nearest region.
+     *
+     *------------------------------------------------------------------------*/
+    int get_gains(float azimuth, float elevation, int hint, int *speakers, float *gains);
+
+private:
+    class Region
+    {
+    public:
+        int speakers[3];
+
+        /*------------------------------------------------------------------------
+         * Inverse of the matrix whose rows are the speakers' unit vectors,
+         * row-major. For pairs, only the top-left 2x2 entries are used.
+         *-----------------------------------------------------------------------*/
+        float inverse[9];
+    };
+
+    void triangulate_horizontal();
+    void triangulate();
+    float get_region_gains(const Region &region, const float *direction, float *gains);
+
+    int num_speakers;
+    bool horizontal;
+
+    /*------------------------------------------------------------------------
+     * Unit vector for each speaker: x is ahead, y is left and z is up.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> directions;
+    std::vector<Region> regions;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "signalflow/core/constants.h"
+#include "signalflow/node/node.h"
+#include "signalflow/node/processors/panning/spatial.h"
+
+#include <vector>
+
+namespace signalflow
+{
+
+/**--------------------------------------------------------------------------------
+ * Vector-based amplitude panning of any number of sources onto a speaker
+ * array, given as lists of speaker azimuths and elevations in degrees. If no
+ * elevations are given, the array is horizontal.
+ *
+ * Each channel of `input` is a source, panned to the direction given by the
+ * corresponding channels of `azimuth` and `elevation`, which are read once
+ * per block. Each source feeds at most three speakers (two for a horizontal
+ * array), and the output has one channel per speaker. When a source moves,
+ * its gains are interpolated linearly across the block.
+ *--------------------------------------------------------------------------------*/
+class VBAPPanner : public Node
+{
+public:
+    VBAPPanner(std::vector<float> speaker_azimuths = { 30.0, -30.0 },
+               std::vector<float> speaker_elevations = std::vector<float>(),
+               NodeRef input = 0,
+               NodeRef azimuth = 0.0,
+               NodeRef elevation = 0.0);
+
+    virtual void process(Buffer &out, int num_frames) override;
+    virtual void update_channels() override;
+
+    NodeRef input;
+    NodeRef azimuth;
+    NodeRef elevation;
+
+private:
+    class Source
+    {
+    public:
+        bool positioned;
+        float azimuth;
+        float elevation;
+        int region;
+        int speakers[3];
+        float gains[3];
+    };
+
+    VBAPLayout layout;
+    std::vector<Source> sources;
+};
+
+REGISTER(VBAPPanner, "vbap-panner")
+}
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "signalflow/patch/patch-node-spec.h"
 
@@ -51,6 +52,21 @@ public:
      *-----------------------------------------------------------------------*/
     Node *create(std::string name);
 
+    /**------------------------------------------------------------------------
+     * Returns the function that constructs a Node of the given name, so
+     * that callers creating many Nodes of the same class can look it up
+     * once. Throws if the name is not registered.
+     *
+     *-----------------------------------------------------------------------*/
+    std::function<Node *()> get_constructor(std::string name);
+
+    /**------------------------------------------------------------------------
+     * Returns the names of all registered Node classes, in alphabetical
+     * order.
+     *
+     *-----------------------------------------------------------------------*/
+    std::vector<std::string> get_names();
+
     /*------------------------------------------------------------------------
      * (Function template implementations must be in .h file.)
      * http://stackoverflow.com/questions/495021/why-can-templates-only-be-implemented-in-the-header-file
@@ -1,8 +1,9 @@
 #pragma once
 
+#include "signalflow/core/random.h"
 #include "signalflow/node/node.h"
 
-#include <random>
+#include <vector>
 
 #define SIGNALFLOW_PROCESS_STOCHASTIC_NODE_RESET_TRIGGER()             \
     if (SIGNALFLOW_CHECK_CHANNEL_TRIGGER(this->reset, channel, frame)) \
@@ -17,18 +18,21 @@ class StochasticNode : public Node
 {
 public:
     StochasticNode(NodeRef reset = nullptr);
+    virtual void alloc() override;
     virtual void trigger(std::string name = SIGNALFLOW_DEFAULT_TRIGGER, float value = 1.0) override;
     virtual void set_seed(unsigned long int seed);
 
 protected:
-    double random_uniform(double from = 0.0, double to = 1.0);
-    double random_gaussian(double mean = 0.0, double sigma = 1.0);
-    double random_exponential(double lambda = 1.0);
-
     NodeRef reset;
     unsigned long int seed;
 
-    std::mt19937 rng;
+    /*------------------------------------------------------------------------
+     * One random stream per output channel, keyed on the node's seed and
+     * the channel index. Each channel's sequence is therefore independent
+     * of the block size and of the other channels. Subclasses that
+     * override alloc() must call StochasticNode::alloc().
+     *-----------------------------------------------------------------------*/
+    std::vector<RandomStream> rng;
 };
 
 }
@@ -6,6 +6,8 @@
 namespace signalflow
 {
 
+class PatchSpec;
+
 class PatchNodeSpec
 {
 public:
@@ -31,13 +33,28 @@ public:
 
     std::unordered_map<std::string, PatchNodeSpec *> get_inputs();
     std::unordered_map<std::string, std::string> get_buffer_inputs();
+    std::unordered_map<std::string, std::string> get_properties();
 
     void add_input(std::string name, PatchNodeSpec *def);
     void add_input(std::string name, float value);
     void add_buffer_input(std::string patch_input_name,
                           std::string node_input_name);
 
+    /**--------------------------------------------------------------------------------
+     * String properties, set on the node when it is instantiated.
+     *--------------------------------------------------------------------------------*/
+    void set_property(std::string name, std::string value);
+
+    /**--------------------------------------------------------------------------------
+     * Set the PatchSpec that this nodespec and its inputs belong to. The
+     * PatchSpec's cached template is discarded whenever they are modified.
+     *--------------------------------------------------------------------------------*/
+    void set_owner(PatchSpec *owner);
+
 private:
+    PatchSpec *owner = nullptr;
+    void modified();
+
     std::string name = "";
     int id = -1;
     float value = 0.0;
@@ -45,6 +62,7 @@ private:
     std::string input_name;
     std::unordered_map<std::string, PatchNodeSpec *> inputs;
     std::unordered_map<std::string, std::string> buffer_inputs;
+    std::unordered_map<std::string, std::string> properties;
 };
 
 }
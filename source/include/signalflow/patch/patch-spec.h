@@ -8,6 +8,8 @@
 
 #include "signalflow/node/node.h"
 #include "signalflow/patch/patch-node-spec.h"
+#include "signalflow/patch/patch-template.h"
+#include <atomic>
 #include <map>
 
 namespace signalflow
@@ -25,7 +27,8 @@ public:
     /**----------------------------------------------------------------------------------
      * Load a PatchSpec from the given filename.
      *
-     * @param filename Path to a .json file containing the patch specification.
+     * @param filename Path to a file containing the patch specification, in
+     *                 either JSON or binary format.
      *
      *---------------------------------------------------------------------------------*/
     PatchSpec(std::string filename);
@@ -54,15 +57,21 @@ public:
     void set_name(std::string name);
 
     /*----------------------------------------------------------------------------------
-     * Load a PatchSpec from disk.
+     * Load a PatchSpec from disk. The format (JSON or binary) is detected
+     * from the file's contents.
      *---------------------------------------------------------------------------------*/
     void load(std::string filename);
 
     /*----------------------------------------------------------------------------------
-     * Save a PatchSpec to disk.
+     * Save a PatchSpec to disk, as JSON.
      *---------------------------------------------------------------------------------*/
     void save(std::string filename);
 
+    /*----------------------------------------------------------------------------------
+     * Save a PatchSpec to disk, in binary format.
+     *---------------------------------------------------------------------------------*/
+    void save_binary(std::string filename);
+
     /*----------------------------------------------------------------------------------
      * Load a PatchSpec from json text.
      *---------------------------------------------------------------------------------*/
@@ -73,12 +82,57 @@ public:
      *---------------------------------------------------------------------------------*/
     std::string to_json();
 
+    /**----------------------------------------------------------------------------------
+     * Load a PatchSpec from its binary form. Unlike JSON, the binary form
+     * records every node, including constants, so that the PatchSpec is
+     * restored exactly. Throws if the data is truncated or invalid.
+     *
+     *---------------------------------------------------------------------------------*/
+    void from_binary(std::string data);
+
+    /**----------------------------------------------------------------------------------
+     * Export a PatchSpec to its binary form.
+     *
+     *---------------------------------------------------------------------------------*/
+    std::string to_binary();
+
+    /**----------------------------------------------------------------------------------
+     * Returns the PatchSpec compiled to a PatchTemplate, which is used to
+     * instantiate Patches. The template is compiled on first use and
+     * cached until the PatchSpec or one of its PatchNodeSpecs is next
+     * modified.
+     *
+     *---------------------------------------------------------------------------------*/
+    PatchTemplateRef get_template();
+
+    /**----------------------------------------------------------------------------------
+     * Returns a counter that is incremented whenever the PatchSpec or one of
+     * its PatchNodeSpecs is modified.
+     *
+     *---------------------------------------------------------------------------------*/
+    unsigned long get_revision();
+
     /*----------------------------------------------------------------------------------
      * Store a PatchSpec to the global PatchRegistry so that it can be
      * instantiated by name.
      *---------------------------------------------------------------------------------*/
     void store();
 
+    /**----------------------------------------------------------------------------------
+     * Optimise the PatchSpec in place, so that the patches instantiated from
+     * it have fewer nodes:
+     *
+     *  - operators whose inputs are all constant are replaced by a constant
+     *  - chains of elementwise operators (Add, Subtract, Multiply, Divide,
+     *    Pow, Clip, ScaleLinLin and ScaleLinExp) are fused into a single
+     *    Expression node
+     *  - nodes that are not connected to the output are removed
+     *
+     * Patch inputs are never folded or fused, so that they can still be set
+     * with Patch::set_input().
+     *---------------------------------------------------------------------------------*/
+    void optimise();
+
     /**----------------------------------------------------------------------------------
      * Print a representation to stdout
      *---------------------------------------------------------------------------------*/
@@ -86,15 +140,22 @@ public:
 
 protected:
     friend class Patch;
+    friend class PatchNodeSpec;
 
-    PatchNodeSpec *output;
+    PatchNodeSpec *output = nullptr;
     std::map<int, PatchNodeSpec *> nodespecs;
 
 private:
     std::string name;
 
     int last_id = 0;
+    PatchTemplateRef patch_template;
+    std::atomic<unsigned long> revision;
+    void node_spec_modified();
+
     void print(PatchNodeSpec *root, int depth);
+    PatchNodeSpec *_create_node_spec(std::string name);
+    PatchNodeSpec *_optimise_node_spec(PatchNodeSpec *nodespec);
 };
 
 template <class T>
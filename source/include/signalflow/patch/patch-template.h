@@ -0,0 +1,99 @@
+#pragma once
+
+/**----------------------------------------------------------------------------------
+ * @file patch-template.h
+ * @brief PatchTemplate is a PatchSpec compiled for fast instantiation.
+ *
+ *---------------------------------------------------------------------------------*/
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace signalflow
+{
+
+class Node;
+class PatchSpec;
+class PatchNodeSpec;
+
+/**----------------------------------------------------------------------------------
+ * A node of a PatchTemplate, with its constructor already resolved from
+ * the NodeRegistry.
+ *---------------------------------------------------------------------------------*/
+class PatchTemplateNode
+{
+public:
+    std::string name;
+    std::function<Node *()> constructor;
+    bool is_constant = false;
+    float value = 0.0;
+
+    /*----------------------------------------------------------------------------------
+     * Name of the patch input that this node provides, or empty.
+     *---------------------------------------------------------------------------------*/
+    std::string input_name;
+
+    std::vector<std::pair<std::string, std::string>> properties;
+
+    /*----------------------------------------------------------------------------------
+     * Pairs of (node input name, index of the template node that feeds it).
+     * Inputs always refer to nodes earlier in the template.
+     *---------------------------------------------------------------------------------*/
+    std::vector<std::pair<std::string, int>> inputs;
+
+    /*----------------------------------------------------------------------------------
+     * Pairs of (patch input name, node input name).
+     *---------------------------------------------------------------------------------*/
+    std::vector<std::pair<std::string, std::string>> buffer_inputs;
+};
+
+/**----------------------------------------------------------------------------------
+ * A PatchTemplate holds the nodes of a patch as a flat list, ordered so
+ * that every node follows the nodes that feed it, and ending with the
+ * patch's output. Instantiating a Patch from a template is a single pass
+ * over the list, constructing and connecting each node in turn, with no
+ * registry lookups or recursion.
+ *
+ * A node that feeds more than one input is instantiated once, and shared.
+ *
+ * PatchSpec compiles and caches its template the first time a Patch is
+ * created from it, and Patch(PatchRef) builds one directly from the
+ * prototype's nodes.
+ *---------------------------------------------------------------------------------*/
+class PatchTemplate
+{
+public:
+    PatchTemplate();
+
+    /**----------------------------------------------------------------------------------
+     * Compile the nodes that are connected to the output of `spec`.
+     * Throws if the spec has no output, or refers to an unknown Node class.
+     *
+     *---------------------------------------------------------------------------------*/
+    PatchTemplate(PatchSpec *spec);
+
+    /**----------------------------------------------------------------------------------
+     * Append a node, returning its index.
+     *
+     *---------------------------------------------------------------------------------*/
+    int add_node(PatchTemplateNode node);
+
+    const std::vector<PatchTemplateNode> &get_nodes() const;
+
+    /**----------------------------------------------------------------------------------
+     * The PatchSpec revision at which the template was compiled.
+     *
+     *---------------------------------------------------------------------------------*/
+    unsigned long get_revision() const;
+
+private:
+    std::vector<PatchTemplateNode> nodes;
+    unsigned long revision = 0;
+};
+
+typedef std::shared_ptr<PatchTemplate> PatchTemplateRef;
+
+}
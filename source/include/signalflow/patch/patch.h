@@ -7,9 +7,14 @@
  *
  *-----------------------------------------------------------------------*/
 
+#include "signalflow/node/operators/expression.h"
 #include "signalflow/patch/patch-node-spec.h"
 #include "signalflow/patch/patch-spec.h"
+#include <atomic>
+#include <list>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 namespace signalflow
 {
@@ -57,9 +62,31 @@ public:
     virtual ~Patch();
 
     signalflow_patch_state_t get_state();
+
+    /**------------------------------------------------------------------------
+     * Set a named input of the Patch. Setting a float changes the value of
+     * the input's Constant; setting a node or buffer reconnects every node
+     * input that the patch input is bound to. Bindings are recorded when
+     * the Patch is instantiated (or, for a Patch built from live nodes, on
+     * first use), so this does not scan the Patch's nodes.
+     *
+     *-----------------------------------------------------------------------*/
     void set_input(std::string name, float value);
     void set_input(std::string name, NodeRef value);
     void set_input(std::string name, BufferRef value);
+
+    /**------------------------------------------------------------------------
+     * Queue a change to a named input, to be applied by the Patch's graph
+     * at the start of the next block, so that the audio thread never renders
+     * a block in which only some of a set of changes have been made. The
+     * inputs queued on all of a graph's patches before a block are applied
+     * together. If the Patch has no graph, the change is applied
+     * immediately.
+     *
+     *-----------------------------------------------------------------------*/
+    void queue_input(std::string name, float value);
+    void queue_input(std::string name, NodeRef value);
+    void queue_input(std::string name, BufferRef value);
     void disconnect();
     bool get_auto_free();
     void set_auto_free(bool value);
@@ -98,15 +125,43 @@ public:
 
     void trigger();
 
+    /**------------------------------------------------------------------------
+     * Send the reset trigger to every node in the Patch, returning it to
+     * its initial state so that it can be reused, and mark the Patch
+     * as active.
+     *
+     *-----------------------------------------------------------------------*/
+    void reset();
+
+    /**------------------------------------------------------------------------
+     * Optimise the Patch's nodes in place, as PatchSpec::optimise() does for
+     * a PatchSpec. Nodes that are not fused or removed are kept, so that
+     * references to them (such as the trigger and auto-free nodes) remain
+     * valid. An operator whose output feeds more than one input is not fused
+     * into either, so that it is still only computed once.
+     *
+     * Must be called before the Patch is played.
+     *
+     *-----------------------------------------------------------------------*/
+    void optimise();
+
     /*----------------------------------------------------------------------------------
      * Parse a template from live Node objects to create a network of NodeDefs
      *---------------------------------------------------------------------------------*/
     PatchSpecRef create_spec();
 
+    /**------------------------------------------------------------------------
+     * Compile the Patch's nodes to a PatchTemplate, which Patch(PatchRef)
+     * uses to create copies of this Patch. Nodes that feed more than one
+     * input are shared in the copies, as they are here.
+     *
+     *-----------------------------------------------------------------------*/
+    PatchTemplateRef create_template();
+
     std::string name;
 
 private:
-    NodeRef instantiate(PatchNodeSpec *nodespec);
+    void instantiate(const PatchTemplate &patch_template);
     void set_state(signalflow_patch_state_t state);
     bool auto_free;
     NodeRef auto_free_node;
@@ -116,6 +171,71 @@ private:
 
     void _iterate_from_node(const NodeRef &node);
 
+    /*----------------------------------------------------------------------------------
+     * Bindings from each patch input to the node inputs that it feeds, as
+     * (node, input slot) pairs, and from each buffer input to the node
+     * buffers that it feeds, as (node, buffer name) pairs. Built by
+     * instantiate(), or by scanning the Patch's nodes on first use if it was
+     * built from live nodes, and discarded when nodes are added or when a
+     * node in the Patch creates or destroys an input, which may move the
+     * slots of its other inputs.
+     *---------------------------------------------------------------------------------*/
+    typedef std::vector<std::pair<Node *, int>> PatchInputBindings;
+    typedef std::vector<std::pair<Node *, std::string>> PatchBufferInputBindings;
+    std::unordered_map<std::string, PatchInputBindings> input_bindings;
+    std::unordered_map<std::string, PatchBufferInputBindings> buffer_input_bindings;
+    bool has_bindings = false;
+    void _create_bindings();
+
+    /*----------------------------------------------------------------------------------
+     * Inputs queued by queue_input(). Each sets a node, a buffer, or if
+     * neither is set, the value of a Constant. Inputs are checked and
+     * prepared (see Node::prepare_input) under queued_inputs_mutex, with a
+     * copy of the bindings that they are applied to, and added to
+     * queued_inputs. They are applied by the graph's rendering thread,
+     * which then holds the nodes or buffer that each replaced, and splices
+     * them into inputs_to_release. They are released by the next call to
+     * queue_input(), so the rendering thread never allocates or frees them.
+     *---------------------------------------------------------------------------------*/
+    class QueuedInput
+    {
+    public:
+        std::string name;
+        NodeRef node;
+        BufferRef buffer;
+        float value;
+        PatchInputBindings bindings;
+        PatchBufferInputBindings buffer_bindings;
+        std::vector<NodeRef> replaced_nodes;
+    };
+    std::list<QueuedInput> queued_inputs;
+    std::list<QueuedInput> inputs_to_release;
+    std::mutex queued_inputs_mutex;
+    void _queue_input(QueuedInput input);
+    void _apply_queued_inputs();
+    void _release_queued_inputs();
+
+    /*----------------------------------------------------------------------------------
+     * Whether the graph holds this Patch in its list of patches with queued
+     * inputs. Only changed by the graph, while it holds its lock.
+     *---------------------------------------------------------------------------------*/
+    friend class AudioGraph;
+    friend class Node;
+    std::atomic<bool> has_queued_inputs;
+
+    /*----------------------------------------------------------------------------------
+     * Apply the queued inputs, if queued_inputs_mutex is free. Returns false
+     * if it is not, in which case they are left queued.
+     *---------------------------------------------------------------------------------*/
+    bool apply_queued_inputs();
+
+    /*----------------------------------------------------------------------------------
+     * Optimisation
+     *---------------------------------------------------------------------------------*/
+    bool _is_fusable(const NodeRef &node, signalflow_expression_op_t &op, std::vector<std::string> &input_names);
+    ExpressionTree _create_expression(const NodeRef &node, std::vector<NodeRef> &leaves, bool is_root);
+    NodeRef _optimise_node(const NodeRef &node, std::map<Node *, NodeRef> &optimised);
+
     /*----------------------------------------------------------------------------------
      * Template stuff
      *---------------------------------------------------------------------------------*/
@@ -123,7 +243,8 @@ private:
 
     std::string _get_input_name(const NodeRef &node);
     std::string _get_input_name(const BufferRef &buf);
-    PatchNodeSpec *_create_spec_from_node(const NodeRef &node);
+    PatchNodeSpec *_create_spec_from_node(const NodeRef &node,
+                                          std::unordered_map<Node *, PatchNodeSpec *> &created_nodespecs);
     std::map<int, PatchNodeSpec *> nodespecs;
     std::set<NodeRef> parsed_nodes;
     bool parsed = false;
@@ -0,0 +1,161 @@
+#pragma once
+
+/**-------------------------------------------------------------------------
+ * @file voice-allocator.h
+ * @brief VoiceAllocator plays a PatchSpec polyphonically from a pool of
+ *        voices that are instantiated up-front and recycled, so that
+ *        no allocation takes place per note.
+ *
+ *-----------------------------------------------------------------------*/
+
+#include "signalflow/node/node.h"
+#include "signalflow/node/oscillators/constant.h"
+#include "signalflow/patch/patch.h"
+
+#include <atomic>
+#include <vector>
+
+#define SIGNALFLOW_VOICE_ALLOCATOR_DEFAULT_NUM_VOICES 8
+
+namespace signalflow
+{
+
+typedef enum
+{
+    /*------------------------------------------------------------------------
+     * Steal the voice whose note began longest ago.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_VOICE_STEAL_OLDEST,
+
+    /*------------------------------------------------------------------------
+     * Steal the voice with the lowest peak amplitude in the last block.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_VOICE_STEAL_QUIETEST,
+
+    /*------------------------------------------------------------------------
+     * Retrigger the voice that is already playing the same note, if any;
+     * otherwise, steal the oldest voice.
+     *-----------------------------------------------------------------------*/
+    SIGNALFLOW_VOICE_STEAL_SAME_NOTE
+} signalflow_voice_steal_policy_t;
+
+class VoiceAllocator : public Node
+{
+public:
+    /**------------------------------------------------------------------------
+     * Create a pool of `num_voices` instances of `patchspec`.
+     *
+     * On note_on, the following Patch inputs are set on the allocated voice,
+     * for each input that the Patch has:
+     *
+     *   note: The MIDI note number
+     *   frequency: The frequency of the MIDI note, in Hz
+     *   velocity: The note velocity
+     *   gate: 1 (set to 0 on note_off)
+     *
+     * Each voice's output is an input of the VoiceAllocator, so voices are
+     * rendered by the graph like any other input. Changes made by note_on and
+     * note_off are passed to the voices via the graph's scheduled events, and
+     * take effect at the start of the next block.
+     *
+     * A voice becomes idle when its Patch stops, which happens when its
+     * auto-free node (or, if none is set, any of its nodes) reaches the
+     * stopped state -- typically an envelope completing after note_off.
+     * Idle voices are neither rendered nor mixed into the output.
+     *
+     *-----------------------------------------------------------------------*/
+    VoiceAllocator(PatchSpecRef patchspec = nullptr,
+                   int num_voices = SIGNALFLOW_VOICE_ALLOCATOR_DEFAULT_NUM_VOICES,
+                   signalflow_voice_steal_policy_t steal_policy = SIGNALFLOW_VOICE_STEAL_OLDEST);
+
+    virtual void process(Buffer &out, int num_frames) override;
+
+    /**------------------------------------------------------------------------
+     * Allocate a voice to play `note`, stealing an active voice if every
+     * voice is in use. The voice is reset before it is reused.
+     *
+     * @returns The index of the allocated voice.
+     *
+     *-----------------------------------------------------------------------*/
+    int note_on(int note, float velocity = 1.0);
+
+    /**------------------------------------------------------------------------
+     * Release all voices that are playing `note`, by setting their gate to 0.
+     *
+     *-----------------------------------------------------------------------*/
+    void note_off(int note);
+
+    /**------------------------------------------------------------------------
+     * Release all voices.
+     *
+     *-----------------------------------------------------------------------*/
+    void all_notes_off();
+
+    int get_num_voices();
+    int get_num_active_voices();
+    PatchRef get_voice(int index);
+
+    signalflow_voice_steal_policy_t get_steal_policy();
+    void set_steal_policy(signalflow_voice_steal_policy_t steal_policy);
+
+private:
+    class Voice
+    {
+    public:
+        Voice()
+            : serial_stopped(0), peak(0.0) {}
+
+        PatchRef patch;
+        NodeRef output;
+        NodeRef note_input;
+        NodeRef frequency_input;
+        NodeRef velocity_input;
+        NodeRef gate_input;
+
+        /*------------------------------------------------------------------------
+         * Set via a scheduled event to the serial number of the note that the
+         * voice is playing, so that the audio thread knows which note it is
+         * rendering. Not connected to the voice's patch.
+         *-----------------------------------------------------------------------*/
+        NodeRef serial_input;
+
+        /*------------------------------------------------------------------------
+         * Accessed only by the thread that calls note_on and note_off.
+         *-----------------------------------------------------------------------*/
+        int note = -1;
+        bool released = false;
+        unsigned long age = 0;
+        unsigned long serial = 0;
+
+        /*------------------------------------------------------------------------
+         * Written by the audio thread. The voice is active until the note
+         * with its current serial number has stopped.
+         *-----------------------------------------------------------------------*/
+        std::atomic<unsigned long> serial_stopped;
+        std::atomic<float> peak;
+
+        bool is_active() { return this->serial != this->serial_stopped.load(); }
+
+        /*------------------------------------------------------------------------
+         * Whether the voice is idle in the current block. Called by the audio
+         * thread.
+         *-----------------------------------------------------------------------*/
+        bool is_idle()
+        {
+            unsigned long serial = (unsigned long) ((Constant *) this->serial_input.get())->value;
+            return serial == 0 || serial == this->serial_stopped.load();
+        }
+    };
+
+    virtual bool skip_input(int index) override;
+
+    int find_voice(int note);
+    NodeRef get_constant_input(PatchRef patch, std::string name);
+    void set_voice_value(Voice &voice, NodeRef input, float value);
+
+    std::vector<Voice> voices;
+    signalflow_voice_steal_policy_t steal_policy;
+    unsigned long note_counter;
+};
+
+}
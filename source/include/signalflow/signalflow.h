@@ -12,13 +12,18 @@
 #include <signalflow/core/version.h>
 
 #include <signalflow/buffer/buffer.h>
+#include <signalflow/buffer/delayline.h>
 #include <signalflow/buffer/ringbuffer.h>
+#include <signalflow/buffer/wavetablebuffer.h>
 
 #include <signalflow/patch/patch-node-spec.h>
 #include <signalflow/patch/patch-registry.h>
 #include <signalflow/patch/patch-spec.h>
+#include <signalflow/patch/patch-template.h>
 #include <signalflow/patch/patch.h>
+#include <signalflow/patch/voice-allocator.h>
 
+#include <signalflow/node/kernel.h>
 #include <signalflow/node/node.h>
 #include <signalflow/node/registry.h>
 
@@ -32,7 +37,9 @@
 #include <signalflow/node/operators/channel-select.h>
 #include <signalflow/node/operators/comparison.h>
 #include <signalflow/node/operators/divide.h>
+#include <signalflow/node/operators/expression.h>
 #include <signalflow/node/operators/frequency-to-midi-note.h>
+#include <signalflow/node/operators/matrix-mixer.h>
 #include <signalflow/node/operators/midi-note-to-frequency.h>
 #include <signalflow/node/operators/multiply.h>
 #include <signalflow/node/operators/pow.h>
@@ -53,6 +60,7 @@
 
 #include <signalflow/node/io/input/abstract.h>
 #include <signalflow/node/io/input/soundio.h>
+#include <signalflow/node/io/input/stream.h>
 
 /*------------------------------------------------------------------------
  * Oscillators
@@ -112,6 +120,7 @@
 #include <signalflow/node/processors/clip.h>
 #include <signalflow/node/processors/delays/allpass.h>
 #include <signalflow/node/processors/delays/comb.h>
+#include <signalflow/node/processors/delays/fdn-reverb.h>
 #include <signalflow/node/processors/delays/onetap.h>
 #include <signalflow/node/processors/delays/stutter.h>
 #include <signalflow/node/processors/distortion/resample.h>
@@ -120,16 +129,21 @@
 #include <signalflow/node/processors/distortion/waveshaper.h>
 #include <signalflow/node/processors/dynamics/compressor.h>
 #include <signalflow/node/processors/dynamics/gate.h>
+#include <signalflow/node/processors/dynamics/limiter.h>
 #include <signalflow/node/processors/dynamics/maximiser.h>
 #include <signalflow/node/processors/dynamics/rms.h>
+#include <signalflow/node/processors/filters/biquad-engine.h>
 #include <signalflow/node/processors/filters/biquad.h>
 #include <signalflow/node/processors/filters/eq.h>
 #include <signalflow/node/processors/filters/moog.h>
 #include <signalflow/node/processors/filters/svf.h>
 #include <signalflow/node/processors/fold.h>
+#include <signalflow/node/processors/panning/ambisonic-decoder.h>
+#include <signalflow/node/processors/panning/ambisonic-encoder.h>
 #include <signalflow/node/processors/panning/pan.h>
 #include <signalflow/node/processors/panning/stereo-balance.h>
 #include <signalflow/node/processors/panning/stereo-width.h>
+#include <signalflow/node/processors/panning/vbap-panner.h>
 #include <signalflow/node/processors/smooth.h>
 #include <signalflow/node/processors/wetdry.h>
 #include <signalflow/node/processors/wrap.h>
@@ -174,6 +188,7 @@
 #include <signalflow/node/fft/lpf.h>
 #include <signalflow/node/fft/noise-gate.h>
 #include <signalflow/node/fft/phase-vocoder.h>
+#include <signalflow/node/fft/spectral-features.h>
 #include <signalflow/node/fft/tonality.h>
 
 #ifdef __APPLE__
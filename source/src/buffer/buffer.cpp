@@ -20,8 +20,6 @@
 namespace signalflow
 {
 
-extern AudioGraph *shared_graph;
-
 Buffer::Buffer()
     : Buffer(0, 0)
 {
@@ -37,9 +35,10 @@ Buffer::Buffer(int num_channels, int num_frames)
      * If the AudioGraph has been instantiated, populate the buffer's sample
      * rate and duration. Otherwise, zero them.
      *-------------------------------------------------------------------------------*/
-    if (shared_graph)
+    AudioGraph *graph = AudioGraph::get_current();
+    if (graph)
     {
-        this->sample_rate = shared_graph->get_sample_rate();
+        this->sample_rate = graph->get_sample_rate();
         this->duration = this->num_frames / this->sample_rate;
     }
     else
@@ -0,0 +1,94 @@
+#include "signalflow/buffer/delayline.h"
+#include "signalflow/core/util.h"
+
+#include <string.h>
+
+namespace signalflow
+{
+
+DelayLine::DelayLine(int max_delay_samples)
+    : write_position(0)
+{
+    /*------------------------------------------------------------------------
+     * An interpolated read at the maximum delay also reads the sample
+     * before it, so one further sample of capacity is needed.
+     *-----------------------------------------------------------------------*/
+    int capacity = 1;
+    while (capacity < max_delay_samples + 2)
+    {
+        capacity *= 2;
+    }
+    this->data.resize(capacity);
+    this->mask = capacity - 1;
+}
+
+int DelayLine::get_max_delay()
+{
+    return this->mask - 1;
+}
+
+void DelayLine::clear()
+{
+    memset(this->data.data(), 0, this->data.size() * sizeof(sample));
+    this->write_position = 0;
+}
+
+void DelayLine::write(const sample *in, int num_frames)
+{
+    while (num_frames > 0)
+    {
+        int segment_length = MIN(num_frames, (int) this->data.size() - this->write_position);
+        memcpy(this->data.data() + this->write_position, in, segment_length * sizeof(sample));
+        this->write_position = (this->write_position + segment_length) & this->mask;
+        in += segment_length;
+        num_frames -= segment_length;
+    }
+}
+
+void DelayLine::read(float delay, sample *out, int num_frames)
+{
+    int delay_int = (int) delay;
+    float delay_frac = delay - delay_int;
+    int position = (this->write_position - delay_int) & this->mask;
+
+    if (delay_frac == 0.0f)
+    {
+        /*------------------------------------------------------------------------
+         * Integer delay: copy the block in (at most) two contiguous segments.
+         *-----------------------------------------------------------------------*/
+        while (num_frames > 0)
+        {
+            int segment_length = MIN(num_frames, (int) this->data.size() - position);
+            memcpy(out, this->data.data() + position, segment_length * sizeof(sample));
+            position = (position + segment_length) & this->mask;
+            out += segment_length;
+            num_frames -= segment_length;
+        }
+    }
+    else
+    {
+        const sample *data = this->data.data();
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            sample a = data[(position + frame) & this->mask];
+            sample b = data[(position + frame - 1) & this->mask];
+            out[frame] = a + delay_frac * (b - a);
+        }
+    }
+}
+
+void DelayLine::read(const float *delays, sample *out, int num_frames)
+{
+    const sample *data = this->data.data();
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        int delay_int = (int) delays[frame];
+        float delay_frac = delays[frame] - delay_int;
+        int index = (this->write_position + frame - delay_int) & this->mask;
+        sample a = data[index];
+        sample b = data[(index - 1) & this->mask];
+        out[frame] = a + delay_frac * (b - a);
+    }
+}
+
+}
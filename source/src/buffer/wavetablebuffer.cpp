@@ -0,0 +1,263 @@
+#include "signalflow/buffer/wavetablebuffer.h"
+
+#if defined(FFT_ACCELERATE)
+#include <Accelerate/Accelerate.h>
+#elif defined(FFT_FFTW)
+#include <fftw3.h>
+#endif
+
+#include <math.h>
+#include <stdexcept>
+#include <string.h>
+
+namespace signalflow
+{
+
+WavetableBuffer::WavetableBuffer(std::vector<sample> data)
+    : Buffer(data)
+{
+    this->generate_levels();
+}
+
+WavetableBuffer::WavetableBuffer(BufferRef buffer)
+    : Buffer(1, buffer->get_num_frames())
+{
+    memcpy(this->data[0], buffer->data[0], this->num_frames * sizeof(sample));
+    this->sample_rate = buffer->get_sample_rate();
+    this->generate_levels();
+}
+
+WavetableBuffer::WavetableBuffer(std::string name, int num_frames)
+    : Buffer(1, num_frames)
+{
+    for (int x = 0; x < num_frames; x++)
+    {
+        float phase = (float) x / num_frames;
+        if (name == "sine")
+            this->data[0][x] = sin(phase * M_PI * 2.0);
+        else if (name == "saw")
+            this->data[0][x] = phase * 2.0 - 1.0;
+        else if (name == "square")
+            this->data[0][x] = (phase < 0.5) ? 1.0 : -1.0;
+        else if (name == "triangle")
+            this->data[0][x] = (phase < 0.5) ? (phase * 4.0 - 1.0) : (1.0 - (phase - 0.5) * 4.0);
+        else
+            throw std::runtime_error("Invalid wavetable name: " + name);
+    }
+
+    this->generate_levels();
+}
+
+int WavetableBuffer::get_num_levels()
+{
+    return this->num_levels;
+}
+
+void WavetableBuffer::generate_levels()
+{
+    int N = this->num_frames;
+    if (N < 2 || (N & (N - 1)) != 0)
+    {
+        throw std::runtime_error("WavetableBuffer length must be a power of two (got " + std::to_string(N) + ")");
+    }
+
+    /*------------------------------------------------------------------------
+     * Level k contains harmonics 1..(N / 2^(k+1)), so the final level
+     * is a pure sinusoid at the fundamental.
+     *-----------------------------------------------------------------------*/
+    int log2N = (int) round(log2((double) N));
+    this->num_levels = log2N;
+    this->levels.resize(this->num_levels);
+    for (int level = 0; level < this->num_levels; level++)
+    {
+        this->levels[level].resize(N + 2);
+    }
+
+    int num_bins = N / 2;
+
+#if defined(FFT_ACCELERATE)
+    FFTSetup fft_setup = vDSP_create_fftsetup(log2N, FFT_RADIX2);
+    std::vector<float> spectrum(N);
+    std::vector<float> level_spectrum(N);
+    DSPSplitComplex spectrum_split = { spectrum.data(), spectrum.data() + num_bins };
+    DSPSplitComplex level_split = { level_spectrum.data(), level_spectrum.data() + num_bins };
+
+    vDSP_ctoz((DSPComplex *) this->data[0], 2, &spectrum_split, 1, num_bins);
+    vDSP_fft_zrip(fft_setup, &spectrum_split, 1, log2N, FFT_FORWARD);
+
+    for (int level = 0; level < this->num_levels; level++)
+    {
+        int max_harmonic = num_bins >> level;
+        level_spectrum = spectrum;
+
+        /*------------------------------------------------------------------------
+         * vDSP packs the Nyquist bin into imagp[0].
+         *-----------------------------------------------------------------------*/
+        if (max_harmonic < num_bins)
+            level_split.imagp[0] = 0.0;
+        for (int bin = max_harmonic + 1; bin < num_bins; bin++)
+        {
+            level_split.realp[bin] = 0.0;
+            level_split.imagp[bin] = 0.0;
+        }
+
+        sample *level_data = this->levels[level].data();
+        vDSP_fft_zrip(fft_setup, &level_split, 1, log2N, FFT_INVERSE);
+        vDSP_ztoc(&level_split, 1, (DSPComplex *) level_data, 2, num_bins);
+
+        /*------------------------------------------------------------------------
+         * Scale down (forward and inverse transforms are each unnormalised)
+         *-----------------------------------------------------------------------*/
+        float scale = 1.0 / (2.0 * N);
+        vDSP_vsmul(level_data, 1, &scale, level_data, 1, N);
+    }
+
+    vDSP_destroy_fftsetup(fft_setup);
+
+#elif defined(FFT_FFTW)
+    float *fftw_input = (float *) fftwf_malloc(sizeof(float) * N);
+    float *fftw_output = (float *) fftwf_malloc(sizeof(float) * N);
+    fftwf_complex *spectrum = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * (num_bins + 1));
+    fftwf_complex *level_spectrum = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex) * (num_bins + 1));
+
+    fftwf_plan forward = fftwf_plan_dft_r2c_1d(N, fftw_input, spectrum, FFTW_ESTIMATE);
+    fftwf_plan inverse = fftwf_plan_dft_c2r_1d(N, level_spectrum, fftw_output, FFTW_ESTIMATE);
+
+    memcpy(fftw_input, this->data[0], sizeof(float) * N);
+    fftwf_execute(forward);
+
+    for (int level = 0; level < this->num_levels; level++)
+    {
+        int max_harmonic = num_bins >> level;
+        memcpy(level_spectrum, spectrum, sizeof(fftwf_complex) * (num_bins + 1));
+        for (int bin = max_harmonic + 1; bin <= num_bins; bin++)
+        {
+            level_spectrum[bin][0] = 0.0;
+            level_spectrum[bin][1] = 0.0;
+        }
+
+        fftwf_execute(inverse);
+
+        sample *level_data = this->levels[level].data();
+        for (int frame = 0; frame < N; frame++)
+        {
+            level_data[frame] = fftw_output[frame] / N;
+        }
+    }
+
+    fftwf_destroy_plan(forward);
+    fftwf_destroy_plan(inverse);
+    fftwf_free(fftw_input);
+    fftwf_free(fftw_output);
+    fftwf_free(spectrum);
+    fftwf_free(level_spectrum);
+
+#else
+    /*------------------------------------------------------------------------
+     * Without an FFT implementation, take a direct DFT. This is O(N^2), but
+     * only runs when the wavetable is created. Bin phases are looked up in
+     * a single-cycle cosine/sine table, as (bin * frame) mod N.
+     *-----------------------------------------------------------------------*/
+    std::vector<double> cosines(N);
+    std::vector<double> sines(N);
+    for (int index = 0; index < N; index++)
+    {
+        cosines[index] = cos(2.0 * M_PI * index / N);
+        sines[index] = sin(2.0 * M_PI * index / N);
+    }
+
+    std::vector<double> spectrum_real(num_bins + 1, 0.0);
+    std::vector<double> spectrum_imag(num_bins + 1, 0.0);
+    for (int bin = 0; bin <= num_bins; bin++)
+    {
+        for (int frame = 0; frame < N; frame++)
+        {
+            int index = (int) (((long long) bin * frame) % N);
+            spectrum_real[bin] += this->data[0][frame] * cosines[index];
+            spectrum_imag[bin] -= this->data[0][frame] * sines[index];
+        }
+    }
+
+    for (int level = 0; level < this->num_levels; level++)
+    {
+        int max_harmonic = num_bins >> level;
+        sample *level_data = this->levels[level].data();
+        for (int frame = 0; frame < N; frame++)
+        {
+            /*------------------------------------------------------------------------
+             * Inverse of the real DFT: bins other than DC and Nyquist stand
+             * for both themselves and their conjugates, so count twice.
+             *-----------------------------------------------------------------------*/
+            double value = spectrum_real[0];
+            for (int bin = 1; bin <= max_harmonic; bin++)
+            {
+                int index = (int) (((long long) bin * frame) % N);
+                double weight = (bin == num_bins) ? 1.0 : 2.0;
+                value += weight * (spectrum_real[bin] * cosines[index] - spectrum_imag[bin] * sines[index]);
+            }
+            level_data[frame] = (sample) (value / N);
+        }
+    }
+#endif
+
+    for (int level = 0; level < this->num_levels; level++)
+    {
+        this->levels[level][N] = this->levels[level][0];
+        this->levels[level][N + 1] = this->levels[level][1];
+    }
+}
+
+void WavetableBuffer::read(const float *phases, const float *increments, sample *out, int num_frames)
+{
+    int N = this->num_frames;
+    int max_level = this->num_levels - 1;
+
+    float last_increment = -1.0;
+    const sample *table_a = nullptr;
+    const sample *table_b = nullptr;
+    float crossfade = 0.0;
+
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        float increment = fabsf(increments[frame]);
+        if (increment != last_increment)
+        {
+            /*------------------------------------------------------------------------
+             * At a position x = log2(N * increment), level floor(x) + 1 is the
+             * first that contains no harmonics above Nyquist. Crossfade towards
+             * the next level up over the course of the octave, so that the
+             * spectrum changes continuously with frequency.
+             *-----------------------------------------------------------------------*/
+            int level_a = 0;
+            int level_b = 0;
+            crossfade = 0.0;
+            if (increment > 0)
+            {
+                float position = log2f(N * increment);
+                float position_floor = floorf(position);
+                level_a = (int) position_floor + 1;
+                level_b = level_a + 1;
+                crossfade = position - position_floor;
+                if (level_a < 0)
+                {
+                    level_a = level_b = 0;
+                }
+                level_a = MIN(level_a, max_level);
+                level_b = MAX(0, MIN(level_b, max_level));
+            }
+            table_a = this->levels[level_a].data();
+            table_b = this->levels[level_b].data();
+            last_increment = increment;
+        }
+
+        float index = phases[frame] * N;
+        int index_int = (int) index;
+        float index_frac = index - index_int;
+
+        float value_a = table_a[index_int] + index_frac * (table_a[index_int + 1] - table_a[index_int]);
+        float value_b = table_b[index_int] + index_frac * (table_b[index_int + 1] - table_b[index_int]);
+        out[frame] = value_a + crossfade * (value_b - value_a);
+    }
+}
+
+}
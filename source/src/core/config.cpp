@@ -109,6 +109,21 @@ AudioGraphConfig::AudioGraphConfig()
                 {
                     this->output_device_name = parameter_value;
                 }
+                else if (parameter_name == "flush_denormals")
+                {
+                    if (parameter_value == "true" || parameter_value == "1")
+                    {
+                        this->flush_denormals = true;
+                    }
+                    else if (parameter_value == "false" || parameter_value == "0")
+                    {
+                        this->flush_denormals = false;
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Invalid value for " + section_name + " > " + parameter_name + ": " + parameter_value);
+                    }
+                }
                 else
                 {
                     throw std::runtime_error("Invalid section parameter name: " + section_name + " > " + parameter_name);
@@ -172,6 +187,16 @@ void AudioGraphConfig::set_output_device_name(const std::string &name)
     this->output_device_name = name;
 }
 
+bool AudioGraphConfig::get_flush_denormals() const
+{
+    return this->flush_denormals;
+}
+
+void AudioGraphConfig::set_flush_denormals(bool flush_denormals)
+{
+    this->flush_denormals = flush_denormals;
+}
+
 void AudioGraphConfig::print() const
 {
     std::cout << "SignalFlow config" << std::endl;
@@ -181,6 +206,7 @@ void AudioGraphConfig::print() const
     std::cout << " - output_buffer_size = " << this->output_buffer_size << std::endl;
     std::cout << " - input_device_name = " << this->input_device_name << std::endl;
     std::cout << " - output_device_name = " << this->output_device_name << std::endl;
+    std::cout << " - flush_denormals = " << (this->flush_denormals ? "true" : "false") << std::endl;
 }
 
 }
@@ -10,13 +10,35 @@
 #include "signalflow/node/io/output/ios.h"
 #include "signalflow/node/io/output/soundio.h"
 
+#include <algorithm>
+#include <atomic>
 #include <limits.h>
+#include <math.h>
+#include <mutex>
 #include <string.h>
+#include <vector>
 
 namespace signalflow
 {
 
-AudioGraph *shared_graph = nullptr;
+/*------------------------------------------------------------------------
+ * All graphs that currently exist, in order of creation, and the most
+ * recently created, which is current on threads that have not selected
+ * a graph.
+ *-----------------------------------------------------------------------*/
+static std::vector<AudioGraph *> graphs;
+static std::mutex graphs_mutex;
+static std::atomic<AudioGraph *> default_graph(nullptr);
+
+/*------------------------------------------------------------------------
+ * The graph most recently made current on each thread. As it may since
+ * have been destroyed on another thread, each thread records the number
+ * of graphs destroyed when it last checked that its graph exists, and
+ * checks again only once another graph has been destroyed.
+ *-----------------------------------------------------------------------*/
+static std::atomic<long> graphs_destroyed(0);
+static thread_local AudioGraph *current_graph = nullptr;
+static thread_local long current_graph_checked = -1;
 
 AudioGraph::AudioGraph(AudioGraphConfig *config,
                        NodeRef output_device,
@@ -24,11 +46,12 @@ AudioGraph::AudioGraph(AudioGraphConfig *config,
 {
     signalflow_init();
 
-    if (shared_graph)
     {
-        throw graph_already_created_exception();
+        std::lock_guard<std::mutex> lock(graphs_mutex);
+        graphs.push_back(this);
+        default_graph = this;
     }
-    shared_graph = this;
+    this->make_current();
 
     if (config)
     {
@@ -37,7 +60,11 @@ AudioGraph::AudioGraph(AudioGraphConfig *config,
 
     if (output_device)
     {
+        /*------------------------------------------------------------------------
+         * The output device may have been created before this graph.
+         *-----------------------------------------------------------------------*/
         this->output = output_device;
+        this->output->graph = this;
     }
     else
     {
@@ -60,6 +87,14 @@ AudioGraph::AudioGraph(AudioGraphConfig *config,
     this->sample_rate = audio_out->get_sample_rate();
     this->node_count = 0;
     this->_node_count_tmp = 0;
+    this->control_rate_block = 0;
+    this->frames_rendered = 0;
+    this->events_cleared = false;
+    this->topology_version = 0;
+    this->feedback_regions_version = 0;
+    this->supports_sub_blocks = true;
+    this->sub_blocks_version = 0;
+    this->sub_block_check = 0;
     this->cpu_usage = 0.0;
     this->monitor = nullptr;
 
@@ -94,13 +129,76 @@ void AudioGraph::clear()
         audioout->remove_input(input);
     }
     this->node_count = 0;
+
+    /*------------------------------------------------------------------------
+     * Events already collected by the rendering thread are discarded by it
+     * at the start of the next block.
+     *-----------------------------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(this->events_mutex);
+    this->events_pending.clear();
+    this->events_to_release.clear();
+    this->events_cleared = true;
 }
 
 AudioGraph::~AudioGraph()
 {
     AudioOut_Abstract *audioout = (AudioOut_Abstract *) this->output.get();
     audioout->destroy();
-    shared_graph = nullptr;
+
+    std::lock_guard<std::mutex> lock(graphs_mutex);
+    graphs.erase(std::remove(graphs.begin(), graphs.end(), this), graphs.end());
+    graphs_destroyed++;
+    default_graph = graphs.empty() ? nullptr : graphs.back();
+    if (current_graph == this)
+    {
+        current_graph = nullptr;
+    }
+}
+
+AudioGraph *AudioGraph::get_current()
+{
+    /*------------------------------------------------------------------------
+     * This is called by every Node constructor, so only takes the lock if
+     * a graph has been destroyed since the thread's graph was last checked.
+     *-----------------------------------------------------------------------*/
+    if (current_graph)
+    {
+        if (current_graph_checked == graphs_destroyed.load())
+        {
+            return current_graph;
+        }
+
+        std::lock_guard<std::mutex> lock(graphs_mutex);
+        if (std::find(graphs.begin(), graphs.end(), current_graph) != graphs.end())
+        {
+            current_graph_checked = graphs_destroyed.load();
+            return current_graph;
+        }
+        current_graph = nullptr;
+    }
+    return default_graph.load();
+}
+
+void AudioGraph::make_current()
+{
+    current_graph = this;
+    current_graph_checked = graphs_destroyed.load();
+}
+
+AudioGraphContext::AudioGraphContext(AudioGraph *graph)
+    : previous(current_graph)
+{
+    current_graph = graph;
+    current_graph_checked = graphs_destroyed.load();
+}
+
+AudioGraphContext::~AudioGraphContext()
+{
+    /*------------------------------------------------------------------------
+     * The previous graph may have been destroyed within the context.
+     *-----------------------------------------------------------------------*/
+    current_graph = this->previous;
+    current_graph_checked = -1;
 }
 
 void AudioGraph::wait(float time)
@@ -125,75 +223,416 @@ void AudioGraph::render_subgraph(const NodeRef &node, int num_frames)
         return;
     }
 
-    if (!(node->inputs.size() > 0 || node->name == "constant" || node->name == "audioout" || node->name == "audioin"))
+    /*------------------------------------------------------------------------
+     * Feedback loops with a delay shorter than the block are rendered
+     * separately, in sub-blocks no longer than the delay.
+     *-----------------------------------------------------------------------*/
+    if (node->name == "feedback-buffer-writer" && this->render_feedback_subgraph(node, num_frames))
+    {
+        return;
+    }
+
+    if (!(node->input_slots.size() > 0 || node->name == "constant" || node->name == "audioout" || node->name == "audioin"))
     {
         signalflow_debug("Node %s has no registered inputs", node->name.c_str());
     }
 
+    /*------------------------------------------------------------------------
+     * Silence propagation.
+     *
+     * If the node is silent whenever any input is silent (e.g. Multiply),
+     * first render those inputs that were silent in the previous block,
+     * as they are the most likely to be silent again. As soon as one is
+     * found to be silent, the remaining input subgraphs are skipped.
+     *-----------------------------------------------------------------------*/
+    bool is_silent = false;
+    if (node->silent_if_any_input_silent)
+    {
+        for (size_t index = 0; index < node->input_slots.size(); index++)
+        {
+            const NodeRef &input_node = *node->input_slots[index];
+            if (input_node && input_node->is_silent && !(node->skips_inputs && node->skip_input((int) index)))
+            {
+                this->render_subgraph(input_node, num_frames);
+                if (input_node->is_silent)
+                {
+                    is_silent = true;
+                    break;
+                }
+            }
+        }
+    }
+
     /*------------------------------------------------------------------------
      * Pull our inputs before we generate our own outputs.
      *-----------------------------------------------------------------------*/
-    for (auto input : node->inputs)
+    for (size_t index = 0; index < node->input_slots.size(); index++)
     {
-        NodeRef input_node = *(input.second);
-        if (input_node)
+        const NodeRef &input_node = *node->input_slots[index];
+        if (input_node && !is_silent && !(node->skips_inputs && node->skip_input((int) index)))
         {
             this->render_subgraph(input_node, num_frames);
 
-            /*------------------------------------------------------------------------
-             * Automatic input upmix.
-             *
-             * If the input node produces less channels than demanded, automatically
-             * up-mix its output by replicating the existing channels. This allows
-             * operations between multi-channel and mono-channel inputs to work
-             * seamlessly without any additional implementation within the node
-             * itself (for example, Multiply(new SineOscillator(440), new LinearPanner(2, ...)))
-             *
-             * A few nodes must prevent automatic input up-mixing from happening.
-             * These include ChannelArray and AudioOut.
-             *
-             * Some partially-initialised nodes (e.g. BufferPlayer with a not-yet-
-             * populated Buffer) will have num_output_channels == 0. Don't try to
-             * upmix a void output.
-             *-----------------------------------------------------------------------*/
-            if (input_node->get_num_output_channels() < node->get_num_input_channels() && !node->no_input_upmix && input_node->get_num_output_channels() > 0)
+            if (node->silent_if_any_input_silent && input_node->is_silent)
+            {
+                is_silent = true;
+                break;
+            }
+
+            this->upmix_input(node.get(), input_node.get(), num_frames);
+        }
+    }
+
+    if (is_silent)
+    {
+        node->_process_silence(node->out, num_frames);
+    }
+    else if (this->resolve_control_rate(node.get()))
+    {
+        node->_process_control(node->out, num_frames);
+    }
+    else
+    {
+        node->_process(node->out, num_frames);
+    }
+
+    if (node->name != "constant")
+    {
+        node->has_rendered = true;
+        this->_node_count_tmp++;
+    }
+}
+
+bool AudioGraph::resolve_control_rate(Node *node)
+{
+    if (node->control_rate_block == this->control_rate_block)
+    {
+        return node->is_control_rate;
+    }
+
+    /*------------------------------------------------------------------------
+     * Mark the node as audio-rate while its outputs are resolved, so that
+     * a cycle resolves to audio rate rather than recursing indefinitely.
+     *-----------------------------------------------------------------------*/
+    node->control_rate_block = this->control_rate_block;
+    node->is_control_rate = false;
+
+    if (!node->supports_control_rate || node->outputs.empty())
+    {
+        return false;
+    }
+
+    for (auto output : node->outputs)
+    {
+        Node *target = output.first;
+        if (target->get_input_rate(output.second) != SIGNALFLOW_INPUT_RATE_CONTROL && !this->resolve_control_rate(target))
+        {
+            return false;
+        }
+    }
+
+    node->is_control_rate = true;
+    return true;
+}
+
+void AudioGraph::upmix_input(Node *node, Node *input_node, int num_frames)
+{
+    /*------------------------------------------------------------------------
+     * Automatic input upmix.
+     *
+     * If the input node produces less channels than demanded, automatically
+     * up-mix its output by replicating the existing channels. This allows
+     * operations between multi-channel and mono-channel inputs to work
+     * seamlessly without any additional implementation within the node
+     * itself (for example, Multiply(new SineOscillator(440), new LinearPanner(2, ...)))
+     *
+     * A few nodes must prevent automatic input up-mixing from happening.
+     * These include ChannelArray and AudioOut.
+     *
+     * Some partially-initialised nodes (e.g. BufferPlayer with a not-yet-
+     * populated Buffer) will have num_output_channels == 0. Don't try to
+     * upmix a void output.
+     *-----------------------------------------------------------------------*/
+    if (input_node->get_num_output_channels() < node->get_num_input_channels() && !node->no_input_upmix && input_node->get_num_output_channels() > 0)
+    {
+        signalflow_debug("Upmixing %s (%s wants %d channels, %s only produces %d)", input_node->name.c_str(),
+                         node->name.c_str(), node->get_num_input_channels(), input_node->name.c_str(), input_node->get_num_output_channels());
+
+        /*------------------------------------------------------------------------
+         * Ensure the input node's output buffer re-allocation has been done.
+         * Reallocation for inputs is automatically done in Node::update_channels.
+         *-----------------------------------------------------------------------*/
+        if (input_node->get_num_output_channels_allocated() < node->get_num_input_channels())
+        {
+            throw std::runtime_error("Input node does not have enough buffers allocated (need " + std::to_string(node->get_num_input_channels()) + ", got " + std::to_string(input_node->get_num_output_channels_allocated()));
+        }
+
+        /*------------------------------------------------------------------------
+         * If we generate 2 channels but have 6 channels demanded, repeat
+         * them: [ 0, 1, 0, 1, 0, 1 ]
+         *-----------------------------------------------------------------------*/
+        for (int out_channel_index = input_node->get_num_output_channels();
+             out_channel_index < node->get_num_input_channels();
+             out_channel_index++)
+        {
+            int in_channel_index = out_channel_index % input_node->get_num_output_channels();
+            memcpy(input_node->out[out_channel_index],
+                   input_node->out[in_channel_index],
+                   num_frames * sizeof(sample));
+        }
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Render a FeedbackBufferWriter whose delay is shorter than the block.
+ *
+ * The feedback region is the set of nodes between the writer and the
+ * FeedbackBufferReaders of the same buffer. Everything that the region
+ * reads from outside it is rendered for the whole block first. The region
+ * is then rendered in sub-blocks no longer than the shortest delay, down
+ * to a single sample, so that every sample a reader reads has been written
+ * in an earlier sub-block.
+ *
+ * Each sub-block is rendered in place, by advancing the output pointers of
+ * the region and its inputs past the frames that have been rendered.
+ *
+ * Returns false if the writer should be rendered as normal, because its
+ * delay is at least a block long, or its loop could not be isolated.
+ *-----------------------------------------------------------------------*/
+bool AudioGraph::render_feedback_subgraph(const NodeRef &writer, int num_frames)
+{
+    NodeRef input = writer->get_input("input");
+    NodeRef delay_time = writer->get_input("delay_time");
+    BufferRef buffer = *(writer->buffers["buffer"]);
+    if (!input || !delay_time || !buffer || !buffer->get_num_frames())
+    {
+        return false;
+    }
+
+    this->render_subgraph(delay_time, num_frames);
+    float min_delay_time = std::numeric_limits<float>::max();
+    for (int channel = 0; channel < writer->get_num_input_channels(); channel++)
+    {
+        int delay_channel = channel % MAX(delay_time->get_num_output_channels(), 1);
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            min_delay_time = MIN(min_delay_time, delay_time->out[delay_channel][frame]);
+        }
+    }
+    int delay_samples = (int) (min_delay_time * this->sample_rate);
+    if (delay_samples >= num_frames || delay_samples < 1)
+    {
+        return false;
+    }
+
+    /*------------------------------------------------------------------------
+     * The region is found once per topology, and cached until a node's
+     * inputs or buffers next change.
+     *-----------------------------------------------------------------------*/
+    unsigned int topology_version = this->topology_version.load();
+    if (topology_version != this->feedback_regions_version)
+    {
+        this->feedback_regions.clear();
+        this->feedback_regions_version = topology_version;
+    }
+    auto cached_region = this->feedback_regions.find(writer.get());
+    if (cached_region == this->feedback_regions.end())
+    {
+        cached_region = this->feedback_regions.emplace(writer.get(), FeedbackRegion()).first;
+        this->build_feedback_region(cached_region->second, writer, buffer.get());
+    }
+    FeedbackRegion &region = cached_region->second;
+    if (!region.isolated)
+    {
+        return false;
+    }
+
+    /*------------------------------------------------------------------------
+     * If any part of the region has already been rendered this block, a
+     * reader has already read ahead of the writer, so the loop cannot be
+     * isolated.
+     *-----------------------------------------------------------------------*/
+    for (Node *node : region.nodes)
+    {
+        if (node->has_rendered)
+        {
+            return false;
+        }
+    }
+
+    for (NodeRef *input_node : region.inputs)
+    {
+        this->render_subgraph(*input_node, num_frames);
+    }
+
+    /*------------------------------------------------------------------------
+     * The last_sample of inputs is updated per sub-block for trigger
+     * detection, so keep the values for the whole block to restore.
+     *-----------------------------------------------------------------------*/
+    this->feedback_saved_last_sample.clear();
+    for (NodeRef *input_node : region.inputs)
+    {
+        for (int channel = 0; channel < (*input_node)->get_num_output_channels_allocated(); channel++)
+        {
+            this->feedback_saved_last_sample.push_back((*input_node)->last_sample[channel]);
+        }
+    }
+
+    int offset = 0;
+    while (true)
+    {
+        int sub_block_frames = MIN(delay_samples, num_frames - offset);
+        for (Node *node : region.nodes)
+        {
+            for (NodeRef *node_input : node->input_slots)
             {
-                signalflow_debug("Upmixing %s (%s wants %d channels, %s only produces %d)", input_node->name.c_str(),
-                                 node->name.c_str(), node->get_num_input_channels(), input_node->name.c_str(), input_node->get_num_output_channels());
-
-                /*------------------------------------------------------------------------
-                 * Ensure the input node's output buffer re-allocation has been done.
-                 * Reallocation for inputs is automatically done in Node::update_channels.
-                 *-----------------------------------------------------------------------*/
-                if (input_node->get_num_output_channels_allocated() < node->get_num_input_channels())
+                Node *input_node = node_input->get();
+                if (input_node)
                 {
-                    throw std::runtime_error("Input node does not have enough buffers allocated (need " + std::to_string(node->get_num_input_channels()) + ", got " + std::to_string(input_node->get_num_output_channels_allocated()));
+                    this->upmix_input(node, input_node, sub_block_frames);
                 }
+            }
+            node->_process(node->out, sub_block_frames);
+        }
+
+        if (offset + sub_block_frames >= num_frames)
+        {
+            break;
+        }
+        offset += sub_block_frames;
+        this->offset_feedback_region(region, sub_block_frames);
+    }
+    this->offset_feedback_region(region, -offset);
+
+    int saved_index = 0;
+    for (NodeRef *input_node : region.inputs)
+    {
+        for (int channel = 0; channel < (*input_node)->get_num_output_channels_allocated(); channel++)
+        {
+            (*input_node)->last_sample[channel] = this->feedback_saved_last_sample[saved_index++];
+        }
+    }
+    for (Node *node : region.nodes)
+    {
+        node->last_num_frames = num_frames;
+        node->has_rendered = true;
+        this->_node_count_tmp++;
+    }
+
+    return true;
+}
 
-                /*------------------------------------------------------------------------
-                 * If we generate 2 channels but have 6 channels demanded, repeat
-                 * them: [ 0, 1, 0, 1, 0, 1 ]
-                 *-----------------------------------------------------------------------*/
-                for (int out_channel_index = input_node->get_num_output_channels();
-                     out_channel_index < node->get_num_input_channels();
-                     out_channel_index++)
+/*------------------------------------------------------------------------
+ * Collect the feedback region of writer in dependency order, ending with
+ * the writer, followed by the slots through which the region reads from
+ * nodes outside it.
+ *-----------------------------------------------------------------------*/
+void AudioGraph::build_feedback_region(FeedbackRegion &region, const NodeRef &writer, Buffer *buffer)
+{
+    this->feedback_region_visited.clear();
+    region.isolated = this->find_feedback_region(region, writer->get_input("input").get(), buffer);
+    if (!region.isolated)
+    {
+        region.nodes.clear();
+        return;
+    }
+    region.nodes.push_back(writer.get());
+    this->feedback_region_visited[writer.get()] = true;
+    for (Node *node : region.nodes)
+    {
+        if (!node->supports_sub_blocks)
+        {
+            region.isolated = false;
+        }
+    }
+
+    for (Node *node : region.nodes)
+    {
+        for (NodeRef *node_input : node->input_slots)
+        {
+            Node *input_node = node_input->get();
+            if (input_node && !this->feedback_region_visited[input_node] &&
+                std::find_if(region.inputs.begin(), region.inputs.end(),
+                             [input_node](NodeRef *other) { return other->get() == input_node; }) == region.inputs.end())
+            {
+                region.inputs.push_back(node_input);
+                if (!input_node->supports_sub_blocks)
                 {
-                    int in_channel_index = out_channel_index % input_node->get_num_output_channels();
-                    memcpy(input_node->out[out_channel_index],
-                           input_node->out[in_channel_index],
-                           num_frames * sizeof(sample));
+                    region.isolated = false;
                 }
             }
         }
     }
+}
 
-    node->_process(node->out, num_frames);
+/*------------------------------------------------------------------------
+ * Returns whether node depends on a FeedbackBufferReader of buffer,
+ * appending each node that does to the region after its inputs.
+ *-----------------------------------------------------------------------*/
+bool AudioGraph::find_feedback_region(FeedbackRegion &region, Node *node, Buffer *buffer)
+{
+    auto visited = this->feedback_region_visited.find(node);
+    if (visited != this->feedback_region_visited.end())
+    {
+        return visited->second;
+    }
+    this->feedback_region_visited[node] = false;
 
-    if (node->name != "constant")
+    bool depends_on_reader = false;
+    if (node->name == "feedback-buffer-reader")
     {
-        node->has_rendered = true;
-        this->_node_count_tmp++;
+        auto reader_buffer = node->buffers.find("buffer");
+        depends_on_reader = (reader_buffer != node->buffers.end() && reader_buffer->second->get() == buffer);
+    }
+    for (NodeRef *input : node->input_slots)
+    {
+        Node *input_node = input->get();
+        if (input_node && this->find_feedback_region(region, input_node, buffer))
+        {
+            depends_on_reader = true;
+        }
     }
+
+    this->feedback_region_visited[node] = depends_on_reader;
+    if (depends_on_reader)
+    {
+        region.nodes.push_back(node);
+    }
+    return depends_on_reader;
+}
+
+/*------------------------------------------------------------------------
+ * Advance the output buffers of the feedback region and its inputs by
+ * num_frames, so that out[-1] refers to the last frame rendered.
+ * A negative num_frames rewinds them to the start of the block, in which
+ * case last_sample is restored by the caller instead.
+ *-----------------------------------------------------------------------*/
+void AudioGraph::offset_feedback_region(FeedbackRegion &region, int num_frames)
+{
+    for (Node *node : region.nodes)
+    {
+        for (int channel = 0; channel < node->get_num_output_channels_allocated(); channel++)
+        {
+            node->out.data[channel] += num_frames;
+        }
+        node->last_num_frames = 0;
+    }
+    for (NodeRef *input_node : region.inputs)
+    {
+        for (int channel = 0; channel < (*input_node)->get_num_output_channels_allocated(); channel++)
+        {
+            (*input_node)->out.data[channel] += num_frames;
+            if (num_frames > 0)
+            {
+                (*input_node)->last_sample[channel] = (*input_node)->out.data[channel][-1];
+            }
+        }
+    }
+}
+
+void AudioGraph::invalidate_topology()
+{
+    this->topology_version++;
 }
 
 void AudioGraph::reset_graph()
@@ -209,6 +648,31 @@ void AudioGraph::reset_graph()
     }
     nodes_to_replace.clear();
 
+    /*------------------------------------------------------------------------
+     * Apply any patch inputs queued since the last block, all at once.
+     * If another thread holds a lock, the inputs are applied at the start
+     * of a later block rather than waiting for it.
+     *-----------------------------------------------------------------------*/
+    {
+        std::unique_lock<std::mutex> lock(this->patch_inputs_mutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            size_t num_remaining = 0;
+            for (auto patch : this->patches_with_queued_inputs)
+            {
+                if (patch->apply_queued_inputs())
+                {
+                    patch->has_queued_inputs = false;
+                }
+                else
+                {
+                    this->patches_with_queued_inputs[num_remaining++] = patch;
+                }
+            }
+            this->patches_with_queued_inputs.resize(num_remaining);
+        }
+    }
+
     /*------------------------------------------------------------------------
      * Disconnect any nodes and patches that are scheduled to be removed.
      *-----------------------------------------------------------------------*/
@@ -238,9 +702,12 @@ void AudioGraph::reset_graph()
     }
 
     /*------------------------------------------------------------------------
-     * Clear the record of processed nodes.
+     * Clear the record of processed nodes. The graph's structure may have
+     * changed since the last render, so also invalidate the cached
+     * control-rate status of every node.
      *-----------------------------------------------------------------------*/
     this->_node_count_tmp = 0;
+    this->control_rate_block++;
     this->reset_subgraph(this->output);
     for (auto node : this->scheduled_nodes)
     {
@@ -251,9 +718,9 @@ void AudioGraph::reset_graph()
 void AudioGraph::reset_subgraph(NodeRef node)
 {
     node->has_rendered = false;
-    for (auto input : node->inputs)
+    for (NodeRef *input : node->input_slots)
     {
-        NodeRef input_node = *(input.second);
+        const NodeRef &input_node = *input;
         if (input_node && input_node->has_rendered)
         {
             this->reset_subgraph(input_node);
@@ -261,6 +728,93 @@ void AudioGraph::reset_subgraph(NodeRef node)
     }
 }
 
+/*------------------------------------------------------------------------
+ * Move the output pointers of node and its inputs to offset frames from
+ * the start of their buffers. A node that is already at offset has been
+ * visited, along with its inputs.
+ *-----------------------------------------------------------------------*/
+void AudioGraph::offset_subgraph(Node *node, int offset, int last_num_frames)
+{
+    if (node->block_offset == offset)
+    {
+        return;
+    }
+    if (node->supports_sub_blocks)
+    {
+        for (int channel = 0; channel < node->get_num_output_channels_allocated(); channel++)
+        {
+            node->out.data[channel] += offset - node->block_offset;
+        }
+        node->last_num_frames = last_num_frames;
+    }
+    node->block_offset = offset;
+
+    for (NodeRef *input : node->input_slots)
+    {
+        Node *input_node = input->get();
+        if (input_node)
+        {
+            this->offset_subgraph(input_node, offset, last_num_frames);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Move the output pointers of every node in the graph. Advancing them
+ * with last_num_frames = 0 means that out[-1] is the last frame of the
+ * previous sub-block, which is read for trigger detection.
+ *-----------------------------------------------------------------------*/
+void AudioGraph::offset_graph(int offset, int last_num_frames)
+{
+    this->offset_subgraph(this->output.get(), offset, last_num_frames);
+    for (auto node : this->scheduled_nodes)
+    {
+        this->offset_subgraph(node.get(), offset, last_num_frames);
+    }
+}
+
+bool AudioGraph::can_divide_blocks()
+{
+    unsigned int topology_version = this->topology_version.load();
+    if (topology_version != this->sub_blocks_version)
+    {
+        this->sub_block_check++;
+        this->supports_sub_blocks = this->subgraph_supports_sub_blocks(this->output.get());
+        for (auto node : this->scheduled_nodes)
+        {
+            if (!this->subgraph_supports_sub_blocks(node.get()))
+            {
+                this->supports_sub_blocks = false;
+            }
+        }
+        this->sub_blocks_version = topology_version;
+    }
+    return this->supports_sub_blocks;
+}
+
+bool AudioGraph::subgraph_supports_sub_blocks(Node *node)
+{
+    if (node->sub_block_check == this->sub_block_check)
+    {
+        return true;
+    }
+    node->sub_block_check = this->sub_block_check;
+    if (!node->supports_sub_blocks)
+    {
+        return false;
+    }
+
+    for (NodeRef *input : node->input_slots)
+    {
+        Node *input_node = input->get();
+        if (input_node && !this->subgraph_supports_sub_blocks(input_node))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 void AudioGraph::render(int num_frames)
 {
     /*------------------------------------------------------------------------
@@ -268,14 +822,60 @@ void AudioGraph::render(int num_frames)
      *-----------------------------------------------------------------------*/
     double t0 = signalflow_timestamp();
 
+    /*------------------------------------------------------------------------
+     * render() may be called from the audio I/O thread, or from any thread
+     * rendering offline, so set the floating-point state on every call.
+     *-----------------------------------------------------------------------*/
+    ScopedFlushDenormals flush_denormals(this->config.get_flush_denormals());
+
+    /*------------------------------------------------------------------------
+     * Apply changes to the graph's structure once per block, so that it is
+     * the same in every sub-block.
+     *-----------------------------------------------------------------------*/
     this->reset_graph();
-    this->render_subgraph(this->output, num_frames);
-    for (auto node : this->scheduled_nodes)
+    this->collect_events();
+
+    /*------------------------------------------------------------------------
+     * Divide the block into sub-blocks at the frame of each scheduled event
+     * that falls within it. If there are none, or the graph cannot be
+     * rendered in sub-blocks, render the whole block in a single pass.
+     *-----------------------------------------------------------------------*/
+    bool can_divide = this->events.empty() || this->can_divide_blocks();
+    int offset = 0;
+    bool divided = false;
+    while (true)
     {
-        this->render_subgraph(node, num_frames);
+        this->dispatch_events(this->frames_rendered + (can_divide ? offset : num_frames - 1));
+        int sub_block_frames = num_frames - offset;
+        if (!this->events.empty() && this->events.front().frame < this->frames_rendered + num_frames)
+        {
+            sub_block_frames = (int) (this->events.front().frame - this->frames_rendered - offset);
+        }
+
+        if (offset > 0)
+        {
+            this->_node_count_tmp = 0;
+            this->reset_subgraph(this->output);
+            for (auto node : this->scheduled_nodes)
+            {
+                this->reset_subgraph(node);
+            }
+        }
+        this->render_block(sub_block_frames);
+
+        offset += sub_block_frames;
+        if (offset >= num_frames)
+        {
+            break;
+        }
+        this->offset_graph(offset, 0);
+        divided = true;
     }
-    this->node_count = this->_node_count_tmp;
-    signalflow_debug("AudioGraph: pull %d frames, %d nodes", num_frames, this->node_count);
+    if (divided)
+    {
+        this->offset_graph(0, num_frames);
+    }
+    this->frames_rendered += num_frames;
 
     if (this->recording_fd)
     {
@@ -308,6 +908,166 @@ void AudioGraph::render(int num_frames)
     }
 }
 
+void AudioGraph::render_block(int num_frames)
+{
+    /*------------------------------------------------------------------------
+     * Render feedback loops before anything else, so that nodes within a
+     * loop are not rendered as part of another subgraph before the loop's
+     * FeedbackBufferWriter has had a chance to render them sample-accurately.
+     *-----------------------------------------------------------------------*/
+    for (NodeRef *input : this->output->input_slots)
+    {
+        const NodeRef &input_node = *input;
+        if (input_node && input_node->name == "feedback-buffer-writer")
+        {
+            this->render_subgraph(input_node, num_frames);
+        }
+    }
+    for (auto node : this->scheduled_nodes)
+    {
+        if (node->name == "feedback-buffer-writer")
+        {
+            this->render_subgraph(node, num_frames);
+        }
+    }
+
+    this->render_subgraph(this->output, num_frames);
+    for (auto node : this->scheduled_nodes)
+    {
+        this->render_subgraph(node, num_frames);
+    }
+    this->node_count = this->_node_count_tmp;
+    signalflow_debug("AudioGraph: pull %d frames, %d nodes", num_frames, this->node_count);
+}
+
+void AudioGraph::schedule_event(const AudioGraphEvent &event)
+{
+    std::lock_guard<std::mutex> lock(this->events_mutex);
+    this->events_to_release.clear();
+    this->events_pending.push_back(event);
+}
+
+void AudioGraph::collect_events()
+{
+    /*------------------------------------------------------------------------
+     * If another thread is scheduling an event, collect it at the start of
+     * the next block rather than waiting for the lock.
+     *-----------------------------------------------------------------------*/
+    std::unique_lock<std::mutex> lock(this->events_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return;
+    }
+
+    this->events_to_release.splice(this->events_to_release.end(), this->events_dispatched);
+    if (this->events_cleared)
+    {
+        this->events_to_release.splice(this->events_to_release.end(), this->events);
+        this->events_cleared = false;
+    }
+
+    /*------------------------------------------------------------------------
+     * Keep events ordered by frame, and events at the same frame in the
+     * order they were scheduled.
+     *-----------------------------------------------------------------------*/
+    while (!this->events_pending.empty())
+    {
+        auto event = this->events_pending.begin();
+        auto position = std::find_if(this->events.begin(), this->events.end(),
+                                     [&event](const AudioGraphEvent &other) { return other.frame > event->frame; });
+        this->events.splice(position, this->events_pending, event);
+    }
+}
+
+void AudioGraph::dispatch_events(long long frame)
+{
+    while (!this->events.empty() && this->events.front().frame <= frame)
+    {
+        /*------------------------------------------------------------------------
+         * Move the event out of the queue before dispatching it, so that it
+         * is not dispatched again if dispatching it throws.
+         *-----------------------------------------------------------------------*/
+        this->events_dispatched.splice(this->events_dispatched.end(), this->events, this->events.begin());
+        AudioGraphEvent &event = this->events_dispatched.back();
+        if (event.type == SIGNALFLOW_GRAPH_EVENT_TRIGGER)
+        {
+            event.node->trigger(event.name, event.value);
+        }
+        else if (event.type == SIGNALFLOW_GRAPH_EVENT_RESET_PATCH)
+        {
+            event.patch->reset();
+        }
+        else
+        {
+            Constant *constant = (Constant *) event.node.get();
+            constant->value = event.value;
+        }
+    }
+}
+
+void AudioGraph::schedule_trigger(NodeRef node, double time, std::string name, float value)
+{
+    long long frame = llround(time * this->sample_rate);
+    this->schedule_event(AudioGraphEvent(frame, SIGNALFLOW_GRAPH_EVENT_TRIGGER, node, name, value));
+}
+
+void AudioGraph::schedule_set_input(NodeRef node, double time, std::string name, float value)
+{
+    int index = node->get_input_index(name);
+    if (index < 0)
+    {
+        throw std::runtime_error("Node " + node->name + " has no such input: " + name);
+    }
+    NodeRef input = node->get_input(index);
+    if (!input || !input->is_constant)
+    {
+        throw std::runtime_error("Node " + node->name + ": Input " + name + " must be a Constant to schedule a change to its value");
+    }
+    this->schedule_set_value(input, time, value);
+}
+
+void AudioGraph::schedule_set_value(NodeRef constant, double time, float value)
+{
+    if (!constant || !constant->is_constant)
+    {
+        throw std::runtime_error("AudioGraph: Can only schedule a change to the value of a Constant");
+    }
+    long long frame = llround(time * this->sample_rate);
+    this->schedule_event(AudioGraphEvent(frame, SIGNALFLOW_GRAPH_EVENT_SET_INPUT, constant, "value", value));
+}
+
+void AudioGraph::schedule_patch_reset(PatchRef patch, double time)
+{
+    long long frame = llround(time * this->sample_rate);
+    this->schedule_event(AudioGraphEvent(frame, patch));
+}
+
+void AudioGraph::schedule_patch_inputs(Patch *patch)
+{
+    std::lock_guard<std::mutex> lock(this->patch_inputs_mutex);
+    if (!patch->has_queued_inputs)
+    {
+        this->patches_with_queued_inputs.push_back(patch);
+        patch->has_queued_inputs = true;
+    }
+}
+
+void AudioGraph::cancel_patch_inputs(Patch *patch)
+{
+    std::lock_guard<std::mutex> lock(this->patch_inputs_mutex);
+    if (patch->has_queued_inputs)
+    {
+        auto &patches = this->patches_with_queued_inputs;
+        patches.erase(std::remove(patches.begin(), patches.end(), patch), patches.end());
+        patch->has_queued_inputs = false;
+    }
+}
+
+double AudioGraph::get_time()
+{
+    return (double) this->frames_rendered / this->sample_rate;
+}
+
 void AudioGraph::render_to_buffer(BufferRef buffer, int block_size)
 {
     // TODO get_num_output_channels()
@@ -349,12 +1109,14 @@ std::list<NodeRef> AudioGraph::get_outputs()
 NodeRef AudioGraph::add_node(NodeRef node)
 {
     this->scheduled_nodes.insert(node);
+    this->invalidate_topology();
     return node;
 }
 
 void AudioGraph::remove_node(NodeRef node)
 {
     this->scheduled_nodes.erase(node);
+    this->invalidate_topology();
 }
 
 void AudioGraph::play(PatchRef patch)
@@ -444,19 +1206,20 @@ std::string AudioGraph::get_structure(NodeRef &root, int depth)
     std::string structure;
     structure += std::string(depth * 3, ' ');
     structure += " * " + root->name + "\n";
-    for (auto pair : root->inputs)
+    for (size_t index = 0; index < root->input_slots.size(); index++)
     {
         structure += std::string((depth + 1) * 3, ' ');
 
-        NodeRef param_node = *(pair.second);
+        const std::string &input_name = root->input_names[index];
+        NodeRef param_node = *(root->input_slots[index]);
         if (param_node->name == "constant")
         {
             Constant *constant = (Constant *) (param_node.get());
-            structure += pair.first + ": " + std::to_string(constant->value) + "\n";
+            structure += input_name + ": " + std::to_string(constant->value) + "\n";
         }
         else
         {
-            structure += pair.first + ":" + "\n";
+            structure += input_name + ":" + "\n";
             structure += this->get_structure(param_node, depth + 1);
         }
     }
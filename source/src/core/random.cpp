@@ -4,17 +4,22 @@
 
 #include "signalflow/core/random.h"
 #include "signalflow/core/util.h"
+#include <mutex>
 #include <random>
 
 #include <limits.h>
+#include <math.h>
 
 namespace signalflow
 {
 
 /*--------------------------------------------------------------------*
- * Maintain a single global RNG state object.
+ * Maintain a single global RNG state object. As it may be used from
+ * multiple threads (for example, when rendering several graphs at
+ * once), access to it is serialised.
  *--------------------------------------------------------------------*/
 std::mt19937 rng;
+std::mutex rng_mutex;
 
 /*--------------------------------------------------------------------*
  * random_init(): Initialise pseudo-random number generator.
@@ -27,6 +32,7 @@ void random_init()
 
 void random_seed(long seed)
 {
+    std::lock_guard<std::mutex> lock(rng_mutex);
     rng.seed(seed);
 }
 
@@ -41,6 +47,7 @@ double random_gaussian(double mean, double sd)
 
 double random_gaussian()
 {
+    std::lock_guard<std::mutex> lock(rng_mutex);
     return std::normal_distribution<double>(0, 1)(rng);
 }
 
@@ -49,6 +56,7 @@ double random_gaussian()
  *--------------------------------------------------------------------*/
 double random_uniform()
 {
+    std::lock_guard<std::mutex> lock(rng_mutex);
     return std::uniform_real_distribution<double>(0, 1)(rng);
 }
 
@@ -67,6 +75,7 @@ bool random_coin(double limit = 0.5)
 
 float random_exponential(float mu)
 {
+    std::lock_guard<std::mutex> lock(rng_mutex);
     return std::exponential_distribution<double>(mu)(rng);
 }
 
@@ -83,4 +92,219 @@ unsigned long random_integer(unsigned long from, unsigned long to)
     return from + (((long) random_uniform(0, to)) % (to - from));
 }
 
+/*--------------------------------------------------------------------*
+ * Philox4x32-10 constants (Salmon et al., "Parallel Random Numbers:
+ * As Easy as 1, 2, 3", SC11).
+ *--------------------------------------------------------------------*/
+#define SIGNALFLOW_PHILOX_M0 0xD2511F53
+#define SIGNALFLOW_PHILOX_M1 0xCD9E8D57
+#define SIGNALFLOW_PHILOX_W0 0x9E3779B9
+#define SIGNALFLOW_PHILOX_W1 0xBB67AE85
+#define SIGNALFLOW_PHILOX_ROUNDS 10
+
+/*--------------------------------------------------------------------*
+ * Convert a 32-bit word to a float in the open interval (0, 1),
+ * using the top 23 bits so that the result is exact.
+ *--------------------------------------------------------------------*/
+static inline float random_word_to_unit(uint32_t word)
+{
+    return ((float) (word >> 9) + 0.5f) * (1.0f / 8388608.0f);
+}
+
+/*--------------------------------------------------------------------*
+ * Apply one Philox round to every lane.
+ *--------------------------------------------------------------------*/
+static void philox_round(uint32_t *c0, uint32_t *c1, uint32_t *c2, uint32_t *c3, uint32_t k0, uint32_t k1)
+{
+    for (int lane = 0; lane < SIGNALFLOW_RANDOM_STREAM_LANES; lane++)
+    {
+        uint64_t p0 = (uint64_t) SIGNALFLOW_PHILOX_M0 * c0[lane];
+        uint64_t p1 = (uint64_t) SIGNALFLOW_PHILOX_M1 * c2[lane];
+        uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1[lane] ^ k0;
+        uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3[lane] ^ k1;
+        c1[lane] = (uint32_t) p1;
+        c3[lane] = (uint32_t) p0;
+        c0[lane] = n0;
+        c2[lane] = n2;
+    }
+}
+
+RandomStream::RandomStream(uint64_t seed, uint32_t stream)
+{
+    this->seed(seed, stream);
+}
+
+void RandomStream::seed(uint64_t seed, uint32_t stream)
+{
+    this->key[0] = (uint32_t) seed;
+    this->key[1] = (uint32_t) (seed >> 32);
+    this->stream = stream;
+    this->seek(0);
+}
+
+void RandomStream::seek(uint64_t position)
+{
+    this->buffer_counter = position / 4;
+    this->buffer_position = (int) (position % 4);
+    this->generate(this->buffer_counter, this->buffer, SIGNALFLOW_RANDOM_STREAM_LANES);
+}
+
+uint64_t RandomStream::get_position() const
+{
+    return this->buffer_counter * 4 + this->buffer_position;
+}
+
+void RandomStream::generate(uint64_t counter, uint32_t *out, int num_counters)
+{
+    uint32_t c0[SIGNALFLOW_RANDOM_STREAM_LANES];
+    uint32_t c1[SIGNALFLOW_RANDOM_STREAM_LANES];
+    uint32_t c2[SIGNALFLOW_RANDOM_STREAM_LANES];
+    uint32_t c3[SIGNALFLOW_RANDOM_STREAM_LANES];
+
+    for (int start = 0; start < num_counters; start += SIGNALFLOW_RANDOM_STREAM_LANES)
+    {
+        for (int lane = 0; lane < SIGNALFLOW_RANDOM_STREAM_LANES; lane++)
+        {
+            uint64_t lane_counter = counter + start + lane;
+            c0[lane] = (uint32_t) lane_counter;
+            c1[lane] = (uint32_t) (lane_counter >> 32);
+            c2[lane] = this->stream;
+            c3[lane] = 0;
+        }
+
+        uint32_t k0 = this->key[0];
+        uint32_t k1 = this->key[1];
+        for (int round = 0; round < SIGNALFLOW_PHILOX_ROUNDS; round++)
+        {
+            philox_round(c0, c1, c2, c3, k0, k1);
+            k0 += SIGNALFLOW_PHILOX_W0;
+            k1 += SIGNALFLOW_PHILOX_W1;
+        }
+
+        int lanes = MIN(SIGNALFLOW_RANDOM_STREAM_LANES, num_counters - start);
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            uint32_t *words = out + (start + lane) * 4;
+            words[0] = c0[lane];
+            words[1] = c1[lane];
+            words[2] = c2[lane];
+            words[3] = c3[lane];
+        }
+    }
+}
+
+uint32_t RandomStream::next()
+{
+    if (this->buffer_position == SIGNALFLOW_RANDOM_STREAM_LANES * 4)
+    {
+        this->buffer_counter += SIGNALFLOW_RANDOM_STREAM_LANES;
+        this->generate(this->buffer_counter, this->buffer, SIGNALFLOW_RANDOM_STREAM_LANES);
+        this->buffer_position = 0;
+    }
+    return this->buffer[this->buffer_position++];
+}
+
+float RandomStream::uniform()
+{
+    return random_word_to_unit(this->next());
+}
+
+float RandomStream::uniform(float from, float to)
+{
+    return from + this->uniform() * (to - from);
+}
+
+float RandomStream::gaussian(float mean, float sigma)
+{
+    /*--------------------------------------------------------------------*
+     * Box-Muller transform, using only the cosine term so that each
+     * value depends on exactly two words.
+     *--------------------------------------------------------------------*/
+    float u0 = this->uniform();
+    float u1 = this->uniform();
+    return mean + sigma * (sqrtf(-2.0f * logf(u0)) * cosf(2.0f * (float) M_PI * u1));
+}
+
+float RandomStream::exponential(float lambda)
+{
+    return -logf(this->uniform()) / lambda;
+}
+
+uint32_t RandomStream::integer(uint32_t count)
+{
+    return (uint32_t) (((uint64_t) this->next() * count) >> 32);
+}
+
+void RandomStream::fill(uint32_t *out, int count)
+{
+    /*--------------------------------------------------------------------*
+     * Use the words remaining in the buffer, then generate whole
+     * counters directly into the output, then refill the buffer for
+     * any remainder.
+     *--------------------------------------------------------------------*/
+    int buffer_size = SIGNALFLOW_RANDOM_STREAM_LANES * 4;
+    while (count > 0 && this->buffer_position < buffer_size)
+    {
+        *out++ = this->buffer[this->buffer_position++];
+        count--;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    uint64_t counter = this->buffer_counter + SIGNALFLOW_RANDOM_STREAM_LANES;
+    int num_counters = count / 4;
+    if (num_counters > 0)
+    {
+        this->generate(counter, out, num_counters);
+        counter += num_counters;
+        out += num_counters * 4;
+        count -= num_counters * 4;
+    }
+
+    this->buffer_counter = counter;
+    this->generate(this->buffer_counter, this->buffer, SIGNALFLOW_RANDOM_STREAM_LANES);
+    this->buffer_position = 0;
+    while (count > 0)
+    {
+        *out++ = this->buffer[this->buffer_position++];
+        count--;
+    }
+}
+
+void RandomStream::fill_uniform(float *out, int count, float from, float to)
+{
+    uint32_t words[SIGNALFLOW_RANDOM_STREAM_LANES * 8];
+    while (count > 0)
+    {
+        int chunk = MIN(count, SIGNALFLOW_RANDOM_STREAM_LANES * 8);
+        this->fill(words, chunk);
+        for (int i = 0; i < chunk; i++)
+        {
+            out[i] = from + random_word_to_unit(words[i]) * (to - from);
+        }
+        out += chunk;
+        count -= chunk;
+    }
+}
+
+void RandomStream::fill_gaussian(float *out, int count, float mean, float sigma)
+{
+    uint32_t words[SIGNALFLOW_RANDOM_STREAM_LANES * 8];
+    while (count > 0)
+    {
+        int chunk = MIN(count, SIGNALFLOW_RANDOM_STREAM_LANES * 4);
+        this->fill(words, chunk * 2);
+        for (int i = 0; i < chunk; i++)
+        {
+            float u0 = random_word_to_unit(words[i * 2]);
+            float u1 = random_word_to_unit(words[i * 2 + 1]);
+            out[i] = mean + sigma * (sqrtf(-2.0f * logf(u0)) * cosf(2.0f * (float) M_PI * u1));
+        }
+        out += chunk;
+        count -= chunk;
+    }
+}
+
 } /* namespace signalflow */
@@ -39,13 +39,13 @@ void GraphRenderer::render_node(NodeRef node)
     /*------------------------------------------------------------------------
      * Collate edges, titled based on their node input
      *-----------------------------------------------------------------------*/
-    for (auto param : node->inputs)
+    for (size_t index = 0; index < node->input_slots.size(); index++)
     {
-        NodeRef value = *(param.second);
+        NodeRef value = *(node->input_slots[index]);
         if (value)
         {
             this->render_node(value);
-            edgestream << "\"" << (void const *) value.get() << "\" -> \"" << (void const *) node.get() << "\" [fontcolor = red, labeldistance = 2, headlabel = \"" << param.first << "\"]; ";
+            edgestream << "\"" << (void const *) value.get() << "\" -> \"" << (void const *) node.get() << "\" [fontcolor = red, labeldistance = 2, headlabel = \"" << node->input_names[index] << "\"]; ";
         }
     }
 }
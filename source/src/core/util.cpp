@@ -11,8 +11,26 @@
 #include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+/*--------------------------------------------------------------------*
+ * Bits of the floating-point control register that flush denormals:
+ * FTZ (bit 15) and DAZ (bit 6) of MXCSR on x86, and FZ (bit 24) of
+ * FPCR/FPSCR on ARM.
+ *--------------------------------------------------------------------*/
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SIGNALFLOW_FP_CONTROL_X86
+#define SIGNALFLOW_FP_FLUSH_DENORMALS_MASK 0x8040
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+#define SIGNALFLOW_FP_CONTROL_ARM64
+#define SIGNALFLOW_FP_FLUSH_DENORMALS_MASK (1 << 24)
+#elif defined(__arm__) && defined(__ARM_FP)
+#define SIGNALFLOW_FP_CONTROL_ARM32
+#define SIGNALFLOW_FP_FLUSH_DENORMALS_MASK (1 << 24)
+#endif
+
 namespace signalflow
 {
 
@@ -135,6 +153,28 @@ float signalflow_midi_note_to_frequency(float midi)
     return 440.0 * powf(2, (midi - 69) / 12.0);
 }
 
+int signalflow_pan_equal_power(float pan, int num_channels, float &gain_lower, float &gain_upper)
+{
+    if (num_channels < 2)
+    {
+        gain_lower = 1.0;
+        gain_upper = 0.0;
+        return 0;
+    }
+
+    pan = signalflow_clip(pan, -1, 1);
+    float position = (pan * 0.5f + 0.5f) * (num_channels - 1);
+    int lower = MIN((int) position, num_channels - 2);
+    float fraction = position - lower;
+
+    /*--------------------------------------------------------------------*
+     * Square-root law: the two gains' squares always sum to one.
+     *--------------------------------------------------------------------*/
+    gain_lower = sqrtf(1.0f - fraction);
+    gain_upper = sqrtf(fraction);
+    return lower;
+}
+
 float signalflow_db_to_amplitude(float db)
 {
     return powf(10.0f, db * 0.05f);
@@ -185,4 +225,85 @@ std::vector<int> signalflow_binary_sequence_to_vector(std::string binary)
     return binary_digits;
 }
 
+/*--------------------------------------------------------------------*
+ * Read and write the thread's floating-point control register:
+ * MXCSR on x86, FPCR on ARM64 and FPSCR on 32-bit ARM.
+ *--------------------------------------------------------------------*/
+static unsigned long signalflow_get_fp_control()
+{
+#if defined(SIGNALFLOW_FP_CONTROL_X86)
+    return _mm_getcsr();
+#elif defined(SIGNALFLOW_FP_CONTROL_ARM64)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    return (unsigned long) fpcr;
+#elif defined(SIGNALFLOW_FP_CONTROL_ARM32)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    return fpscr;
+#else
+    return 0;
+#endif
+}
+
+static void signalflow_set_fp_control(unsigned long state)
+{
+#if defined(SIGNALFLOW_FP_CONTROL_X86)
+    _mm_setcsr((unsigned int) state);
+#elif defined(SIGNALFLOW_FP_CONTROL_ARM64)
+    uint64_t fpcr = state;
+    asm volatile("msr fpcr, %0" : : "r"(fpcr));
+#elif defined(SIGNALFLOW_FP_CONTROL_ARM32)
+    uint32_t fpscr = (uint32_t) state;
+    asm volatile("vmsr fpscr, %0" : : "r"(fpscr));
+#else
+    (void) state;
+#endif
+}
+
+bool signalflow_get_flush_denormals()
+{
+#ifdef SIGNALFLOW_FP_FLUSH_DENORMALS_MASK
+    return (signalflow_get_fp_control() & SIGNALFLOW_FP_FLUSH_DENORMALS_MASK) == SIGNALFLOW_FP_FLUSH_DENORMALS_MASK;
+#else
+    return false;
+#endif
+}
+
+void signalflow_set_flush_denormals(bool enabled)
+{
+#ifdef SIGNALFLOW_FP_FLUSH_DENORMALS_MASK
+    unsigned long state = signalflow_get_fp_control();
+    if (enabled)
+    {
+        state |= SIGNALFLOW_FP_FLUSH_DENORMALS_MASK;
+    }
+    else
+    {
+        state &= ~((unsigned long) SIGNALFLOW_FP_FLUSH_DENORMALS_MASK);
+    }
+    signalflow_set_fp_control(state);
+#else
+    (void) enabled;
+#endif
+}
+
+ScopedFlushDenormals::ScopedFlushDenormals(bool enabled)
+    : enabled(enabled), previous_state(0)
+{
+    if (this->enabled)
+    {
+        this->previous_state = signalflow_get_fp_control();
+        signalflow_set_flush_denormals(true);
+    }
+}
+
+ScopedFlushDenormals::~ScopedFlushDenormals()
+{
+    if (this->enabled)
+    {
+        signalflow_set_fp_control(this->previous_state);
+    }
+}
+
 } /* namespace signalflow */
@@ -15,7 +15,7 @@ CrossCorrelate::CrossCorrelate(NodeRef input, BufferRef buffer, int hop_size)
 
     this->create_buffer("buffer", this->buffer);
     this->create_input("input", this->input);
-    this->ring_buffer = new SampleRingBuffer(buffer->get_num_frames());
+    this->delay_line = DelayLine(buffer ? buffer->get_num_frames() : 0);
 }
 
 void CrossCorrelate::process(Buffer &out, int num_frames)
@@ -27,7 +27,7 @@ void CrossCorrelate::process(Buffer &out, int num_frames)
         return;
 
     int buffer_num_frames = this->buffer->get_num_frames();
-    this->ring_buffer->extend(this->input->out[0], num_frames);
+    this->delay_line.write(this->input->out[0], num_frames);
 
     float correlation;
     for (int hop = 0; hop < num_frames; hop += this->hop_size)
@@ -35,7 +35,7 @@ void CrossCorrelate::process(Buffer &out, int num_frames)
         correlation = 0;
         for (int frame = 0; frame < buffer_num_frames; frame++)
         {
-            correlation += this->buffer->data[0][frame] * this->ring_buffer->get(-2 * buffer_num_frames + hop + frame);
+            correlation += this->buffer->data[0][frame] * this->delay_line.read(buffer_num_frames - (hop + frame) % buffer_num_frames);
         }
         for (int frame = 0; frame < this->hop_size; frame++)
         {
@@ -29,8 +29,8 @@ BufferPlayer::BufferPlayer(BufferRef buffer, NodeRef rate, NodeRef loop,
 
     this->create_input("rate", this->rate);
     this->create_input("loop", this->loop);
-    this->create_input("start_time", this->start_time);
-    this->create_input("end_time", this->end_time);
+    this->create_input("start_time", this->start_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("end_time", this->end_time, SIGNALFLOW_INPUT_RATE_CONTROL);
     this->create_input("clock", this->clock);
 
     /*--------------------------------------------------------------------------------
@@ -141,6 +141,8 @@ void BufferPlayer::process(Buffer &out, int num_frames)
         if ((int) this->phase < end_frame)
             this->phase += this->rate->out[0][frame] * this->rate_scale_factor;
     }
+
+    this->set_silent_if_stopped(out, num_frames);
 }
 
 }
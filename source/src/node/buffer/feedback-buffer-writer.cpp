@@ -37,9 +37,15 @@ void FeedbackBufferWriter::process(Buffer &out, int num_frames)
         {
             int delay_samples = (int) (this->delay_time->out[channel][frame] * this->graph->get_sample_rate());
 
-            if (delay_samples < this->graph->get_output_buffer_size())
+            /*--------------------------------------------------------------------------------
+             * Loops with a delay shorter than the block are rendered by the AudioGraph
+             * in sub-blocks no longer than the delay. If that was not possible (for
+             * example, because part of the loop had already been rendered elsewhere),
+             * the reader has already read past samples that have not been written.
+             *--------------------------------------------------------------------------------*/
+            if (delay_samples < num_frames || delay_samples < 1)
             {
-                throw std::runtime_error("FeedbackBufferWriter delay_time cannot be shorter than the AudioGraph output buffer size");
+                throw std::runtime_error("FeedbackBufferWriter delay_time cannot be shorter than the block being rendered, unless the feedback loop can be rendered in sub-blocks by the AudioGraph");
             }
 
             int offset = this->phase + delay_samples;
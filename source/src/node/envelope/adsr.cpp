@@ -21,6 +21,18 @@ EnvelopeADSR::EnvelopeADSR(NodeRef attack, NodeRef decay, NodeRef sustain, NodeR
     this->level = 0.0;
 }
 
+void EnvelopeADSR::trigger(std::string name, float value)
+{
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        this->phase = 0.0;
+        this->level = 0.0;
+        this->released = false;
+        this->state = SIGNALFLOW_NODE_STATE_ACTIVE;
+    }
+    this->Node::trigger(name, value);
+}
+
 void EnvelopeADSR::process(Buffer &out, int num_frames)
 {
     float phase_step = 1.0f / this->graph->get_sample_rate();
@@ -91,7 +103,7 @@ void EnvelopeADSR::process(Buffer &out, int num_frames)
         }
         this->phase += phase_step;
 
-        float rv;
+        float rv = 0.0;
         if (this->curve == SIGNALFLOW_CURVE_EXPONENTIAL)
         {
             if (this->level > 0)
@@ -114,6 +126,8 @@ void EnvelopeADSR::process(Buffer &out, int num_frames)
             out[channel][frame] = rv;
         }
     }
+
+    this->set_silent_if_stopped(out, num_frames);
 }
 
 }
@@ -36,6 +36,25 @@ void EnvelopeASR::trigger(std::string name, float value)
         }
         this->state = SIGNALFLOW_NODE_STATE_ACTIVE;
     }
+    else if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        /*------------------------------------------------------------------------
+         * Without a clock, the envelope begins immediately, as on construction.
+         *-----------------------------------------------------------------------*/
+        if (this->clock)
+        {
+            for (int channel = 0; channel < this->num_output_channels; channel++)
+            {
+                this->phase[channel] = std::numeric_limits<float>::max();
+            }
+            this->state = SIGNALFLOW_NODE_STATE_ACTIVE;
+            this->Node::trigger(name, value);
+        }
+        else
+        {
+            this->trigger();
+        }
+    }
 }
 
 void EnvelopeASR::process(Buffer &out, int num_frames)
@@ -100,6 +119,8 @@ void EnvelopeASR::process(Buffer &out, int num_frames)
             out[channel][frame] = rv;
         }
     }
+
+    this->set_silent_if_stopped(out, num_frames);
 }
 
 }
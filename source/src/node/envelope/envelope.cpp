@@ -123,6 +123,8 @@ void Envelope::process(Buffer &out, int num_frames)
 
         out[0][frame] = rv;
     }
+
+    this->set_silent_if_stopped(out, num_frames);
 }
 
 }
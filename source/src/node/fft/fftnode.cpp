@@ -11,6 +11,7 @@ FFTNode::FFTNode(int fft_size, int hop_size, int window_size, bool do_window)
      *-----------------------------------------------------------------------*/
     this->num_bins = fft_size / 2 + 1;
     this->num_hops = 0;
+    this->supports_sub_blocks = false;
     this->set_channels(1, 1);
 
     /*------------------------------------------------------------------------
@@ -53,10 +54,9 @@ FFTOpNode::FFTOpNode(NodeRef input)
     }
 }
 
-void FFTOpNode::set_input(std::string name, const NodeRef &node)
+void FFTOpNode::input_changed(int index, const NodeRef &previous)
 {
-    FFTNode::set_input(name, node);
-    if (name == "input")
+    if (this->input_names[index] == "input")
     {
         // TODO: Update FFT size and buffers
     }
@@ -8,7 +8,7 @@ FFTLPF::FFTLPF(NodeRef input, NodeRef frequency)
     : FFTOpNode(input), frequency(frequency)
 {
     this->name = "fft-lpf";
-    this->create_input("frequency", this->frequency);
+    this->create_input("frequency", this->frequency, SIGNALFLOW_INPUT_RATE_CONTROL);
 }
 
 void FFTLPF::process(Buffer &out, int num_frames)
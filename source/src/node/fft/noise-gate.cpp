@@ -1,15 +1,13 @@
 #include "signalflow/node/fft/noise-gate.h"
 
-#include <algorithm>
-
 namespace signalflow
 {
 
 FFTNoiseGate::FFTNoiseGate(NodeRef input, NodeRef threshold)
-    : FFTOpNode(input), threshold(threshold)
+    : FFTOpNode(input), threshold(threshold), statistics(this->num_bins)
 {
     this->name = "fft_noise_gate";
-    this->create_input("threshold", this->threshold);
+    this->create_input("threshold", this->threshold, SIGNALFLOW_INPUT_RATE_CONTROL);
 }
 
 void FFTNoiseGate::process(Buffer &out, int num_frames)
@@ -23,24 +21,13 @@ void FFTNoiseGate::process(Buffer &out, int num_frames)
          * Rather than num_frames here, we need to iterate over fft_size frames
          *  - as each block contains a whole fft of samples.
          *-----------------------------------------------------------------------*/
-        memcpy(this->mags, &input->out[hop][0], sizeof(float) * num_bins);
-        std::sort(this->mags, mags + num_bins);
-        float cutoff = this->mags[(int) (this->threshold->out[0][0] * num_bins)];
+        float cutoff = this->statistics.percentile(input->out[hop], this->threshold->out[0][0]);
 
-        for (int frame = 0; frame < this->fft_size; frame++)
+        for (int bin = 0; bin < this->num_bins; bin++)
         {
-            if (frame < this->num_bins)
-            {
-                if (input->out[hop][frame] > cutoff)
-                    out[hop][frame] = input->out[hop][frame];
-                else
-                    out[hop][frame] = 0.0;
-            }
-            else
-            {
-                out[hop][frame] = input->out[hop][frame];
-            }
+            out[hop][bin] = (input->out[hop][bin] > cutoff) ? input->out[hop][bin] : 0.0f;
         }
+        memcpy(out[hop] + this->num_bins, input->out[hop] + this->num_bins, this->num_bins * sizeof(sample));
 
         /*
         float min_magnitude = 1e6;
@@ -0,0 +1,50 @@
+#include "signalflow/core/graph.h"
+#include "signalflow/node/fft/spectral-features.h"
+
+#include <string.h>
+
+namespace signalflow
+{
+
+FFTSpectralFeatures::FFTSpectralFeatures(NodeRef input, NodeRef rolloff)
+    : FFTOpNode(input), rolloff(rolloff), statistics(this->num_bins)
+{
+    this->name = "fft-spectral-features";
+    this->num_output_channels = 4;
+    this->update_channels();
+
+    this->create_input("rolloff", this->rolloff, SIGNALFLOW_INPUT_RATE_CONTROL);
+
+    this->previous_magnitudes.resize(this->num_bins);
+    this->centroid = 0.0;
+    this->flux = 0.0;
+    this->rolloff_frequency = 0.0;
+    this->flatness = 0.0;
+}
+
+void FFTSpectralFeatures::process(Buffer &out, int num_frames)
+{
+    FFTNode *fftnode = (FFTNode *) this->input.get();
+    this->num_hops = fftnode->num_hops;
+
+    float bin_frequency = (float) this->graph->get_sample_rate() / this->fft_size;
+    for (int hop = 0; hop < this->num_hops; hop++)
+    {
+        const sample *magnitudes = this->input->out[hop];
+        this->centroid = this->statistics.centroid(magnitudes) * bin_frequency;
+        this->flux = this->statistics.flux(magnitudes, this->previous_magnitudes.data()) * 2.0 / this->fft_size;
+        this->rolloff_frequency = this->statistics.rolloff(magnitudes, this->rolloff->out[0][0]) * bin_frequency;
+        this->flatness = this->statistics.flatness(magnitudes);
+        memcpy(this->previous_magnitudes.data(), magnitudes, this->num_bins * sizeof(sample));
+    }
+
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        out[0][frame] = this->centroid;
+        out[1][frame] = this->flux;
+        out[2][frame] = this->rolloff_frequency;
+        out[3][frame] = this->flatness;
+    }
+}
+
+}
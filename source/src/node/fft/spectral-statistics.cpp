@@ -0,0 +1,323 @@
+#include "signalflow/node/fft/spectral-statistics.h"
+#include "signalflow/core/util.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * Sums are accumulated in this many independent lanes, so that the
+ * compiler can vectorise them without reassociating floating-point adds.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_SPECTRAL_LANES 8
+
+/*------------------------------------------------------------------------
+ * Floor for powers in the flatness measure, so that empty bins do not
+ * send the geometric mean to zero.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_SPECTRAL_MIN_POWER 1e-20
+
+namespace signalflow
+{
+
+SpectralStatistics::SpectralStatistics(int num_bins)
+    : num_bins(num_bins)
+{
+    this->scratch.resize(num_bins);
+    this->right_bases.resize(num_bins);
+    this->stack_minima.resize(num_bins);
+    this->stack.resize(num_bins);
+    this->candidates.resize(num_bins);
+    this->all_peaks.resize(num_bins / 2 + 1);
+}
+
+int SpectralStatistics::get_num_bins()
+{
+    return this->num_bins;
+}
+
+float SpectralStatistics::percentile(const sample *magnitudes, float proportion)
+{
+    int rank = (int) (proportion * this->num_bins);
+    rank = MAX(0, MIN(rank, this->num_bins - 1));
+
+    /*------------------------------------------------------------------------
+     * nth_element partially orders the copy so that only the requested
+     * rank is in sorted position, in linear time on average.
+     *-----------------------------------------------------------------------*/
+    memcpy(this->scratch.data(), magnitudes, this->num_bins * sizeof(sample));
+    std::nth_element(this->scratch.begin(), this->scratch.begin() + rank, this->scratch.end());
+    return this->scratch[rank];
+}
+
+int SpectralStatistics::find_peaks(const sample *magnitudes,
+                                   float threshold,
+                                   float min_prominence,
+                                   SpectralPeak *peaks,
+                                   int max_peaks,
+                                   bool interpolate)
+{
+    int num_bins = this->num_bins;
+    if (num_bins < 3)
+    {
+        return 0;
+    }
+
+    /*------------------------------------------------------------------------
+     * Candidate local maxima, found with a branch-free comparison across
+     * all bins.
+     *-----------------------------------------------------------------------*/
+    unsigned char *candidates = this->candidates.data();
+    candidates[0] = 0;
+    candidates[num_bins - 1] = 0;
+    for (int bin = 1; bin < num_bins - 1; bin++)
+    {
+        candidates[bin] = (magnitudes[bin] > threshold) & (magnitudes[bin] > magnitudes[bin - 1]) & (magnitudes[bin] > magnitudes[bin + 1]);
+    }
+
+    /*------------------------------------------------------------------------
+     * For each bin, find the lowest magnitude between it and the nearest
+     * bin at least as high, on each side. A stack holds bins in decreasing
+     * order of magnitude, each with the minimum of the bins between it and
+     * the bin below it on the stack. When a bin pops lower bins from the
+     * stack, the minimum over the popped range is its base on that side.
+     *
+     * The right-hand bases are found with a backward pass, and the
+     * left-hand bases with a forward pass that also evaluates each peak.
+     *-----------------------------------------------------------------------*/
+    int *stack = this->stack.data();
+    sample *stack_minima = this->stack_minima.data();
+    sample *right_bases = this->right_bases.data();
+    int stack_size = 0;
+
+    for (int bin = num_bins - 1; bin >= 0; bin--)
+    {
+        sample base = FLT_MAX;
+        while (stack_size > 0 && magnitudes[stack[stack_size - 1]] < magnitudes[bin])
+        {
+            stack_size--;
+            base = MIN(base, magnitudes[stack[stack_size]]);
+            base = MIN(base, stack_minima[stack_size]);
+        }
+        right_bases[bin] = base;
+        stack[stack_size] = bin;
+        stack_minima[stack_size] = base;
+        stack_size++;
+    }
+
+    int peak_count = 0;
+    stack_size = 0;
+    for (int bin = 0; bin < num_bins; bin++)
+    {
+        sample base = FLT_MAX;
+        while (stack_size > 0 && magnitudes[stack[stack_size - 1]] < magnitudes[bin])
+        {
+            stack_size--;
+            base = MIN(base, magnitudes[stack[stack_size]]);
+            base = MIN(base, stack_minima[stack_size]);
+        }
+        stack[stack_size] = bin;
+        stack_minima[stack_size] = base;
+        stack_size++;
+
+        if (candidates[bin])
+        {
+            sample higher_base = MAX(base, right_bases[bin]);
+            if (higher_base == 0)
+            {
+                higher_base = 1e-9;
+            }
+            float prominence = magnitudes[bin] / higher_base;
+            if (prominence > min_prominence)
+            {
+                SpectralPeak &peak = this->all_peaks[peak_count++];
+                peak.bin = bin;
+                peak.magnitude = magnitudes[bin];
+                peak.prominence = prominence;
+            }
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Keep the highest max_peaks peaks, in descending order of magnitude.
+     *-----------------------------------------------------------------------*/
+    auto by_magnitude = [](const SpectralPeak &a, const SpectralPeak &b) -> bool {
+        return a.magnitude > b.magnitude;
+    };
+    int num_peaks = MIN(peak_count, max_peaks);
+    std::partial_sort(this->all_peaks.begin(),
+                      this->all_peaks.begin() + num_peaks,
+                      this->all_peaks.begin() + peak_count,
+                      by_magnitude);
+
+    for (int index = 0; index < num_peaks; index++)
+    {
+        peaks[index] = this->all_peaks[index];
+        if (interpolate)
+        {
+            int bin = (int) peaks[index].bin;
+            float alpha = logf(MAX(magnitudes[bin - 1], 1e-12f));
+            float beta = logf(MAX(magnitudes[bin], 1e-12f));
+            float gamma = logf(MAX(magnitudes[bin + 1], 1e-12f));
+            float denominator = alpha - 2.0f * beta + gamma;
+            if (denominator != 0.0f)
+            {
+                peaks[index].bin += 0.5f * (alpha - gamma) / denominator;
+            }
+        }
+    }
+
+    return num_peaks;
+}
+
+float SpectralStatistics::centroid(const sample *magnitudes)
+{
+    float weighted[SIGNALFLOW_SPECTRAL_LANES] = { 0 };
+    float total[SIGNALFLOW_SPECTRAL_LANES] = { 0 };
+    int bin = 0;
+    for (; bin + SIGNALFLOW_SPECTRAL_LANES <= this->num_bins; bin += SIGNALFLOW_SPECTRAL_LANES)
+    {
+        for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+        {
+            weighted[lane] += (float) (bin + lane) * magnitudes[bin + lane];
+            total[lane] += magnitudes[bin + lane];
+        }
+    }
+    for (; bin < this->num_bins; bin++)
+    {
+        weighted[0] += (float) bin * magnitudes[bin];
+        total[0] += magnitudes[bin];
+    }
+
+    float weighted_sum = 0.0;
+    float total_sum = 0.0;
+    for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+    {
+        weighted_sum += weighted[lane];
+        total_sum += total[lane];
+    }
+    return (total_sum > 0) ? (weighted_sum / total_sum) : 0.0;
+}
+
+float SpectralStatistics::flux(const sample *magnitudes, const sample *previous)
+{
+    float sums[SIGNALFLOW_SPECTRAL_LANES] = { 0 };
+    int bin = 0;
+    for (; bin + SIGNALFLOW_SPECTRAL_LANES <= this->num_bins; bin += SIGNALFLOW_SPECTRAL_LANES)
+    {
+        for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+        {
+            float difference = magnitudes[bin + lane] - previous[bin + lane];
+            sums[lane] += (difference > 0) ? difference : 0.0f;
+        }
+    }
+    for (; bin < this->num_bins; bin++)
+    {
+        float difference = magnitudes[bin] - previous[bin];
+        sums[0] += (difference > 0) ? difference : 0.0f;
+    }
+
+    float sum = 0.0;
+    for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+    {
+        sum += sums[lane];
+    }
+    return sum;
+}
+
+float SpectralStatistics::rolloff(const sample *magnitudes, float proportion)
+{
+    float sums[SIGNALFLOW_SPECTRAL_LANES] = { 0 };
+    int bin = 0;
+    for (; bin + SIGNALFLOW_SPECTRAL_LANES <= this->num_bins; bin += SIGNALFLOW_SPECTRAL_LANES)
+    {
+        for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+        {
+            sums[lane] += magnitudes[bin + lane] * magnitudes[bin + lane];
+        }
+    }
+    for (; bin < this->num_bins; bin++)
+    {
+        sums[0] += magnitudes[bin] * magnitudes[bin];
+    }
+
+    float total = 0.0;
+    for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+    {
+        total += sums[lane];
+    }
+
+    float target = total * proportion;
+    float cumulative = 0.0;
+    for (bin = 0; bin < this->num_bins; bin++)
+    {
+        cumulative += magnitudes[bin] * magnitudes[bin];
+        if (cumulative >= target)
+        {
+            return bin;
+        }
+    }
+    return this->num_bins - 1;
+}
+
+float SpectralStatistics::flatness(const sample *magnitudes)
+{
+    /*------------------------------------------------------------------------
+     * The geometric mean is computed as the mean of logs, but taking the
+     * log of a product of each run of bins rather than of every bin. Powers
+     * are bounded well within the range of a double, so a product of
+     * SIGNALFLOW_SPECTRAL_LANES of them cannot overflow or underflow.
+     *-----------------------------------------------------------------------*/
+    double log_sum = 0.0;
+    float sums[SIGNALFLOW_SPECTRAL_LANES] = { 0 };
+    int bin = 0;
+    for (; bin + SIGNALFLOW_SPECTRAL_LANES <= this->num_bins; bin += SIGNALFLOW_SPECTRAL_LANES)
+    {
+        double product = 1.0;
+        for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+        {
+            float power = magnitudes[bin + lane] * magnitudes[bin + lane] + SIGNALFLOW_SPECTRAL_MIN_POWER;
+            product *= power;
+            sums[lane] += power;
+        }
+        log_sum += log(product);
+    }
+    for (; bin < this->num_bins; bin++)
+    {
+        float power = magnitudes[bin] * magnitudes[bin] + SIGNALFLOW_SPECTRAL_MIN_POWER;
+        log_sum += log(power);
+        sums[0] += power;
+    }
+
+    float sum = 0.0;
+    for (int lane = 0; lane < SIGNALFLOW_SPECTRAL_LANES; lane++)
+    {
+        sum += sums[lane];
+    }
+
+    float arithmetic_mean = sum / this->num_bins;
+    float geometric_mean = exp(log_sum / this->num_bins);
+    return (arithmetic_mean > 0) ? (geometric_mean / arithmetic_mean) : 0.0;
+}
+
+void SpectralStatistics::smooth(const sample *magnitudes, sample *out, float smoothing)
+{
+    if (this->num_bins == 0)
+    {
+        return;
+    }
+
+    float one_minus_smoothing = 1.0 - smoothing;
+    out[0] = magnitudes[0];
+    for (int bin = 1; bin < this->num_bins; bin++)
+    {
+        out[bin] = (out[bin - 1] * smoothing) + (magnitudes[bin] * one_minus_smoothing);
+    }
+    for (int bin = this->num_bins - 2; bin >= 0; bin--)
+    {
+        out[bin] = (out[bin + 1] * smoothing) + (out[bin] * one_minus_smoothing);
+    }
+}
+
+}
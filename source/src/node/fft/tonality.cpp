@@ -1,17 +1,16 @@
 #include "signalflow/node/fft/tonality.h"
 
-#include <algorithm>
-#include <array>
-
 namespace signalflow
 {
 
 FFTTonality::FFTTonality(NodeRef input, NodeRef level, NodeRef smoothing)
-    : FFTOpNode(input), level(level), smoothing(smoothing)
+    : FFTOpNode(input), level(level), smoothing(smoothing), statistics(this->num_bins)
 {
     this->name = "fft-tonality";
-    this->create_input("level", this->level);
-    this->create_input("smoothing", this->smoothing);
+    this->create_input("level", this->level, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("smoothing", this->smoothing, SIGNALFLOW_INPUT_RATE_CONTROL);
+
+    this->mags_smoothed.resize(this->num_bins);
 }
 
 void FFTTonality::process(Buffer &out, int num_frames)
@@ -25,32 +24,19 @@ void FFTTonality::process(Buffer &out, int num_frames)
          * Rather than num_frames here, we need to iterate over fft_size frames
          *  - as each block contains a whole fft of samples.
          *-----------------------------------------------------------------------*/
+        this->statistics.smooth(input->out[hop], this->mags_smoothed.data(), this->smoothing->out[0][0]);
 
-        memcpy(this->mags_smoothed, input->out[hop], num_bins * sizeof(float));
-        float smoothing = this->smoothing->out[0][0];
-        float one_minus_smoothing = 1.0 - smoothing;
-        for (int bin_index = 1; bin_index < num_bins; bin_index++)
-        {
-            this->mags_smoothed[bin_index] = (this->mags_smoothed[bin_index - 1] * smoothing) + (this->mags_smoothed[bin_index] * one_minus_smoothing);
-        }
-        for (int bin_index = num_bins - 2; bin_index >= 0; bin_index--)
-        {
-            this->mags_smoothed[bin_index] = (this->mags_smoothed[bin_index + 1] * smoothing) + (this->mags_smoothed[bin_index] * one_minus_smoothing);
-        }
-
-        for (int frame = 0; frame < this->fft_size; frame++)
+        /*------------------------------------------------------------------------
+         * Subtract the smoothed spectral envelope from the magnitudes,
+         * and pass the phases through unchanged.
+         *-----------------------------------------------------------------------*/
+        float level = this->level->out[0][0];
+        for (int bin = 0; bin < this->num_bins; bin++)
         {
-            if (frame < this->num_bins)
-            {
-                out[hop][frame] = input->out[hop][frame] - this->level->out[0][0] * this->mags_smoothed[frame];
-                if (out[hop][frame] < 0)
-                    out[hop][frame] = 0;
-            }
-            else
-            {
-                out[hop][frame] = input->out[hop][frame];
-            }
+            float magnitude = input->out[hop][bin] - level * this->mags_smoothed[bin];
+            out[hop][bin] = (magnitude > 0) ? magnitude : 0.0f;
         }
+        memcpy(out[hop] + this->num_bins, input->out[hop] + this->num_bins, this->num_bins * sizeof(sample));
     }
 }
 
@@ -11,21 +11,18 @@
 #include <stdlib.h>
 #include <string.h>
 
-static bool is_processing = false;
-
 namespace signalflow
 {
-extern AudioIn_Abstract *shared_in;
 
 void read_callback(struct SoundIoInStream *instream,
                    int frame_count_min, int frame_count_max)
 {
-    is_processing = true;
-
-    AudioIn_SoundIO *input = (AudioIn_SoundIO *) shared_in;
-    if (!shared_in)
+    AudioIn_SoundIO *input = (AudioIn_SoundIO *) instream->userdata;
+    if (!input)
         return;
 
+    input->is_processing = true;
+
     const struct SoundIoChannelLayout *layout = &instream->layout;
     struct SoundIoChannelArea *areas;
     int frame_count = frame_count_max;
@@ -62,11 +59,11 @@ void read_callback(struct SoundIoInStream *instream,
         frames_left -= frame_count;
     }
 
-    is_processing = false;
+    input->is_processing = false;
 }
 
 AudioIn_SoundIO::AudioIn_SoundIO()
-    : AudioIn_Abstract()
+    : AudioIn_Abstract(), is_processing(false)
 {
     // Allocate enough buffer for twice our block size, else
     // we risk overwriting our input buffer from the audio in
@@ -104,6 +101,7 @@ int AudioIn_SoundIO::init()
     this->instream = soundio_instream_create(device);
     this->instream->format = SoundIoFormatFloat32NE;
     this->instream->read_callback = read_callback;
+    this->instream->userdata = (void *) this;
     this->instream->sample_rate = device->sample_rate_current;
     this->instream->software_latency = 256.0 / this->instream->sample_rate;
 
@@ -139,11 +137,10 @@ int AudioIn_SoundIO::stop()
 
 int AudioIn_SoundIO::destroy()
 {
-    while (is_processing)
+    while (this->is_processing)
     {
     }
 
-    shared_in = nullptr;
     soundio_instream_destroy(this->instream);
     soundio_device_unref(this->device);
 
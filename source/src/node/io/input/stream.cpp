@@ -0,0 +1,120 @@
+#include "signalflow/node/io/input/stream.h"
+
+#include <string.h>
+
+namespace signalflow
+{
+
+StreamInput::StreamInput(int num_channels, int capacity)
+    : frames_written(0), frames_read(0), reset_position(-1), num_underruns(0)
+{
+    if (num_channels < 1)
+    {
+        throw std::runtime_error("StreamInput: num_channels must be at least 1");
+    }
+
+    this->name = "stream-input";
+    this->set_channels(0, num_channels);
+
+    /*------------------------------------------------------------------------
+     * Round the capacity up to a power of two so that positions wrap
+     * with a bitmask.
+     *-----------------------------------------------------------------------*/
+    this->capacity = 1;
+    while (this->capacity < capacity)
+    {
+        this->capacity *= 2;
+    }
+    this->mask = this->capacity - 1;
+    this->data.resize(num_channels * this->capacity);
+}
+
+int StreamInput::write(const sample *data, int num_channels, int num_frames)
+{
+    if (num_channels < 1)
+    {
+        return 0;
+    }
+
+    int stride = num_frames;
+    long frames_written = this->frames_written.load(std::memory_order_relaxed);
+    long frames_read = this->frames_read.load(std::memory_order_acquire);
+    num_frames = MIN(num_frames, this->capacity - (int) (frames_written - frames_read));
+
+    int position = frames_written & this->mask;
+    int first_segment = MIN(num_frames, this->capacity - position);
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        const sample *channel_in = data + (channel % num_channels) * stride;
+        sample *channel_data = this->data.data() + channel * this->capacity;
+        memcpy(channel_data + position, channel_in, first_segment * sizeof(sample));
+        memcpy(channel_data, channel_in + first_segment, (num_frames - first_segment) * sizeof(sample));
+    }
+
+    this->frames_written.store(frames_written + num_frames, std::memory_order_release);
+    return num_frames;
+}
+
+int StreamInput::get_num_frames_queued()
+{
+    long frames_read = MAX(this->frames_read.load(), this->reset_position.load());
+    return (int) (this->frames_written.load() - frames_read);
+}
+
+int StreamInput::get_num_frames_free()
+{
+    return this->capacity - this->get_num_frames_queued();
+}
+
+int StreamInput::get_capacity()
+{
+    return this->capacity;
+}
+
+int StreamInput::get_num_underruns()
+{
+    return this->num_underruns;
+}
+
+void StreamInput::trigger(std::string name, float value)
+{
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        /*------------------------------------------------------------------------
+         * frames_read is only modified by the rendering thread, so the frames
+         * queued so far are discarded when the node is next processed.
+         *-----------------------------------------------------------------------*/
+        this->reset_position.store(this->frames_written.load(std::memory_order_acquire), std::memory_order_release);
+    }
+    this->Node::trigger(name, value);
+}
+
+void StreamInput::process(Buffer &out, int num_frames)
+{
+    long frames_read = this->frames_read.load(std::memory_order_relaxed);
+    long reset_position = this->reset_position.exchange(-1, std::memory_order_acquire);
+    if (reset_position > frames_read)
+    {
+        frames_read = reset_position;
+    }
+    long frames_written = this->frames_written.load(std::memory_order_acquire);
+    int num_frames_queued = MIN(num_frames, (int) (frames_written - frames_read));
+
+    int position = frames_read & this->mask;
+    int first_segment = MIN(num_frames_queued, this->capacity - position);
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        const sample *channel_data = this->data.data() + channel * this->capacity;
+        memcpy(out[channel], channel_data + position, first_segment * sizeof(sample));
+        memcpy(out[channel] + first_segment, channel_data, (num_frames_queued - first_segment) * sizeof(sample));
+        memset(out[channel] + num_frames_queued, 0, (num_frames - num_frames_queued) * sizeof(sample));
+    }
+
+    if (num_frames_queued < num_frames)
+    {
+        this->num_underruns++;
+    }
+    this->frames_read.store(frames_read + num_frames_queued, std::memory_order_release);
+}
+
+}
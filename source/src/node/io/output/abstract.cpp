@@ -23,6 +23,11 @@ void AudioOut_Abstract::process(Buffer &out, int num_frames)
 
     for (NodeRef input : this->audio_inputs)
     {
+        if (input->get_is_silent())
+        {
+            continue;
+        }
+
         for (int channel = 0; channel < input->get_num_output_channels(); channel++)
         {
 #ifdef __APPLE__
@@ -56,14 +61,14 @@ void AudioOut_Abstract::add_input(NodeRef node)
 void AudioOut_Abstract::remove_input(NodeRef node)
 {
     bool removed = false;
-    for (auto param : this->inputs)
+    for (size_t index = 0; index < this->input_slots.size(); index++)
     {
-        if (*(param.second) == node)
+        if (*(this->input_slots[index]) == node)
         {
-            this->destroy_input(param.first);
+            std::string input_name = this->input_names[index];
+            this->destroy_input(input_name);
             audio_inputs.remove(node);
             removed = true;
-            node->remove_output(this, param.first);
             break;
         }
     }
@@ -76,14 +81,15 @@ void AudioOut_Abstract::remove_input(NodeRef node)
 void AudioOut_Abstract::replace_input(NodeRef node, NodeRef other)
 {
     bool replaced = false;
-    for (auto param : this->inputs)
+    for (size_t index = 0; index < this->input_slots.size(); index++)
     {
-        if (*(param.second) == node)
+        if (*(this->input_slots[index]) == node)
         {
             // Need to call create_input to also update the channel I/O on `other`
+            node->remove_output(this, (int) index);
             audio_inputs.remove(node);
             audio_inputs.push_back(other);
-            this->create_input(param.first, audio_inputs.back());
+            this->create_input(this->input_names[index], audio_inputs.back());
             replaced = true;
             break;
         }
@@ -10,18 +10,15 @@
 #include <stdlib.h>
 #include <string.h>
 
-static bool is_processing = false;
-
 namespace signalflow
 {
 
-extern AudioGraph *shared_graph;
-
 void write_callback(struct SoundIoOutStream *outstream,
                     int frame_count_min,
                     int frame_count_max)
 {
-    is_processing = true;
+    AudioOut_SoundIO *out_node = (AudioOut_SoundIO *) outstream->userdata;
+    AudioGraph *graph = out_node->get_graph();
 
     const struct SoundIoChannelLayout *layout = &outstream->layout;
     struct SoundIoChannelArea *areas;
@@ -29,16 +26,16 @@ void write_callback(struct SoundIoOutStream *outstream,
     int frames_left = frame_count_max;
 
     /*-----------------------------------------------------------------------*
-     * Return if the shared_graph hasn't been initialized yet.
+     * Return if the graph hasn't been initialized yet.
      * (The libsoundio Pulse Audio driver calls the write_callback once
      * on initialization, so this may happen legitimately.)
      *-----------------------------------------------------------------------*/
-    if (!shared_graph || !shared_graph->get_output())
+    if (!graph || !graph->get_output())
     {
         return;
     }
 
-    AudioOut_SoundIO *out_node = (AudioOut_SoundIO *) outstream->userdata;
+    out_node->is_processing = true;
 
     /*-----------------------------------------------------------------------*
      * On some drivers (eg Linux), we cannot write all samples at once.
@@ -56,7 +53,7 @@ void write_callback(struct SoundIoOutStream *outstream,
         {
             try
             {
-                shared_graph->render(frame_count);
+                graph->render(frame_count);
             }
             catch (const std::exception &e)
             {
@@ -69,7 +66,7 @@ void write_callback(struct SoundIoOutStream *outstream,
                 for (int channel = 0; channel < layout->channel_count; channel += 1)
                 {
                     float *ptr = reinterpret_cast<float *>(areas[channel].ptr + areas[channel].step * frame);
-                    *ptr = shared_graph->get_output()->out[channel][frame];
+                    *ptr = graph->get_output()->out[channel][frame];
 
                     /*-----------------------------------------------------------------------*
                      * Hard limiter.
@@ -101,7 +98,7 @@ void write_callback(struct SoundIoOutStream *outstream,
         frames_left -= frame_count;
     }
 
-    is_processing = false;
+    out_node->is_processing = false;
 }
 
 int soundio_get_device_by_name(struct SoundIo *soundio, const char *name)
@@ -123,7 +120,7 @@ int soundio_get_device_by_name(struct SoundIo *soundio, const char *name)
 AudioOut_SoundIO::AudioOut_SoundIO(const std::string &device_name,
                                    unsigned int sample_rate,
                                    unsigned int buffer_size)
-    : AudioOut_Abstract()
+    : AudioOut_Abstract(), is_processing(false)
 {
     this->device_name = device_name;
     this->sample_rate = sample_rate;
@@ -233,7 +230,7 @@ int AudioOut_SoundIO::stop()
 
 int AudioOut_SoundIO::destroy()
 {
-    while (is_processing)
+    while (this->is_processing)
     {
     }
 
@@ -14,15 +14,17 @@
 #include "signalflow/core/graph.h"
 #include "signalflow/node/node-monitor.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
 namespace signalflow
 {
 
-extern AudioGraph *shared_graph;
-
 Node::Node()
 {
     this->name = "(unknown node)";
-    this->graph = shared_graph;
+    this->graph = AudioGraph::get_current();
     this->state = SIGNALFLOW_NODE_STATE_ACTIVE;
 
     this->matches_input_channels = true;
@@ -35,17 +37,28 @@ Node::Node()
     this->patch = nullptr;
 
     this->has_rendered = false;
+    this->is_constant = false;
+    this->is_silent = false;
+    this->silent_if_any_input_silent = false;
+    this->skips_inputs = false;
+    this->supports_control_rate = false;
+    this->supports_sub_blocks = true;
+    this->is_control_rate = false;
+    this->control_rate_block = -1;
+    this->block_offset = 0;
+    this->sub_block_check = -1;
+    this->denormal_count = 0;
     this->num_output_channels_allocated = 0;
 
     /*------------------------------------------------------------------------
-     * In most cases, shared_graph->get_output_buffer_size() should always
+     * In most cases, graph->get_output_buffer_size() should always
      * be non-zero. However, there are edge cases when it is zero
      * (e.g. when creating an AudioOut before the graph has been instantiated).
      *
      *-----------------------------------------------------------------------*/
-    if (shared_graph && shared_graph->get_config().get_output_buffer_size() && false)
+    if (this->graph && this->graph->get_config().get_output_buffer_size() && false)
     {
-        this->output_buffer_length = shared_graph->get_config().get_output_buffer_size();
+        this->output_buffer_length = this->graph->get_config().get_output_buffer_size();
     }
     else
     {
@@ -94,8 +107,55 @@ void Node::_process(Buffer &out, int num_frames)
     {
         this->last_sample[i] = out[i][last_num_frames - 1];
     }
+    this->is_silent = false;
     this->process(out, num_frames);
     this->last_num_frames = num_frames;
+#ifdef DEBUG
+    this->count_denormals(out, num_frames);
+#endif
+}
+
+void Node::_process_silence(Buffer &out, int num_frames)
+{
+    for (int i = 0; i < this->num_output_channels_allocated; i++)
+    {
+        this->last_sample[i] = out[i][last_num_frames - 1];
+        memset(out[i], 0, num_frames * sizeof(sample));
+    }
+    this->is_silent = true;
+    this->last_num_frames = num_frames;
+}
+
+void Node::_process_control(Buffer &out, int num_frames)
+{
+    for (int i = 0; i < this->num_output_channels_allocated; i++)
+    {
+        this->last_sample[i] = out[i][last_num_frames - 1];
+    }
+    this->is_silent = false;
+    this->process_control(out, num_frames);
+    for (int i = 0; i < this->num_output_channels_allocated; i++)
+    {
+        std::fill(out[i] + 1, out[i] + num_frames, out[i][0]);
+    }
+    this->last_num_frames = num_frames;
+#ifdef DEBUG
+    this->count_denormals(out, num_frames);
+#endif
+}
+
+void Node::count_denormals(Buffer &out, int num_frames)
+{
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            if (std::fpclassify(out[channel][frame]) == FP_SUBNORMAL)
+            {
+                this->denormal_count++;
+            }
+        }
+    }
 }
 
 void Node::process(int num_frames)
@@ -113,6 +173,11 @@ void Node::process(Buffer &out, int num_frames)
      *-----------------------------------------------------------------------*/
 }
 
+void Node::process_control(Buffer &out, int num_frames)
+{
+    this->process(out, 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Channels
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,15 +194,13 @@ void Node::update_channels()
     if (this->matches_input_channels)
     {
         int max_channels = 1;
-        for (auto input : this->inputs)
+        for (NodeRef *ptr : this->input_slots)
         {
-            NodeRef *ptr = input.second;
             // A param may be registered but not yet set
             if (!ptr || !*ptr)
                 continue;
-            std::string param_name = input.first;
 
-            NodeRef input_node = *ptr;
+            Node *input_node = ptr->get();
             if (input_node->get_num_output_channels() > max_channels)
                 max_channels = input_node->get_num_output_channels();
         }
@@ -146,14 +209,7 @@ void Node::update_channels()
         this->num_input_channels = max_channels;
         this->num_output_channels = max_channels;
 
-        for (auto input : this->inputs)
-        {
-            NodeRef node = *input.second;
-            if (node && node->get_num_output_channels_allocated() < this->num_output_channels)
-            {
-                node->resize_output_buffers(this->num_output_channels);
-            }
-        }
+        this->resize_input_buffers(this->num_output_channels);
 
         if (previous_num_output_channels != this->num_output_channels)
         {
@@ -170,15 +226,13 @@ void Node::update_channels()
     }
     else
     {
-        for (auto input : this->inputs)
+        for (NodeRef *ptr : this->input_slots)
         {
-            NodeRef *ptr = input.second;
             // A param may be registered but not yet set
             if (!ptr || !*ptr)
                 continue;
-            std::string param_name = input.first;
 
-            NodeRef input_node = *ptr;
+            Node *input_node = ptr->get();
             if (input_node->get_num_output_channels() > this->num_input_channels)
             {
                 throw invalid_channel_count_exception("Node " + input_node->name + " has more output channels than " + this->name + " supports. Either downmix with ChannelMixer, or select the intended channels with ChannelSelect.");
@@ -237,11 +291,38 @@ void Node::resize_output_buffers(int output_buffer_count)
     }
 }
 
+void Node::resize_input_buffers(int num_channels)
+{
+    for (NodeRef *input : this->input_slots)
+    {
+        Node *node = input->get();
+        if (node && node->get_num_output_channels_allocated() < num_channels)
+        {
+            node->resize_output_buffers(num_channels);
+        }
+    }
+}
+
 int Node::get_output_buffer_length()
 {
     return this->output_buffer_length;
 }
 
+bool Node::get_is_silent()
+{
+    return this->is_silent;
+}
+
+bool Node::get_is_control_rate()
+{
+    return this->is_control_rate;
+}
+
+unsigned long Node::get_denormal_count()
+{
+    return this->denormal_count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // States
 ////////////////////////////////////////////////////////////////////////////////
@@ -251,6 +332,26 @@ signalflow_node_state_t Node::get_state()
     return this->state;
 }
 
+void Node::set_silent_if_stopped(Buffer &out, int num_frames)
+{
+    if (this->state != SIGNALFLOW_NODE_STATE_STOPPED)
+    {
+        return;
+    }
+
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            if (out[channel][frame] != 0)
+            {
+                return;
+            }
+        }
+    }
+    this->is_silent = true;
+}
+
 void Node::set_state(signalflow_node_state_t state)
 {
     if (state != this->state)
@@ -267,16 +368,60 @@ void Node::set_state(signalflow_node_state_t state)
 // Inputs and outputs
 ////////////////////////////////////////////////////////////////////////////////
 
-void Node::create_input(std::string name, NodeRef &input)
+/*------------------------------------------------------------------------
+ * A node can only be connected to nodes in the same graph, as each graph
+ * renders on its own thread, at its own sample rate.
+ *-----------------------------------------------------------------------*/
+static void check_same_graph(Node *node, Node *input)
+{
+    if (input && node->get_graph() && input->get_graph() && input->get_graph() != node->get_graph())
+    {
+        throw std::runtime_error("Node " + node->name + ": Cannot connect to " + input->name + ", which belongs to a different AudioGraph");
+    }
+}
+
+void Node::create_input(std::string name, NodeRef &input, signalflow_input_rate_t rate)
 {
-    this->inputs[name] = &input;
+    check_same_graph(this, input.get());
+
+    /*------------------------------------------------------------------------
+     * Creating an input that already exists replaces its slot, so that
+     * its index is unchanged.
+     *-----------------------------------------------------------------------*/
+    int slot;
+    auto index = this->input_indices.find(name);
+    if (index != this->input_indices.end())
+    {
+        slot = index->second;
+        this->input_slots[slot] = &input;
+        if (rate != SIGNALFLOW_INPUT_RATE_AUDIO)
+        {
+            this->input_rates[slot] = rate;
+        }
+    }
+    else
+    {
+        slot = (int) this->input_slots.size();
+        this->input_indices[name] = slot;
+        this->input_slots.push_back(&input);
+        this->input_names.push_back(name);
+        this->input_rates.push_back(rate);
+    }
+    if (this->graph)
+    {
+        this->graph->invalidate_topology();
+    }
+    if (this->patch)
+    {
+        this->patch->has_bindings = false;
+    }
 
     /*------------------------------------------------------------------------
      * Create a new named input.
      *-----------------------------------------------------------------------*/
     if (input)
     {
-        input->add_output(this, name);
+        input->add_output(this, slot);
 
         /*------------------------------------------------------------------------
          * In case the input has more output channels than this Node is
@@ -291,48 +436,175 @@ void Node::destroy_input(std::string name)
     /*------------------------------------------------------------------------
      * Only done by special classes (ChannelArray, AudioOut)
      *-----------------------------------------------------------------------*/
-    this->inputs.erase(name);
+    auto index = this->input_indices.find(name);
+    if (index != this->input_indices.end())
+    {
+        int removed_index = index->second;
+        Node *removed_node = this->input_slots[removed_index]->get();
+        if (removed_node)
+        {
+            removed_node->remove_output(this, removed_index);
+        }
+        this->input_slots.erase(this->input_slots.begin() + removed_index);
+        this->input_names.erase(this->input_names.begin() + removed_index);
+        this->input_rates.erase(this->input_rates.begin() + removed_index);
+        this->input_indices.erase(index);
+
+        /*------------------------------------------------------------------------
+         * Later inputs move to earlier slots, so their nodes' outputs are
+         * updated to match.
+         *-----------------------------------------------------------------------*/
+        for (size_t later_index = removed_index; later_index < this->input_names.size(); later_index++)
+        {
+            this->input_indices[this->input_names[later_index]] = (int) later_index;
+            Node *later_node = this->input_slots[later_index]->get();
+            if (later_node)
+            {
+                later_node->remove_output(this, (int) later_index + 1);
+                later_node->add_output(this, (int) later_index);
+            }
+        }
+    }
+    if (this->graph)
+    {
+        this->graph->invalidate_topology();
+    }
+    if (this->patch)
+    {
+        this->patch->has_bindings = false;
+    }
     this->update_channels();
 }
 
+int Node::get_input_index(const std::string &name)
+{
+    auto index = this->input_indices.find(name);
+    if (index == this->input_indices.end())
+    {
+        return -1;
+    }
+    return index->second;
+}
+
 NodeRef Node::get_input(std::string name)
 {
-    if (this->inputs.find(name) == this->inputs.end())
+    int index = this->get_input_index(name);
+    if (index < 0)
     {
         throw std::runtime_error("Node " + this->name + " has no such input: " + name);
     }
 
-    return *(this->inputs[name]);
+    return *(this->input_slots[index]);
+}
+
+NodeRef Node::get_input(int index)
+{
+    assert(index >= 0 && index < (int) this->input_slots.size());
+    return *(this->input_slots[index]);
+}
+
+signalflow_input_rate_t Node::get_input_rate(const std::string &name)
+{
+    int index = this->get_input_index(name);
+    if (index < 0)
+    {
+        return SIGNALFLOW_INPUT_RATE_AUDIO;
+    }
+    return this->input_rates[index];
+}
+
+signalflow_input_rate_t Node::get_input_rate(int index)
+{
+    assert(index >= 0 && index < (int) this->input_rates.size());
+    return this->input_rates[index];
 }
 
 void Node::set_input(std::string name, const NodeRef &node)
 {
-    if (this->inputs.find(name) == this->inputs.end())
+    int index = this->get_input_index(name);
+    if (index < 0)
     {
         throw std::runtime_error("Node " + this->name + " has no such input: " + name);
     }
 
-    NodeRef current_input = *(this->inputs[name]);
+    this->set_input(index, node);
+}
+
+void Node::set_input(int index, const NodeRef &node)
+{
+    assert(index >= 0 && index < (int) this->input_slots.size());
+    check_same_graph(this, node.get());
 
-    if (current_input)
+    NodeRef previous;
+    this->apply_input(index, node, previous);
+    if (previous)
+    {
+        previous->remove_output(this, index);
+    }
+    if (node)
     {
-        current_input->remove_output(this, name);
+        node->add_output(this, index);
     }
+}
+
+void Node::prepare_input(int index, const NodeRef &node)
+{
+    assert(index >= 0 && index < (int) this->input_slots.size());
+    check_same_graph(this, node.get());
 
-    *(this->inputs[name]) = node;
+    /*------------------------------------------------------------------------
+     * Make the checks that update_channels() would make when the input is
+     * applied. A node that matches its input channels only allocates if it
+     * grows beyond the channels it has already allocated.
+     *-----------------------------------------------------------------------*/
+    if (!this->matches_input_channels && node->get_num_output_channels() > this->num_input_channels)
+    {
+        throw invalid_channel_count_exception("Node " + node->name + " has more output channels than " + this->name + " supports. Either downmix with ChannelMixer, or select the intended channels with ChannelSelect.");
+    }
+    if (this->matches_input_channels && node->get_num_output_channels() > this->num_output_channels_allocated)
+    {
+        throw invalid_channel_count_exception("Node " + node->name + " has more output channels than " + this->name + " has allocated, so cannot be set from the audio thread. Set it with set_input() instead.");
+    }
+
+    node->add_output(this, index);
+    this->input_changing(index, node);
+}
+
+void Node::apply_input(int index, const NodeRef &node, NodeRef &previous)
+{
+    NodeRef *slot = this->input_slots[index];
+    previous = *slot;
+    *slot = node;
+    if (this->graph)
+    {
+        this->graph->invalidate_topology();
+    }
     this->update_channels();
+    this->input_changed(index, previous);
+}
 
-    node->add_output(this, name);
+void Node::input_changing(int index, const NodeRef &node)
+{
+}
+
+void Node::input_changed(int index, const NodeRef &previous)
+{
+}
+
+bool Node::skip_input(int index)
+{
+    return false;
 }
 
 void Node::set_input(std::string name, float value)
 {
-    if (this->inputs.find(name) == this->inputs.end())
+    int index = this->get_input_index(name);
+    if (index < 0)
     {
         throw std::runtime_error("Node " + this->name + " has no such input: " + name);
     }
 
-    NodeRef current_input = *(this->inputs[name]);
+    NodeRef current_input = *(this->input_slots[index]);
 
     if (current_input && current_input->name == "constant")
     {
@@ -341,6 +613,7 @@ void Node::set_input(std::string name, float value)
     }
     else
     {
+        AudioGraphContext context(this->graph);
         this->set_input(name, new Constant(value));
     }
 }
@@ -355,21 +628,34 @@ void Node::remove_input(NodeRef input)
     throw std::runtime_error("This Node class does not support unnamed inputs");
 }
 
-void Node::add_output(Node *target, std::string name)
+void Node::add_output(Node *target, int index)
+{
+    this->outputs.insert(std::make_pair(target, index));
+}
+
+void Node::remove_output(Node *target, int index)
 {
-    this->outputs.insert(std::make_pair(target, name));
+    this->outputs.erase(std::make_pair(target, index));
 }
 
-void Node::remove_output(Node *target, std::string name)
+void Node::detach_from_inputs()
 {
-    this->outputs.erase(std::make_pair(target, name));
+    for (size_t index = 0; index < this->input_slots.size(); index++)
+    {
+        Node *input_node = this->input_slots[index]->get();
+        if (input_node)
+        {
+            input_node->remove_output(this, (int) index);
+        }
+    }
 }
 
 void Node::disconnect_inputs()
 {
-    for (auto param : this->inputs)
+    std::vector<std::string> names = this->input_names;
+    for (auto name : names)
     {
-        this->set_input(param.first, 0);
+        this->set_input(name, 0);
     }
 }
 
@@ -386,8 +672,8 @@ void Node::disconnect_outputs()
     {
         auto output = *(this->outputs.begin());
         Node *target = output.first;
-        std::string name = output.second;
-        //        target->set_input(name, new Constant(0.0));
+        int index = output.second;
+        //        target->set_input(index, new Constant(0.0));
 
         // This is causing crashes
         if (target->has_variable_inputs)
@@ -396,7 +682,7 @@ void Node::disconnect_outputs()
         }
         else
         {
-            target->set_input(name, new Constant(0.0));
+            target->set_input(index, new Constant(0.0));
         }
     }
 }
@@ -446,6 +732,10 @@ void Node::set_buffer(std::string name, BufferRef buffer)
         throw std::runtime_error("Node " + this->name + " has no such buffer: " + name);
 
     *(this->buffers[name]) = buffer;
+    if (this->graph)
+    {
+        this->graph->invalidate_topology();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -477,7 +767,22 @@ void Node::set_patch(Patch *patch)
 
 void Node::trigger(std::string name, float value)
 {
-    throw std::runtime_error("Trigger " + name + " is not implemented in node class " + this->name);
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        /*------------------------------------------------------------------------
+         * If triggered between sub-blocks, keep the frames already rendered.
+         *-----------------------------------------------------------------------*/
+        int frames_rendered = this->supports_sub_blocks ? this->block_offset : 0;
+        for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
+        {
+            memset(this->out[channel], 0, (this->output_buffer_length - frames_rendered) * sizeof(sample));
+            this->last_sample[channel] = 0.0;
+        }
+    }
+    else
+    {
+        throw std::runtime_error("Trigger " + name + " is not implemented in node class " + this->name);
+    }
 }
 
 void Node::poll(float frequency, std::string label)
@@ -523,23 +828,23 @@ UnaryOpNode::UnaryOpNode(NodeRef a)
 
 template <class T>
 NodeRefTemplate<T>::NodeRefTemplate(double x)
-    : std::shared_ptr<T>(new Constant(x)) {}
+    : NodeRefTemplate(new Constant(x)) {}
 
 template <class T>
 NodeRefTemplate<T>::NodeRefTemplate(int x)
-    : std::shared_ptr<T>(new Constant((float) x)) {}
+    : NodeRefTemplate(new Constant((float) x)) {}
 
 template <class T>
 NodeRefTemplate<T>::NodeRefTemplate(std::initializer_list<NodeRefTemplate> x)
-    : std::shared_ptr<T>(new ChannelArray(x)) {}
+    : NodeRefTemplate(new ChannelArray(x)) {}
 
 template <class T>
 NodeRefTemplate<T>::NodeRefTemplate(std::vector<NodeRefTemplate> x)
-    : std::shared_ptr<T>(new ChannelArray(x)) {}
+    : NodeRefTemplate(new ChannelArray(x)) {}
 
 template <class T>
 NodeRefTemplate<T>::NodeRefTemplate(std::vector<float> x)
-    : std::shared_ptr<T>(new ChannelArray(x)) {}
+    : NodeRefTemplate(new ChannelArray(x)) {}
 
 template <class T>
 NodeRefTemplate<T> NodeRefTemplate<T>::operator*(NodeRefTemplate<T> other)
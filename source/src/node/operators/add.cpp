@@ -1,27 +1,34 @@
 #include "signalflow/node/operators/add.h"
 
+#include "signalflow/node/kernel.h"
+
 namespace signalflow
 {
 
+class AddKernel : public NodeKernel
+{
+public:
+    inline sample process(sample a, sample b) { return a + b; }
+};
+
 Add::Add(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "add";
+    this->supports_control_rate = true;
 }
 
 void Add::process(Buffer &out, int num_frames)
 {
+#ifdef __APPLE__
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
-#ifdef __APPLE__
         vDSP_vadd(input0->out[channel], 1, input1->out[channel], 1, out[channel], 1, num_frames);
+    }
 #else
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            out[channel][frame] = input0->out[channel][frame] + input1->out[channel][frame];
-        }
+    AddKernel kernel;
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->input0, this->input1);
 #endif
-    }
 }
 
 }
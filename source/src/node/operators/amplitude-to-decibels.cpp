@@ -8,6 +8,7 @@ AmplitudeToDecibels::AmplitudeToDecibels(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "amplitude-to-decibels";
+    this->supports_control_rate = true;
 }
 
 void AmplitudeToDecibels::process(Buffer &out, int num_frames)
@@ -25,6 +26,7 @@ DecibelsToAmplitude::DecibelsToAmplitude(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "decibels-to-amplitude";
+    this->supports_control_rate = true;
 }
 
 void DecibelsToAmplitude::process(Buffer &out, int num_frames)
@@ -79,13 +79,13 @@ void ChannelArray::update_channels()
 void ChannelArray::add_input(NodeRef input)
 {
     this->input_list.push_back(input);
-    std::string input_name = "input" + std::to_string(this->inputs.size());
+    std::string input_name = "input" + std::to_string(this->input_slots.size());
     this->Node::create_input(input_name, input_list.back());
 }
 
 void ChannelArray::set_input(std::string name, const NodeRef &node)
 {
-    if (this->inputs.find(name) == this->inputs.end())
+    if (this->get_input_index(name) < 0)
     {
         this->input_list.push_back(node);
         this->Node::create_input(name, input_list.back());
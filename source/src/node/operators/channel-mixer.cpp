@@ -14,14 +14,48 @@ ChannelMixer::ChannelMixer(int channels, NodeRef input, bool amplitude_compensat
 
 void ChannelMixer::process(Buffer &out, int num_frames)
 {
-    float out_channel_pan,
-        in_channel_pan;
-
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
         memset(out[channel], 0, num_frames * sizeof(sample));
     }
 
+    for (int out_channel = 0; out_channel < this->channels; out_channel++)
+    {
+        for (int in_channel = 0; in_channel < this->num_input_channels; in_channel++)
+        {
+            float channel_amp = this->channel_amps[out_channel * this->num_input_channels + in_channel];
+            if (channel_amp == 0.0)
+                continue;
+
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                out[out_channel][frame] += channel_amp * this->input->out[in_channel][frame];
+            }
+        }
+    }
+}
+
+void ChannelMixer::update_channels()
+{
+    this->set_channels(this->input->get_num_output_channels(), this->channels);
+
+    if (this->amplitude_compensation)
+    {
+        this->amplitude_compensation_level = (float) this->num_output_channels / this->num_input_channels;
+        if (this->amplitude_compensation_level > 1.0)
+        {
+            this->amplitude_compensation_level = 1.0;
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Gains depend only on the channel counts, so are computed here rather
+     * than on every block.
+     *-----------------------------------------------------------------------*/
+    float out_channel_pan,
+        in_channel_pan;
+
+    this->channel_amps.resize(this->channels * this->num_input_channels);
     for (int out_channel = 0; out_channel < this->channels; out_channel++)
     {
         /*------------------------------------------------------------------------
@@ -50,26 +84,7 @@ void ChannelMixer::process(Buffer &out, int num_frames)
                                                        0, 1);
                 channel_amp = signalflow_clip(channel_amp, 0, 1);
             }
-            channel_amp = channel_amp * this->amplitude_compensation_level;
-
-            for (int frame = 0; frame < num_frames; frame++)
-            {
-                out[out_channel][frame] += channel_amp * this->input->out[in_channel][frame];
-            }
-        }
-    }
-}
-
-void ChannelMixer::update_channels()
-{
-    this->set_channels(this->input->get_num_output_channels(), this->channels);
-
-    if (this->amplitude_compensation)
-    {
-        this->amplitude_compensation_level = (float) this->num_output_channels / this->num_input_channels;
-        if (this->amplitude_compensation_level > 1.0)
-        {
-            this->amplitude_compensation_level = 1.0;
+            this->channel_amps[out_channel * this->num_input_channels + in_channel] = channel_amp * this->amplitude_compensation_level;
         }
     }
 
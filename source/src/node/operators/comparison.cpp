@@ -7,6 +7,7 @@ Equal::Equal(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "equals";
+    this->supports_control_rate = true;
 }
 
 void Equal::process(Buffer &out, int num_frames)
@@ -20,6 +21,7 @@ NotEqual::NotEqual(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "not-equal";
+    this->supports_control_rate = true;
 }
 
 void NotEqual::process(Buffer &out, int num_frames)
@@ -33,6 +35,7 @@ GreaterThan::GreaterThan(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "greater-than";
+    this->supports_control_rate = true;
 }
 
 void GreaterThan::process(Buffer &out, int num_frames)
@@ -46,6 +49,7 @@ GreaterThanOrEqual::GreaterThanOrEqual(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "greater-than-or-equal";
+    this->supports_control_rate = true;
 }
 
 void GreaterThanOrEqual::process(Buffer &out, int num_frames)
@@ -59,6 +63,7 @@ LessThan::LessThan(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "less-than";
+    this->supports_control_rate = true;
 }
 
 void LessThan::process(Buffer &out, int num_frames)
@@ -72,6 +77,7 @@ LessThanOrEqual::LessThanOrEqual(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "less-than-or-equal";
+    this->supports_control_rate = true;
 }
 
 void LessThanOrEqual::process(Buffer &out, int num_frames)
@@ -85,6 +91,7 @@ Modulo::Modulo(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "modulo";
+    this->supports_control_rate = true;
 }
 
 void Modulo::process(Buffer &out, int num_frames)
@@ -98,6 +105,7 @@ Abs::Abs(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "abs";
+    this->supports_control_rate = true;
 }
 
 void Abs::process(Buffer &out, int num_frames)
@@ -111,6 +119,7 @@ If::If(NodeRef a, NodeRef value_if_true, NodeRef value_if_false)
     : UnaryOpNode(a), value_if_true(value_if_true), value_if_false(value_if_false)
 {
     this->name = "if";
+    this->supports_control_rate = true;
 
     this->create_input("value_if_true", this->value_if_true);
     this->create_input("value_if_false", this->value_if_false);
@@ -1,23 +1,27 @@
 #include "signalflow/node/operators/divide.h"
 
+#include "signalflow/node/kernel.h"
+
 namespace signalflow
 {
 
+class DivideKernel : public NodeKernel
+{
+public:
+    inline sample process(sample a, sample b) { return a / b; }
+};
+
 Divide::Divide(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "divide";
+    this->supports_control_rate = true;
 }
 
 void Divide::process(Buffer &out, int num_frames)
 {
-    for (int frame = 0; frame < num_frames; frame++)
-    {
-        for (int channel = 0; channel < this->num_output_channels; channel++)
-        {
-            out[channel][frame] = input0->out[channel][frame] / input1->out[channel][frame];
-        }
-    }
+    DivideKernel kernel;
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->input0, this->input1);
 }
 
 }
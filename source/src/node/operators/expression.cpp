@@ -0,0 +1,1106 @@
+#include "signalflow/core/graph.h"
+#include "signalflow/core/util.h"
+#include "signalflow/node/operators/expression.h"
+#include "signalflow/node/oscillators/constant.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace signalflow
+{
+
+/*------------------------------------------------------------------------
+ * Per-sample maths for each operation, shared by constant folding and
+ * block processing. Each matches the process() of the corresponding node.
+ *-----------------------------------------------------------------------*/
+class ExpressionAdd
+{
+public:
+    static inline sample apply(sample a, sample b) { return a + b; }
+};
+
+class ExpressionSubtract
+{
+public:
+    static inline sample apply(sample a, sample b) { return a - b; }
+};
+
+class ExpressionMultiply
+{
+public:
+    static inline sample apply(sample a, sample b) { return a * b; }
+};
+
+class ExpressionDivide
+{
+public:
+    static inline sample apply(sample a, sample b) { return a / b; }
+};
+
+class ExpressionPow
+{
+public:
+    static inline sample apply(sample a, sample b) { return powf(a, b); }
+};
+
+class ExpressionModulo
+{
+public:
+    static inline sample apply(sample a, sample b) { return fmodf(a, b); }
+};
+
+class ExpressionEqual
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a == b); }
+};
+
+class ExpressionNotEqual
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a != b); }
+};
+
+class ExpressionGreaterThan
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a > b); }
+};
+
+class ExpressionGreaterThanOrEqual
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a >= b); }
+};
+
+class ExpressionLessThan
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a < b); }
+};
+
+class ExpressionLessThanOrEqual
+{
+public:
+    static inline sample apply(sample a, sample b) { return (int) (a <= b); }
+};
+
+class ExpressionAbs
+{
+public:
+    static inline sample apply(sample a) { return fabsf(a); }
+};
+
+class ExpressionRound
+{
+public:
+    static inline sample apply(sample a) { return roundf(a); }
+};
+
+class ExpressionSin
+{
+public:
+    static inline sample apply(sample a) { return sinf(a); }
+};
+
+class ExpressionCos
+{
+public:
+    static inline sample apply(sample a) { return cosf(a); }
+};
+
+class ExpressionTan
+{
+public:
+    static inline sample apply(sample a) { return tanf(a); }
+};
+
+class ExpressionTanh
+{
+public:
+    static inline sample apply(sample a) { return tanhf(a); }
+};
+
+class ExpressionClip
+{
+public:
+    static inline sample apply(sample value, sample min, sample max)
+    {
+        value = (value < min) ? min : value;
+        return (value > max) ? max : value;
+    }
+};
+
+class ExpressionWrap
+{
+public:
+    static inline sample apply(sample value, sample min, sample max) { return signalflow_wrap(value, min, max); }
+};
+
+class ExpressionFold
+{
+public:
+    static inline sample apply(sample value, sample min, sample max) { return signalflow_fold(value, min, max); }
+};
+
+class ExpressionIf
+{
+public:
+    static inline sample apply(sample value, sample value_if_true, sample value_if_false)
+    {
+        return value ? value_if_true : value_if_false;
+    }
+};
+
+class ExpressionScaleLinLin
+{
+public:
+    static inline sample apply(sample value, sample a, sample b, sample c, sample d)
+    {
+        float norm = (value - a) / (b - a);
+        return c + (d - c) * norm;
+    }
+};
+
+class ExpressionScaleLinExp
+{
+public:
+    static inline sample apply(sample value, sample a, sample b, sample c, sample d)
+    {
+        float norm = (value - a) / (b - a);
+        return powf(d / c, norm) * c;
+    }
+};
+
+class ExpressionOperation
+{
+public:
+    signalflow_expression_op_t op;
+    const char *name;
+    int num_operands;
+    const char *input_names[SIGNALFLOW_EXPRESSION_MAX_OPERANDS];
+};
+
+static const ExpressionOperation expression_operations[] = {
+    { SIGNALFLOW_EXPRESSION_ADD, "add", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_SUBTRACT, "subtract", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_MULTIPLY, "multiply", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_DIVIDE, "divide", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_POW, "pow", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_MODULO, "modulo", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_EQUAL, "equals", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_NOT_EQUAL, "not-equal", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_GREATER_THAN, "greater-than", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_GREATER_THAN_OR_EQUAL, "greater-than-or-equal", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_LESS_THAN, "less-than", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_LESS_THAN_OR_EQUAL, "less-than-or-equal", 2, { "input0", "input1" } },
+    { SIGNALFLOW_EXPRESSION_ABS, "abs", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_ROUND, "round", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_SIN, "sin", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_COS, "cos", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_TAN, "tan", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_TANH, "tanh", 1, { "input" } },
+    { SIGNALFLOW_EXPRESSION_CLIP, "clip", 3, { "input", "min", "max" } },
+    { SIGNALFLOW_EXPRESSION_WRAP, "wrap", 3, { "input", "min", "max" } },
+    { SIGNALFLOW_EXPRESSION_FOLD, "fold", 3, { "input", "min", "max" } },
+    { SIGNALFLOW_EXPRESSION_IF, "if", 3, { "input", "value_if_true", "value_if_false" } },
+    { SIGNALFLOW_EXPRESSION_SCALE_LIN_LIN, "scale-lin-lin", 5, { "input", "a", "b", "c", "d" } },
+    { SIGNALFLOW_EXPRESSION_SCALE_LIN_EXP, "scale-lin-exp", 5, { "input", "a", "b", "c", "d" } }
+};
+
+static const ExpressionOperation *expression_find_operation(signalflow_expression_op_t op)
+{
+    for (const ExpressionOperation &operation : expression_operations)
+    {
+        if (operation.op == op)
+        {
+            return &operation;
+        }
+    }
+    return nullptr;
+}
+
+static const ExpressionOperation *expression_find_operation(const std::string &name)
+{
+    for (const ExpressionOperation &operation : expression_operations)
+    {
+        if (name == operation.name)
+        {
+            return &operation;
+        }
+    }
+    return nullptr;
+}
+
+/*------------------------------------------------------------------------
+ * ExpressionTree
+ *-----------------------------------------------------------------------*/
+
+ExpressionTree::ExpressionTree(float value)
+    : op(SIGNALFLOW_EXPRESSION_CONSTANT), value(value), input_index(-1)
+{
+}
+
+ExpressionTree::ExpressionTree(signalflow_expression_op_t op, std::vector<ExpressionTree> operands)
+    : op(op), value(0.0), input_index(-1), operands(operands)
+{
+    const ExpressionOperation *operation = expression_find_operation(op);
+    if (!operation)
+    {
+        throw std::runtime_error("Expression: Invalid operation");
+    }
+    if ((int) operands.size() != operation->num_operands)
+    {
+        throw std::runtime_error("Expression: " + std::string(operation->name) + " takes " + std::to_string(operation->num_operands) + " operands");
+    }
+
+    /*------------------------------------------------------------------------
+     * Fold operations on constants.
+     *-----------------------------------------------------------------------*/
+    sample values[SIGNALFLOW_EXPRESSION_MAX_OPERANDS];
+    for (int index = 0; index < operation->num_operands; index++)
+    {
+        if (!operands[index].is_constant())
+        {
+            return;
+        }
+        values[index] = operands[index].value;
+    }
+    this->value = ExpressionTree::apply(op, values);
+    this->op = SIGNALFLOW_EXPRESSION_CONSTANT;
+    this->operands.clear();
+}
+
+ExpressionTree ExpressionTree::input(int index)
+{
+    ExpressionTree tree;
+    tree.op = SIGNALFLOW_EXPRESSION_INPUT;
+    tree.input_index = index;
+    return tree;
+}
+
+static void expression_skip_whitespace(const std::string &text, size_t &position)
+{
+    while (position < text.size() && isspace(text[position]))
+    {
+        position++;
+    }
+}
+
+static ExpressionTree expression_parse(const std::string &text, size_t &position)
+{
+    expression_skip_whitespace(text, position);
+    if (position >= text.size())
+    {
+        throw std::runtime_error("Expression: Unexpected end of expression");
+    }
+
+    if (text[position] == '(')
+    {
+        position++;
+        size_t start = position;
+        while (position < text.size() && !isspace(text[position]) && text[position] != '(' && text[position] != ')')
+        {
+            position++;
+        }
+        std::string name = text.substr(start, position - start);
+        const ExpressionOperation *operation = expression_find_operation(name);
+        if (!operation)
+        {
+            throw std::runtime_error("Expression: Unknown operation: " + name);
+        }
+
+        std::vector<ExpressionTree> operands;
+        while (true)
+        {
+            expression_skip_whitespace(text, position);
+            if (position >= text.size())
+            {
+                throw std::runtime_error("Expression: Missing closing bracket");
+            }
+            if (text[position] == ')')
+            {
+                position++;
+                break;
+            }
+            operands.push_back(expression_parse(text, position));
+        }
+        return ExpressionTree(operation->op, operands);
+    }
+
+    const char *start = text.c_str() + position;
+    char *end = nullptr;
+    if (text[position] == '$')
+    {
+        long index = strtol(start + 1, &end, 10);
+        if (end == start + 1 || index < 0)
+        {
+            throw std::runtime_error("Expression: Invalid input: " + text.substr(position));
+        }
+        position += end - start;
+        return ExpressionTree::input((int) index);
+    }
+
+    float value = strtof(start, &end);
+    if (end == start)
+    {
+        throw std::runtime_error("Expression: Invalid token: " + text.substr(position));
+    }
+    position += end - start;
+    return ExpressionTree(value);
+}
+
+ExpressionTree ExpressionTree::parse(std::string text)
+{
+    size_t position = 0;
+    ExpressionTree tree = expression_parse(text, position);
+    expression_skip_whitespace(text, position);
+    if (position != text.size())
+    {
+        throw std::runtime_error("Expression: Unexpected text after expression: " + text.substr(position));
+    }
+    return tree;
+}
+
+bool ExpressionTree::get_node_operation(std::string node_name,
+                                        signalflow_expression_op_t &op,
+                                        std::vector<std::string> &input_names)
+{
+    const ExpressionOperation *operation = expression_find_operation(node_name);
+    if (!operation)
+    {
+        return false;
+    }
+    op = operation->op;
+    input_names.assign(operation->input_names, operation->input_names + operation->num_operands);
+    return true;
+}
+
+std::string ExpressionTree::get_op_name(signalflow_expression_op_t op)
+{
+    const ExpressionOperation *operation = expression_find_operation(op);
+    return operation ? operation->name : "";
+}
+
+sample ExpressionTree::apply(signalflow_expression_op_t op, const sample *operands)
+{
+    switch (op)
+    {
+        case SIGNALFLOW_EXPRESSION_ADD:
+            return ExpressionAdd::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_SUBTRACT:
+            return ExpressionSubtract::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_MULTIPLY:
+            return ExpressionMultiply::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_DIVIDE:
+            return ExpressionDivide::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_POW:
+            return ExpressionPow::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_MODULO:
+            return ExpressionModulo::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_EQUAL:
+            return ExpressionEqual::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_NOT_EQUAL:
+            return ExpressionNotEqual::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_GREATER_THAN:
+            return ExpressionGreaterThan::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_GREATER_THAN_OR_EQUAL:
+            return ExpressionGreaterThanOrEqual::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_LESS_THAN:
+            return ExpressionLessThan::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_LESS_THAN_OR_EQUAL:
+            return ExpressionLessThanOrEqual::apply(operands[0], operands[1]);
+        case SIGNALFLOW_EXPRESSION_ABS:
+            return ExpressionAbs::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_ROUND:
+            return ExpressionRound::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_SIN:
+            return ExpressionSin::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_COS:
+            return ExpressionCos::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_TAN:
+            return ExpressionTan::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_TANH:
+            return ExpressionTanh::apply(operands[0]);
+        case SIGNALFLOW_EXPRESSION_CLIP:
+            return ExpressionClip::apply(operands[0], operands[1], operands[2]);
+        case SIGNALFLOW_EXPRESSION_WRAP:
+            return ExpressionWrap::apply(operands[0], operands[1], operands[2]);
+        case SIGNALFLOW_EXPRESSION_FOLD:
+            return ExpressionFold::apply(operands[0], operands[1], operands[2]);
+        case SIGNALFLOW_EXPRESSION_IF:
+            return ExpressionIf::apply(operands[0], operands[1], operands[2]);
+        case SIGNALFLOW_EXPRESSION_SCALE_LIN_LIN:
+            return ExpressionScaleLinLin::apply(operands[0], operands[1], operands[2], operands[3], operands[4]);
+        case SIGNALFLOW_EXPRESSION_SCALE_LIN_EXP:
+            return ExpressionScaleLinExp::apply(operands[0], operands[1], operands[2], operands[3], operands[4]);
+        default:
+            throw std::runtime_error("Expression: Invalid operation");
+    }
+}
+
+signalflow_expression_op_t ExpressionTree::get_op() const
+{
+    return this->op;
+}
+
+float ExpressionTree::get_value() const
+{
+    return this->value;
+}
+
+int ExpressionTree::get_input_index() const
+{
+    return this->input_index;
+}
+
+const std::vector<ExpressionTree> &ExpressionTree::get_operands() const
+{
+    return this->operands;
+}
+
+bool ExpressionTree::is_constant() const
+{
+    return this->op == SIGNALFLOW_EXPRESSION_CONSTANT;
+}
+
+int ExpressionTree::get_num_operations() const
+{
+    if (this->op == SIGNALFLOW_EXPRESSION_CONSTANT || this->op == SIGNALFLOW_EXPRESSION_INPUT)
+    {
+        return 0;
+    }
+    int count = 1;
+    for (const ExpressionTree &operand : this->operands)
+    {
+        count += operand.get_num_operations();
+    }
+    return count;
+}
+
+int ExpressionTree::get_num_inputs() const
+{
+    if (this->op == SIGNALFLOW_EXPRESSION_INPUT)
+    {
+        return this->input_index + 1;
+    }
+    int count = 0;
+    for (const ExpressionTree &operand : this->operands)
+    {
+        int operand_inputs = operand.get_num_inputs();
+        count = MAX(count, operand_inputs);
+    }
+    return count;
+}
+
+ExpressionTree ExpressionTree::substitute(const std::vector<ExpressionTree> &inputs) const
+{
+    if (this->op == SIGNALFLOW_EXPRESSION_CONSTANT)
+    {
+        return *this;
+    }
+    if (this->op == SIGNALFLOW_EXPRESSION_INPUT)
+    {
+        if (this->input_index >= (int) inputs.size())
+        {
+            throw std::runtime_error("Expression: No substitute for input $" + std::to_string(this->input_index));
+        }
+        return inputs[this->input_index];
+    }
+
+    std::vector<ExpressionTree> operands;
+    for (const ExpressionTree &operand : this->operands)
+    {
+        operands.push_back(operand.substitute(inputs));
+    }
+    return ExpressionTree(this->op, operands);
+}
+
+std::string ExpressionTree::to_string() const
+{
+    if (this->op == SIGNALFLOW_EXPRESSION_CONSTANT)
+    {
+        /*------------------------------------------------------------------------
+         * Nine significant digits are enough for any float to be read back
+         * exactly.
+         *-----------------------------------------------------------------------*/
+        char text[32];
+        snprintf(text, sizeof(text), "%.9g", this->value);
+        return text;
+    }
+    if (this->op == SIGNALFLOW_EXPRESSION_INPUT)
+    {
+        return "$" + std::to_string(this->input_index);
+    }
+
+    std::string text = "(" + ExpressionTree::get_op_name(this->op);
+    for (const ExpressionTree &operand : this->operands)
+    {
+        text += " " + operand.to_string();
+    }
+    return text + ")";
+}
+
+/*------------------------------------------------------------------------
+ * Expression
+ *-----------------------------------------------------------------------*/
+
+Expression::Expression(std::string expression, std::vector<NodeRef> inputs)
+    : Expression(ExpressionTree::parse(expression), inputs)
+{
+}
+
+Expression::Expression(ExpressionTree tree, std::vector<NodeRef> inputs)
+    : expression(tree.to_string()), program_changed(false)
+{
+    this->name = "expression";
+    this->supports_control_rate = true;
+    this->add_property("expression", this->expression);
+
+    for (NodeRef input : inputs)
+    {
+        this->input_list.push_back(input);
+        this->create_input("input" + std::to_string(this->input_refs.size()), this->input_list.back());
+        this->input_refs.push_back(&this->input_list.back());
+    }
+    this->compile(tree);
+}
+
+void Expression::create_inputs(int num_inputs)
+{
+    while ((int) this->input_refs.size() < num_inputs)
+    {
+        this->input_list.push_back(NodeRef(0.0));
+        this->create_input("input" + std::to_string(this->input_refs.size()), this->input_list.back());
+        this->input_refs.push_back(&this->input_list.back());
+    }
+}
+
+void Expression::set_input(std::string name, const NodeRef &node)
+{
+    if (this->get_input_index(name) < 0 && name.compare(0, 5, "input") == 0)
+    {
+        const char *digits = name.c_str() + 5;
+        char *end = nullptr;
+        long index = strtol(digits, &end, 10);
+        if (end != digits && *end == '\0' && index >= 0)
+        {
+            this->create_inputs((int) index + 1);
+        }
+    }
+
+    this->Node::set_input(name, node);
+}
+
+void Expression::input_changing(int index, const NodeRef &input)
+{
+    /*------------------------------------------------------------------------
+     * Compile the program for the new input before it is set on the audio
+     * thread, so that input_changed() finds it already compiled. Other
+     * inputs are taken from the last program compiled, so that it also
+     * includes any changes queued before this one.
+     *-----------------------------------------------------------------------*/
+    bool is_constant = input && input->is_constant;
+    if (index < (int) this->constant_inputs.size() && is_constant != this->constant_inputs[index])
+    {
+        std::vector<bool> constant_inputs = this->constant_inputs;
+        constant_inputs[index] = is_constant;
+        this->compile(this->tree, constant_inputs);
+    }
+}
+
+void Expression::input_changed(int index, const NodeRef &previous)
+{
+    /*------------------------------------------------------------------------
+     * Whether an input is read as a single value per block is decided when
+     * the expression is compiled, so recompile if that changes.
+     *-----------------------------------------------------------------------*/
+    NodeRef input = this->get_input(index);
+    bool is_constant = input && input->is_constant;
+    if (index < (int) this->constant_inputs.size() && is_constant != this->constant_inputs[index])
+    {
+        this->compile(this->tree);
+    }
+}
+
+void Expression::set_property(std::string name, const PropertyRef &value)
+{
+    this->Node::set_property(name, value);
+    if (name == "expression")
+    {
+        this->compile(ExpressionTree::parse(value->string_value()));
+    }
+}
+
+ExpressionTree Expression::get_expression()
+{
+    return this->tree;
+}
+
+NodeRef Expression::fuse(NodeRef node)
+{
+    std::vector<NodeRef> leaves;
+    ExpressionTree tree;
+    if (!Expression::merge(node, leaves, tree, true))
+    {
+        return node;
+    }
+
+    AudioGraphContext context(node->get_graph());
+    if (tree.is_constant())
+    {
+        return new Constant(tree.get_value());
+    }
+    return new Expression(tree, leaves);
+}
+
+bool Expression::merge(const NodeRef &node, std::vector<NodeRef> &leaves, ExpressionTree &tree, bool is_root)
+{
+    /*------------------------------------------------------------------------
+     * An operand that is read by anything other than the node being merged
+     * is kept as an input, so that its output is not computed twice.
+     *-----------------------------------------------------------------------*/
+    if (!node || node->get_patch() || (!is_root && node->outputs.size() > 1))
+    {
+        return false;
+    }
+    for (NodeRef *input : node->input_slots)
+    {
+        if (!*input)
+        {
+            return false;
+        }
+    }
+
+    if (node->name == "expression")
+    {
+        Expression *expression = (Expression *) node.get();
+        std::vector<ExpressionTree> inputs;
+        for (NodeRef *input : expression->input_refs)
+        {
+            inputs.push_back(Expression::merge_operand(*input, leaves));
+        }
+        tree = expression->tree.substitute(inputs);
+        return true;
+    }
+
+    signalflow_expression_op_t op;
+    std::vector<std::string> input_names;
+    if (!ExpressionTree::get_node_operation(node->name, op, input_names))
+    {
+        return false;
+    }
+
+    std::vector<ExpressionTree> operands;
+    for (auto input_name : input_names)
+    {
+        int index = node->get_input_index(input_name);
+        if (index < 0)
+        {
+            return false;
+        }
+        operands.push_back(Expression::merge_operand(*(node->input_slots[index]), leaves));
+    }
+    tree = ExpressionTree(op, operands);
+    return true;
+}
+
+ExpressionTree Expression::merge_operand(const NodeRef &node, std::vector<NodeRef> &leaves)
+{
+    ExpressionTree tree;
+    if (Expression::merge(node, leaves, tree, false))
+    {
+        return tree;
+    }
+    return Expression::merge_leaf(node, leaves);
+}
+
+ExpressionTree Expression::merge_leaf(const NodeRef &node, std::vector<NodeRef> &leaves)
+{
+    /*------------------------------------------------------------------------
+     * A constant input of a merged node can only be folded if nothing else
+     * holds a reference to it, as it may be a patch input, or be changed
+     * later with set_input().
+     *-----------------------------------------------------------------------*/
+    if (node->is_constant && node.use_count() == 1)
+    {
+        return ExpressionTree(node->get_value());
+    }
+
+    auto leaf = std::find(leaves.begin(), leaves.end(), node);
+    if (leaf != leaves.end())
+    {
+        return ExpressionTree::input((int) (leaf - leaves.begin()));
+    }
+    leaves.push_back(node);
+    return ExpressionTree::input((int) leaves.size() - 1);
+}
+
+void Expression::compile(ExpressionTree tree)
+{
+    this->create_inputs(tree.get_num_inputs());
+
+    std::vector<bool> constant_inputs;
+    for (NodeRef *input : this->input_refs)
+    {
+        constant_inputs.push_back(*input && (*input)->is_constant);
+    }
+    this->compile(tree, constant_inputs);
+}
+
+void Expression::compile(ExpressionTree tree, const std::vector<bool> &constant_inputs)
+{
+    this->tree = tree;
+    this->constant_inputs = constant_inputs;
+
+    std::unique_ptr<Program> program(new Program());
+    program->tree = tree;
+    program->inputs = this->input_refs;
+    program->constant_inputs = constant_inputs;
+    if (tree.get_num_operations() > 0)
+    {
+        this->compile_operand(*program, tree, 0);
+        program->instructions.back().destination = -1;
+    }
+
+    program->length = this->output_buffer_length;
+    program->registers.resize(program->num_registers * program->length);
+    program->broadcasts.resize(SIGNALFLOW_EXPRESSION_MAX_OPERANDS * program->length);
+
+    std::lock_guard<std::mutex> lock(this->program_mutex);
+    this->next_program = std::move(program);
+    this->program_changed = true;
+}
+
+Expression::Operand Expression::compile_operand(Program &program, const ExpressionTree &tree, int depth)
+{
+    Operand operand;
+    operand.index = 0;
+    operand.value = 0.0;
+
+    switch (tree.get_op())
+    {
+        case SIGNALFLOW_EXPRESSION_CONSTANT:
+            operand.kind = OPERAND_CONSTANT;
+            operand.value = tree.get_value();
+            return operand;
+
+        case SIGNALFLOW_EXPRESSION_INPUT:
+        {
+            operand.index = tree.get_input_index();
+            operand.kind = program.constant_inputs[operand.index] ? OPERAND_CONSTANT_INPUT : OPERAND_INPUT;
+            return operand;
+        }
+
+        default:
+            break;
+    }
+
+    /*------------------------------------------------------------------------
+     * Operand n is evaluated into register depth + n, so that the registers
+     * in use at any point form a stack. The result overwrites the first
+     * operand's register, which is safe as every operation is elementwise.
+     *-----------------------------------------------------------------------*/
+    Instruction instruction;
+    instruction.op = tree.get_op();
+    instruction.num_operands = (int) tree.get_operands().size();
+    for (int index = 0; index < instruction.num_operands; index++)
+    {
+        instruction.operands[index] = this->compile_operand(program, tree.get_operands()[index], depth + index);
+    }
+    instruction.destination = depth;
+    program.num_registers = MAX(program.num_registers, depth + 1);
+    program.instructions.push_back(instruction);
+
+    operand.kind = OPERAND_REGISTER;
+    operand.index = depth;
+    return operand;
+}
+
+bool Expression::can_run(const Program &program)
+{
+    for (size_t index = 0; index < program.constant_inputs.size(); index++)
+    {
+        const NodeRef &input = *program.inputs[index];
+        if (program.constant_inputs[index] && !(input && input->is_constant))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*------------------------------------------------------------------------
+ * One block of an operand: either a pointer to per-frame values, or a
+ * single value for the whole block.
+ *-----------------------------------------------------------------------*/
+class ExpressionBlock
+{
+public:
+    const sample *data;
+    sample value;
+    bool is_constant;
+};
+
+template <class Operation>
+static void expression_process_unary(const ExpressionBlock &a, sample *out, int num_frames)
+{
+    if (a.is_constant)
+    {
+        std::fill(out, out + num_frames, Operation::apply(a.value));
+    }
+    else
+    {
+        const sample *data = a.data;
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] = Operation::apply(data[frame]);
+        }
+    }
+}
+
+template <class Operation>
+static void expression_process_binary(const ExpressionBlock &a, const ExpressionBlock &b, sample *out, int num_frames)
+{
+    if (a.is_constant && b.is_constant)
+    {
+        std::fill(out, out + num_frames, Operation::apply(a.value, b.value));
+    }
+    else if (a.is_constant)
+    {
+        const sample value = a.value;
+        const sample *data = b.data;
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] = Operation::apply(value, data[frame]);
+        }
+    }
+    else if (b.is_constant)
+    {
+        const sample *data = a.data;
+        const sample value = b.value;
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] = Operation::apply(data[frame], value);
+        }
+    }
+    else
+    {
+        const sample *data_a = a.data;
+        const sample *data_b = b.data;
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] = Operation::apply(data_a[frame], data_b[frame]);
+        }
+    }
+}
+
+template <class Operation>
+static void expression_process_ternary(const sample *const *data, sample *out, int num_frames)
+{
+    const sample *data_a = data[0];
+    const sample *data_b = data[1];
+    const sample *data_c = data[2];
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        out[frame] = Operation::apply(data_a[frame], data_b[frame], data_c[frame]);
+    }
+}
+
+template <class Operation>
+static void expression_process_scale(const sample *const *data, sample *out, int num_frames)
+{
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        out[frame] = Operation::apply(data[0][frame], data[1][frame], data[2][frame], data[3][frame], data[4][frame]);
+    }
+}
+
+void Expression::process(Buffer &out, int num_frames)
+{
+    /*------------------------------------------------------------------------
+     * If the expression is being recompiled, pick up the new program at the
+     * start of the next block rather than waiting for the lock. A program
+     * compiled for a queued input is left until that input has been set.
+     *-----------------------------------------------------------------------*/
+    if (this->program_changed)
+    {
+        std::unique_lock<std::mutex> lock(this->program_mutex, std::try_to_lock);
+        if (lock.owns_lock() && this->can_run(*this->next_program))
+        {
+            this->program.swap(this->next_program);
+            this->program_changed = false;
+        }
+    }
+
+    Program *program = this->program.get();
+    if (!program)
+    {
+        for (int channel = 0; channel < this->num_output_channels; channel++)
+        {
+            memset(out[channel], 0, num_frames * sizeof(sample));
+        }
+        return;
+    }
+    int length = program->length;
+
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        /*------------------------------------------------------------------------
+         * An expression with no operations is a constant or a single input.
+         *-----------------------------------------------------------------------*/
+        if (program->instructions.empty())
+        {
+            if (program->tree.get_op() == SIGNALFLOW_EXPRESSION_INPUT)
+            {
+                Node *input = program->inputs[program->tree.get_input_index()]->get();
+                memcpy(out[channel], input->out[channel], num_frames * sizeof(sample));
+            }
+            else
+            {
+                std::fill(out[channel], out[channel] + num_frames, program->tree.get_value());
+            }
+            continue;
+        }
+
+        for (const Instruction &instruction : program->instructions)
+        {
+            ExpressionBlock blocks[SIGNALFLOW_EXPRESSION_MAX_OPERANDS];
+            for (int index = 0; index < instruction.num_operands; index++)
+            {
+                const Operand &operand = instruction.operands[index];
+                ExpressionBlock &block = blocks[index];
+                block.data = nullptr;
+                block.value = 0.0;
+                block.is_constant = false;
+
+                if (operand.kind == OPERAND_CONSTANT)
+                {
+                    block.value = operand.value;
+                    block.is_constant = true;
+                }
+                else if (operand.kind == OPERAND_CONSTANT_INPUT)
+                {
+                    block.value = (*program->inputs[operand.index])->out[channel][0];
+                    block.is_constant = true;
+                }
+                else if (operand.kind == OPERAND_INPUT)
+                {
+                    block.data = (*program->inputs[operand.index])->out[channel];
+                }
+                else
+                {
+                    block.data = program->registers.data() + operand.index * length;
+                }
+            }
+
+            /*------------------------------------------------------------------------
+             * Operations with more than two operands are rare enough that
+             * constant operands are simply broadcast to a block.
+             *-----------------------------------------------------------------------*/
+            const sample *data[SIGNALFLOW_EXPRESSION_MAX_OPERANDS];
+            if (instruction.num_operands > 2)
+            {
+                for (int index = 0; index < instruction.num_operands; index++)
+                {
+                    if (blocks[index].is_constant)
+                    {
+                        sample *broadcast = program->broadcasts.data() + index * length;
+                        std::fill(broadcast, broadcast + num_frames, blocks[index].value);
+                        data[index] = broadcast;
+                    }
+                    else
+                    {
+                        data[index] = blocks[index].data;
+                    }
+                }
+            }
+
+            sample *destination = (instruction.destination < 0) ? out[channel] : (program->registers.data() + instruction.destination * length);
+
+            switch (instruction.op)
+            {
+                case SIGNALFLOW_EXPRESSION_ADD:
+                    expression_process_binary<ExpressionAdd>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_SUBTRACT:
+                    expression_process_binary<ExpressionSubtract>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_MULTIPLY:
+                    expression_process_binary<ExpressionMultiply>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_DIVIDE:
+                    expression_process_binary<ExpressionDivide>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_POW:
+                    expression_process_binary<ExpressionPow>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_MODULO:
+                    expression_process_binary<ExpressionModulo>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_EQUAL:
+                    expression_process_binary<ExpressionEqual>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_NOT_EQUAL:
+                    expression_process_binary<ExpressionNotEqual>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_GREATER_THAN:
+                    expression_process_binary<ExpressionGreaterThan>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_GREATER_THAN_OR_EQUAL:
+                    expression_process_binary<ExpressionGreaterThanOrEqual>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_LESS_THAN:
+                    expression_process_binary<ExpressionLessThan>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_LESS_THAN_OR_EQUAL:
+                    expression_process_binary<ExpressionLessThanOrEqual>(blocks[0], blocks[1], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_ABS:
+                    expression_process_unary<ExpressionAbs>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_ROUND:
+                    expression_process_unary<ExpressionRound>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_SIN:
+                    expression_process_unary<ExpressionSin>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_COS:
+                    expression_process_unary<ExpressionCos>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_TAN:
+                    expression_process_unary<ExpressionTan>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_TANH:
+                    expression_process_unary<ExpressionTanh>(blocks[0], destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_CLIP:
+                    expression_process_ternary<ExpressionClip>(data, destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_WRAP:
+                    expression_process_ternary<ExpressionWrap>(data, destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_FOLD:
+                    expression_process_ternary<ExpressionFold>(data, destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_IF:
+                    expression_process_ternary<ExpressionIf>(data, destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_SCALE_LIN_LIN:
+                    expression_process_scale<ExpressionScaleLinLin>(data, destination, num_frames);
+                    break;
+                case SIGNALFLOW_EXPRESSION_SCALE_LIN_EXP:
+                    expression_process_scale<ExpressionScaleLinExp>(data, destination, num_frames);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+}
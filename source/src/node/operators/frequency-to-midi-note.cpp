@@ -8,6 +8,7 @@ FrequencyToMidiNote::FrequencyToMidiNote(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "frequency-to-midi-note";
+    this->supports_control_rate = true;
 }
 
 void FrequencyToMidiNote::process(Buffer &out, int num_frames)
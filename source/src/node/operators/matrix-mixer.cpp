@@ -0,0 +1,356 @@
+#include "signalflow/core/graph.h"
+#include "signalflow/core/util.h"
+#include "signalflow/node/operators/matrix-mixer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdexcept>
+#include <string.h>
+
+namespace signalflow
+{
+
+MatrixMixer::MatrixMixer(int channels, NodeRef input, signalflow_mixer_preset_t preset, float smoothing_time)
+    : UnaryOpNode(input), channels(channels), preset(preset), smoothing_time(smoothing_time), gains_changed(false)
+{
+    this->name = "matrix-mixer";
+
+    if ((preset == SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1 || preset == SIGNALFLOW_MIXER_PRESET_DOWNMIX_7_1) && channels != 2)
+    {
+        throw std::runtime_error("MatrixMixer: Downmix presets require 2 output channels");
+    }
+
+    this->update_channels();
+
+    /*------------------------------------------------------------------------
+     * Start at the initial gains, rather than ramping up to them.
+     *-----------------------------------------------------------------------*/
+    this->active_gains = this->gains;
+    this->update_routes();
+    for (auto &route : this->routes)
+    {
+        route.gain = route.target;
+        route.steps_remaining = 0;
+    }
+    this->gains_changed = false;
+}
+
+void MatrixMixer::update_channels()
+{
+    this->set_channels(this->input->get_num_output_channels(), this->channels);
+    this->resize_output_buffers(this->num_output_channels);
+
+    /*------------------------------------------------------------------------
+     * Resize the matrix, keeping any existing gains. If the matrix was set
+     * from a preset, recompute it for the new number of inputs.
+     *-----------------------------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    this->gains.resize(this->num_output_channels);
+    for (int output_channel = 0; output_channel < this->num_output_channels; output_channel++)
+    {
+        this->gains[output_channel].resize(this->num_input_channels, 0.0);
+    }
+    if (this->preset != SIGNALFLOW_MIXER_PRESET_NONE)
+    {
+        this->apply_preset(this->preset);
+    }
+    this->gains_changed = true;
+}
+
+void MatrixMixer::check_channels(int input_channel, int output_channel)
+{
+    if (input_channel < 0 || input_channel >= this->num_input_channels)
+    {
+        throw std::runtime_error("MatrixMixer: Invalid input channel (" + std::to_string(input_channel) + ")");
+    }
+    if (output_channel < 0 || output_channel >= this->num_output_channels)
+    {
+        throw std::runtime_error("MatrixMixer: Invalid output channel (" + std::to_string(output_channel) + ")");
+    }
+}
+
+void MatrixMixer::set_gain(int input_channel, int output_channel, float gain)
+{
+    this->check_channels(input_channel, output_channel);
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    this->preset = SIGNALFLOW_MIXER_PRESET_NONE;
+    this->gains[output_channel][input_channel] = gain;
+    this->gains_changed = true;
+}
+
+float MatrixMixer::get_gain(int input_channel, int output_channel)
+{
+    this->check_channels(input_channel, output_channel);
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    return this->gains[output_channel][input_channel];
+}
+
+void MatrixMixer::set_gains(std::vector<std::vector<float>> gains)
+{
+    if ((int) gains.size() != this->num_output_channels)
+    {
+        throw std::runtime_error("MatrixMixer: Gain matrix must have one row per output channel");
+    }
+    for (auto &row : gains)
+    {
+        if ((int) row.size() != this->num_input_channels)
+        {
+            throw std::runtime_error("MatrixMixer: Gain matrix must have one column per input channel");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    this->preset = SIGNALFLOW_MIXER_PRESET_NONE;
+    for (int output_channel = 0; output_channel < this->num_output_channels; output_channel++)
+    {
+        std::copy(gains[output_channel].begin(), gains[output_channel].end(), this->gains[output_channel].begin());
+    }
+    this->gains_changed = true;
+}
+
+std::vector<std::vector<float>> MatrixMixer::get_gains()
+{
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    return this->gains;
+}
+
+void MatrixMixer::set_pan(int input_channel, float pan)
+{
+    this->check_channels(input_channel, 0);
+
+    /*------------------------------------------------------------------------
+     * Zero and refill the column under one lock, so that the audio thread
+     * never picks up the column part-way through.
+     *-----------------------------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    this->preset = SIGNALFLOW_MIXER_PRESET_NONE;
+
+    for (int output_channel = 0; output_channel < this->num_output_channels; output_channel++)
+    {
+        this->gains[output_channel][input_channel] = 0.0;
+    }
+
+    float gain_lower, gain_upper;
+    int lower = signalflow_pan_equal_power(pan, this->num_output_channels, gain_lower, gain_upper);
+    this->gains[lower][input_channel] = gain_lower;
+    if (lower + 1 < this->num_output_channels)
+    {
+        this->gains[lower + 1][input_channel] = gain_upper;
+    }
+    this->gains_changed = true;
+}
+
+void MatrixMixer::set_preset(signalflow_mixer_preset_t preset)
+{
+    std::lock_guard<std::mutex> lock(this->gains_mutex);
+    this->apply_preset(preset);
+}
+
+void MatrixMixer::apply_preset(signalflow_mixer_preset_t preset)
+{
+    for (auto &row : this->gains)
+    {
+        std::fill(row.begin(), row.end(), 0.0);
+    }
+
+    switch (preset)
+    {
+        case SIGNALFLOW_MIXER_PRESET_NONE:
+            break;
+
+        case SIGNALFLOW_MIXER_PRESET_IDENTITY:
+            for (int channel = 0; channel < MIN(this->num_input_channels, this->num_output_channels); channel++)
+            {
+                this->gains[channel][channel] = 1.0;
+            }
+            break;
+
+        case SIGNALFLOW_MIXER_PRESET_SPREAD:
+            for (int input_channel = 0; input_channel < this->num_input_channels; input_channel++)
+            {
+                float pan = 0.0;
+                if (this->num_input_channels > 1)
+                {
+                    pan = -1.0 + 2.0 * input_channel / (this->num_input_channels - 1);
+                }
+                float gain_lower, gain_upper;
+                int lower = signalflow_pan_equal_power(pan, this->num_output_channels, gain_lower, gain_upper);
+                this->gains[lower][input_channel] = gain_lower;
+                if (lower + 1 < this->num_output_channels)
+                {
+                    this->gains[lower + 1][input_channel] = gain_upper;
+                }
+            }
+            break;
+
+        case SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1:
+        case SIGNALFLOW_MIXER_PRESET_DOWNMIX_7_1:
+        {
+            if (this->num_output_channels != 2)
+            {
+                throw std::runtime_error("MatrixMixer: Downmix presets require 2 output channels");
+            }
+
+            /*------------------------------------------------------------------------
+             * Input channel index, and gain to left and right outputs.
+             *-----------------------------------------------------------------------*/
+            const float h = M_SQRT1_2;
+            const float downmix[8][3] = {
+                { 0, 1, 0 },
+                { 1, 0, 1 },
+                { 2, h, h },
+                { 3, 0, 0 },
+                { 4, h, 0 },
+                { 5, 0, h },
+                { 6, h, 0 },
+                { 7, 0, h }
+            };
+            int num_sources = (preset == SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1) ? 6 : 8;
+            for (int source = 0; source < MIN(num_sources, this->num_input_channels); source++)
+            {
+                int input_channel = (int) downmix[source][0];
+                this->gains[0][input_channel] = downmix[source][1];
+                this->gains[1][input_channel] = downmix[source][2];
+            }
+            break;
+        }
+    }
+
+    this->preset = preset;
+    this->gains_changed = true;
+}
+
+int MatrixMixer::get_num_routes()
+{
+    return (int) this->routes.size();
+}
+
+void MatrixMixer::update_routes()
+{
+    int smoothing_steps = 1;
+    if (this->graph)
+    {
+        smoothing_steps = MAX(1, (int) (this->smoothing_time * this->graph->get_sample_rate()));
+    }
+
+    /*------------------------------------------------------------------------
+     * Reserve a route for every entry in the matrix. This only allocates
+     * when the number of channels has grown.
+     *-----------------------------------------------------------------------*/
+    int num_output_channels = (int) this->active_gains.size();
+    int num_input_channels = num_output_channels > 0 ? (int) this->active_gains[0].size() : 0;
+    this->routes.reserve(num_output_channels * num_input_channels);
+    this->next_routes.reserve(num_output_channels * num_input_channels);
+
+    /*------------------------------------------------------------------------
+     * Walk the matrix and the existing routes together, both in
+     * (output, input) order. Existing routes ramp from their current gain
+     * to the new target; new routes ramp up from zero; routes whose gain
+     * has reached zero are dropped.
+     *-----------------------------------------------------------------------*/
+    this->next_routes.clear();
+    size_t existing = 0;
+    for (int output_channel = 0; output_channel < num_output_channels; output_channel++)
+    {
+        for (int input_channel = 0; input_channel < num_input_channels; input_channel++)
+        {
+            float target = this->active_gains[output_channel][input_channel];
+            float gain = 0.0;
+
+            while (existing < this->routes.size() && (this->routes[existing].output_channel < output_channel || (this->routes[existing].output_channel == output_channel && this->routes[existing].input_channel < input_channel)))
+            {
+                existing++;
+            }
+            if (existing < this->routes.size() && this->routes[existing].output_channel == output_channel && this->routes[existing].input_channel == input_channel)
+            {
+                gain = this->routes[existing].gain;
+            }
+
+            if (target == 0.0 && gain == 0.0)
+            {
+                continue;
+            }
+
+            Route route;
+            route.input_channel = input_channel;
+            route.output_channel = output_channel;
+            route.gain = gain;
+            route.target = target;
+            route.steps_remaining = (gain == target) ? 0 : smoothing_steps;
+            route.step = (target - gain) / smoothing_steps;
+            this->next_routes.push_back(route);
+        }
+    }
+    this->routes.swap(this->next_routes);
+}
+
+void MatrixMixer::process(Buffer &out, int num_frames)
+{
+    /*------------------------------------------------------------------------
+     * If another thread is changing the gains, pick up the new matrix at
+     * the start of the next block rather than waiting for the lock.
+     *-----------------------------------------------------------------------*/
+    if (this->gains_changed)
+    {
+        std::unique_lock<std::mutex> lock(this->gains_mutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            /*------------------------------------------------------------------------
+             * Copying into a matrix of the same size reuses its storage.
+             *-----------------------------------------------------------------------*/
+            this->active_gains = this->gains;
+            this->gains_changed = false;
+            lock.unlock();
+            this->update_routes();
+        }
+    }
+
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        memset(out[channel], 0, num_frames * sizeof(sample));
+    }
+
+    bool silent_routes = false;
+    for (auto &route : this->routes)
+    {
+        const sample *in = this->input->out[route.input_channel];
+        sample *channel_out = out[route.output_channel];
+        int frame = 0;
+
+        if (route.steps_remaining > 0)
+        {
+            int ramp_frames = MIN(route.steps_remaining, num_frames);
+            float gain = route.gain;
+            float step = route.step;
+            for (; frame < ramp_frames; frame++)
+            {
+                channel_out[frame] += (gain + step * (frame + 1)) * in[frame];
+            }
+            route.steps_remaining -= ramp_frames;
+            route.gain = (route.steps_remaining == 0) ? route.target : (gain + step * ramp_frames);
+            if (route.gain == 0.0)
+            {
+                silent_routes = true;
+            }
+        }
+
+        float gain = route.gain;
+        for (; frame < num_frames; frame++)
+        {
+            channel_out[frame] += gain * in[frame];
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Drop routes that have faded out.
+     *-----------------------------------------------------------------------*/
+    if (silent_routes)
+    {
+        auto end = std::remove_if(this->routes.begin(), this->routes.end(), [](const Route &route) {
+            return route.gain == 0.0 && route.steps_remaining == 0;
+        });
+        this->routes.erase(end, this->routes.end());
+    }
+}
+
+}
@@ -8,6 +8,7 @@ MidiNoteToFrequency::MidiNoteToFrequency(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "midi-note-to-frequency";
+    this->supports_control_rate = true;
 }
 
 void MidiNoteToFrequency::process(Buffer &out, int num_frames)
@@ -1,25 +1,35 @@
 #include "signalflow/node/operators/multiply.h"
 
+#include "signalflow/node/kernel.h"
+
 namespace signalflow
 {
 
+class MultiplyKernel : public NodeKernel
+{
+public:
+    inline sample process(sample a, sample b) { return a * b; }
+};
+
 Multiply::Multiply(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "multiply";
+    this->supports_control_rate = true;
+    this->silent_if_any_input_silent = true;
 }
 
 void Multiply::process(Buffer &out, int num_frames)
 {
+#ifdef __APPLE__
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
-#ifdef __APPLE__
         vDSP_vmul(input0->out[channel], 1, input1->out[channel], 1, out[channel], 1, num_frames);
+    }
 #else
-        for (int frame = 0; frame < num_frames; frame++)
-            out[channel][frame] = input0->out[channel][frame] * input1->out[channel][frame];
+    MultiplyKernel kernel;
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->input0, this->input1);
 #endif
-    }
 }
 
 }
@@ -7,6 +7,7 @@ Pow::Pow(NodeRef a, NodeRef b)
     : BinaryOpNode(a, b)
 {
     this->name = "pow";
+    this->supports_control_rate = true;
 }
 
 void Pow::process(Buffer &out, int num_frames)
@@ -7,6 +7,7 @@ RoundToScale::RoundToScale(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "round-to-scale";
+    this->supports_control_rate = true;
 }
 
 void RoundToScale::process(Buffer &out, int num_frames)
@@ -8,6 +8,7 @@ Round::Round(NodeRef a)
     : UnaryOpNode(a)
 {
     this->name = "round";
+    this->supports_control_rate = true;
 }
 
 void Round::process(Buffer &out, int num_frames)
@@ -7,6 +7,7 @@ ScaleLinExp::ScaleLinExp(NodeRef input, NodeRef a, NodeRef b, NodeRef c, NodeRef
     : UnaryOpNode(input), a(a), b(b), c(c), d(d)
 {
     this->name = "scale-lin-exp";
+    this->supports_control_rate = true;
 
     this->create_input("a", this->a);
     this->create_input("b", this->b);
@@ -30,6 +31,7 @@ ScaleLinLin::ScaleLinLin(NodeRef input, NodeRef a, NodeRef b, NodeRef c, NodeRef
     : UnaryOpNode(input), a(a), b(b), c(c), d(d)
 {
     this->name = "scale-lin-lin";
+    this->supports_control_rate = true;
 
     this->create_input("a", this->a);
     this->create_input("b", this->b);
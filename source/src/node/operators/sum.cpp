@@ -8,6 +8,7 @@ namespace signalflow
 Sum::Sum()
 {
     this->name = "sum";
+    this->supports_control_rate = true;
     this->has_variable_inputs = true;
 }
 
@@ -76,7 +77,7 @@ void Sum::remove_input(NodeRef input)
 
 void Sum::set_input(std::string name, const NodeRef &node)
 {
-    if (this->inputs.find(name) == this->inputs.end())
+    if (this->get_input_index(name) < 0)
     {
         this->input_list.push_back(node);
         this->Node::create_input(name, input_list.back());
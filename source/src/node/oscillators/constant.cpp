@@ -8,6 +8,7 @@ Constant::Constant(sample value)
 {
     this->value = value;
     this->name = "constant";
+    this->is_constant = true;
     this->set_channels(0, 1);
 
     /*--------------------------------------------------------------------------------
@@ -32,6 +33,8 @@ void Constant::process(Buffer &out, int num_frames)
         out[0][frame] = this->value;
     }
 #endif
+
+    this->is_silent = (this->value == 0);
 }
 
 float Constant::get_value()
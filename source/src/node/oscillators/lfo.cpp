@@ -8,6 +8,7 @@ LFO::LFO(NodeRef frequency, NodeRef min, NodeRef max)
     : frequency(frequency), min(min), max(max)
 {
     SIGNALFLOW_CHECK_GRAPH();
+    this->supports_control_rate = true;
     this->create_input("frequency", this->frequency);
     this->create_input("min", this->min);
     this->create_input("max", this->max);
@@ -1,9 +1,27 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/oscillators/saw-lfo.h"
 
 namespace signalflow
 {
 
+class SawLFOKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency, sample min, sample max)
+    {
+        sample rv = min + this->phase * (max - min);
+
+        this->phase += frequency / this->sample_rate;
+        while (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SawLFO::SawLFO(NodeRef frequency, NodeRef min, NodeRef max)
     : LFO(frequency, min, max)
 {
@@ -12,20 +30,14 @@ SawLFO::SawLFO(NodeRef frequency, NodeRef min, NodeRef max)
 
 void SawLFO::process(Buffer &out, int num_frames)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
-    {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float min = this->min->out[channel][frame];
-            float max = this->max->out[channel][frame];
-
-            out[channel][frame] = min + this->phase[channel] * (max - min);
+    SawLFOKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency, this->min, this->max);
+}
 
-            this->phase[channel] += this->frequency->out[channel][frame] / this->graph->get_sample_rate();
-            while (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
-        }
-    }
+void SawLFO::process_control(Buffer &out, int num_frames)
+{
+    SawLFOKernel kernel(this->phase.data(), (float) this->graph->get_sample_rate() / num_frames);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, 1, this->frequency, this->min, this->max);
 }
 
 }
@@ -1,9 +1,35 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
+#include "signalflow/node/oscillators/polyblep.h"
 #include "signalflow/node/oscillators/saw.h"
 
 namespace signalflow
 {
 
+class SawOscillatorKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency)
+    {
+        float increment = frequency / this->sample_rate;
+        float dt = MIN(fabsf(increment), 0.5f);
+
+        /*--------------------------------------------------------------------------------
+         * Naive ramp, with a polyBLEP correction at the falling edge.
+         *--------------------------------------------------------------------------------*/
+        sample rv = (this->phase * 2.0) - 1.0;
+        rv -= signalflow_poly_blep(this->phase, dt);
+
+        this->phase += increment;
+        while (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SawOscillator::SawOscillator(NodeRef frequency)
     : frequency(frequency)
 {
@@ -19,21 +45,22 @@ void SawOscillator::alloc()
     this->phase.resize(this->num_output_channels_allocated);
 }
 
-void SawOscillator::process(Buffer &out, int num_frames)
+void SawOscillator::trigger(std::string name, float value)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
+    if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            float rv = (this->phase[channel] * 2.0) - 1.0;
-
-            out[channel][frame] = rv;
-
-            this->phase[channel] += this->frequency->out[channel][frame] / this->graph->get_sample_rate();
-            while (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
+            this->phase[channel] = 0.0;
         }
     }
+    this->Node::trigger(name, value);
+}
+
+void SawOscillator::process(Buffer &out, int num_frames)
+{
+    SawOscillatorKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency);
 }
 
 }
@@ -1,9 +1,27 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/oscillators/sine-lfo.h"
 
 namespace signalflow
 {
 
+class SineLFOKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency, sample min, sample max)
+    {
+        sample rv = min + ((sin(this->phase * M_PI * 2.0) + 1) / 2) * (max - min);
+        this->phase += frequency / this->sample_rate;
+
+        while (this->phase > 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SineLFO::SineLFO(NodeRef frequency, NodeRef min, NodeRef max)
     : LFO(frequency, min, max)
 {
@@ -12,20 +30,14 @@ SineLFO::SineLFO(NodeRef frequency, NodeRef min, NodeRef max)
 
 void SineLFO::process(Buffer &out, int num_frames)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
-    {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float freq = this->frequency->out[channel][frame];
-            float min = this->min->out[channel][frame];
-            float max = this->max->out[channel][frame];
-            out[channel][frame] = min + ((sin(this->phase[channel] * M_PI * 2.0) + 1) / 2) * (max - min);
-            this->phase[channel] += freq / this->graph->get_sample_rate();
-
-            while (this->phase[channel] > 1.0)
-                this->phase[channel] -= 1.0;
-        }
-    }
+    SineLFOKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency, this->min, this->max);
+}
+
+void SineLFO::process_control(Buffer &out, int num_frames)
+{
+    SineLFOKernel kernel(this->phase.data(), (float) this->graph->get_sample_rate() / num_frames);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, 1, this->frequency, this->min, this->max);
 }
 
 }
@@ -1,15 +1,34 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/oscillators/sine.h"
 
 namespace signalflow
 {
 
+class SineOscillatorKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency)
+    {
+        sample rv = sin(this->phase * M_PI * 2.0);
+        this->phase += frequency / this->sample_rate;
+
+        while (this->phase > 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SineOscillator::SineOscillator(NodeRef frequency)
     : frequency(frequency)
 {
     SIGNALFLOW_CHECK_GRAPH();
 
     this->name = "sine";
+    this->supports_control_rate = true;
     this->create_input("frequency", this->frequency);
 
     /*--------------------------------------------------------------------------------
@@ -33,20 +52,28 @@ void SineOscillator::alloc()
     this->phase.resize(this->num_output_channels_allocated);
 }
 
-void SineOscillator::process(Buffer &out, int num_frames)
+void SineOscillator::trigger(std::string name, float value)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
+    if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            float freq = this->frequency->out[channel][frame];
-            out[channel][frame] = sin(this->phase[channel] * M_PI * 2.0);
-            this->phase[channel] += freq / this->graph->get_sample_rate();
-
-            while (this->phase[channel] > 1.0)
-                this->phase[channel] -= 1.0;
+            this->phase[channel] = 0.0;
         }
     }
+    this->Node::trigger(name, value);
+}
+
+void SineOscillator::process(Buffer &out, int num_frames)
+{
+    SineOscillatorKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency);
+}
+
+void SineOscillator::process_control(Buffer &out, int num_frames)
+{
+    SineOscillatorKernel kernel(this->phase.data(), (float) this->graph->get_sample_rate() / num_frames);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, 1, this->frequency);
 }
 
 }
@@ -1,9 +1,27 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/oscillators/square-lfo.h"
 
 namespace signalflow
 {
 
+class SquareLFOKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency, sample min, sample max, sample width)
+    {
+        sample rv = (this->phase < width) ? max : min;
+
+        this->phase += 1.0 / (this->sample_rate / frequency);
+        while (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SquareLFO::SquareLFO(NodeRef frequency, NodeRef min, NodeRef max, NodeRef width)
     : LFO(frequency, min, max), width(width)
 {
@@ -13,21 +31,14 @@ SquareLFO::SquareLFO(NodeRef frequency, NodeRef min, NodeRef max, NodeRef width)
 
 void SquareLFO::process(Buffer &out, int num_frames)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
-    {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float frequency = this->frequency->out[channel][frame];
-            float width = this->width->out[channel][frame];
-            float rv = (this->phase[channel] < width) ? this->max->out[channel][frame] : this->min->out[channel][frame];
-
-            out[channel][frame] = rv;
-
-            this->phase[channel] += 1.0 / (this->graph->get_sample_rate() / frequency);
-            if (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
-        }
-    }
+    SquareLFOKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency, this->min, this->max, this->width);
+}
+
+void SquareLFO::process_control(Buffer &out, int num_frames)
+{
+    SquareLFOKernel kernel(this->phase.data(), (float) this->graph->get_sample_rate() / num_frames);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, 1, this->frequency, this->min, this->max, this->width);
 }
 
 }
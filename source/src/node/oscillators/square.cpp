@@ -1,9 +1,39 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
+#include "signalflow/node/oscillators/polyblep.h"
 #include "signalflow/node/oscillators/square.h"
 
 namespace signalflow
 {
 
+class SquareOscillatorKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency, sample width)
+    {
+        float increment = frequency / this->sample_rate;
+        float dt = MIN(fabsf(increment), 0.5f);
+
+        /*--------------------------------------------------------------------------------
+         * Naive pulse, with polyBLEP corrections at the rising edge (phase = 0)
+         * and the falling edge (phase = width).
+         *--------------------------------------------------------------------------------*/
+        sample rv = (this->phase < width) ? 1 : -1;
+        float falling_phase = this->phase - width;
+        falling_phase -= floorf(falling_phase);
+        rv += signalflow_poly_blep(this->phase, dt);
+        rv -= signalflow_poly_blep(falling_phase, dt);
+
+        this->phase += increment;
+        if (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 SquareOscillator::SquareOscillator(NodeRef frequency, NodeRef width)
     : frequency(frequency), width(width)
 {
@@ -22,23 +52,22 @@ void SquareOscillator::alloc()
     this->phase.resize(this->num_output_channels_allocated);
 }
 
-void SquareOscillator::process(Buffer &out, int num_frames)
+void SquareOscillator::trigger(std::string name, float value)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
+    if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            float frequency = this->frequency->out[channel][frame];
-            float width = this->width->out[channel][frame];
-            float rv = (this->phase[channel] < width) ? 1 : -1;
-
-            out[channel][frame] = rv;
-
-            this->phase[channel] += 1.0 / (this->graph->get_sample_rate() / frequency);
-            if (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
+            this->phase[channel] = 0.0;
         }
     }
+    this->Node::trigger(name, value);
+}
+
+void SquareOscillator::process(Buffer &out, int num_frames)
+{
+    SquareOscillatorKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency, this->width);
 }
 
 }
@@ -1,9 +1,28 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/oscillators/triangle-lfo.h"
 
 namespace signalflow
 {
 
+class TriangleLFOKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency, sample min, sample max)
+    {
+        float rv = (this->phase < 0.5) ? (this->phase * 2.0) : (1.0 - (this->phase - 0.5) * 2.0);
+        rv = min + rv * (max - min);
+
+        this->phase += frequency / this->sample_rate;
+        while (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 TriangleLFO::TriangleLFO(NodeRef frequency, NodeRef min, NodeRef max)
     : LFO(frequency, min, max)
 {
@@ -12,21 +31,14 @@ TriangleLFO::TriangleLFO(NodeRef frequency, NodeRef min, NodeRef max)
 
 void TriangleLFO::process(Buffer &out, int num_frames)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
-    {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float min = this->min->out[channel][frame];
-            float max = this->max->out[channel][frame];
-
-            float rv = (this->phase[channel] < 0.5) ? (this->phase[channel] * 2.0) : (1.0 - (this->phase[channel] - 0.5) * 2.0);
-            out[channel][frame] = min + rv * (max - min);
-
-            this->phase[channel] += this->frequency->out[channel][frame] / this->graph->get_sample_rate();
-            while (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
-        }
-    }
+    TriangleLFOKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency, this->min, this->max);
+}
+
+void TriangleLFO::process_control(Buffer &out, int num_frames)
+{
+    TriangleLFOKernel kernel(this->phase.data(), (float) this->graph->get_sample_rate() / num_frames);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, 1, this->frequency, this->min, this->max);
 }
 
 }
@@ -1,9 +1,40 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
+#include "signalflow/node/oscillators/polyblep.h"
 #include "signalflow/node/oscillators/triangle.h"
 
 namespace signalflow
 {
 
+class TriangleOscillatorKernel : public OscillatorKernel
+{
+public:
+    using OscillatorKernel::OscillatorKernel;
+
+    inline sample process(sample frequency)
+    {
+        float increment = frequency / this->sample_rate;
+        float dt = MIN(fabsf(increment), 0.5f);
+
+        /*--------------------------------------------------------------------------------
+         * Naive triangle, with polyBLAMP corrections at the trough (phase = 0)
+         * and the peak (phase = 0.5), where the slope changes by 8 * dt per sample.
+         *--------------------------------------------------------------------------------*/
+        sample rv = (this->phase < 0.5) ? (this->phase * 4.0 - 1.0) : (1.0 - (this->phase - 0.5) * 4.0);
+        float peak_phase = this->phase + 0.5;
+        if (peak_phase >= 1.0)
+            peak_phase -= 1.0;
+        rv += 8.0 * dt * signalflow_poly_blamp(this->phase, dt);
+        rv -= 8.0 * dt * signalflow_poly_blamp(peak_phase, dt);
+
+        this->phase += increment;
+        while (this->phase >= 1.0)
+            this->phase -= 1.0;
+
+        return rv;
+    }
+};
+
 TriangleOscillator::TriangleOscillator(NodeRef frequency)
     : frequency(frequency)
 {
@@ -19,21 +50,22 @@ void TriangleOscillator::alloc()
     this->phase.resize(this->num_output_channels_allocated);
 }
 
-void TriangleOscillator::process(Buffer &out, int num_frames)
+void TriangleOscillator::trigger(std::string name, float value)
 {
-    for (int channel = 0; channel < this->num_output_channels; channel++)
+    if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            float rv = (this->phase[channel] < 0.5) ? (this->phase[channel] * 4.0 - 1.0) : (1.0 - (this->phase[channel] - 0.5) * 4.0);
-
-            out[channel][frame] = rv;
-
-            this->phase[channel] += this->frequency->out[channel][frame] / this->graph->get_sample_rate();
-            while (this->phase[channel] >= 1.0)
-                this->phase[channel] -= 1.0;
+            this->phase[channel] = 0.0;
         }
     }
+    this->Node::trigger(name, value);
+}
+
+void TriangleOscillator::process(Buffer &out, int num_frames)
+{
+    TriangleOscillatorKernel kernel(this->phase.data(), this->graph->get_sample_rate());
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->frequency);
 }
 
 }
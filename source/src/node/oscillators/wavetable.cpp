@@ -23,6 +23,8 @@ Wavetable::Wavetable(BufferRef buffer, NodeRef frequency, NodeRef phase, NodeRef
 void Wavetable::alloc()
 {
     this->current_phase.resize(this->num_output_channels_allocated);
+    this->read_phases.resize(this->output_buffer_length);
+    this->read_increments.resize(this->output_buffer_length);
 }
 
 void Wavetable::process(Buffer &out, int num_frames)
@@ -33,6 +35,12 @@ void Wavetable::process(Buffer &out, int num_frames)
     if (!this->buffer || !this->buffer->get_num_frames())
         return;
 
+    /*--------------------------------------------------------------------------------
+     * If the buffer is a WavetableBuffer, read from its bandlimited mip levels.
+     *--------------------------------------------------------------------------------*/
+    WavetableBuffer *wavetable = dynamic_cast<WavetableBuffer *>(this->buffer.get());
+    float sample_rate = this->graph->get_sample_rate();
+
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
         for (int frame = 0; frame < num_frames; frame++)
@@ -44,7 +52,6 @@ void Wavetable::process(Buffer &out, int num_frames)
 
             float frequency = this->frequency->out[channel][frame];
 
-            // TODO Create wavetable buffer
             float index = this->current_phase[channel] + this->phase->out[channel][frame];
             index = fmod(index, 1);
             while (index < 0)
@@ -54,16 +61,28 @@ void Wavetable::process(Buffer &out, int num_frames)
             if (this->phase_map)
             {
                 index = this->phase_map->get_frame(0, index * this->phase_map->get_num_frames());
+                index = index - floorf(index);
             }
 
-            float rv = this->buffer->get_frame(0, index * this->buffer->get_num_frames());
+            this->read_phases[frame] = index;
+            this->read_increments[frame] = frequency / sample_rate;
 
-            out[channel][frame] = rv;
-
-            this->current_phase[channel] += (frequency / this->graph->get_sample_rate());
+            this->current_phase[channel] += (frequency / sample_rate);
             while (this->current_phase[channel] >= 1.0)
                 this->current_phase[channel] -= 1.0;
         }
+
+        if (wavetable)
+        {
+            wavetable->read(this->read_phases.data(), this->read_increments.data(), out[channel], num_frames);
+        }
+        else
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                out[channel][frame] = this->buffer->get_frame(0, this->read_phases[frame] * this->buffer->get_num_frames());
+            }
+        }
     }
 }
 
@@ -7,6 +7,7 @@ Clip::Clip(NodeRef input, NodeRef min, NodeRef max)
     : UnaryOpNode(input), min(min), max(max)
 {
     this->name = "clip";
+    this->supports_control_rate = true;
     this->create_input("min", this->min);
     this->create_input("max", this->max);
 }
@@ -7,43 +7,70 @@ namespace signalflow
 {
 
 AllpassDelay::AllpassDelay(NodeRef input, NodeRef delay_time, NodeRef feedback, float max_delay_time)
-    : UnaryOpNode(input), delay_time(delay_time), feedback(feedback)
+    : UnaryOpNode(input), delay_time(delay_time), feedback(feedback), max_delay_time(max_delay_time)
 {
     this->name = "allpass-delay";
     this->create_input("delay_time", this->delay_time);
     this->create_input("feedback", this->feedback);
 
     SIGNALFLOW_CHECK_GRAPH();
-    for (int i = 0; i < SIGNALFLOW_MAX_CHANNELS; i++)
-    {
-        buffers.push_back(new SampleRingBuffer(max_delay_time * this->graph->get_sample_rate()));
-    }
+    this->alloc();
 }
 
-AllpassDelay::~AllpassDelay()
+void AllpassDelay::alloc()
 {
-    for (auto buffer : buffers)
-    {
-        delete buffer;
-    }
+    int max_delay_samples = this->max_delay_time * this->graph->get_sample_rate();
+    this->buffers.resize(this->num_output_channels_allocated, DelayLine(max_delay_samples));
+    this->delayed.resize(this->output_buffer_length);
+    this->written.resize(this->output_buffer_length);
 }
 
 void AllpassDelay::process(Buffer &out, int num_frames)
 {
     SIGNALFLOW_CHECK_GRAPH();
 
+    float sample_rate = this->graph->get_sample_rate();
+
     for (int channel = 0; channel < this->num_input_channels; channel++)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        DelayLine &buffer = this->buffers[channel];
+
+        if (this->delay_time->is_constant && this->delay_time->out[channel][0] * sample_rate >= 1.0)
+        {
+            /*------------------------------------------------------------------------
+             * Fixed delay: process in runs no longer than the delay, as for
+             * CombDelay.
+             *-----------------------------------------------------------------------*/
+            float delay = MIN(this->delay_time->out[channel][0] * sample_rate, buffer.get_max_delay());
+            int run_length = (int) delay;
+            for (int frame = 0; frame < num_frames; frame += run_length)
+            {
+                int num_run_frames = MIN(run_length, num_frames - frame);
+                buffer.read(delay, this->delayed.data(), num_run_frames);
+                for (int n = 0; n < num_run_frames; n++)
+                {
+                    sample feedback = this->feedback->out[channel][frame + n];
+                    sample v = input->out[channel][frame + n] - feedback * this->delayed[n];
+                    out[channel][frame + n] = feedback * v + this->delayed[n];
+                    this->written[n] = v;
+                }
+                buffer.write(this->written.data(), num_run_frames);
+            }
+        }
+        else
         {
-            sample delay = this->delay_time->out[channel][frame];
-            sample feedback = this->feedback->out[channel][frame];
-            float offset = delay * this->graph->get_sample_rate();
-
-            sample v = input->out[channel][frame] - feedback * buffers[channel]->get(-offset);
-            sample rv = feedback * v + buffers[channel]->get(-offset);
-            out[channel][frame] = rv;
-            buffers[channel]->append(v);
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                sample delay = this->delay_time->out[channel][frame];
+                sample feedback = this->feedback->out[channel][frame];
+                float offset = delay * sample_rate;
+
+                sample delayed = buffer.read(offset);
+                sample v = input->out[channel][frame] - feedback * delayed;
+                sample rv = feedback * v + delayed;
+                out[channel][frame] = rv;
+                buffer.write(v);
+            }
         }
     }
 }
@@ -7,42 +7,65 @@ namespace signalflow
 {
 
 CombDelay::CombDelay(NodeRef input, NodeRef delay_time, NodeRef feedback, float max_delay_time)
-    : UnaryOpNode(input), delay_time(delay_time), feedback(feedback)
+    : UnaryOpNode(input), delay_time(delay_time), feedback(feedback), max_delay_time(max_delay_time)
 {
     this->name = "comb-delay";
     this->create_input("delay_time", this->delay_time);
     this->create_input("feedback", this->feedback);
 
     SIGNALFLOW_CHECK_GRAPH();
-    for (int i = 0; i < SIGNALFLOW_MAX_CHANNELS; i++)
-    {
-        buffers.push_back(new SampleRingBuffer(max_delay_time * this->graph->get_sample_rate()));
-    }
+    this->alloc();
 }
 
-CombDelay::~CombDelay()
+void CombDelay::alloc()
 {
-    for (auto buffer : buffers)
-    {
-        delete buffer;
-    }
+    int max_delay_samples = this->max_delay_time * this->graph->get_sample_rate();
+    this->buffers.resize(this->num_output_channels_allocated, DelayLine(max_delay_samples));
+    this->delayed.resize(this->output_buffer_length);
 }
 
 void CombDelay::process(Buffer &out, int num_frames)
 {
     SIGNALFLOW_CHECK_GRAPH();
 
+    float sample_rate = this->graph->get_sample_rate();
+
     for (int channel = 0; channel < this->num_input_channels; channel++)
     {
-        for (int frame = 0; frame < num_frames; frame++)
+        DelayLine &buffer = this->buffers[channel];
+
+        if (this->delay_time->is_constant && this->delay_time->out[channel][0] * sample_rate >= 1.0)
+        {
+            /*------------------------------------------------------------------------
+             * With a fixed delay of D samples, each run of up to D frames only
+             * depends on frames that have already been written, so can be read
+             * from the delay line as a block.
+             *-----------------------------------------------------------------------*/
+            float delay = MIN(this->delay_time->out[channel][0] * sample_rate, buffer.get_max_delay());
+            int run_length = (int) delay;
+            for (int frame = 0; frame < num_frames; frame += run_length)
+            {
+                int num_run_frames = MIN(run_length, num_frames - frame);
+                buffer.read(delay, this->delayed.data(), num_run_frames);
+                for (int n = 0; n < num_run_frames; n++)
+                {
+                    out[channel][frame + n] = input->out[channel][frame + n] + this->feedback->out[channel][frame + n] * this->delayed[n];
+                }
+                buffer.write(out[channel] + frame, num_run_frames);
+            }
+        }
+        else
         {
-            sample delay = this->delay_time->out[channel][frame];
-            sample feedback = this->feedback->out[channel][frame];
-            float offset = delay * this->graph->get_sample_rate();
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                sample delay = this->delay_time->out[channel][frame];
+                sample feedback = this->feedback->out[channel][frame];
+                float offset = delay * sample_rate;
 
-            sample rv = input->out[channel][frame] + (feedback * buffers[channel]->get(-offset));
-            out[channel][frame] = rv;
-            buffers[channel]->append(rv);
+                sample rv = input->out[channel][frame] + (feedback * buffer.read(offset));
+                out[channel][frame] = rv;
+                buffer.write(rv);
+            }
         }
     }
 }
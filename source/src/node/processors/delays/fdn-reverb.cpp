@@ -0,0 +1,283 @@
+#include "signalflow/core/graph.h"
+#include "signalflow/node/processors/delays/fdn-reverb.h"
+
+#include <math.h>
+#include <stdexcept>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * Delay line lengths are spread exponentially across this range,
+ * before scaling by size.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_FDN_MIN_LINE_TIME 0.031
+#define SIGNALFLOW_FDN_MAX_LINE_TIME 0.097
+
+/*------------------------------------------------------------------------
+ * Modulation depth is limited to a fraction of the shortest line.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_FDN_MAX_MODULATION_RATIO 0.25
+
+namespace signalflow
+{
+
+static bool signalflow_is_prime(int n)
+{
+    if (n < 2)
+        return false;
+    for (int i = 2; i * i <= n; i++)
+    {
+        if (n % i == 0)
+            return false;
+    }
+    return true;
+}
+
+FDNReverb::FDNReverb(NodeRef input,
+                     NodeRef decay_time,
+                     NodeRef damping,
+                     NodeRef modulation_depth,
+                     NodeRef modulation_rate,
+                     int num_lines,
+                     signalflow_fdn_matrix_t matrix_type,
+                     float size)
+    : UnaryOpNode(input), decay_time(decay_time), damping(damping), modulation_depth(modulation_depth), modulation_rate(modulation_rate), num_lines(num_lines), matrix_type(matrix_type), size(size)
+{
+    SIGNALFLOW_CHECK_GRAPH();
+
+    this->name = "fdn-reverb";
+    this->create_input("decay_time", this->decay_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("damping", this->damping, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("modulation_depth", this->modulation_depth, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("modulation_rate", this->modulation_rate, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->set_channels(2, 2);
+
+    if (num_lines != 8 && num_lines != 16 && num_lines != 32)
+    {
+        throw std::runtime_error("FDNReverb: num_lines must be 8, 16 or 32 (got " + std::to_string(num_lines) + ")");
+    }
+
+    /*------------------------------------------------------------------------
+     * Use prime lengths, so that no two lines share a common period.
+     *-----------------------------------------------------------------------*/
+    float sample_rate = this->graph->get_sample_rate();
+    int previous_length = 0;
+    for (int line = 0; line < num_lines; line++)
+    {
+        float position = (float) line / (num_lines - 1);
+        float time = SIGNALFLOW_FDN_MIN_LINE_TIME * powf(SIGNALFLOW_FDN_MAX_LINE_TIME / SIGNALFLOW_FDN_MIN_LINE_TIME, position);
+        int length = MAX((int) (time * size * sample_rate), 16);
+        length = MAX(length, previous_length + 1);
+        while (!signalflow_is_prime(length))
+        {
+            length++;
+        }
+        previous_length = length;
+
+        this->line_lengths.push_back(length);
+        this->lines.push_back(DelayLine(length * (1.0 + SIGNALFLOW_FDN_MAX_MODULATION_RATIO) + 1));
+        this->modulation_phase.push_back(2.0 * M_PI * line / num_lines);
+    }
+    this->line_gains.resize(num_lines);
+    this->damping_state.resize(num_lines);
+
+    this->alloc();
+}
+
+void FDNReverb::alloc()
+{
+    this->line_outputs.resize(this->num_lines * this->output_buffer_length);
+    this->scratch.resize(this->output_buffer_length);
+}
+
+void FDNReverb::trigger(std::string name, float value)
+{
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        for (int line = 0; line < this->num_lines; line++)
+        {
+            this->lines[line].clear();
+            this->damping_state[line] = 0.0;
+        }
+    }
+    this->Node::trigger(name, value);
+}
+
+void FDNReverb::process(Buffer &out, int num_frames)
+{
+    switch (this->num_lines)
+    {
+        case 8:
+            this->process_lines<8>(out, num_frames);
+            break;
+        case 16:
+            this->process_lines<16>(out, num_frames);
+            break;
+        case 32:
+            this->process_lines<32>(out, num_frames);
+            break;
+    }
+}
+
+template <int NumLines>
+void FDNReverb::process_lines(Buffer &out, int num_frames)
+{
+    float sample_rate = this->graph->get_sample_rate();
+    int stride = this->output_buffer_length;
+
+    /*------------------------------------------------------------------------
+     * Per-block parameters.
+     *-----------------------------------------------------------------------*/
+    float decay_time = MAX(this->decay_time->out[0][0], 0.001f);
+    float damping = MAX(0.0f, MIN(this->damping->out[0][0], 0.999f));
+    float depth = MAX(0.0f, this->modulation_depth->out[0][0] * sample_rate);
+    depth = MIN(depth, this->line_lengths[0] * SIGNALFLOW_FDN_MAX_MODULATION_RATIO);
+    float rate = this->modulation_rate->out[0][0];
+
+    /*------------------------------------------------------------------------
+     * Gain per line for a 60dB decay over decay_time. For the Hadamard
+     * matrix, the 1/sqrt(N) normalisation is folded in here too.
+     *-----------------------------------------------------------------------*/
+    float matrix_scale = (this->matrix_type == SIGNALFLOW_FDN_MATRIX_HADAMARD) ? (1.0f / sqrtf(NumLines)) : 1.0f;
+    for (int line = 0; line < NumLines; line++)
+    {
+        this->line_gains[line] = matrix_scale * powf(10.0f, -3.0f * this->line_lengths[line] / (sample_rate * decay_time));
+    }
+    float io_gain = 1.0f / sqrtf(NumLines / 2);
+
+    /*------------------------------------------------------------------------
+     * Every line is longer than the run length, so each run's reads
+     * only depend on frames written in previous runs. This allows each
+     * line to be read, mixed and written a whole run at a time.
+     *-----------------------------------------------------------------------*/
+    int max_run_length = (int) (this->line_lengths[0] - depth) - 1;
+    for (int start = 0; start < num_frames; start += max_run_length)
+    {
+        int run_length = MIN(max_run_length, num_frames - start);
+
+        /*------------------------------------------------------------------------
+         * Read each line. Modulation is slow enough relative to the run
+         * length that the delay can be interpolated linearly across the run.
+         *-----------------------------------------------------------------------*/
+        for (int line = 0; line < NumLines; line++)
+        {
+            sample *line_output = this->line_outputs.data() + line * stride;
+            if (depth > 0)
+            {
+                float length = this->line_lengths[line];
+                float line_rate = rate * (0.8f + 0.4f * line / (NumLines - 1));
+                float phase_increment = 2.0f * M_PI * line_rate / sample_rate;
+                float phase_start = this->modulation_phase[line];
+                float phase_end = phase_start + phase_increment * run_length;
+                float delay_start = length + depth * sinf(phase_start);
+                float delay_step = depth * (sinf(phase_end) - sinf(phase_start)) / run_length;
+                for (int frame = 0; frame < run_length; frame++)
+                {
+                    this->scratch[frame] = delay_start + delay_step * frame;
+                }
+                this->lines[line].read(this->scratch.data(), line_output, run_length);
+                this->modulation_phase[line] = fmodf(phase_end, 2.0f * M_PI);
+            }
+            else
+            {
+                this->lines[line].read(this->line_lengths[line], line_output, run_length);
+            }
+        }
+
+        /*------------------------------------------------------------------------
+         * Output taps: even lines to the left channel, odd lines to the right.
+         *-----------------------------------------------------------------------*/
+        for (int channel = 0; channel < 2; channel++)
+        {
+            sample *channel_out = out[channel] + start;
+            memset(channel_out, 0, run_length * sizeof(sample));
+            for (int line = channel; line < NumLines; line += 2)
+            {
+                const sample *line_output = this->line_outputs.data() + line * stride;
+                for (int frame = 0; frame < run_length; frame++)
+                {
+                    channel_out[frame] += line_output[frame] * io_gain;
+                }
+            }
+        }
+
+        /*------------------------------------------------------------------------
+         * Damping and decay.
+         *-----------------------------------------------------------------------*/
+        for (int line = 0; line < NumLines; line++)
+        {
+            sample *line_output = this->line_outputs.data() + line * stride;
+            float state = this->damping_state[line];
+            float gain = this->line_gains[line];
+            for (int frame = 0; frame < run_length; frame++)
+            {
+                state = line_output[frame] + damping * (state - line_output[frame]);
+                line_output[frame] = state * gain;
+            }
+            this->damping_state[line] = state;
+        }
+
+        /*------------------------------------------------------------------------
+         * Feedback matrix, applied across all frames of the run at once.
+         *-----------------------------------------------------------------------*/
+        if (this->matrix_type == SIGNALFLOW_FDN_MATRIX_HADAMARD)
+        {
+            for (int half = 1; half < NumLines; half *= 2)
+            {
+                for (int line = 0; line < NumLines; line += 2 * half)
+                {
+                    for (int pair = line; pair < line + half; pair++)
+                    {
+                        sample *a = this->line_outputs.data() + pair * stride;
+                        sample *b = this->line_outputs.data() + (pair + half) * stride;
+                        for (int frame = 0; frame < run_length; frame++)
+                        {
+                            sample sum = a[frame] + b[frame];
+                            sample difference = a[frame] - b[frame];
+                            a[frame] = sum;
+                            b[frame] = difference;
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            float *sum = this->scratch.data();
+            memset(sum, 0, run_length * sizeof(float));
+            for (int line = 0; line < NumLines; line++)
+            {
+                const sample *line_output = this->line_outputs.data() + line * stride;
+                for (int frame = 0; frame < run_length; frame++)
+                {
+                    sum[frame] += line_output[frame];
+                }
+            }
+            for (int line = 0; line < NumLines; line++)
+            {
+                sample *line_output = this->line_outputs.data() + line * stride;
+                for (int frame = 0; frame < run_length; frame++)
+                {
+                    line_output[frame] -= sum[frame] * (2.0f / NumLines);
+                }
+            }
+        }
+
+        /*------------------------------------------------------------------------
+         * Add the input, alternating polarity between pairs of lines so that
+         * correlated stereo input does not excite only the symmetric modes.
+         *-----------------------------------------------------------------------*/
+        for (int line = 0; line < NumLines; line++)
+        {
+            sample *line_output = this->line_outputs.data() + line * stride;
+            const sample *line_input = this->input->out[line % 2] + start;
+            float input_gain = ((line / 2) % 2) ? -io_gain : io_gain;
+            for (int frame = 0; frame < run_length; frame++)
+            {
+                line_output[frame] += line_input[frame] * input_gain;
+            }
+            this->lines[line].write(line_output, run_length);
+        }
+    }
+}
+
+}
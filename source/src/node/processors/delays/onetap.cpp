@@ -6,39 +6,56 @@ namespace signalflow
 {
 
 OneTapDelay::OneTapDelay(NodeRef input, NodeRef delay_time, float max_delay_time)
-    : UnaryOpNode(input), delay_time(delay_time)
+    : UnaryOpNode(input), delay_time(delay_time), max_delay_time(max_delay_time)
 {
     this->name = "one-tap-delay";
     this->create_input("delay_time", this->delay_time);
 
     SIGNALFLOW_CHECK_GRAPH();
-    for (int i = 0; i < SIGNALFLOW_MAX_CHANNELS; i++)
-    {
-        buffers.push_back(new SampleRingBuffer(max_delay_time * this->graph->get_sample_rate()));
-    }
+    this->alloc();
 }
 
-OneTapDelay::~OneTapDelay()
+void OneTapDelay::alloc()
 {
-    for (auto buffer : buffers)
-    {
-        delete buffer;
-    }
+    /*------------------------------------------------------------------------
+     * Each block of input is written before it is read, so the delay line
+     * must hold a block more than the maximum delay.
+     *-----------------------------------------------------------------------*/
+    int max_delay_samples = this->max_delay_time * this->graph->get_sample_rate() + this->output_buffer_length;
+    this->buffers.resize(this->num_output_channels_allocated, DelayLine(max_delay_samples));
+    this->delays.resize(this->output_buffer_length);
 }
 
 void OneTapDelay::process(Buffer &out, int num_frames)
 {
     SIGNALFLOW_CHECK_GRAPH();
 
+    float sample_rate = this->graph->get_sample_rate();
+
+    /*------------------------------------------------------------------------
+     * The delay line only holds max_delay_time (plus a block), so longer
+     * delays would read samples that have since been overwritten.
+     *-----------------------------------------------------------------------*/
+    float max_delay_samples = this->max_delay_time * sample_rate;
+
     for (int channel = 0; channel < this->num_input_channels; channel++)
     {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            sample delay = this->delay_time->out[channel][frame];
-            float offset = delay * this->graph->get_sample_rate();
+        DelayLine &buffer = this->buffers[channel];
+        buffer.write(this->input->out[channel], num_frames);
 
-            out[channel][frame] = buffers[channel]->get(-offset);
-            buffers[channel]->append(this->input->out[channel][frame]);
+        if (this->delay_time->is_constant)
+        {
+            float delay = MAX(0.0f, MIN(this->delay_time->out[channel][0] * sample_rate, max_delay_samples));
+            buffer.read(delay + num_frames, out[channel], num_frames);
+        }
+        else
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                float delay = MAX(0.0f, MIN(this->delay_time->out[channel][frame] * sample_rate, max_delay_samples));
+                this->delays[frame] = delay + num_frames;
+            }
+            buffer.read(this->delays.data(), out[channel], num_frames);
         }
     }
 }
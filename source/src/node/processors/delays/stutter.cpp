@@ -12,7 +12,7 @@ Stutter::Stutter(NodeRef input, NodeRef stutter_time, NodeRef stutter_count, Nod
 
     this->name = "stutter";
     this->create_input("stutter_time", this->stutter_time);
-    this->create_input("stutter_count", this->stutter_count);
+    this->create_input("stutter_count", this->stutter_count, SIGNALFLOW_INPUT_RATE_CONTROL);
     this->create_input("clock", this->clock);
     this->alloc();
 }
@@ -24,19 +24,8 @@ void Stutter::alloc()
     this->stutters_to_do.resize(this->num_output_channels_allocated);
     this->stutter_samples_remaining.resize(this->num_output_channels_allocated);
 
-    int buffers_to_allocate = this->num_output_channels_allocated - buffers.size();
-    for (int i = 0; i < buffers_to_allocate; i++)
-    {
-        buffers.push_back(new SampleRingBuffer(this->max_stutter_time * this->graph->get_sample_rate()));
-    }
-}
-
-Stutter::~Stutter()
-{
-    for (auto buffer : buffers)
-    {
-        delete buffer;
-    }
+    int max_stutter_samples = this->max_stutter_time * this->graph->get_sample_rate();
+    this->buffers.resize(this->num_output_channels_allocated, DelayLine(max_stutter_samples));
 }
 
 void Stutter::trigger(std::string name, float value)
@@ -93,8 +82,8 @@ void Stutter::process(Buffer &out, int num_frames)
                 else
                 {
                     // TODO this won't quite work
-                    int buffer_sample_offset = -this->stutter_samples_remaining[channel];
-                    out[channel][frame] = this->buffers[channel]->get(buffer_sample_offset);
+                    int buffer_sample_offset = this->stutter_samples_remaining[channel];
+                    out[channel][frame] = this->buffers[channel].read(buffer_sample_offset);
                 }
             }
             else
@@ -106,7 +95,7 @@ void Stutter::process(Buffer &out, int num_frames)
             if (this->stutter_index[channel] == 0)
             {
                 // stutter_index is zero in the first stutter or when we're not stuttering
-                this->buffers[channel]->append(this->input->out[channel][frame]);
+                this->buffers[channel].write(this->input->out[channel][frame]);
             }
         }
     }
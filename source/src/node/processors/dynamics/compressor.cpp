@@ -6,69 +6,65 @@ namespace signalflow
 
 Compressor::Compressor(NodeRef input, NodeRef threshold, NodeRef ratio,
                        NodeRef attack_time, NodeRef release_time,
-                       NodeRef sidechain)
-    : UnaryOpNode(input), threshold(threshold), ratio(ratio), attack_time(attack_time), release_time(release_time), sidechain(sidechain)
+                       NodeRef sidechain, bool linked)
+    : UnaryOpNode(input), threshold(threshold), ratio(ratio), attack_time(attack_time), release_time(release_time), sidechain(sidechain), engine(linked)
 {
     this->name = "compressor";
-    this->current_ratio = 1.0;
 
-    this->create_input("threshold", this->threshold);
-    this->create_input("ratio", this->ratio);
-    this->create_input("attack_time", this->attack_time);
-    this->create_input("release_time", this->release_time);
+    this->create_input("threshold", this->threshold, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("ratio", this->ratio, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("attack_time", this->attack_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("release_time", this->release_time, SIGNALFLOW_INPUT_RATE_CONTROL);
     this->create_input("sidechain", this->sidechain);
+
+    this->alloc();
+}
+
+void Compressor::alloc()
+{
+    this->engine.alloc(this->num_output_channels_allocated);
+    this->follower.alloc(this->num_output_channels_allocated);
+}
+
+void Compressor::trigger(std::string name, float value)
+{
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        this->engine.clear();
+        this->follower.clear();
+    }
+    this->Node::trigger(name, value);
 }
 
 void Compressor::process(Buffer &out, int num_frames)
 {
-    for (int frame = 0; frame < num_frames; frame++)
+    float threshold = fabsf(this->threshold->out[0][0]);
+    float ratio = MAX(this->ratio->out[0][0], 1.0f);
+    int num_channels = this->num_output_channels;
+    int num_detectors = this->engine.get_num_detectors(num_channels);
+    Buffer &detector_input = this->sidechain ? this->sidechain->out : this->input->out;
+
+    /*------------------------------------------------------------------------
+     * Above the threshold, output level in dB is threshold + excess / ratio,
+     * which as a linear gain is (threshold / level) ^ (1 - 1 / ratio).
+     *-----------------------------------------------------------------------*/
+    float exponent = 1.0f - 1.0f / ratio;
+    this->follower.set_times(this->attack_time->out[0][0],
+                             this->release_time->out[0][0],
+                             this->graph->get_sample_rate());
+
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_DYNAMICS_BLOCK_SIZE)
     {
-        float input_sample = this->sidechain ? this->sidechain->out[0][frame] : this->input->out[0][frame];
-        if (fabsf(input_sample) > fabsf(this->threshold->out[0][frame]))
-        {
-            if (this->current_ratio < this->ratio->out[0][frame])
-            {
-                float attack_time_samples = this->attack_time->out[0][frame] * this->graph->get_sample_rate();
-                float compression_change_per_sample = ((this->ratio->out[0][frame] - 1) / attack_time_samples);
-                this->current_ratio += compression_change_per_sample;
-                // check overshoot
-                if (this->current_ratio > this->ratio->out[0][frame])
-                {
-                    this->current_ratio = this->ratio->out[0][frame];
-                }
-            }
-        }
-        else
-        {
-            if (this->current_ratio > 1)
-            {
-                float release_time_samples = this->release_time->out[0][frame] * this->graph->get_sample_rate();
-                float compression_change_per_sample = (-(this->ratio->out[0][frame] - 1) / release_time_samples);
-                this->current_ratio += compression_change_per_sample;
-                if (this->current_ratio < 1)
-                {
-                    this->current_ratio = 1;
-                }
-            }
-        }
+        int block_frames = MIN(SIGNALFLOW_DYNAMICS_BLOCK_SIZE, num_frames - offset);
+        float *levels = this->engine.get_levels();
 
-        for (int channel = 0; channel < this->num_output_channels; channel++)
+        this->engine.detect(detector_input, num_channels, offset, block_frames);
+        this->follower.process(levels, num_detectors, block_frames);
+        for (int index = 0; index < block_frames * num_detectors; index++)
         {
-            out[channel][frame] = this->input->out[channel][frame] / this->current_ratio;
-            //            if (fabsf(this->input->out[channel][frame]) < threshold->out[channel][frame])
-            //            {
-            //                out[channel][frame] = this->input->out[channel][frame];
-            //            }
-            //            else
-            //            {
-            //                float remainder = fabsf(this->input->out[channel][frame]) - threshold->out[channel][frame];
-            //                float remainder_compressed = remainder / this->current_ratio;
-            //                float sample = threshold->out[channel][frame] + remainder_compressed;
-            //                printf("ratio %f, remainder %f, sample %f\n", this->current_ratio, remainder_compressed, sample);
-            //                out[channel][frame] = (this->input->out[channel][frame] > 0) ? sample : -sample;
-            //                out[channel][frame] = this->input->out[channel][frame] / this->current_ratio;
-            //            }
+            levels[index] = (levels[index] > threshold) ? powf(threshold / levels[index], exponent) : 1.0f;
         }
+        this->engine.apply(this->input->out, out, num_channels, offset, block_frames);
     }
 }
 
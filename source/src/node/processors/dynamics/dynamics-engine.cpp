@@ -0,0 +1,310 @@
+#include "signalflow/node/processors/dynamics/dynamics-engine.h"
+#include "signalflow/core/util.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdexcept>
+#include <string>
+
+namespace signalflow
+{
+
+/*------------------------------------------------------------------------
+ * SlidingMax
+ *-----------------------------------------------------------------------*/
+
+SlidingMax::SlidingMax(int max_window)
+{
+    /*------------------------------------------------------------------------
+     * The deque holds up to `window` entries, plus the newest entry before
+     * the oldest is expired. A power-of-two ring of at least that size
+     * allows head and tail to wrap with a mask.
+     *-----------------------------------------------------------------------*/
+    unsigned int capacity = 1;
+    while (capacity < (unsigned int) MAX(max_window, 1) + 1)
+    {
+        capacity *= 2;
+    }
+    this->values.resize(capacity);
+    this->positions.resize(capacity);
+    this->mask = capacity - 1;
+    this->window = MAX(max_window, 1);
+    this->clear();
+}
+
+void SlidingMax::set_window(int window)
+{
+    if (window < 1 || (unsigned int) window > this->mask)
+    {
+        throw std::runtime_error("SlidingMax: Invalid window length (" + std::to_string(window) + ")");
+    }
+    this->window = window;
+    this->clear();
+}
+
+void SlidingMax::clear()
+{
+    this->head = 0;
+    this->tail = 0;
+    this->position = 0;
+}
+
+void SlidingMax::process(float *values, int num_frames, int stride)
+{
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        float value = values[frame * stride];
+
+        /*------------------------------------------------------------------------
+         * Entries no greater than the new value can never be the maximum
+         * again, so discard them from the back. The deque is therefore
+         * always in decreasing order, and its front is the maximum.
+         *-----------------------------------------------------------------------*/
+        while (this->tail != this->head && this->values[(this->tail - 1) & this->mask] <= value)
+        {
+            this->tail--;
+        }
+        this->values[this->tail & this->mask] = value;
+        this->positions[this->tail & this->mask] = this->position;
+        this->tail++;
+
+        /*------------------------------------------------------------------------
+         * Positions are distinct and advance by one per frame, so at most
+         * one entry can leave the window each frame.
+         *-----------------------------------------------------------------------*/
+        if (this->position - this->positions[this->head & this->mask] >= this->window)
+        {
+            this->head++;
+        }
+
+        values[frame * stride] = this->values[this->head & this->mask];
+        this->position++;
+    }
+}
+
+/*------------------------------------------------------------------------
+ * EnvelopeFollower
+ *-----------------------------------------------------------------------*/
+
+EnvelopeFollower::EnvelopeFollower()
+    : attack_coefficient(0.0), release_coefficient(0.0)
+{
+}
+
+void EnvelopeFollower::alloc(int num_detectors)
+{
+    this->state.resize(num_detectors, 0.0);
+}
+
+void EnvelopeFollower::clear(float value)
+{
+    std::fill(this->state.begin(), this->state.end(), value);
+}
+
+void EnvelopeFollower::set_times(float attack_time, float release_time, float sample_rate)
+{
+    this->attack_coefficient = (attack_time > 0) ? expf(-1.0f / (attack_time * sample_rate)) : 0.0f;
+    this->release_coefficient = (release_time > 0) ? expf(-1.0f / (release_time * sample_rate)) : 0.0f;
+}
+
+void EnvelopeFollower::process(float *values, int num_detectors, int num_frames)
+{
+    float *state = this->state.data();
+    float attack_coefficient = this->attack_coefficient;
+    float release_coefficient = this->release_coefficient;
+
+    /*------------------------------------------------------------------------
+     * Each detector's recurrence is serial across frames, so iterate
+     * detectors in the inner loop. The attack/release choice is a select
+     * rather than a branch, so that unlinked multichannel detection can be
+     * vectorised across detectors.
+     *-----------------------------------------------------------------------*/
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        float *frame_values = values + frame * num_detectors;
+        for (int detector = 0; detector < num_detectors; detector++)
+        {
+            float value = frame_values[detector];
+            float previous = state[detector];
+            float coefficient = (value > previous) ? attack_coefficient : release_coefficient;
+            float next = value + coefficient * (previous - value);
+            state[detector] = next;
+            frame_values[detector] = next;
+        }
+    }
+}
+
+/*------------------------------------------------------------------------
+ * DynamicsEngine
+ *-----------------------------------------------------------------------*/
+
+DynamicsEngine::DynamicsEngine(bool linked, int lookahead)
+    : linked(linked), lookahead(MAX(lookahead, 0)), num_channels_allocated(0), smoothing_position(0)
+{
+}
+
+void DynamicsEngine::alloc(int num_channels)
+{
+    if (num_channels <= this->num_channels_allocated)
+    {
+        return;
+    }
+
+    this->num_channels_allocated = num_channels;
+    this->levels.resize(SIGNALFLOW_DYNAMICS_BLOCK_SIZE * num_channels);
+    while ((int) this->delays.size() < num_channels)
+    {
+        this->delays.push_back(DelayLine(this->lookahead + SIGNALFLOW_DYNAMICS_BLOCK_SIZE));
+        this->holds.push_back(SlidingMax(this->lookahead + 1));
+        this->holds.back().set_window(this->lookahead + 1);
+    }
+    this->smoothing_history.resize((this->lookahead + 1) * num_channels);
+    this->smoothing_sums.resize(num_channels);
+    this->clear();
+}
+
+void DynamicsEngine::clear()
+{
+    for (auto &delay : this->delays)
+    {
+        delay.clear();
+    }
+    for (auto &hold : this->holds)
+    {
+        hold.clear();
+    }
+
+    /*------------------------------------------------------------------------
+     * Gains start at unity.
+     *-----------------------------------------------------------------------*/
+    std::fill(this->smoothing_history.begin(), this->smoothing_history.end(), 1.0f);
+    std::fill(this->smoothing_sums.begin(), this->smoothing_sums.end(), (double) (this->lookahead + 1));
+    this->smoothing_position = 0;
+}
+
+int DynamicsEngine::get_lookahead()
+{
+    return this->lookahead;
+}
+
+int DynamicsEngine::get_num_detectors(int num_channels)
+{
+    return this->linked ? 1 : num_channels;
+}
+
+float *DynamicsEngine::get_levels()
+{
+    return this->levels.data();
+}
+
+void DynamicsEngine::detect(Buffer &in, int num_channels, int offset, int num_frames)
+{
+    float *levels = this->levels.data();
+    if (this->linked)
+    {
+        std::fill(levels, levels + num_frames, 0.0f);
+        for (int channel = 0; channel < num_channels; channel++)
+        {
+            const sample *channel_in = in[channel] + offset;
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                float value = fabsf(channel_in[frame]);
+                levels[frame] = (value > levels[frame]) ? value : levels[frame];
+            }
+        }
+    }
+    else
+    {
+        for (int channel = 0; channel < num_channels; channel++)
+        {
+            const sample *channel_in = in[channel] + offset;
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                levels[frame * num_channels + channel] = fabsf(channel_in[frame]);
+            }
+        }
+    }
+}
+
+void DynamicsEngine::hold(int num_channels, int num_frames)
+{
+    if (this->lookahead == 0)
+    {
+        return;
+    }
+
+    int num_detectors = this->get_num_detectors(num_channels);
+    for (int detector = 0; detector < num_detectors; detector++)
+    {
+        this->holds[detector].process(this->levels.data() + detector, num_frames, num_detectors);
+    }
+}
+
+void DynamicsEngine::smooth(int num_channels, int num_frames)
+{
+    if (this->lookahead == 0)
+    {
+        return;
+    }
+
+    /*------------------------------------------------------------------------
+     * Moving average as a running sum over a ring of past gains. The ring
+     * is strided by the allocated channel count so that its layout does not
+     * depend on the number of detectors in use.
+     *-----------------------------------------------------------------------*/
+    int num_detectors = this->get_num_detectors(num_channels);
+    int window = this->lookahead + 1;
+    int stride = this->num_channels_allocated;
+    double scale = 1.0 / window;
+    double *sums = this->smoothing_sums.data();
+    float *levels = this->levels.data();
+
+    for (int frame = 0; frame < num_frames; frame++)
+    {
+        float *frame_levels = levels + frame * num_detectors;
+        float *history = this->smoothing_history.data() + this->smoothing_position * stride;
+        for (int detector = 0; detector < num_detectors; detector++)
+        {
+            sums[detector] += frame_levels[detector] - history[detector];
+            history[detector] = frame_levels[detector];
+            frame_levels[detector] = (float) (sums[detector] * scale);
+        }
+        this->smoothing_position = (this->smoothing_position + 1) % window;
+    }
+}
+
+void DynamicsEngine::apply(Buffer &in, Buffer &out, int num_channels, int offset, int num_frames)
+{
+    const float *gains = this->levels.data();
+    int num_detectors = this->get_num_detectors(num_channels);
+
+    for (int channel = 0; channel < num_channels; channel++)
+    {
+        const sample *channel_in = in[channel] + offset;
+        sample *channel_out = out[channel] + offset;
+
+        if (this->lookahead > 0)
+        {
+            this->delays[channel].write(channel_in, num_frames);
+            this->delays[channel].read(this->lookahead + num_frames, channel_out, num_frames);
+            channel_in = channel_out;
+        }
+
+        if (this->linked)
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                channel_out[frame] = channel_in[frame] * gains[frame];
+            }
+        }
+        else
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                channel_out[frame] = channel_in[frame] * gains[frame * num_detectors + channel];
+            }
+        }
+    }
+}
+
+}
@@ -1,41 +1,70 @@
+#include "signalflow/core/graph.h"
 #include "signalflow/node/processors/dynamics/gate.h"
 
 namespace signalflow
 {
 
-Gate::Gate(NodeRef input, NodeRef threshold)
-    : UnaryOpNode(input), threshold(threshold)
+Gate::Gate(NodeRef input, NodeRef threshold, NodeRef attack_time, NodeRef release_time,
+           NodeRef sidechain, bool linked)
+    : UnaryOpNode(input), threshold(threshold), attack_time(attack_time), release_time(release_time), sidechain(sidechain), engine(linked)
 {
-    this->level = 0.0;
-
     this->name = "gate";
-    this->create_input("threshold", this->threshold);
+    this->create_input("threshold", this->threshold, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("attack_time", this->attack_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("release_time", this->release_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("sidechain", this->sidechain);
+
+    this->alloc();
 }
 
-void Gate::process(Buffer &out, int num_frames)
+void Gate::alloc()
+{
+    this->engine.alloc(this->num_output_channels_allocated);
+    this->level_follower.alloc(this->num_output_channels_allocated);
+    this->gain_follower.alloc(this->num_output_channels_allocated);
+}
+
+void Gate::trigger(std::string name, float value)
 {
-    for (int frame = 0; frame < num_frames; frame++)
+    if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        float amp = 0.0;
-        for (int channel = 0; channel < this->num_input_channels; channel++)
-            amp += this->input->out[channel][frame];
-        amp /= this->num_input_channels;
+        this->engine.clear();
+        this->level_follower.clear();
+        this->gain_follower.clear();
+    }
+    this->Node::trigger(name, value);
+}
 
-        float threshold = this->threshold->out[0][frame];
+void Gate::process(Buffer &out, int num_frames)
+{
+    float threshold = fabsf(this->threshold->out[0][0]);
+    float attack_time = this->attack_time->out[0][0];
+    float release_time = this->release_time->out[0][0];
+    float sample_rate = this->graph->get_sample_rate();
+    int num_channels = this->num_output_channels;
+    int num_detectors = this->engine.get_num_detectors(num_channels);
+    Buffer &detector_input = this->sidechain ? this->sidechain->out : this->input->out;
 
-        if (amp > threshold)
-        {
-            level = 1.0;
-        }
-        else
-        {
-            level = 0.0;
-        }
+    /*------------------------------------------------------------------------
+     * The detected peak is held over release_time, so that the gate does
+     * not chatter at every zero crossing of a signal near the threshold.
+     *-----------------------------------------------------------------------*/
+    this->level_follower.set_times(0.0, release_time, sample_rate);
+    this->gain_follower.set_times(attack_time, release_time, sample_rate);
+
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_DYNAMICS_BLOCK_SIZE)
+    {
+        int block_frames = MIN(SIGNALFLOW_DYNAMICS_BLOCK_SIZE, num_frames - offset);
+        float *levels = this->engine.get_levels();
 
-        for (int channel = 0; channel < this->num_output_channels; channel++)
+        this->engine.detect(detector_input, num_channels, offset, block_frames);
+        this->level_follower.process(levels, num_detectors, block_frames);
+        for (int index = 0; index < block_frames * num_detectors; index++)
         {
-            out[channel][frame] = this->input->out[channel][frame] * level;
+            levels[index] = (levels[index] > threshold) ? 1.0f : 0.0f;
         }
+        this->gain_follower.process(levels, num_detectors, block_frames);
+        this->engine.apply(this->input->out, out, num_channels, offset, block_frames);
     }
 }
 
@@ -0,0 +1,66 @@
+#include "signalflow/core/graph.h"
+#include "signalflow/node/processors/dynamics/limiter.h"
+
+namespace signalflow
+{
+
+Limiter::Limiter(NodeRef input, NodeRef ceiling, NodeRef release_time, float lookahead_time, bool linked)
+    : UnaryOpNode(input), ceiling(ceiling), release_time(release_time)
+{
+    SIGNALFLOW_CHECK_GRAPH();
+
+    this->name = "limiter";
+    this->create_input("ceiling", this->ceiling, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("release_time", this->release_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+
+    this->engine = DynamicsEngine(linked, (int) (lookahead_time * this->graph->get_sample_rate()));
+    this->alloc();
+}
+
+void Limiter::alloc()
+{
+    this->engine.alloc(this->num_output_channels_allocated);
+    this->follower.alloc(this->num_output_channels_allocated);
+}
+
+void Limiter::trigger(std::string name, float value)
+{
+    if (name == SIGNALFLOW_TRIGGER_RESET)
+    {
+        this->engine.clear();
+        this->follower.clear();
+    }
+    this->Node::trigger(name, value);
+}
+
+void Limiter::process(Buffer &out, int num_frames)
+{
+    float ceiling = fabsf(this->ceiling->out[0][0]);
+    int num_channels = this->num_output_channels;
+    int num_detectors = this->engine.get_num_detectors(num_channels);
+
+    /*------------------------------------------------------------------------
+     * Peaks are followed with an instant attack, so the level never falls
+     * below the true peak and the ceiling is never exceeded; the attack is
+     * instead shaped by the look-ahead ramp in smooth().
+     *-----------------------------------------------------------------------*/
+    this->follower.set_times(0.0, this->release_time->out[0][0], this->graph->get_sample_rate());
+
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_DYNAMICS_BLOCK_SIZE)
+    {
+        int block_frames = MIN(SIGNALFLOW_DYNAMICS_BLOCK_SIZE, num_frames - offset);
+        float *levels = this->engine.get_levels();
+
+        this->engine.detect(this->input->out, num_channels, offset, block_frames);
+        this->follower.process(levels, num_detectors, block_frames);
+        this->engine.hold(num_channels, block_frames);
+        for (int index = 0; index < block_frames * num_detectors; index++)
+        {
+            levels[index] = (levels[index] > ceiling) ? (ceiling / levels[index]) : 1.0f;
+        }
+        this->engine.smooth(num_channels, block_frames);
+        this->engine.apply(this->input->out, out, num_channels, offset, block_frames);
+    }
+}
+
+}
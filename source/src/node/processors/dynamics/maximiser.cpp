@@ -10,9 +10,9 @@ Maximiser::Maximiser(NodeRef input, NodeRef ceiling, NodeRef attack_time, NodeRe
     this->name = "maximiser";
     this->gain = 1.0;
 
-    this->create_input("ceiling", this->ceiling);
-    this->create_input("attack_time", this->attack_time);
-    this->create_input("release_time", this->release_time);
+    this->create_input("ceiling", this->ceiling, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("attack_time", this->attack_time, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("release_time", this->release_time, SIGNALFLOW_INPUT_RATE_CONTROL);
 }
 
 void Maximiser::process(Buffer &out, int num_frames)
@@ -0,0 +1,348 @@
+#include "signalflow/node/processors/filters/biquad-engine.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace signalflow
+{
+
+BiquadCoefficients::BiquadCoefficients(float a0, float a1, float a2, float b1, float b2)
+    : a0(a0), a1(a1), a2(a2), b1(b1), b2(b2)
+{
+}
+
+BiquadCoefficients BiquadCoefficients::from_filter_type(signalflow_filter_type_t filter_type,
+                                                        float cutoff,
+                                                        float resonance,
+                                                        float peak_gain,
+                                                        float sample_rate)
+{
+    BiquadCoefficients c;
+    float norm;
+    float V = powf(10.0, fabs(peak_gain) / 20.0);
+    float K = tan(M_PI * cutoff / sample_rate);
+    float Q = resonance;
+
+    switch (filter_type)
+    {
+        case SIGNALFLOW_FILTER_TYPE_LOW_PASS:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = K * K * norm;
+            c.a1 = 2 * c.a0;
+            c.a2 = c.a0;
+            c.b1 = 2 * (K * K - 1) * norm;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_HIGH_PASS:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = 1 * norm;
+            c.a1 = -2 * c.a0;
+            c.a2 = c.a0;
+            c.b1 = 2 * (K * K - 1) * norm;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_BAND_PASS:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = K / Q * norm;
+            c.a1 = 0;
+            c.a2 = -c.a0;
+            c.b1 = 2 * (K * K - 1) * norm;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_NOTCH:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = (1 + K * K) * norm;
+            c.a1 = 2 * (K * K - 1) * norm;
+            c.a2 = c.a0;
+            c.b1 = c.a1;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_PEAK:
+            if (peak_gain >= 0) // boost
+            {
+                norm = 1 / (1 + 1 / Q * K + K * K);
+                c.a0 = (1 + V / Q * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - V / Q * K + K * K) * norm;
+                c.b1 = c.a1;
+                c.b2 = (1 - 1 / Q * K + K * K) * norm;
+            }
+            else // cut
+            {
+                norm = 1 / (1 + V / Q * K + K * K);
+                c.a0 = (1 + 1 / Q * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - 1 / Q * K + K * K) * norm;
+                c.b1 = c.a1;
+                c.b2 = (1 - V / Q * K + K * K) * norm;
+            }
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_LOW_SHELF:
+            if (peak_gain >= 0) // boost
+            {
+                norm = 1 / (1 + sqrt(2) * K + K * K);
+                c.a0 = (1 + sqrt(2 * V) * K + V * K * K) * norm;
+                c.a1 = 2 * (V * K * K - 1) * norm;
+                c.a2 = (1 - sqrt(2 * V) * K + V * K * K) * norm;
+                c.b1 = 2 * (K * K - 1) * norm;
+                c.b2 = (1 - sqrt(2) * K + K * K) * norm;
+            }
+            else // cut
+            {
+                norm = 1 / (1 + sqrt(2 * V) * K + V * K * K);
+                c.a0 = (1 + sqrt(2) * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - sqrt(2) * K + K * K) * norm;
+                c.b1 = 2 * (V * K * K - 1) * norm;
+                c.b2 = (1 - sqrt(2 * V) * K + V * K * K) * norm;
+            }
+            break;
+
+        case SIGNALFLOW_FILTER_TYPE_HIGH_SHELF:
+            if (peak_gain >= 0) // boost
+            {
+                norm = 1 / (1 + sqrt(2) * K + K * K);
+                c.a0 = (V + sqrt(2 * V) * K + K * K) * norm;
+                c.a1 = 2 * (K * K - V) * norm;
+                c.a2 = (V - sqrt(2 * V) * K + K * K) * norm;
+                c.b1 = 2 * (K * K - 1) * norm;
+                c.b2 = (1 - sqrt(2) * K + K * K) * norm;
+            }
+            else
+            { // cut
+                norm = 1 / (V + sqrt(2 * V) * K + K * K);
+                c.a0 = (1 + sqrt(2) * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - sqrt(2) * K + K * K) * norm;
+                c.b1 = 2 * (K * K - V) * norm;
+                c.b2 = (V - sqrt(2 * V) * K + K * K) * norm;
+            }
+            break;
+    }
+
+    return c;
+}
+
+BiquadEngine::BiquadEngine(int num_channels, int num_sections)
+{
+    this->num_channels = 0;
+    this->num_sections = 0;
+    this->is_ramping = false;
+    this->has_coefficients = false;
+    this->resize(num_channels, num_sections);
+}
+
+void BiquadEngine::resize(int num_channels, int num_sections)
+{
+    if (num_channels == this->num_channels && num_sections == this->num_sections)
+    {
+        return;
+    }
+
+    /*------------------------------------------------------------------------
+     * Storage is section-major, so changing the channel count changes the
+     * stride. Copy the existing values across into the new layout.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> *fields[] = { &a0, &a1, &a2, &b1, &b2,
+                                     &target_a0, &target_a1, &target_a2, &target_b1, &target_b2,
+                                     &delta_a0, &delta_a1, &delta_a2, &delta_b1, &delta_b2,
+                                     &z1, &z2 };
+    for (std::vector<float> *field : fields)
+    {
+        float initial_value = (field == &a0 || field == &target_a0) ? 1.0 : 0.0;
+        std::vector<float> resized(num_channels * num_sections, initial_value);
+        for (int section = 0; section < MIN(num_sections, this->num_sections); section++)
+        {
+            for (int channel = 0; channel < MIN(num_channels, this->num_channels); channel++)
+            {
+                resized[section * num_channels + channel] = (*field)[section * this->num_channels + channel];
+            }
+        }
+        field->swap(resized);
+    }
+
+    this->num_channels = num_channels;
+    this->num_sections = num_sections;
+    this->interleaved.resize(num_channels * SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE);
+}
+
+void BiquadEngine::reset()
+{
+    std::fill(this->z1.begin(), this->z1.end(), 0.0);
+    std::fill(this->z2.begin(), this->z2.end(), 0.0);
+    this->has_coefficients = false;
+}
+
+void BiquadEngine::set_coefficients(int channel, int section, const BiquadCoefficients &coefficients)
+{
+    int index = section * this->num_channels + channel;
+    this->target_a0[index] = coefficients.a0;
+    this->target_a1[index] = coefficients.a1;
+    this->target_a2[index] = coefficients.a2;
+    this->target_b1[index] = coefficients.b1;
+    this->target_b2[index] = coefficients.b2;
+
+    if (this->target_a0[index] != this->a0[index] || this->target_a1[index] != this->a1[index] || this->target_a2[index] != this->a2[index] || this->target_b1[index] != this->b1[index] || this->target_b2[index] != this->b2[index])
+    {
+        this->is_ramping = true;
+    }
+}
+
+void BiquadEngine::process(Buffer &input, Buffer &output, int num_channels, int offset, int num_frames)
+{
+    if (num_frames <= 0)
+    {
+        return;
+    }
+
+    /*------------------------------------------------------------------------
+     * The first set of coefficients is applied immediately rather than
+     * ramped, so that the filter does not sweep in from its default state.
+     *-----------------------------------------------------------------------*/
+    if (this->is_ramping && !this->has_coefficients)
+    {
+        this->a0 = this->target_a0;
+        this->a1 = this->target_a1;
+        this->a2 = this->target_a2;
+        this->b1 = this->target_b1;
+        this->b2 = this->target_b2;
+        this->is_ramping = false;
+    }
+    this->has_coefficients = true;
+
+    bool ramp = this->is_ramping;
+    if (ramp)
+    {
+        float scale = 1.0 / num_frames;
+        for (int i = 0; i < this->num_channels * this->num_sections; i++)
+        {
+            this->delta_a0[i] = (this->target_a0[i] - this->a0[i]) * scale;
+            this->delta_a1[i] = (this->target_a1[i] - this->a1[i]) * scale;
+            this->delta_a2[i] = (this->target_a2[i] - this->a2[i]) * scale;
+            this->delta_b1[i] = (this->target_b1[i] - this->b1[i]) * scale;
+            this->delta_b2[i] = (this->target_b2[i] - this->b2[i]) * scale;
+        }
+    }
+
+    if (num_channels == 1)
+    {
+        /*------------------------------------------------------------------------
+         * A single channel is already laid out frame-major, so can be
+         * processed in place without interleaving.
+         *-----------------------------------------------------------------------*/
+        if (&input != &output)
+        {
+            memcpy(output[0] + offset, input[0] + offset, num_frames * sizeof(sample));
+        }
+        this->process_interleaved(output[0] + offset, 1, num_frames, ramp);
+    }
+    else
+    {
+        for (int block_offset = 0; block_offset < num_frames; block_offset += SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE)
+        {
+            int block_frames = MIN(SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE, num_frames - block_offset);
+            int start = offset + block_offset;
+            sample *data = this->interleaved.data();
+
+            for (int channel = 0; channel < num_channels; channel++)
+            {
+                sample *channel_in = input[channel] + start;
+                for (int frame = 0; frame < block_frames; frame++)
+                {
+                    data[frame * num_channels + channel] = channel_in[frame];
+                }
+            }
+
+            this->process_interleaved(data, num_channels, block_frames, ramp);
+
+            for (int channel = 0; channel < num_channels; channel++)
+            {
+                sample *channel_out = output[channel] + start;
+                for (int frame = 0; frame < block_frames; frame++)
+                {
+                    channel_out[frame] = data[frame * num_channels + channel];
+                }
+            }
+        }
+    }
+
+    if (ramp)
+    {
+        /*------------------------------------------------------------------------
+         * Snap to the target to prevent accumulated rounding error.
+         *-----------------------------------------------------------------------*/
+        this->a0 = this->target_a0;
+        this->a1 = this->target_a1;
+        this->a2 = this->target_a2;
+        this->b1 = this->target_b1;
+        this->b2 = this->target_b2;
+        this->is_ramping = false;
+    }
+}
+
+void BiquadEngine::process_interleaved(sample *data, int num_channels, int num_frames, bool ramp)
+{
+    for (int section = 0; section < this->num_sections; section++)
+    {
+        int index = section * this->num_channels;
+        float *a0 = this->a0.data() + index;
+        float *a1 = this->a1.data() + index;
+        float *a2 = this->a2.data() + index;
+        float *b1 = this->b1.data() + index;
+        float *b2 = this->b2.data() + index;
+        float *z1 = this->z1.data() + index;
+        float *z2 = this->z2.data() + index;
+
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            sample *frame_data = data + frame * num_channels;
+
+            /*------------------------------------------------------------------------
+             * Channels are independent, so this loop vectorises across channels.
+             *-----------------------------------------------------------------------*/
+            for (int channel = 0; channel < num_channels; channel++)
+            {
+                float in = frame_data[channel];
+                float value = in * a0[channel] + z1[channel];
+                z1[channel] = in * a1[channel] + z2[channel] - b1[channel] * value;
+                z2[channel] = in * a2[channel] - b2[channel] * value;
+                frame_data[channel] = value;
+            }
+
+            if (ramp)
+            {
+                float *delta_a0 = this->delta_a0.data() + index;
+                float *delta_a1 = this->delta_a1.data() + index;
+                float *delta_a2 = this->delta_a2.data() + index;
+                float *delta_b1 = this->delta_b1.data() + index;
+                float *delta_b2 = this->delta_b2.data() + index;
+                for (int channel = 0; channel < num_channels; channel++)
+                {
+                    a0[channel] += delta_a0[channel];
+                    a1[channel] += delta_a1[channel];
+                    a2[channel] += delta_a2[channel];
+                    b1[channel] += delta_b1[channel];
+                    b2[channel] += delta_b2[channel];
+                }
+            }
+        }
+    }
+}
+
+int BiquadEngine::get_num_channels()
+{
+    return this->num_channels;
+}
+
+int BiquadEngine::get_num_sections()
+{
+    return this->num_sections;
+}
+
+}
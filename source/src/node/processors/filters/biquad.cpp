@@ -1,6 +1,7 @@
 #include "signalflow/core/graph.h"
 #include "signalflow/node/processors/filters/biquad.h"
 
+#include <math.h>
 #include <stdlib.h>
 
 /*--------------------------------------------------------------------------------*
@@ -29,142 +30,48 @@ BiquadFilter::BiquadFilter(NodeRef input,
 
 void BiquadFilter::alloc()
 {
-    this->a0.resize(this->num_output_channels_allocated, 1.0);
-    this->a1.resize(this->num_output_channels_allocated, 0.0);
-    this->a2.resize(this->num_output_channels_allocated, 0.0);
-    this->b1.resize(this->num_output_channels_allocated, 0.0);
-    this->b2.resize(this->num_output_channels_allocated, 0.0);
-    this->z1.resize(this->num_output_channels_allocated, 0.0);
-    this->z2.resize(this->num_output_channels_allocated, 0.0);
+    this->engine.resize(this->num_output_channels_allocated);
+    this->last_cutoff.resize(this->num_output_channels_allocated, NAN);
+    this->last_resonance.resize(this->num_output_channels_allocated, NAN);
+    this->last_peak_gain.resize(this->num_output_channels_allocated, NAN);
 }
 
 void BiquadFilter::process(Buffer &out, int num_frames)
 {
-    this->_recalculate();
-    for (int channel = 0; channel < num_output_channels; channel++)
+    /*------------------------------------------------------------------------
+     * Sample the filter parameters at the end of each sub-block, and ramp
+     * the coefficients towards them over the course of the sub-block.
+     *-----------------------------------------------------------------------*/
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE)
     {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float in = this->input->out[channel][frame];
-            float value = in * a0[channel] + z1[channel];
-            z1[channel] = in * a1[channel] + z2[channel] - b1[channel] * value;
-            z2[channel] = in * a2[channel] - b2[channel] * value;
-            out[channel][frame] = value;
-        }
+        int block_frames = MIN(SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE, num_frames - offset);
+        this->_recalculate(offset + block_frames - 1);
+        this->engine.process(this->input->out, out, this->num_output_channels, offset, block_frames);
     }
 }
 
-void BiquadFilter::_recalculate()
+void BiquadFilter::_recalculate(int frame)
 {
     for (int channel = 0; channel < num_output_channels; channel++)
     {
-        float norm;
-        float V = powf(10.0, fabs(this->peak_gain->out[channel][0]) / 20.0);
-        float K = tan(M_PI * this->cutoff->out[channel][0] / this->graph->get_sample_rate());
-        float Q = this->resonance->out[channel][0];
-        float peak_gain = this->peak_gain->out[channel][0];
+        float cutoff = this->cutoff->out[channel][frame];
+        float resonance = this->resonance->out[channel][frame];
+        float peak_gain = this->peak_gain->out[channel][frame];
 
-        switch (this->filter_type)
+        if (cutoff == this->last_cutoff[channel] && resonance == this->last_resonance[channel] && peak_gain == this->last_peak_gain[channel])
         {
-            case SIGNALFLOW_FILTER_TYPE_LOW_PASS:
-                norm = 1 / (1 + K / Q + K * K);
-                a0[channel] = K * K * norm;
-                a1[channel] = 2 * a0[channel];
-                a2[channel] = a0[channel];
-                b1[channel] = 2 * (K * K - 1) * norm;
-                b2[channel] = (1 - K / Q + K * K) * norm;
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_HIGH_PASS:
-                norm = 1 / (1 + K / Q + K * K);
-                a0[channel] = 1 * norm;
-                a1[channel] = -2 * a0[channel];
-                a2[channel] = a0[channel];
-                b1[channel] = 2 * (K * K - 1) * norm;
-                b2[channel] = (1 - K / Q + K * K) * norm;
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_BAND_PASS:
-                norm = 1 / (1 + K / Q + K * K);
-                a0[channel] = K / Q * norm;
-                a1[channel] = 0;
-                a2[channel] = -a0[channel];
-                b1[channel] = 2 * (K * K - 1) * norm;
-                b2[channel] = (1 - K / Q + K * K) * norm;
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_NOTCH:
-                norm = 1 / (1 + K / Q + K * K);
-                a0[channel] = (1 + K * K) * norm;
-                a1[channel] = 2 * (K * K - 1) * norm;
-                a2[channel] = a0[channel];
-                b1[channel] = a1[channel];
-                b2[channel] = (1 - K / Q + K * K) * norm;
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_PEAK:
-                if (peak_gain >= 0) // boost
-                {
-                    norm = 1 / (1 + 1 / Q * K + K * K);
-                    a0[channel] = (1 + V / Q * K + K * K) * norm;
-                    a1[channel] = 2 * (K * K - 1) * norm;
-                    a2[channel] = (1 - V / Q * K + K * K) * norm;
-                    b1[channel] = a1[channel];
-                    b2[channel] = (1 - 1 / Q * K + K * K) * norm;
-                }
-                else // cut
-                {
-                    norm = 1 / (1 + V / Q * K + K * K);
-                    a0[channel] = (1 + 1 / Q * K + K * K) * norm;
-                    a1[channel] = 2 * (K * K - 1) * norm;
-                    a2[channel] = (1 - 1 / Q * K + K * K) * norm;
-                    b1[channel] = a1[channel];
-                    b2[channel] = (1 - V / Q * K + K * K) * norm;
-                }
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_LOW_SHELF:
-                if (peak_gain >= 0) // boost
-                {
-                    norm = 1 / (1 + sqrt(2) * K + K * K);
-                    a0[channel] = (1 + sqrt(2 * V) * K + V * K * K) * norm;
-                    a1[channel] = 2 * (V * K * K - 1) * norm;
-                    a2[channel] = (1 - sqrt(2 * V) * K + V * K * K) * norm;
-                    b1[channel] = 2 * (K * K - 1) * norm;
-                    b2[channel] = (1 - sqrt(2) * K + K * K) * norm;
-                }
-                else // cut
-                {
-                    norm = 1 / (1 + sqrt(2 * V) * K + V * K * K);
-                    a0[channel] = (1 + sqrt(2) * K + K * K) * norm;
-                    a1[channel] = 2 * (K * K - 1) * norm;
-                    a2[channel] = (1 - sqrt(2) * K + K * K) * norm;
-                    b1[channel] = 2 * (V * K * K - 1) * norm;
-                    b2[channel] = (1 - sqrt(2 * V) * K + V * K * K) * norm;
-                }
-                break;
-
-            case SIGNALFLOW_FILTER_TYPE_HIGH_SHELF:
-                if (peak_gain >= 0) // boost
-                {
-                    norm = 1 / (1 + sqrt(2) * K + K * K);
-                    a0[channel] = (V + sqrt(2 * V) * K + K * K) * norm;
-                    a1[channel] = 2 * (K * K - V) * norm;
-                    a2[channel] = (V - sqrt(2 * V) * K + K * K) * norm;
-                    b1[channel] = 2 * (K * K - 1) * norm;
-                    b2[channel] = (1 - sqrt(2) * K + K * K) * norm;
-                }
-                else
-                { // cut
-                    norm = 1 / (V + sqrt(2 * V) * K + K * K);
-                    a0[channel] = (1 + sqrt(2) * K + K * K) * norm;
-                    a1[channel] = 2 * (K * K - 1) * norm;
-                    a2[channel] = (1 - sqrt(2) * K + K * K) * norm;
-                    b1[channel] = 2 * (K * K - V) * norm;
-                    b2[channel] = (V - sqrt(2 * V) * K + K * K) * norm;
-                }
-                break;
+            continue;
         }
+        this->last_cutoff[channel] = cutoff;
+        this->last_resonance[channel] = resonance;
+        this->last_peak_gain[channel] = peak_gain;
+
+        BiquadCoefficients coefficients = BiquadCoefficients::from_filter_type(this->filter_type,
+                                                                               cutoff,
+                                                                               resonance,
+                                                                               peak_gain,
+                                                                               this->graph->get_sample_rate());
+        this->engine.set_coefficients(channel, 0, coefficients);
     }
 }
 
@@ -2,6 +2,7 @@
 
 #include "signalflow/core/graph.h"
 
+#include <math.h>
 #include <stdlib.h>
 
 namespace signalflow
@@ -23,14 +24,12 @@ EQ::EQ(NodeRef input, NodeRef low_gain, NodeRef mid_gain, NodeRef high_gain,
 
 void EQ::alloc()
 {
-    this->f1p0.resize(this->num_output_channels_allocated);
-    this->f1p1.resize(this->num_output_channels_allocated);
-    this->f1p2.resize(this->num_output_channels_allocated);
-    this->f1p3.resize(this->num_output_channels_allocated);
-    this->f2p0.resize(this->num_output_channels_allocated);
-    this->f2p1.resize(this->num_output_channels_allocated);
-    this->f2p2.resize(this->num_output_channels_allocated);
-    this->f2p3.resize(this->num_output_channels_allocated);
+    this->low_engine.resize(this->num_output_channels_allocated, 2);
+    this->high_engine.resize(this->num_output_channels_allocated, 2);
+    this->low_buffer.resize(this->num_output_channels_allocated, this->output_buffer_length);
+    this->high_buffer.resize(this->num_output_channels_allocated, this->output_buffer_length);
+    this->last_low_freq.resize(this->num_output_channels_allocated, NAN);
+    this->last_high_freq.resize(this->num_output_channels_allocated, NAN);
     this->sdm1.resize(this->num_output_channels_allocated);
     this->sdm2.resize(this->num_output_channels_allocated);
     this->sdm3.resize(this->num_output_channels_allocated);
@@ -40,31 +39,24 @@ void EQ::process(Buffer &out, int num_frames)
 {
     float low, mid, high;
 
+    /*------------------------------------------------------------------------
+     * Split the input into low-passed copies at each band edge.
+     *-----------------------------------------------------------------------*/
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE)
+    {
+        int block_frames = MIN(SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE, num_frames - offset);
+        this->_recalculate(offset + block_frames - 1);
+        this->low_engine.process(this->input->out, this->low_buffer, this->num_output_channels, offset, block_frames);
+        this->high_engine.process(this->input->out, this->high_buffer, this->num_output_channels, offset, block_frames);
+    }
+
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
         for (int frame = 0; frame < num_frames; frame++)
         {
-            float lf = 2 * sin(M_PI * ((double) this->low_freq->out[channel][frame] / this->graph->get_sample_rate()));
-            float hf = 2 * sin(M_PI * ((double) this->high_freq->out[channel][frame] / this->graph->get_sample_rate()));
-
-            /*------------------------------------------------------------------------
-             * Low-pass filter
-             *-----------------------------------------------------------------------*/
             float sample = this->input->out[channel][frame];
-            this->f1p0[channel] += (lf * (sample - this->f1p0[channel]));
-            this->f1p1[channel] += (lf * (this->f1p0[channel] - this->f1p1[channel]));
-            this->f1p2[channel] += (lf * (this->f1p1[channel] - this->f1p2[channel]));
-            this->f1p3[channel] += (lf * (this->f1p2[channel] - this->f1p3[channel]));
-            low = this->f1p3[channel];
-
-            /*------------------------------------------------------------------------
-             * High-pass filter
-             *-----------------------------------------------------------------------*/
-            this->f2p0[channel] += (hf * (sample - this->f2p0[channel]));
-            this->f2p1[channel] += (hf * (this->f2p0[channel] - this->f2p1[channel]));
-            this->f2p2[channel] += (hf * (this->f2p1[channel] - this->f2p2[channel]));
-            this->f2p3[channel] += (hf * (this->f2p2[channel] - this->f2p3[channel]));
-            high = this->sdm3[channel] - this->f2p3[channel];
+            low = this->low_buffer[channel][frame];
+            high = this->sdm3[channel] - this->high_buffer[channel][frame];
 
             /*------------------------------------------------------------------------
              * Midrange (signal - (low + high))
@@ -84,4 +76,34 @@ void EQ::process(Buffer &out, int num_frames)
     }
 }
 
+void EQ::_recalculate(int frame)
+{
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        float low_freq = this->low_freq->out[channel][frame];
+        float high_freq = this->high_freq->out[channel][frame];
+
+        /*------------------------------------------------------------------------
+         * Two cascaded one-pole low-pass filters y += f * (x - y) are
+         * equivalent to a biquad with a double pole at (1 - f).
+         *-----------------------------------------------------------------------*/
+        if (low_freq != this->last_low_freq[channel])
+        {
+            this->last_low_freq[channel] = low_freq;
+            float lf = 2 * sin(M_PI * ((double) low_freq / this->graph->get_sample_rate()));
+            BiquadCoefficients coefficients(lf * lf, 0, 0, -2 * (1 - lf), (1 - lf) * (1 - lf));
+            this->low_engine.set_coefficients(channel, 0, coefficients);
+            this->low_engine.set_coefficients(channel, 1, coefficients);
+        }
+        if (high_freq != this->last_high_freq[channel])
+        {
+            this->last_high_freq[channel] = high_freq;
+            float hf = 2 * sin(M_PI * ((double) high_freq / this->graph->get_sample_rate()));
+            BiquadCoefficients coefficients(hf * hf, 0, 0, -2 * (1 - hf), (1 - hf) * (1 - hf));
+            this->high_engine.set_coefficients(channel, 0, coefficients);
+            this->high_engine.set_coefficients(channel, 1, coefficients);
+        }
+    }
+}
+
 }
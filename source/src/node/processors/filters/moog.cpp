@@ -1,4 +1,5 @@
 #include "signalflow/core/graph.h"
+#include "signalflow/node/kernel.h"
 #include "signalflow/node/processors/filters/moog.h"
 
 #include <stdlib.h>
@@ -6,6 +7,82 @@
 namespace signalflow
 {
 
+class MoogVCFKernel : public NodeKernel
+{
+public:
+    MoogVCFKernel(MoogVCF *node, float nyquist)
+        : node(node), nyquist(nyquist) {}
+
+    inline void begin_channel(int channel)
+    {
+        this->out1 = node->out1[channel];
+        this->out2 = node->out2[channel];
+        this->out3 = node->out3[channel];
+        this->out4 = node->out4[channel];
+        this->in1 = node->in1[channel];
+        this->in2 = node->in2[channel];
+        this->in3 = node->in3[channel];
+        this->in4 = node->in4[channel];
+    }
+
+    inline void end_channel(int channel)
+    {
+        node->out1[channel] = this->out1;
+        node->out2[channel] = this->out2;
+        node->out3[channel] = this->out3;
+        node->out4[channel] = this->out4;
+        node->in1[channel] = this->in1;
+        node->in2[channel] = this->in2;
+        node->in3[channel] = this->in3;
+        node->in4[channel] = this->in4;
+    }
+
+    inline sample process(sample input, sample cutoff, sample resonance)
+    {
+        cutoff = signalflow_scale_lin_lin(cutoff, 0, this->nyquist, 0.005, 1);
+        float f = cutoff * 1.16;
+        float fb = resonance * (1.0 - 0.15 * f * f);
+
+        /*------------------------------------------------------------------------
+         * Calculate filter
+         *-----------------------------------------------------------------------*/
+        input -= out4 * fb;
+        input *= 0.35013 * f * f * f * f;
+
+        /*------------------------------------------------------------------------
+         * Pole 1
+         *-----------------------------------------------------------------------*/
+        out1 = input + 0.3 * in1 + (1 - f) * out1;
+        in1 = input;
+
+        /*------------------------------------------------------------------------
+         * Pole 2
+         *-----------------------------------------------------------------------*/
+        out2 = out1 + 0.3 * in2 + (1 - f) * out2;
+        in2 = out1;
+
+        /*------------------------------------------------------------------------
+         * Pole 3
+         *-----------------------------------------------------------------------*/
+        out3 = out2 + 0.3 * in3 + (1 - f) * out3;
+        in3 = out2;
+
+        /*------------------------------------------------------------------------
+         * Pole 4
+         *-----------------------------------------------------------------------*/
+        out4 = out3 + 0.3 * in4 + (1 - f) * out4;
+        in4 = out3;
+
+        return out4;
+    }
+
+private:
+    MoogVCF *node;
+    float nyquist;
+    float out1, out2, out3, out4;
+    float in1, in2, in3, in4;
+};
+
 MoogVCF::MoogVCF(NodeRef input, NodeRef cutoff, NodeRef resonance)
     : UnaryOpNode(input), cutoff(cutoff), resonance(resonance)
 {
@@ -30,50 +107,8 @@ void MoogVCF::alloc()
 
 void MoogVCF::process(Buffer &out, int num_frames)
 {
-    for (int channel = 0; channel < num_output_channels; channel++)
-    {
-        for (int frame = 0; frame < num_frames; frame++)
-        {
-            float cutoff = signalflow_scale_lin_lin(this->cutoff->out[channel][frame], 0, this->graph->get_sample_rate() / 2, 0.005, 1);
-            float resonance = this->resonance->out[channel][frame];
-            float f = cutoff * 1.16;
-            float fb = resonance * (1.0 - 0.15 * f * f);
-
-            /*------------------------------------------------------------------------
-             * Calculate filter
-             *-----------------------------------------------------------------------*/
-            float input = this->input->out[channel][frame];
-
-            input -= out4[channel] * fb;
-            input *= 0.35013 * f * f * f * f;
-
-            /*------------------------------------------------------------------------
-             * Pole 1
-             *-----------------------------------------------------------------------*/
-            out1[channel] = input + 0.3 * in1[channel] + (1 - f) * out1[channel];
-            in1[channel] = input;
-
-            /*------------------------------------------------------------------------
-             * Pole 2
-             *-----------------------------------------------------------------------*/
-            out2[channel] = out1[channel] + 0.3 * in2[channel] + (1 - f) * out2[channel];
-            in2[channel] = out1[channel];
-
-            /*------------------------------------------------------------------------
-             * Pole 3
-             *-----------------------------------------------------------------------*/
-            out3[channel] = out2[channel] + 0.3 * in3[channel] + (1 - f) * out3[channel];
-            in3[channel] = out2[channel];
-
-            /*------------------------------------------------------------------------
-             * Pole 4
-             *-----------------------------------------------------------------------*/
-            out4[channel] = out3[channel] + 0.3 * in4[channel] + (1 - f) * out4[channel];
-            in4[channel] = out3[channel];
-
-            out[channel][frame] = out4[channel];
-        }
-    }
+    MoogVCFKernel kernel(this, this->graph->get_sample_rate() / 2);
+    signalflow_process_kernel(kernel, out, this->num_output_channels, num_frames, this->input, this->cutoff, this->resonance);
 }
 
 }
@@ -41,6 +41,20 @@
 
     lpf, bpf, hpf, notch, peak = svf(data, fs)
 
+ * The linear trapezoidal SVF is the bilinear transform of the analog
+ * prototype H(s) = N(s) / (s^2 + ks + 1), so each of its outputs is
+ * equivalent to a biquad with the coefficients below, where
+ * D = 1 + gk + g^2:
+
+    low_pass:  a = [g^2, 2g^2, g^2] / D
+    band_pass: a = [g, 0, -g] / D
+    high_pass: a = [1, -2, 1] / D
+    notch:     a = [1 + g^2, 2g^2 - 2, 1 + g^2] / D
+    peak:      a = [g^2 - 1, 2g^2 + 2, g^2 - 1] / D
+    b = [2g^2 - 2, 1 - gk + g^2] / D
+
+ * This allows the SVF to be processed by the shared BiquadEngine, with
+ * coefficients ramped between sub-blocks.
  **-------------------------------------------------------------------------------*/
 
 namespace signalflow
@@ -70,51 +84,18 @@ SVFFilter::SVFFilter(NodeRef input,
 
 void SVFFilter::alloc()
 {
-    this->ic1eq.resize(this->num_output_channels_allocated, 0.0);
-    this->ic2eq.resize(this->num_output_channels_allocated, 0.0);
-    this->g.resize(this->num_output_channels_allocated, 0.0);
-    this->k.resize(this->num_output_channels_allocated, 0.0);
-    this->a1.resize(this->num_output_channels_allocated, 0.0);
-    this->a2.resize(this->num_output_channels_allocated, 0.0);
-    this->a3.resize(this->num_output_channels_allocated, 0.0);
+    this->engine.resize(this->num_output_channels_allocated);
+    this->last_cutoff.resize(this->num_output_channels_allocated, NAN);
+    this->last_resonance.resize(this->num_output_channels_allocated, NAN);
 }
 
 void SVFFilter::process(Buffer &out, int num_frames)
 {
-    for (int frame = 0; frame < num_frames; frame++)
+    for (int offset = 0; offset < num_frames; offset += SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE)
     {
-        this->_recalculate(frame);
-
-        for (int channel = 0; channel < num_output_channels; channel++)
-        {
-            float v0 = this->input->out[channel][frame];
-            float v3 = v0 - ic2eq[channel];
-            float v1 = a1[channel] * ic1eq[channel] + a2[channel] * v3;
-            float v2 = ic2eq[channel] + a2[channel] * ic1eq[channel] + a3[channel] * v3;
-            ic1eq[channel] = 2 * v1 - ic1eq[channel];
-            ic2eq[channel] = 2 * v2 - ic2eq[channel];
-
-            switch (this->filter_type)
-            {
-                case SIGNALFLOW_FILTER_TYPE_LOW_PASS:
-                    out[channel][frame] = v2;
-                    break;
-                case SIGNALFLOW_FILTER_TYPE_BAND_PASS:
-                    out[channel][frame] = v1;
-                    break;
-                case SIGNALFLOW_FILTER_TYPE_HIGH_PASS:
-                    out[channel][frame] = v0 - k[channel] * v1 - v2;
-                    break;
-                case SIGNALFLOW_FILTER_TYPE_NOTCH:
-                    out[channel][frame] = v2 + (v0 - k[channel] * v1 - v2);
-                    break;
-                case SIGNALFLOW_FILTER_TYPE_PEAK:
-                    out[channel][frame] = v2 - (v0 - k[channel] * v1 - v2);
-                    break;
-                default:
-                    throw std::runtime_error("SVFFilter does not support this filter type");
-            }
-        }
+        int block_frames = MIN(SIGNALFLOW_FILTER_COEFFICIENT_BLOCK_SIZE, num_frames - offset);
+        this->_recalculate(offset + block_frames - 1);
+        this->engine.process(this->input->out, out, this->num_output_channels, offset, block_frames);
     }
 }
 
@@ -122,11 +103,44 @@ void SVFFilter::_recalculate(int frame)
 {
     for (int channel = 0; channel < num_output_channels; channel++)
     {
-        g[channel] = tanf(M_PI * this->cutoff->out[channel][frame] / this->graph->get_sample_rate());
-        k[channel] = 2.0 - 2.0 * this->resonance->out[channel][frame];
-        a1[channel] = 1 / (1 + g[channel] * (g[channel] + k[channel]));
-        a2[channel] = g[channel] * a1[channel];
-        a3[channel] = g[channel] * a2[channel];
+        float cutoff = this->cutoff->out[channel][frame];
+        float resonance = this->resonance->out[channel][frame];
+        if (cutoff == this->last_cutoff[channel] && resonance == this->last_resonance[channel])
+        {
+            continue;
+        }
+        this->last_cutoff[channel] = cutoff;
+        this->last_resonance[channel] = resonance;
+
+        float g = tanf(M_PI * cutoff / this->graph->get_sample_rate());
+        float k = 2.0 - 2.0 * resonance;
+        float g2 = g * g;
+        float norm = 1 / (1 + g * k + g2);
+        float b1 = (2 * g2 - 2) * norm;
+        float b2 = (1 - g * k + g2) * norm;
+
+        BiquadCoefficients coefficients;
+        switch (this->filter_type)
+        {
+            case SIGNALFLOW_FILTER_TYPE_LOW_PASS:
+                coefficients = BiquadCoefficients(g2 * norm, 2 * g2 * norm, g2 * norm, b1, b2);
+                break;
+            case SIGNALFLOW_FILTER_TYPE_BAND_PASS:
+                coefficients = BiquadCoefficients(g * norm, 0, -g * norm, b1, b2);
+                break;
+            case SIGNALFLOW_FILTER_TYPE_HIGH_PASS:
+                coefficients = BiquadCoefficients(norm, -2 * norm, norm, b1, b2);
+                break;
+            case SIGNALFLOW_FILTER_TYPE_NOTCH:
+                coefficients = BiquadCoefficients((1 + g2) * norm, b1, (1 + g2) * norm, b1, b2);
+                break;
+            case SIGNALFLOW_FILTER_TYPE_PEAK:
+                coefficients = BiquadCoefficients((g2 - 1) * norm, (2 * g2 + 2) * norm, (g2 - 1) * norm, b1, b2);
+                break;
+            default:
+                throw std::runtime_error("SVFFilter does not support this filter type");
+        }
+        this->engine.set_coefficients(channel, 0, coefficients);
     }
 }
 
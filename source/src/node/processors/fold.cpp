@@ -8,6 +8,7 @@ Fold::Fold(NodeRef input, NodeRef min, NodeRef max)
     : UnaryOpNode(input), min(min), max(max)
 {
     this->name = "fold";
+    this->supports_control_rate = true;
     this->create_input("min", this->min);
     this->create_input("max", this->max);
 }
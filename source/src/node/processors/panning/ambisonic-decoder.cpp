@@ -0,0 +1,136 @@
+#include "signalflow/node/processors/panning/ambisonic-decoder.h"
+#include "signalflow/core/util.h"
+
+#include <math.h>
+#include <stdexcept>
+#include <string.h>
+
+namespace signalflow
+{
+
+AmbisonicDecoder::AmbisonicDecoder(std::vector<float> speaker_azimuths,
+                                   std::vector<float> speaker_elevations,
+                                   NodeRef input,
+                                   bool max_re)
+    : UnaryOpNode(input), speaker_azimuths(speaker_azimuths), speaker_elevations(speaker_elevations), max_re(max_re)
+{
+    if (speaker_azimuths.empty())
+    {
+        throw std::runtime_error("AmbisonicDecoder: At least one speaker is required");
+    }
+    if (!speaker_elevations.empty() && speaker_elevations.size() != speaker_azimuths.size())
+    {
+        throw std::runtime_error("AmbisonicDecoder: Speaker azimuths and elevations must be the same length");
+    }
+
+    this->name = "ambisonic-decoder";
+    this->update_channels();
+}
+
+void AmbisonicDecoder::update_channels()
+{
+    int num_speakers = (int) this->speaker_azimuths.size();
+    int num_inputs = this->input->get_num_output_channels();
+    this->set_channels(num_inputs, num_speakers);
+    this->resize_output_buffers(num_speakers);
+
+    /*------------------------------------------------------------------------
+     * Use the highest order whose channels are all present.
+     *-----------------------------------------------------------------------*/
+    this->order = MIN((int) sqrtf(num_inputs + 0.5f) - 1, SIGNALFLOW_AMBISONIC_MAX_ORDER);
+    this->order = MAX(this->order, 0);
+    int num_channels = signalflow_ambisonic_num_channels(this->order);
+
+    bool horizontal = true;
+    for (auto elevation : this->speaker_elevations)
+    {
+        if (elevation != 0.0)
+        {
+            horizontal = false;
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Per-order weights. The max-rE weights are those of Zotter and Frank:
+     * cos(n * pi / (2N + 2)) in 2D, and the Legendre polynomials evaluated
+     * at cos(137.9 degrees / (N + 1.51)) in 3D.
+     *-----------------------------------------------------------------------*/
+    std::vector<double> weights(this->order + 1, 1.0);
+    if (this->max_re)
+    {
+        if (horizontal)
+        {
+            for (int n = 0; n <= this->order; n++)
+            {
+                weights[n] = cos(n * M_PI / (2 * this->order + 2));
+            }
+        }
+        else
+        {
+            double x = cos((137.9 * M_PI / 180.0) / (this->order + 1.51));
+            double p_lower = 1.0;
+            double p = x;
+            for (int n = 1; n <= this->order; n++)
+            {
+                weights[n] = p;
+                double p_next = ((2 * n + 1) * x * p - n * p_lower) / (n + 1);
+                p_lower = p;
+                p = p_next;
+            }
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Sampling decoder: each speaker's gains are the spherical harmonics in
+     * its direction, scaled so that the SN3D components sum to the
+     * (weighted) Legendre series in the angle between speaker and source.
+     * In 2D, only the components with |m| = n are used, rescaled to
+     * circular harmonics.
+     *-----------------------------------------------------------------------*/
+    std::vector<float> harmonics(num_channels);
+    std::vector<float> horizontal_norms(num_channels);
+    signalflow_ambisonic_encode(this->order, 0.0, 0.0, horizontal_norms.data());
+
+    this->matrix.assign(num_speakers * num_inputs, 0.0);
+    for (int speaker = 0; speaker < num_speakers; speaker++)
+    {
+        float elevation = horizontal ? 0.0 : this->speaker_elevations[speaker];
+        signalflow_ambisonic_encode(this->order, this->speaker_azimuths[speaker], elevation, harmonics.data());
+
+        for (int n = 0; n <= this->order; n++)
+        {
+            for (int m = -n; m <= n; m++)
+            {
+                int channel = n * n + n + m;
+                double gain;
+                if (horizontal)
+                {
+                    if (m != n && m != -n)
+                    {
+                        continue;
+                    }
+                    double norm = horizontal_norms[n * n + 2 * n];
+                    gain = weights[n] * (n == 0 ? 1.0 : 2.0) * harmonics[channel] / (norm * norm);
+                }
+                else
+                {
+                    gain = weights[n] * (2 * n + 1) * harmonics[channel];
+                }
+                this->matrix[speaker * num_inputs + channel] = gain / num_speakers;
+            }
+        }
+    }
+}
+
+void AmbisonicDecoder::process(Buffer &out, int num_frames)
+{
+    int num_inputs = this->num_input_channels;
+    for (int speaker = 0; speaker < this->num_output_channels; speaker++)
+    {
+        const float *gains = &this->matrix[speaker * num_inputs];
+        memset(out[speaker], 0, num_frames * sizeof(sample));
+        signalflow_spatial_mix(this->input->out.data, num_inputs, gains, gains, 1, out[speaker], num_frames);
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+#include "signalflow/node/processors/panning/ambisonic-encoder.h"
+#include "signalflow/core/util.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
+#define SIGNALFLOW_AMBISONIC_ENCODER_SOURCES_PER_PASS 8
+
+namespace signalflow
+{
+
+AmbisonicEncoder::AmbisonicEncoder(int order, NodeRef input, NodeRef azimuth, NodeRef elevation)
+    : input(input), azimuth(azimuth), elevation(elevation), order(order)
+{
+    if (order < 0 || order > SIGNALFLOW_AMBISONIC_MAX_ORDER)
+    {
+        throw std::runtime_error("AmbisonicEncoder: Order must be between 0 and " + std::to_string(SIGNALFLOW_AMBISONIC_MAX_ORDER));
+    }
+
+    this->name = "ambisonic-encoder";
+    this->num_ambisonic_channels = signalflow_ambisonic_num_channels(order);
+
+    this->create_input("input", this->input);
+    this->create_input("azimuth", this->azimuth, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("elevation", this->elevation, SIGNALFLOW_INPUT_RATE_CONTROL);
+
+    this->update_channels();
+}
+
+void AmbisonicEncoder::update_channels()
+{
+    /*------------------------------------------------------------------------
+     * There is one source for each channel of the widest input, with the
+     * other inputs upmixed to match.
+     *-----------------------------------------------------------------------*/
+    int num_sources = 1;
+    for (NodeRef node : { this->input, this->azimuth, this->elevation })
+    {
+        if (node)
+        {
+            num_sources = MAX(num_sources, node->get_num_output_channels());
+        }
+    }
+
+    this->set_channels(num_sources, this->num_ambisonic_channels);
+    this->resize_input_buffers(num_sources);
+    this->resize_output_buffers(this->num_output_channels);
+
+    this->positioned.resize(num_sources, false);
+    this->azimuths.resize(num_sources);
+    this->elevations.resize(num_sources);
+    this->coefficients.resize(num_sources * this->num_ambisonic_channels);
+    this->next_coefficients.resize(num_sources * this->num_ambisonic_channels);
+    this->inputs.resize(num_sources);
+}
+
+void AmbisonicEncoder::process(Buffer &out, int num_frames)
+{
+    int num_channels = this->num_ambisonic_channels;
+    int num_sources = this->num_input_channels;
+
+    /*------------------------------------------------------------------------
+     * Find each source's coefficients for the end of the block, which
+     * differ from those at the start only for sources that have moved.
+     *-----------------------------------------------------------------------*/
+    for (int source = 0; source < num_sources; source++)
+    {
+        float azimuth = this->azimuth->out[source][0];
+        float elevation = this->elevation->out[source][0];
+        float *coefficients = &this->coefficients[source * num_channels];
+        float *next_coefficients = &this->next_coefficients[source * num_channels];
+
+        if (!this->positioned[source] || azimuth != this->azimuths[source] || elevation != this->elevations[source])
+        {
+            signalflow_ambisonic_encode(this->order, azimuth, elevation, next_coefficients);
+            if (!this->positioned[source])
+            {
+                std::copy(next_coefficients, next_coefficients + num_channels, coefficients);
+                this->positioned[source] = true;
+            }
+            this->azimuths[source] = azimuth;
+            this->elevations[source] = elevation;
+        }
+        else
+        {
+            std::copy(coefficients, coefficients + num_channels, next_coefficients);
+        }
+        this->inputs[source] = this->input->out[source];
+    }
+
+    /*------------------------------------------------------------------------
+     * Mix a few sources at a time into every output channel, so that both
+     * the sources' and the outputs' samples stay in cache.
+     *-----------------------------------------------------------------------*/
+    for (int channel = 0; channel < num_channels; channel++)
+    {
+        memset(out[channel], 0, num_frames * sizeof(sample));
+    }
+    for (int source = 0; source < num_sources; source += SIGNALFLOW_AMBISONIC_ENCODER_SOURCES_PER_PASS)
+    {
+        int group_size = MIN(SIGNALFLOW_AMBISONIC_ENCODER_SOURCES_PER_PASS, num_sources - source);
+        for (int channel = 0; channel < num_channels; channel++)
+        {
+            signalflow_spatial_mix(&this->inputs[source],
+                                   group_size,
+                                   &this->coefficients[source * num_channels + channel],
+                                   &this->next_coefficients[source * num_channels + channel],
+                                   num_channels,
+                                   out[channel],
+                                   num_frames);
+        }
+    }
+
+    this->coefficients.swap(this->next_coefficients);
+}
+
+}
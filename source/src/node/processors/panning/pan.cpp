@@ -1,5 +1,8 @@
+#include "signalflow/core/util.h"
 #include "signalflow/node/processors/panning/pan.h"
 
+#include <string.h>
+
 namespace signalflow
 {
 
@@ -16,25 +19,25 @@ LinearPanner::LinearPanner(int channels, NodeRef input, NodeRef pan)
 
 void LinearPanner::process(Buffer &out, int num_frames)
 {
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        memset(out[channel], 0, num_frames * sizeof(sample));
+    }
+
+    /*------------------------------------------------------------------------
+     * The input is panned between the two adjacent output channels nearest
+     * its position, with equal power.
+     *-----------------------------------------------------------------------*/
     for (int frame = 0; frame < num_frames; frame++)
     {
-        sample pan = this->pan->out[0][frame];
         sample in = this->input->out[0][frame];
+        float gain_lower, gain_upper;
+        int lower = signalflow_pan_equal_power(this->pan->out[0][frame], this->num_output_channels, gain_lower, gain_upper);
 
-        if (pan < -1)
-            pan = -1.0f;
-        if (pan > 1)
-            pan = 1.0;
-
-        if (this->num_output_channels == 2)
-        {
-            pan = pan * 0.5 + 0.5;
-            out[0][frame] = in * sqrtf((1.0 - pan));
-            out[1][frame] = in * sqrtf(pan);
-        }
-        else
+        out[lower][frame] = in * gain_lower;
+        if (lower + 1 < this->num_output_channels)
         {
-            throw std::runtime_error("Unsupported channel count");
+            out[lower + 1][frame] = in * gain_upper;
         }
     }
 }
@@ -0,0 +1,548 @@
+#include "signalflow/node/processors/panning/spatial.h"
+#include "signalflow/core/util.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <stdexcept>
+
+/*------------------------------------------------------------------------
+ * Speaker triplets whose determinant, relative to their perimeter in
+ * radians, falls below this are too close to coplanar with the listener
+ * to pan between (Pulkki's MIN_VOL_P_SIDE_LGTH).
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_VBAP_MIN_VOLUME_PER_SIDE 0.01
+
+/*------------------------------------------------------------------------
+ * Gains below zero by no more than this are treated as zero, so that
+ * directions on the edge of a region are found within it.
+ *-----------------------------------------------------------------------*/
+#define SIGNALFLOW_VBAP_GAIN_TOLERANCE -0.001
+
+namespace signalflow
+{
+
+int signalflow_ambisonic_num_channels(int order)
+{
+    return (order + 1) * (order + 1);
+}
+
+void signalflow_ambisonic_encode(int order, float azimuth, float elevation, float *coefficients)
+{
+    double theta = azimuth * M_PI / 180.0;
+    double x = sin(elevation * M_PI / 180.0);
+    double c = cos(elevation * M_PI / 180.0);
+
+    for (int m = 0; m <= order; m++)
+    {
+        /*------------------------------------------------------------------------
+         * Associated Legendre functions without the Condon-Shortley phase,
+         * from P(m, m) = (2m - 1)!! c^m upwards by the three-term recurrence.
+         *-----------------------------------------------------------------------*/
+        double p_mm = 1.0;
+        for (int i = 1; i <= m; i++)
+        {
+            p_mm *= (2 * i - 1) * c;
+        }
+
+        double cos_m_theta = cos(m * theta);
+        double sin_m_theta = sin(m * theta);
+        double p_lower = 0.0;
+        double p = p_mm;
+
+        for (int n = m; n <= order; n++)
+        {
+            if (n > m)
+            {
+                double p_next = ((2 * n - 1) * x * p - (n + m - 1) * p_lower) / (n - m);
+                p_lower = p;
+                p = p_next;
+            }
+
+            /*------------------------------------------------------------------------
+             * SN3D normalisation: sqrt((2 - delta(m)) * (n - m)! / (n + m)!)
+             *-----------------------------------------------------------------------*/
+            double factorial_ratio = 1.0;
+            for (int i = n - m + 1; i <= n + m; i++)
+            {
+                factorial_ratio /= i;
+            }
+            double norm = sqrt((m == 0 ? 1.0 : 2.0) * factorial_ratio);
+
+            coefficients[n * n + n + m] = norm * p * cos_m_theta;
+            if (m > 0)
+            {
+                coefficients[n * n + n - m] = norm * p * sin_m_theta;
+            }
+        }
+    }
+}
+
+void signalflow_spatial_accumulate(const sample *in, sample *out, float gain_from, float gain_to, int num_frames)
+{
+    if (gain_from == gain_to)
+    {
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] += gain_to * in[frame];
+        }
+    }
+    else
+    {
+        float step = (gain_to - gain_from) / num_frames;
+        for (int frame = 0; frame < num_frames; frame++)
+        {
+            out[frame] += (gain_from + step * (frame + 1)) * in[frame];
+        }
+    }
+}
+
+void signalflow_spatial_mix(const sample *const *inputs,
+                            int num_inputs,
+                            const float *gains_from,
+                            const float *gains_to,
+                            int gain_stride,
+                            sample *out,
+                            int num_frames)
+{
+    /*------------------------------------------------------------------------
+     * With gains ramping linearly from c to c + d * num_frames, each group
+     * contributes sum(c * x) + (frame + 1) * sum(d * x), so ramped inputs
+     * cost only one more multiply-add per input than fixed ones.
+     *-----------------------------------------------------------------------*/
+    int index = 0;
+    for (; index + 4 <= num_inputs; index += 4)
+    {
+        const sample *x0 = inputs[index];
+        const sample *x1 = inputs[index + 1];
+        const sample *x2 = inputs[index + 2];
+        const sample *x3 = inputs[index + 3];
+        float c[4], d[4];
+        bool ramped = false;
+        for (int k = 0; k < 4; k++)
+        {
+            c[k] = gains_from[(index + k) * gain_stride];
+            d[k] = (gains_to[(index + k) * gain_stride] - c[k]) / num_frames;
+            ramped = ramped || (d[k] != 0.0);
+        }
+
+        if (ramped)
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                float fixed = c[0] * x0[frame] + c[1] * x1[frame] + c[2] * x2[frame] + c[3] * x3[frame];
+                float ramp = d[0] * x0[frame] + d[1] * x1[frame] + d[2] * x2[frame] + d[3] * x3[frame];
+                out[frame] += fixed + (float) (frame + 1) * ramp;
+            }
+        }
+        else
+        {
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                out[frame] += c[0] * x0[frame] + c[1] * x1[frame] + c[2] * x2[frame] + c[3] * x3[frame];
+            }
+        }
+    }
+
+    for (; index < num_inputs; index++)
+    {
+        signalflow_spatial_accumulate(inputs[index], out, gains_from[index * gain_stride], gains_to[index * gain_stride], num_frames);
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Vector helpers for the triangulation.
+ *-----------------------------------------------------------------------*/
+static void cross(const float *a, const float *b, float *out)
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static float dot(const float *a, const float *b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static float angle_between(const float *a, const float *b)
+{
+    return acosf(signalflow_clip(dot(a, b), -1, 1));
+}
+
+/*------------------------------------------------------------------------
+ * Returns true if the point p, on the great circle through a and b, lies
+ * strictly within the shorter arc between them.
+ *-----------------------------------------------------------------------*/
+static bool arc_contains(const float *a, const float *b, const float *p)
+{
+    float normal[3], a_p[3], p_b[3];
+    cross(a, b, normal);
+    cross(a, p, a_p);
+    cross(p, b, p_b);
+    return dot(a_p, normal) > 1e-6 && dot(p_b, normal) > 1e-6;
+}
+
+static bool arcs_cross(const float *a, const float *b, const float *c, const float *d)
+{
+    float normal_ab[3], normal_cd[3], intersection[3];
+    cross(a, b, normal_ab);
+    cross(c, d, normal_cd);
+    cross(normal_ab, normal_cd, intersection);
+
+    float length = sqrtf(dot(intersection, intersection));
+    if (length < 1e-6)
+    {
+        return false;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        intersection[i] /= length;
+    }
+
+    float opposite[3] = { -intersection[0], -intersection[1], -intersection[2] };
+    return (arc_contains(a, b, intersection) && arc_contains(c, d, intersection)) || (arc_contains(a, b, opposite) && arc_contains(c, d, opposite));
+}
+
+VBAPLayout::VBAPLayout(std::vector<float> azimuths, std::vector<float> elevations)
+{
+    if (azimuths.empty())
+    {
+        throw std::runtime_error("VBAPLayout: At least one speaker is required");
+    }
+    if (!elevations.empty() && elevations.size() != azimuths.size())
+    {
+        throw std::runtime_error("VBAPLayout: Speaker azimuths and elevations must be the same length");
+    }
+
+    this->num_speakers = (int) azimuths.size();
+    this->horizontal = true;
+    this->directions.resize(this->num_speakers * 3);
+    for (int speaker = 0; speaker < this->num_speakers; speaker++)
+    {
+        float azimuth = azimuths[speaker] * M_PI / 180.0;
+        float elevation = elevations.empty() ? 0.0 : elevations[speaker] * M_PI / 180.0;
+        this->directions[speaker * 3 + 0] = cosf(azimuth) * cosf(elevation);
+        this->directions[speaker * 3 + 1] = sinf(azimuth) * cosf(elevation);
+        this->directions[speaker * 3 + 2] = sinf(elevation);
+        if (fabsf(elevation) > 1e-6)
+        {
+            this->horizontal = false;
+        }
+    }
+
+    if (this->num_speakers == 1)
+    {
+        return;
+    }
+
+    if (this->horizontal)
+    {
+        this->triangulate_horizontal();
+    }
+    else
+    {
+        this->triangulate();
+    }
+
+    if (this->regions.empty())
+    {
+        throw std::runtime_error("VBAPLayout: Speaker layout cannot be divided into regions for panning");
+    }
+}
+
+int VBAPLayout::get_num_speakers()
+{
+    return this->num_speakers;
+}
+
+int VBAPLayout::get_num_regions()
+{
+    return (int) this->regions.size();
+}
+
+bool VBAPLayout::is_horizontal()
+{
+    return this->horizontal;
+}
+
+void VBAPLayout::triangulate_horizontal()
+{
+    std::vector<int> order(this->num_speakers);
+    std::vector<float> angles(this->num_speakers);
+    for (int speaker = 0; speaker < this->num_speakers; speaker++)
+    {
+        order[speaker] = speaker;
+        angles[speaker] = atan2f(this->directions[speaker * 3 + 1], this->directions[speaker * 3 + 0]);
+    }
+    std::sort(order.begin(), order.end(), [&angles](int a, int b) { return angles[a] < angles[b]; });
+
+    for (int index = 0; index < this->num_speakers; index++)
+    {
+        int a = order[index];
+        int b = order[(index + 1) % this->num_speakers];
+        const float *da = &this->directions[a * 3];
+        const float *db = &this->directions[b * 3];
+
+        /*------------------------------------------------------------------------
+         * Pairs must be less than 180 degrees apart, measured anticlockwise
+         * from a to b, for the pair to have an inverse that pans between them.
+         *-----------------------------------------------------------------------*/
+        float determinant = da[0] * db[1] - da[1] * db[0];
+        if (determinant < 1e-3)
+        {
+            continue;
+        }
+
+        Region region = { { a, b, -1 }, { 0 } };
+        region.inverse[0] = db[1] / determinant;
+        region.inverse[1] = -da[1] / determinant;
+        region.inverse[3] = -db[0] / determinant;
+        region.inverse[4] = da[0] / determinant;
+        this->regions.push_back(region);
+    }
+}
+
+void VBAPLayout::triangulate()
+{
+    int n = this->num_speakers;
+    const float *directions = this->directions.data();
+
+    /*------------------------------------------------------------------------
+     * Find every usable triplet that encloses no other speaker.
+     *-----------------------------------------------------------------------*/
+    std::vector<Region> candidates;
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = i + 1; j < n; j++)
+        {
+            for (int k = j + 1; k < n; k++)
+            {
+                const float *a = directions + i * 3;
+                const float *b = directions + j * 3;
+                const float *c = directions + k * 3;
+
+                float b_c[3], c_a[3], a_b[3];
+                cross(b, c, b_c);
+                cross(c, a, c_a);
+                cross(a, b, a_b);
+                float determinant = dot(a, b_c);
+                float perimeter = angle_between(a, b) + angle_between(b, c) + angle_between(c, a);
+                if (fabsf(determinant) / perimeter < SIGNALFLOW_VBAP_MIN_VOLUME_PER_SIDE)
+                {
+                    continue;
+                }
+
+                /*------------------------------------------------------------------------
+                 * The inverse's columns are the cross products of pairs of
+                 * rows, divided by the determinant.
+                 *-----------------------------------------------------------------------*/
+                Region region = { { i, j, k }, { 0 } };
+                for (int row = 0; row < 3; row++)
+                {
+                    region.inverse[row * 3 + 0] = b_c[row] / determinant;
+                    region.inverse[row * 3 + 1] = c_a[row] / determinant;
+                    region.inverse[row * 3 + 2] = a_b[row] / determinant;
+                }
+
+                bool encloses_speaker = false;
+                for (int other = 0; other < n && !encloses_speaker; other++)
+                {
+                    if (other == i || other == j || other == k)
+                    {
+                        continue;
+                    }
+                    float gains[3];
+                    if (this->get_region_gains(region, directions + other * 3, gains) >= SIGNALFLOW_VBAP_GAIN_TOLERANCE)
+                    {
+                        encloses_speaker = true;
+                    }
+                }
+
+                if (!encloses_speaker)
+                {
+                    candidates.push_back(region);
+                }
+            }
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Collect the edges of the candidate triplets, and in order of
+     * increasing length, discard any longer edge that crosses them.
+     *-----------------------------------------------------------------------*/
+    std::vector<bool> connected(n * n, false);
+    for (auto &region : candidates)
+    {
+        for (int edge = 0; edge < 3; edge++)
+        {
+            int a = region.speakers[edge];
+            int b = region.speakers[(edge + 1) % 3];
+            connected[a * n + b] = connected[b * n + a] = true;
+        }
+    }
+
+    std::vector<std::pair<float, std::pair<int, int>>> edges;
+    for (int a = 0; a < n; a++)
+    {
+        for (int b = a + 1; b < n; b++)
+        {
+            if (connected[a * n + b])
+            {
+                edges.push_back(std::make_pair(angle_between(directions + a * 3, directions + b * 3), std::make_pair(a, b)));
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t shorter = 0; shorter < edges.size(); shorter++)
+    {
+        int a = edges[shorter].second.first;
+        int b = edges[shorter].second.second;
+        if (!connected[a * n + b])
+        {
+            continue;
+        }
+        for (size_t longer = shorter + 1; longer < edges.size(); longer++)
+        {
+            int c = edges[longer].second.first;
+            int d = edges[longer].second.second;
+            if (!connected[c * n + d] || a == c || a == d || b == c || b == d)
+            {
+                continue;
+            }
+            if (arcs_cross(directions + a * 3, directions + b * 3, directions + c * 3, directions + d * 3))
+            {
+                connected[c * n + d] = connected[d * n + c] = false;
+            }
+        }
+    }
+
+    for (auto &region : candidates)
+    {
+        int *s = region.speakers;
+        if (connected[s[0] * n + s[1]] && connected[s[1] * n + s[2]] && connected[s[2] * n + s[0]])
+        {
+            this->regions.push_back(region);
+        }
+    }
+}
+
+float VBAPLayout::get_region_gains(const Region &region, const float *direction, float *gains)
+{
+    const float *inverse = region.inverse;
+    if (region.speakers[2] < 0)
+    {
+        gains[0] = direction[0] * inverse[0] + direction[1] * inverse[3];
+        gains[1] = direction[0] * inverse[1] + direction[1] * inverse[4];
+        gains[2] = 0.0;
+        return MIN(gains[0], gains[1]);
+    }
+
+    for (int column = 0; column < 3; column++)
+    {
+        gains[column] = direction[0] * inverse[column] + direction[1] * inverse[3 + column] + direction[2] * inverse[6 + column];
+    }
+    return MIN(gains[0], MIN(gains[1], gains[2]));
+}
+
+int VBAPLayout::get_gains(float azimuth, float elevation, int hint, int *speakers, float *gains)
+{
+    if (this->num_speakers == 1)
+    {
+        speakers[0] = 0;
+        speakers[1] = speakers[2] = -1;
+        gains[0] = 1.0;
+        gains[1] = gains[2] = 0.0;
+        return 0;
+    }
+
+    /*------------------------------------------------------------------------
+     * For a horizontal layout, only the azimuth is used.
+     *-----------------------------------------------------------------------*/
+    azimuth = azimuth * M_PI / 180.0;
+    elevation = this->horizontal ? 0.0 : elevation * M_PI / 180.0;
+    float direction[3] = { cosf(azimuth) * cosf(elevation), sinf(azimuth) * cosf(elevation), sinf(elevation) };
+
+    int num_regions = (int) this->regions.size();
+    int best_region = -1;
+    float best_minimum = -FLT_MAX;
+    float region_gains[3];
+
+    if (hint >= 0 && hint < num_regions)
+    {
+        best_minimum = this->get_region_gains(this->regions[hint], direction, gains);
+        best_region = hint;
+    }
+
+    for (int region = 0; region < num_regions && best_minimum < SIGNALFLOW_VBAP_GAIN_TOLERANCE; region++)
+    {
+        float minimum = this->get_region_gains(this->regions[region], direction, region_gains);
+        if (minimum >= SIGNALFLOW_VBAP_GAIN_TOLERANCE)
+        {
+            best_minimum = minimum;
+            best_region = region;
+            std::copy(region_gains, region_gains + 3, gains);
+        }
+    }
+
+    if (best_minimum < SIGNALFLOW_VBAP_GAIN_TOLERANCE)
+    {
+        /*------------------------------------------------------------------------
+         * The direction is outside the covered area. Use the region whose
+         * gains, with negative gains clipped, pan closest to it.
+         *-----------------------------------------------------------------------*/
+        float best_similarity = -FLT_MAX;
+        for (int region = 0; region < num_regions; region++)
+        {
+            this->get_region_gains(this->regions[region], direction, region_gains);
+            float panned[3] = { 0.0, 0.0, 0.0 };
+            for (int index = 0; index < 3; index++)
+            {
+                int speaker = this->regions[region].speakers[index];
+                if (speaker >= 0 && region_gains[index] > 0)
+                {
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        panned[axis] += region_gains[index] * this->directions[speaker * 3 + axis];
+                    }
+                }
+            }
+            float length = sqrtf(dot(panned, panned));
+            float similarity = (length > 0) ? dot(panned, direction) / length : -1.0;
+            if (similarity > best_similarity)
+            {
+                best_similarity = similarity;
+                best_region = region;
+                std::copy(region_gains, region_gains + 3, gains);
+            }
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Clip any negative gains and normalise to unit power.
+     *-----------------------------------------------------------------------*/
+    float power = 0.0;
+    for (int index = 0; index < 3; index++)
+    {
+        speakers[index] = this->regions[best_region].speakers[index];
+        gains[index] = (speakers[index] < 0) ? 0.0 : MAX(gains[index], 0.0f);
+        power += gains[index] * gains[index];
+    }
+    if (power > 0)
+    {
+        float scale = 1.0 / sqrtf(power);
+        for (int index = 0; index < 3; index++)
+        {
+            gains[index] *= scale;
+        }
+    }
+    else
+    {
+        gains[0] = 1.0;
+    }
+
+    return best_region;
+}
+
+}
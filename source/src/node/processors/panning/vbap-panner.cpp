@@ -0,0 +1,126 @@
+#include "signalflow/node/processors/panning/vbap-panner.h"
+#include "signalflow/core/util.h"
+
+#include <string.h>
+
+namespace signalflow
+{
+
+VBAPPanner::VBAPPanner(std::vector<float> speaker_azimuths,
+                       std::vector<float> speaker_elevations,
+                       NodeRef input,
+                       NodeRef azimuth,
+                       NodeRef elevation)
+    : input(input), azimuth(azimuth), elevation(elevation), layout(speaker_azimuths, speaker_elevations)
+{
+    this->name = "vbap-panner";
+
+    this->create_input("input", this->input);
+    this->create_input("azimuth", this->azimuth, SIGNALFLOW_INPUT_RATE_CONTROL);
+    this->create_input("elevation", this->elevation, SIGNALFLOW_INPUT_RATE_CONTROL);
+
+    this->update_channels();
+}
+
+void VBAPPanner::update_channels()
+{
+    /*------------------------------------------------------------------------
+     * There is one source for each channel of the widest input, with the
+     * other inputs upmixed to match.
+     *-----------------------------------------------------------------------*/
+    int num_sources = 1;
+    for (NodeRef node : { this->input, this->azimuth, this->elevation })
+    {
+        if (node)
+        {
+            num_sources = MAX(num_sources, node->get_num_output_channels());
+        }
+    }
+
+    this->set_channels(num_sources, this->layout.get_num_speakers());
+    this->resize_input_buffers(num_sources);
+    this->resize_output_buffers(this->num_output_channels);
+
+    Source source = { false, 0.0, 0.0, -1, { -1, -1, -1 }, { 0.0, 0.0, 0.0 } };
+    this->sources.resize(num_sources, source);
+}
+
+void VBAPPanner::process(Buffer &out, int num_frames)
+{
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        memset(out[channel], 0, num_frames * sizeof(sample));
+    }
+
+    for (int index = 0; index < this->num_input_channels; index++)
+    {
+        Source &source = this->sources[index];
+        const sample *in = this->input->out[index];
+        float azimuth = this->azimuth->out[index][0];
+        float elevation = this->elevation->out[index][0];
+
+        if (!source.positioned)
+        {
+            source.region = this->layout.get_gains(azimuth, elevation, -1, source.speakers, source.gains);
+            source.azimuth = azimuth;
+            source.elevation = elevation;
+            source.positioned = true;
+        }
+
+        if (azimuth == source.azimuth && elevation == source.elevation)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                if (source.speakers[k] >= 0 && source.gains[k] != 0.0)
+                {
+                    signalflow_spatial_accumulate(in, out[source.speakers[k]], source.gains[k], source.gains[k], num_frames);
+                }
+            }
+            continue;
+        }
+
+        int speakers[3];
+        float gains[3];
+        source.region = this->layout.get_gains(azimuth, elevation, source.region, speakers, gains);
+
+        /*------------------------------------------------------------------------
+         * Ramp each speaker that the source was feeding to its new gain,
+         * which is zero if the source has moved to a different region, then
+         * ramp up any speakers that it was not previously feeding.
+         *-----------------------------------------------------------------------*/
+        for (int k = 0; k < 3; k++)
+        {
+            if (source.speakers[k] < 0)
+            {
+                continue;
+            }
+            float target = 0.0;
+            for (int j = 0; j < 3; j++)
+            {
+                if (speakers[j] == source.speakers[k])
+                {
+                    target = gains[j];
+                }
+            }
+            signalflow_spatial_accumulate(in, out[source.speakers[k]], source.gains[k], target, num_frames);
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            if (speakers[j] < 0 || speakers[j] == source.speakers[0] || speakers[j] == source.speakers[1] || speakers[j] == source.speakers[2])
+            {
+                continue;
+            }
+            signalflow_spatial_accumulate(in, out[speakers[j]], 0.0, gains[j], num_frames);
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            source.speakers[k] = speakers[k];
+            source.gains[k] = gains[k];
+        }
+        source.azimuth = azimuth;
+        source.elevation = elevation;
+    }
+}
+
+}
@@ -2,6 +2,7 @@
 #include "signalflow/patch/patch-spec.h"
 #include "signalflow/patch/patch.h"
 
+#include <algorithm>
 #include <stdlib.h>
 
 namespace signalflow
@@ -30,12 +31,32 @@ NodeRegistry *NodeRegistry::global()
 
 Node *NodeRegistry::create(std::string name)
 {
-    if (!registry->classes[name])
+    return this->get_constructor(name)();
+}
+
+std::function<Node *()> NodeRegistry::get_constructor(std::string name)
+{
+    /*------------------------------------------------------------------------
+     * Use find() rather than operator[], which would insert an entry for an
+     * unknown name, so that Nodes can be created from multiple threads.
+     *-----------------------------------------------------------------------*/
+    auto creator = registry->classes.find(name);
+    if (creator == registry->classes.end() || !creator->second)
     {
         throw std::runtime_error("Could not instantiate Node (unknown type: " + name + ")");
     }
-    Node *node = registry->classes[name]();
-    return node;
+    return creator->second;
+}
+
+std::vector<std::string> NodeRegistry::get_names()
+{
+    std::vector<std::string> names;
+    for (auto pair : this->classes)
+    {
+        names.push_back(pair.first);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
 }
 
 }
@@ -3,6 +3,7 @@
 #include "signalflow/core/graph.h"
 #include "signalflow/core/random.h"
 
+#include <limits>
 #include <math.h>
 
 namespace signalflow
@@ -31,6 +32,7 @@ PinkNoise::PinkNoise(float low_cutoff, float high_cutoff, NodeRef reset)
 
 void PinkNoise::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::vector<float>(this->num_octaves, std::numeric_limits<float>::max()));
     this->steps_remaining.resize(this->num_output_channels_allocated, std::vector<int>(this->num_octaves));
 }
@@ -51,9 +53,9 @@ void PinkNoise::process(Buffer &out, int num_frames)
                 if (this->steps_remaining[channel][octave] <= 0)
                 {
                     // pick a new target value
-                    float target = this->random_uniform(-1, 1);
+                    float target = this->rng[channel].uniform(-1, 1);
 
-                    this->steps_remaining[channel][octave] = (int) this->random_uniform(0, powf(2, octave + this->initial_octave) * 2);
+                    this->steps_remaining[channel][octave] = (int) this->rng[channel].uniform(0, powf(2, octave + this->initial_octave) * 2);
                     if (this->steps_remaining[channel][octave] == 0)
                         this->steps_remaining[channel][octave] = 1;
 
@@ -16,6 +16,7 @@ RandomBrownian::RandomBrownian(NodeRef min, NodeRef max, NodeRef delta, NodeRef
 
 void RandomBrownian::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated);
 }
 
@@ -25,7 +26,7 @@ void RandomBrownian::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] += this->random_gaussian(0, this->delta->out[channel][0]);
+            this->value[channel] += this->rng[channel].gaussian(0, this->delta->out[channel][0]);
 
             if (this->value[channel] > this->max->out[channel][0])
                 this->value[channel] = this->max->out[channel][0] - (this->value[channel] - this->max->out[channel][0]);
@@ -49,7 +50,7 @@ void RandomBrownian::process(Buffer &out, int num_frames)
 
             if (clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] += this->random_gaussian(0, this->delta->out[channel][frame]);
+                this->value[channel] += this->rng[channel].gaussian(0, this->delta->out[channel][frame]);
                 if (this->value[channel] > this->max->out[channel][frame])
                     this->value[channel] = this->max->out[channel][frame] - (this->value[channel] - this->max->out[channel][frame]);
                 else if (this->value[channel] < this->min->out[channel][frame])
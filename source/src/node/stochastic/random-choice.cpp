@@ -15,6 +15,7 @@ RandomChoice::RandomChoice(std::vector<float> values, NodeRef clock, NodeRef res
 
 void RandomChoice::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::numeric_limits<float>::max());
 }
 
@@ -24,7 +25,7 @@ void RandomChoice::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            int index = (int) this->random_uniform(0, this->values.size());
+            int index = this->rng[channel].integer(this->values.size());
             this->value[channel] = this->values[index];
         }
     }
@@ -40,7 +41,7 @@ void RandomChoice::process(Buffer &out, int num_frames)
 
             if (clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                int index = (int) this->random_uniform(0, this->values.size());
+                int index = this->rng[channel].integer(this->values.size());
                 this->value[channel] = this->values[index];
             }
 
@@ -16,6 +16,7 @@ RandomCoin::RandomCoin(NodeRef probability, NodeRef clock, NodeRef reset)
 
 void RandomCoin::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::numeric_limits<float>::max());
 }
 
@@ -25,7 +26,7 @@ void RandomCoin::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] = this->random_uniform() < this->probability->out[channel][0];
+            this->value[channel] = this->rng[channel].uniform() < this->probability->out[channel][0];
         }
     }
     else
@@ -44,7 +45,7 @@ void RandomCoin::process(Buffer &out, int num_frames)
 
             if (this->value[channel] == std::numeric_limits<float>::max() || clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] = this->random_uniform() < this->probability->out[channel][frame];
+                this->value[channel] = this->rng[channel].uniform() < this->probability->out[channel][frame];
             }
 
             out[channel][frame] = this->value[channel];
@@ -15,6 +15,7 @@ RandomExponentialDist::RandomExponentialDist(NodeRef scale, NodeRef clock, NodeR
 
 void RandomExponentialDist::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated);
 }
 
@@ -24,7 +25,7 @@ void RandomExponentialDist::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] = this->random_exponential(this->scale->out[channel][0]);
+            this->value[channel] = this->rng[channel].exponential(this->scale->out[channel][0]);
         }
     }
     else
@@ -43,7 +44,7 @@ void RandomExponentialDist::process(Buffer &out, int num_frames)
 
             if (clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] = this->random_exponential(this->scale->out[channel][frame]);
+                this->value[channel] = this->rng[channel].exponential(this->scale->out[channel][frame]);
             }
 
             out[channel][frame] = this->value[channel];
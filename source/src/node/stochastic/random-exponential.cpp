@@ -17,6 +17,7 @@ RandomExponential::RandomExponential(NodeRef min, NodeRef max, NodeRef clock, No
 
 void RandomExponential::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::numeric_limits<float>::max());
 }
 
@@ -26,7 +27,7 @@ void RandomExponential::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] = signalflow_scale_lin_exp(this->random_uniform(0, 1), 0, 1, min->out[channel][0], this->max->out[channel][0]);
+            this->value[channel] = signalflow_scale_lin_exp(this->rng[channel].uniform(), 0, 1, min->out[channel][0], this->max->out[channel][0]);
         }
     }
     else
@@ -45,7 +46,7 @@ void RandomExponential::process(Buffer &out, int num_frames)
 
             if (this->value[channel] == std::numeric_limits<float>::max() || clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] = signalflow_scale_lin_exp(this->random_uniform(0, 1),
+                this->value[channel] = signalflow_scale_lin_exp(this->rng[channel].uniform(),
                                                                 0, 1, min->out[channel][frame], this->max->out[channel][frame]);
             }
 
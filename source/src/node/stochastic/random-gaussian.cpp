@@ -15,6 +15,7 @@ RandomGaussian::RandomGaussian(NodeRef mean, NodeRef sigma, NodeRef clock, NodeR
 
 void RandomGaussian::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated);
 }
 
@@ -24,7 +25,7 @@ void RandomGaussian::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] = this->random_gaussian(this->mean->out[channel][0],
+            this->value[channel] = this->rng[channel].gaussian(this->mean->out[channel][0],
                                                          this->sigma->out[channel][0]);
         }
     }
@@ -38,13 +39,28 @@ void RandomGaussian::process(Buffer &out, int num_frames)
 {
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
+        /*--------------------------------------------------------------------------------
+         * With no clock or reset, a new value is drawn every frame, so the
+         * block can be generated at once.
+         *--------------------------------------------------------------------------------*/
+        if (!this->clock && !this->reset)
+        {
+            this->rng[channel].fill_gaussian(out[channel], num_frames);
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                out[channel][frame] = this->mean->out[channel][frame] + this->sigma->out[channel][frame] * out[channel][frame];
+            }
+            this->value[channel] = out[channel][num_frames - 1];
+            continue;
+        }
+
         for (int frame = 0; frame < num_frames; frame++)
         {
             SIGNALFLOW_PROCESS_STOCHASTIC_NODE_RESET_TRIGGER()
 
             if (clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] = this->random_gaussian(this->mean->out[channel][frame],
+                this->value[channel] = this->rng[channel].gaussian(this->mean->out[channel][frame],
                                                              this->sigma->out[channel][frame]);
             }
 
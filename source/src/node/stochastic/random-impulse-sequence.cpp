@@ -1,5 +1,7 @@
 #include "signalflow/node/stochastic/random-impulse-sequence.h"
 
+#include <limits>
+
 namespace signalflow
 {
 
@@ -25,6 +27,7 @@ RandomImpulseSequence::RandomImpulseSequence(NodeRef probability, NodeRef length
 
 void RandomImpulseSequence::alloc()
 {
+    this->StochasticNode::alloc();
     this->position.resize(this->num_output_channels_allocated);
 }
 
@@ -42,7 +45,7 @@ void RandomImpulseSequence::trigger(std::string name, float value)
         // Regenerate whole sequence
         for (size_t i = 0; i < this->sequence.size(); i++)
         {
-            this->sequence[i] = this->random_uniform(0, 1) < this->probability->out[0][0];
+            this->sequence[i] = this->rng[0].uniform() < this->probability->out[0][0];
         }
     }
     else if (name == SIGNALFLOW_TRIGGER_EXPLORE)
@@ -51,9 +54,9 @@ void RandomImpulseSequence::trigger(std::string name, float value)
         {
             // Toggle with small probability
             // TODO: Incorporate PExplorer algorithms (shift, swap, etc)
-            if (this->random_uniform(0, 1) < 0.2)
+            if (this->rng[0].uniform() < 0.2)
             {
-                this->sequence[i] = this->random_uniform(0, 1) < this->probability->out[0][0];
+                this->sequence[i] = this->rng[0].uniform() < this->probability->out[0][0];
             }
         }
     }
@@ -69,7 +72,7 @@ void RandomImpulseSequence::process(Buffer &out, int num_frames)
     {
         for (size_t i = 0; i < this->sequence.size(); i++)
         {
-            this->sequence[i] = this->random_uniform(0, 1) < this->probability->out[0][0];
+            this->sequence[i] = this->rng[0].uniform() < this->probability->out[0][0];
         }
     }
     for (int channel = 0; channel < this->num_output_channels; channel++)
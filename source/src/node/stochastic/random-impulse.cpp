@@ -22,6 +22,7 @@ RandomImpulse::RandomImpulse(NodeRef frequency, signalflow_event_distribution_t
 
 void RandomImpulse::alloc()
 {
+    this->StochasticNode::alloc();
     this->steps_remaining.resize(this->num_output_channels_allocated);
 }
 
@@ -46,11 +47,11 @@ void RandomImpulse::process(Buffer &out, int num_frames)
                 {
                     if (this->distribution == SIGNALFLOW_EVENT_DISTRIBUTION_UNIFORM)
                     {
-                        this->steps_remaining[channel] = (int) this->random_uniform(0, this->graph->get_sample_rate() / (freq / 2.0));
+                        this->steps_remaining[channel] = (int) this->rng[channel].uniform(0, this->graph->get_sample_rate() / (freq / 2.0));
                     }
                     else if (this->distribution == SIGNALFLOW_EVENT_DISTRIBUTION_POISSON)
                     {
-                        this->steps_remaining[channel] = this->graph->get_sample_rate() * -logf(1.0 - this->random_uniform(0, 1)) / freq;
+                        this->steps_remaining[channel] = this->graph->get_sample_rate() * -logf(1.0 - this->rng[channel].uniform()) / freq;
                     }
                 }
                 this->steps_remaining[channel]--;
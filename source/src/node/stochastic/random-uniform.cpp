@@ -17,6 +17,7 @@ RandomUniform::RandomUniform(NodeRef min, NodeRef max, NodeRef clock, NodeRef re
 
 void RandomUniform::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::numeric_limits<float>::max());
 }
 
@@ -26,7 +27,7 @@ void RandomUniform::trigger(std::string name, float value)
     {
         for (int channel = 0; channel < this->num_output_channels_allocated; channel++)
         {
-            this->value[channel] = this->random_uniform(min->out[channel][0], this->max->out[channel][0]);
+            this->value[channel] = this->rng[channel].uniform(min->out[channel][0], this->max->out[channel][0]);
         }
     }
     else
@@ -39,6 +40,23 @@ void RandomUniform::process(Buffer &out, int num_frames)
 {
     for (int channel = 0; channel < this->num_output_channels; channel++)
     {
+        /*--------------------------------------------------------------------------------
+         * With no clock or reset, a new value is drawn every frame, so the
+         * block can be generated at once.
+         *--------------------------------------------------------------------------------*/
+        if (!this->clock && !this->reset)
+        {
+            this->rng[channel].fill_uniform(out[channel], num_frames);
+            for (int frame = 0; frame < num_frames; frame++)
+            {
+                float min = this->min->out[channel][frame];
+                float max = this->max->out[channel][frame];
+                out[channel][frame] = min + out[channel][frame] * (max - min);
+            }
+            this->value[channel] = out[channel][num_frames - 1];
+            continue;
+        }
+
         for (int frame = 0; frame < num_frames; frame++)
         {
             SIGNALFLOW_PROCESS_STOCHASTIC_NODE_RESET_TRIGGER()
@@ -51,7 +69,7 @@ void RandomUniform::process(Buffer &out, int num_frames)
              *--------------------------------------------------------------------------------*/
             if (this->value[channel] == std::numeric_limits<float>::max() || clock == nullptr || SIGNALFLOW_CHECK_CHANNEL_TRIGGER(clock, channel, frame))
             {
-                this->value[channel] = this->random_uniform(min->out[channel][frame], this->max->out[channel][frame]);
+                this->value[channel] = this->rng[channel].uniform(min->out[channel][frame], this->max->out[channel][frame]);
             }
 
             out[channel][frame] = this->value[channel];
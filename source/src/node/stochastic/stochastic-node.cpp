@@ -1,7 +1,7 @@
 #include "signalflow/node/stochastic/stochastic-node.h"
 
 #include "signalflow/core/graph.h"
-#include "signalflow/core/random.h"
+#include "signalflow/core/util.h"
 
 namespace signalflow
 {
@@ -11,34 +11,31 @@ StochasticNode::StochasticNode(NodeRef reset)
 {
     this->create_input("reset", this->reset);
     this->set_seed(signalflow_create_random_seed());
+    this->StochasticNode::alloc();
 }
 
-double StochasticNode::random_uniform(double from, double to)
+void StochasticNode::alloc()
 {
-    return std::uniform_real_distribution<double>(from, to)(this->rng);
-}
-
-double StochasticNode::random_gaussian(double mean, double sigma)
-{
-    return std::normal_distribution<double>(mean, sigma)(this->rng);
-}
-
-double StochasticNode::random_exponential(double lambda)
-{
-    return std::exponential_distribution<double>(lambda)(this->rng);
+    for (int channel = this->rng.size(); channel < MAX(this->num_output_channels_allocated, 1); channel++)
+    {
+        this->rng.push_back(RandomStream(this->seed, channel));
+    }
 }
 
 void StochasticNode::set_seed(unsigned long int seed)
 {
     this->seed = seed;
-    this->rng.seed(seed);
+    for (size_t channel = 0; channel < this->rng.size(); channel++)
+    {
+        this->rng[channel].seed(seed, channel);
+    }
 }
 
 void StochasticNode::trigger(std::string name, float value)
 {
     if (name == SIGNALFLOW_TRIGGER_RESET)
     {
-        this->rng.seed(this->seed);
+        this->set_seed(this->seed);
     }
     else
     {
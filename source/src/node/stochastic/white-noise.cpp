@@ -24,6 +24,7 @@ WhiteNoise::WhiteNoise(NodeRef frequency,
 
 void WhiteNoise::alloc()
 {
+    this->StochasticNode::alloc();
     this->value.resize(this->num_output_channels_allocated, std::numeric_limits<float>::max());
     this->steps_remaining.resize(this->num_output_channels_allocated);
     this->step_change.resize(this->num_output_channels_allocated);
@@ -40,6 +41,47 @@ void WhiteNoise::process(Buffer &out, int num_frames)
             this->value[channel] = this->min->out[0][0];
         }
 
+        /*------------------------------------------------------------------------
+         * With no frequency set and no reset input, a new value is drawn every
+         * frame, so the block can be generated at once. This draws the same
+         * values as the per-frame path below, including the interval draw
+         * when random_interval is set.
+         *-----------------------------------------------------------------------*/
+        bool per_frame = !this->reset && this->steps_remaining[channel] <= 0;
+        for (int frame = 0; per_frame && frame < num_frames; frame++)
+        {
+            per_frame = (this->frequency->out[channel][frame] == 0);
+        }
+        if (per_frame)
+        {
+            sample *min = this->min->out[channel];
+            sample *max = this->max->out[channel];
+            if (this->random_interval)
+            {
+                float draws[128];
+                for (int start = 0; start < num_frames; start += 64)
+                {
+                    int chunk = MIN(64, num_frames - start);
+                    this->rng[channel].fill_uniform(draws, chunk * 2);
+                    for (int frame = start; frame < start + chunk; frame++)
+                    {
+                        out[channel][frame] = min[frame] + draws[(frame - start) * 2] * (max[frame] - min[frame]);
+                    }
+                }
+            }
+            else
+            {
+                this->rng[channel].fill_uniform(out[channel], num_frames);
+                for (int frame = 0; frame < num_frames; frame++)
+                {
+                    out[channel][frame] = min[frame] + out[channel][frame] * (max[frame] - min[frame]);
+                }
+            }
+            this->value[channel] = out[channel][num_frames - 1];
+            this->steps_remaining[channel] = 0;
+            continue;
+        }
+
         for (int frame = 0; frame < num_frames; frame++)
         {
             SIGNALFLOW_PROCESS_STOCHASTIC_NODE_RESET_TRIGGER()
@@ -53,13 +95,13 @@ void WhiteNoise::process(Buffer &out, int num_frames)
             if (this->steps_remaining[channel] <= 0)
             {
                 // pick a new target value
-                float target = this->random_uniform(min, max);
+                float target = this->rng[channel].uniform(min, max);
 
                 if (frequency > 0)
                 {
                     if (random_interval)
                     {
-                        this->steps_remaining[channel] = (int) (this->random_uniform() * this->graph->get_sample_rate() / (frequency / 2.0));
+                        this->steps_remaining[channel] = (int) (this->rng[channel].uniform() * this->graph->get_sample_rate() / (frequency / 2.0));
                     }
                     else
                     {
@@ -1,4 +1,5 @@
 #include "signalflow/patch/patch-node-spec.h"
+#include "signalflow/patch/patch-spec.h"
 
 namespace signalflow
 {
@@ -26,6 +27,7 @@ int PatchNodeSpec::get_id()
 void PatchNodeSpec::set_id(int value)
 {
     this->id = value;
+    this->modified();
 }
 
 std::string PatchNodeSpec::get_name()
@@ -36,6 +38,7 @@ std::string PatchNodeSpec::get_name()
 void PatchNodeSpec::set_name(std::string name)
 {
     this->name = name;
+    this->modified();
 }
 
 bool PatchNodeSpec::get_is_constant()
@@ -52,23 +55,39 @@ void PatchNodeSpec::set_constant_value(float value)
 {
     this->value = value;
     this->is_constant = true;
+    this->modified();
 }
 
 void PatchNodeSpec::add_input(std::string name, PatchNodeSpec *def)
 {
     PatchNodeSpec *def_copy = new PatchNodeSpec();
     *def_copy = *def;
+    if (this->owner)
+    {
+        def_copy->set_owner(this->owner);
+    }
     this->inputs[name] = def_copy;
+    this->modified();
 }
 
 void PatchNodeSpec::add_input(std::string name, float value)
 {
-    this->inputs[name] = new PatchNodeSpec("constant", value);
+    PatchNodeSpec *constant = new PatchNodeSpec("constant", value);
+    constant->owner = this->owner;
+    this->inputs[name] = constant;
+    this->modified();
 }
 
 void PatchNodeSpec::add_buffer_input(std::string patch_input_name, std::string node_input_name)
 {
     this->buffer_inputs[patch_input_name] = node_input_name;
+    this->modified();
+}
+
+void PatchNodeSpec::set_property(std::string name, std::string value)
+{
+    this->properties[name] = value;
+    this->modified();
 }
 
 std::unordered_map<std::string, PatchNodeSpec *> PatchNodeSpec::get_inputs()
@@ -81,9 +100,15 @@ std::unordered_map<std::string, std::string> PatchNodeSpec::get_buffer_inputs()
     return this->buffer_inputs;
 }
 
+std::unordered_map<std::string, std::string> PatchNodeSpec::get_properties()
+{
+    return this->properties;
+}
+
 void PatchNodeSpec::set_input_name(std::string name)
 {
     this->input_name = name;
+    this->modified();
 }
 
 std::string PatchNodeSpec::get_input_name()
@@ -91,4 +116,29 @@ std::string PatchNodeSpec::get_input_name()
     return this->input_name;
 }
 
+void PatchNodeSpec::set_owner(PatchSpec *owner)
+{
+    /*----------------------------------------------------------------------------------
+     * Inputs may be shared between the copies made by add_input(), so stop
+     * at any that already have this owner.
+     *---------------------------------------------------------------------------------*/
+    if (this->owner == owner)
+    {
+        return;
+    }
+    this->owner = owner;
+    for (auto input : this->inputs)
+    {
+        input.second->set_owner(owner);
+    }
+}
+
+void PatchNodeSpec::modified()
+{
+    if (this->owner)
+    {
+        this->owner->node_spec_modified();
+    }
+}
+
 }
@@ -2,12 +2,15 @@
 
 #include "json11/json11.hpp"
 #include "signalflow/core/core.h"
+#include "signalflow/node/operators/expression.h"
 #include "signalflow/node/registry.h"
 #include "signalflow/patch/patch-registry.h"
 
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string.h>
 
 using namespace json11;
 
@@ -17,6 +20,7 @@ namespace signalflow
 PatchSpec::PatchSpec()
 {
     this->name = "Unnamed Patch";
+    this->revision = 0;
 }
 
 PatchSpec::PatchSpec(std::string filename)
@@ -25,29 +29,168 @@ PatchSpec::PatchSpec(std::string filename)
     this->load(filename);
 }
 
-void PatchSpec::load(std::string filename)
+/*----------------------------------------------------------------------------------
+ * Binary format. Integers are little-endian, and each string is a uint32
+ * length followed by its bytes.
+ *
+ *   "SFPS", uint32 version, string name, uint32 node count, nodes,
+ *   uint32 index of the output node
+ *
+ * Each node is a string name, int32 id, uint8 constant flag, float32
+ * constant value and string patch input name, followed by counted lists
+ * of properties (name, value), inputs (node input name, index of an
+ * earlier node) and buffer inputs (patch input name, node input name).
+ *---------------------------------------------------------------------------------*/
+static const std::string patch_spec_binary_magic = "SFPS";
+static const uint32_t patch_spec_binary_version = 1;
+
+static void patch_spec_write_uint32(std::string &data, uint32_t value)
+{
+    for (int byte = 0; byte < 4; byte++)
+    {
+        data.push_back((char) ((value >> (byte * 8)) & 0xFF));
+    }
+}
+
+static void patch_spec_write_float(std::string &data, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    patch_spec_write_uint32(data, bits);
+}
+
+static void patch_spec_write_string(std::string &data, const std::string &value)
+{
+    patch_spec_write_uint32(data, (uint32_t) value.size());
+    data += value;
+}
+
+static void patch_spec_check_length(const std::string &data, size_t offset, size_t length)
+{
+    if (length > data.size() || offset > data.size() - length)
+    {
+        throw std::runtime_error("Cannot parse binary PatchSpec (data is truncated)");
+    }
+}
+
+static uint32_t patch_spec_read_uint32(const std::string &data, size_t &offset)
+{
+    patch_spec_check_length(data, offset, 4);
+    uint32_t value = 0;
+    for (int byte = 0; byte < 4; byte++)
+    {
+        value |= ((uint32_t) (unsigned char) data[offset + byte]) << (byte * 8);
+    }
+    offset += 4;
+    return value;
+}
+
+static float patch_spec_read_float(const std::string &data, size_t &offset)
 {
-    std::string buf;
-    std::string line;
+    uint32_t bits = patch_spec_read_uint32(data, offset);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static std::string patch_spec_read_string(const std::string &data, size_t &offset)
+{
+    uint32_t length = patch_spec_read_uint32(data, offset);
+    patch_spec_check_length(data, offset, length);
+    std::string value = data.substr(offset, length);
+    offset += length;
+    return value;
+}
+
+/*----------------------------------------------------------------------------------
+ * Write `nodespec` to `records` after the nodes that feed it, and return
+ * its index. Nodespecs with an ID are written once. Inputs and properties
+ * are sorted by name, so that the same PatchSpec always produces the same
+ * data.
+ *---------------------------------------------------------------------------------*/
+static uint32_t patch_spec_write_node_spec(std::string &records,
+                                           uint32_t &num_records,
+                                           PatchNodeSpec *nodespec,
+                                           std::map<int, uint32_t> &indices)
+{
+    int id = nodespec->get_id();
+    if (id != -1 && indices.find(id) != indices.end())
+    {
+        return indices[id];
+    }
+
+    std::vector<std::pair<std::string, uint32_t>> inputs;
+    auto nodespec_inputs = nodespec->get_inputs();
+    for (auto input : std::map<std::string, PatchNodeSpec *>(nodespec_inputs.begin(), nodespec_inputs.end()))
+    {
+        uint32_t input_index = patch_spec_write_node_spec(records, num_records, input.second, indices);
+        inputs.push_back(std::make_pair(input.first, input_index));
+    }
+
+    patch_spec_write_string(records, nodespec->get_name());
+    patch_spec_write_uint32(records, (uint32_t) id);
+    records.push_back((char) (nodespec->get_is_constant() ? 1 : 0));
+    patch_spec_write_float(records, nodespec->get_constant_value());
+    patch_spec_write_string(records, nodespec->get_input_name());
+
+    auto nodespec_properties = nodespec->get_properties();
+    std::map<std::string, std::string> properties(nodespec_properties.begin(), nodespec_properties.end());
+    patch_spec_write_uint32(records, (uint32_t) properties.size());
+    for (auto property : properties)
+    {
+        patch_spec_write_string(records, property.first);
+        patch_spec_write_string(records, property.second);
+    }
+
+    patch_spec_write_uint32(records, (uint32_t) inputs.size());
+    for (auto input : inputs)
+    {
+        patch_spec_write_string(records, input.first);
+        patch_spec_write_uint32(records, input.second);
+    }
+
+    auto nodespec_buffer_inputs = nodespec->get_buffer_inputs();
+    std::map<std::string, std::string> buffer_inputs(nodespec_buffer_inputs.begin(), nodespec_buffer_inputs.end());
+    patch_spec_write_uint32(records, (uint32_t) buffer_inputs.size());
+    for (auto buffer_input : buffer_inputs)
+    {
+        patch_spec_write_string(records, buffer_input.first);
+        patch_spec_write_string(records, buffer_input.second);
+    }
+
+    uint32_t index = num_records++;
+    if (id != -1)
+    {
+        indices[id] = index;
+    }
+    return index;
+}
 
-    std::ifstream input(filename);
+void PatchSpec::load(std::string filename)
+{
+    std::ifstream input(filename, std::ios::binary);
     if (!input.good())
     {
         /*--------------------------------------------------------------------------------
          * If absolute pathname couldn't be found, search in user's patches directory
          * (~/.signalflow/patches)
          *--------------------------------------------------------------------------------*/
-        input.open(SIGNALFLOW_USER_DIR + "/patches/" + filename);
+        input.open(SIGNALFLOW_USER_DIR + "/patches/" + filename, std::ios::binary);
         if (!input.good())
         {
             throw std::runtime_error("Couldn't read from patch file: " + filename);
         }
     }
-    while (std::getline(input, line))
+
+    std::string buf((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (buf.compare(0, patch_spec_binary_magic.size(), patch_spec_binary_magic) == 0)
     {
-        buf += line + "\n";
+        this->from_binary(buf);
+    }
+    else
+    {
+        this->from_json(buf);
     }
-    this->from_json(buf);
 }
 
 void PatchSpec::save(std::string filename)
@@ -58,6 +201,118 @@ void PatchSpec::save(std::string filename)
     output.close();
 }
 
+void PatchSpec::save_binary(std::string filename)
+{
+    std::ofstream output(filename, std::ios::binary);
+    if (!output.good())
+    {
+        throw std::runtime_error("Couldn't write to patch file: " + filename);
+    }
+    std::string buf = this->to_binary();
+    output.write(buf.data(), buf.size());
+    output.close();
+}
+
+std::string PatchSpec::to_binary()
+{
+    if (!this->output)
+    {
+        throw std::runtime_error("PatchSpec " + this->name + ": output is not set");
+    }
+
+    /*--------------------------------------------------------------------------------
+     * Nodes are written from the output, so that each follows its inputs,
+     * and then any nodes that are not connected to the output.
+     *--------------------------------------------------------------------------------*/
+    std::string records;
+    uint32_t num_records = 0;
+    std::map<int, uint32_t> indices;
+    uint32_t output_index = patch_spec_write_node_spec(records, num_records, this->output, indices);
+    for (auto pair : this->nodespecs)
+    {
+        patch_spec_write_node_spec(records, num_records, pair.second, indices);
+    }
+
+    std::string data = patch_spec_binary_magic;
+    patch_spec_write_uint32(data, patch_spec_binary_version);
+    patch_spec_write_string(data, this->name);
+    patch_spec_write_uint32(data, num_records);
+    data += records;
+    patch_spec_write_uint32(data, output_index);
+    return data;
+}
+
+void PatchSpec::from_binary(std::string data)
+{
+    if (data.compare(0, patch_spec_binary_magic.size(), patch_spec_binary_magic) != 0)
+    {
+        throw std::runtime_error("Cannot parse binary PatchSpec (invalid header)");
+    }
+    size_t offset = patch_spec_binary_magic.size();
+    uint32_t version = patch_spec_read_uint32(data, offset);
+    if (version != patch_spec_binary_version)
+    {
+        throw std::runtime_error("Cannot parse binary PatchSpec (unsupported version " + std::to_string(version) + ")");
+    }
+
+    this->name = patch_spec_read_string(data, offset);
+
+    uint32_t num_records = patch_spec_read_uint32(data, offset);
+    std::vector<PatchNodeSpec *> records;
+    for (uint32_t index = 0; index < num_records; index++)
+    {
+        PatchNodeSpec *nodespec = new PatchNodeSpec(patch_spec_read_string(data, offset));
+        nodespec->set_id((int) patch_spec_read_uint32(data, offset));
+        patch_spec_check_length(data, offset, 1);
+        bool is_constant = data[offset++] != 0;
+        float value = patch_spec_read_float(data, offset);
+        if (is_constant)
+        {
+            nodespec->set_constant_value(value);
+        }
+        nodespec->set_input_name(patch_spec_read_string(data, offset));
+
+        uint32_t num_properties = patch_spec_read_uint32(data, offset);
+        for (uint32_t property_index = 0; property_index < num_properties; property_index++)
+        {
+            std::string property_name = patch_spec_read_string(data, offset);
+            nodespec->set_property(property_name, patch_spec_read_string(data, offset));
+        }
+
+        uint32_t num_inputs = patch_spec_read_uint32(data, offset);
+        for (uint32_t input_index = 0; input_index < num_inputs; input_index++)
+        {
+            std::string input_name = patch_spec_read_string(data, offset);
+            uint32_t source_index = patch_spec_read_uint32(data, offset);
+            if (source_index >= records.size())
+            {
+                throw std::runtime_error("Cannot parse binary PatchSpec (node " + std::to_string(index) + " has an invalid input)");
+            }
+            nodespec->add_input(input_name, records[source_index]);
+        }
+
+        uint32_t num_buffer_inputs = patch_spec_read_uint32(data, offset);
+        for (uint32_t buffer_input_index = 0; buffer_input_index < num_buffer_inputs; buffer_input_index++)
+        {
+            std::string patch_input_name = patch_spec_read_string(data, offset);
+            nodespec->add_buffer_input(patch_input_name, patch_spec_read_string(data, offset));
+        }
+
+        records.push_back(nodespec);
+        if (nodespec->get_id() != -1)
+        {
+            this->add_node_spec(nodespec);
+        }
+    }
+
+    uint32_t output_index = patch_spec_read_uint32(data, offset);
+    if (output_index >= records.size())
+    {
+        throw std::runtime_error("Cannot parse binary PatchSpec (no output specified)");
+    }
+    this->set_output(records[output_index]);
+}
+
 void PatchSpec::from_json(std::string buf)
 {
     std::string err;
@@ -92,6 +347,11 @@ void PatchSpec::from_json(std::string buf)
         {
             is_output = true;
         }
+        for (auto property : node_obj["properties"].object_items())
+        {
+            nodespec->set_property(property.first, property.second.string_value());
+        }
+
         auto inputs = node_obj["inputs"];
 
         for (auto input_pair : inputs.object_items())
@@ -223,6 +483,15 @@ std::string PatchSpec::to_json()
         {
             object["inputs"] = inputs;
         }
+        if (spec->get_properties().size() > 0)
+        {
+            Json::object properties;
+            for (auto property : spec->get_properties())
+            {
+                properties[property.first] = property.second;
+            }
+            object["properties"] = properties;
+        }
         nodes.push_back(object);
     }
 
@@ -246,6 +515,8 @@ void PatchSpec::store()
 void PatchSpec::add_node_spec(PatchNodeSpec *spec)
 {
     this->nodespecs[spec->get_id()] = spec;
+    spec->set_owner(this);
+    this->node_spec_modified();
 }
 
 PatchNodeSpec *PatchSpec::get_node_spec(int id)
@@ -256,6 +527,38 @@ PatchNodeSpec *PatchSpec::get_node_spec(int id)
 void PatchSpec::set_output(PatchNodeSpec *spec)
 {
     this->output = spec;
+    if (spec)
+    {
+        spec->set_owner(this);
+    }
+    this->node_spec_modified();
+}
+
+PatchTemplateRef PatchSpec::get_template()
+{
+    /*----------------------------------------------------------------------------------
+     * Patches may be created from the same PatchSpec on several threads.
+     * If two compile the template at once, both results are equivalent, and
+     * whichever is stored last is kept. The template is recompiled if the
+     * PatchSpec or its nodespecs have been modified since it was compiled.
+     *---------------------------------------------------------------------------------*/
+    PatchTemplateRef patch_template = std::atomic_load(&this->patch_template);
+    if (!patch_template || patch_template->get_revision() != this->revision.load())
+    {
+        patch_template = std::make_shared<PatchTemplate>(this);
+        std::atomic_store(&this->patch_template, patch_template);
+    }
+    return patch_template;
+}
+
+unsigned long PatchSpec::get_revision()
+{
+    return this->revision.load();
+}
+
+void PatchSpec::node_spec_modified()
+{
+    this->revision++;
 }
 
 std::string PatchSpec::get_name()
@@ -273,6 +576,161 @@ PatchNodeSpec *PatchSpec::get_root()
     return this->output;
 }
 
+/*----------------------------------------------------------------------------------
+ * Returns true if the node performs an elementwise operation that can be
+ * folded or fused, populating its operation and operand input names.
+ *---------------------------------------------------------------------------------*/
+static bool patch_spec_is_fusable(PatchNodeSpec *nodespec,
+                                  signalflow_expression_op_t &op,
+                                  std::vector<std::string> &input_names)
+{
+    if (!nodespec->get_input_name().empty() || !nodespec->get_buffer_inputs().empty())
+    {
+        return false;
+    }
+    if (!ExpressionTree::get_node_operation(nodespec->get_name(), op, input_names))
+    {
+        return false;
+    }
+    auto inputs = nodespec->get_inputs();
+    for (auto input_name : input_names)
+    {
+        if (inputs.find(input_name) == inputs.end())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------------
+ * Build the expression computed by a fusable node and its fusable inputs.
+ * Any other input becomes an input of the expression, and is appended to
+ * `leaves`.
+ *---------------------------------------------------------------------------------*/
+static ExpressionTree patch_spec_create_expression(PatchNodeSpec *nodespec, std::vector<PatchNodeSpec *> &leaves)
+{
+    signalflow_expression_op_t op;
+    std::vector<std::string> input_names;
+    if (patch_spec_is_fusable(nodespec, op, input_names))
+    {
+        auto inputs = nodespec->get_inputs();
+        std::vector<ExpressionTree> operands;
+        for (auto input_name : input_names)
+        {
+            operands.push_back(patch_spec_create_expression(inputs[input_name], leaves));
+        }
+        return ExpressionTree(op, operands);
+    }
+
+    if (nodespec->get_is_constant() && nodespec->get_input_name().empty())
+    {
+        return ExpressionTree(nodespec->get_constant_value());
+    }
+
+    leaves.push_back(nodespec);
+    return ExpressionTree::input((int) leaves.size() - 1);
+}
+
+void PatchSpec::optimise()
+{
+    if (!this->output)
+    {
+        throw std::runtime_error("PatchSpec " + this->name + ": output is not set");
+    }
+
+    /*----------------------------------------------------------------------------------
+     * The optimised graph is built afresh from the output, so that nodes
+     * which are not connected to it are dropped. IDs are reassigned from the
+     * output downwards, as they are by Patch::create_spec().
+     *---------------------------------------------------------------------------------*/
+    PatchNodeSpec *output = this->output;
+    this->nodespecs.clear();
+    this->last_id = 0;
+    this->set_output(this->_optimise_node_spec(output));
+}
+
+PatchNodeSpec *PatchSpec::_create_node_spec(std::string name)
+{
+    PatchNodeSpec *nodespec = new PatchNodeSpec(name);
+    nodespec->set_id(this->last_id++);
+    this->add_node_spec(nodespec);
+    return nodespec;
+}
+
+PatchNodeSpec *PatchSpec::_optimise_node_spec(PatchNodeSpec *source)
+{
+    PatchNodeSpec *nodespec;
+    signalflow_expression_op_t op;
+    std::vector<std::string> input_names;
+
+    if (patch_spec_is_fusable(source, op, input_names))
+    {
+        std::vector<PatchNodeSpec *> leaves;
+        ExpressionTree tree = patch_spec_create_expression(source, leaves);
+
+        if (tree.is_constant())
+        {
+            nodespec = this->_create_node_spec("constant");
+            nodespec->set_constant_value(tree.get_value());
+        }
+        else if (tree.get_num_operations() == 1)
+        {
+            /*----------------------------------------------------------------------------------
+             * A single operator is faster as the original node, which is
+             * specialised for its operation. Its inputs may still have been
+             * folded to constants.
+             *---------------------------------------------------------------------------------*/
+            nodespec = this->_create_node_spec(source->get_name());
+            for (size_t index = 0; index < input_names.size(); index++)
+            {
+                const ExpressionTree &operand = tree.get_operands()[index];
+                if (operand.is_constant())
+                {
+                    PatchNodeSpec *constant = this->_create_node_spec("constant");
+                    constant->set_constant_value(operand.get_value());
+                    nodespec->add_input(input_names[index], constant);
+                }
+                else
+                {
+                    nodespec->add_input(input_names[index], this->_optimise_node_spec(leaves[operand.get_input_index()]));
+                }
+            }
+        }
+        else
+        {
+            nodespec = this->_create_node_spec("expression");
+            nodespec->set_property("expression", tree.to_string());
+            for (size_t index = 0; index < leaves.size(); index++)
+            {
+                nodespec->add_input("input" + std::to_string(index), this->_optimise_node_spec(leaves[index]));
+            }
+        }
+        return nodespec;
+    }
+
+    nodespec = this->_create_node_spec(source->get_name());
+    if (source->get_is_constant())
+    {
+        nodespec->set_constant_value(source->get_constant_value());
+    }
+    nodespec->set_input_name(source->get_input_name());
+    for (auto property : source->get_properties())
+    {
+        nodespec->set_property(property.first, property.second);
+    }
+    for (auto buffer_input : source->get_buffer_inputs())
+    {
+        nodespec->add_buffer_input(buffer_input.first, buffer_input.second);
+    }
+    for (auto input : source->get_inputs())
+    {
+        nodespec->add_input(input.first, this->_optimise_node_spec(input.second));
+    }
+
+    return nodespec;
+}
+
 void PatchSpec::print()
 {
     std::cout << "PatchSpec " << this->name << " (" << this->nodespecs.size() << " nodes)" << std::endl;
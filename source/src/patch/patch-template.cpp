@@ -0,0 +1,100 @@
+#include "signalflow/patch/patch-template.h"
+
+#include "signalflow/node/registry.h"
+#include "signalflow/patch/patch-node-spec.h"
+#include "signalflow/patch/patch-spec.h"
+
+#include <map>
+#include <stdexcept>
+
+namespace signalflow
+{
+
+/*----------------------------------------------------------------------------------
+ * Append `nodespec` to the template after the nodes that feed it, and
+ * return its index. Nodespecs with an ID are added once; those without
+ * (constants created by PatchNodeSpec::add_input) are added wherever they
+ * are used.
+ *---------------------------------------------------------------------------------*/
+static int patch_template_add_node_spec(PatchTemplate &patch_template,
+                                        PatchNodeSpec *nodespec,
+                                        std::map<int, int> &indices)
+{
+    int id = nodespec->get_id();
+    if (id != -1)
+    {
+        auto existing = indices.find(id);
+        if (existing != indices.end())
+        {
+            return existing->second;
+        }
+    }
+
+    PatchTemplateNode node;
+    node.name = nodespec->get_name();
+    node.constructor = NodeRegistry::global()->get_constructor(node.name);
+    node.is_constant = nodespec->get_is_constant();
+    node.value = nodespec->get_constant_value();
+    node.input_name = nodespec->get_input_name();
+
+    for (auto property : nodespec->get_properties())
+    {
+        node.properties.push_back(property);
+    }
+    for (auto input : nodespec->get_inputs())
+    {
+        int input_index = patch_template_add_node_spec(patch_template, input.second, indices);
+        node.inputs.push_back(std::make_pair(input.first, input_index));
+    }
+    for (auto buffer_input : nodespec->get_buffer_inputs())
+    {
+        node.buffer_inputs.push_back(buffer_input);
+    }
+
+    int index = patch_template.add_node(node);
+    if (id != -1)
+    {
+        indices[id] = index;
+    }
+    return index;
+}
+
+PatchTemplate::PatchTemplate()
+{
+}
+
+PatchTemplate::PatchTemplate(PatchSpec *spec)
+{
+    /*----------------------------------------------------------------------------------
+     * Read the revision before compiling, so that an edit made during
+     * compilation still marks the template as outdated.
+     *---------------------------------------------------------------------------------*/
+    this->revision = spec->get_revision();
+
+    PatchNodeSpec *output = spec->get_root();
+    if (!output)
+    {
+        throw std::runtime_error("PatchSpec " + spec->get_name() + ": output is not set");
+    }
+
+    std::map<int, int> indices;
+    patch_template_add_node_spec(*this, output, indices);
+}
+
+int PatchTemplate::add_node(PatchTemplateNode node)
+{
+    this->nodes.push_back(node);
+    return (int) this->nodes.size() - 1;
+}
+
+const std::vector<PatchTemplateNode> &PatchTemplate::get_nodes() const
+{
+    return this->nodes;
+}
+
+unsigned long PatchTemplate::get_revision() const
+{
+    return this->revision;
+}
+
+}
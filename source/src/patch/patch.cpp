@@ -10,28 +10,27 @@
 #include "signalflow/node/operators/multiply.h"
 #include "signalflow/node/operators/subtract.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
 namespace signalflow
 {
 
-extern AudioGraph *shared_graph;
-
 Patch::Patch()
 {
-    this->graph = shared_graph;
+    this->graph = AudioGraph::get_current();
     this->auto_free = false;
     this->auto_free_node = nullptr;
     this->trigger_node = nullptr;
+    this->state = SIGNALFLOW_PATCH_STATE_ACTIVE;
+    this->has_queued_inputs = false;
 }
 
 Patch::Patch(PatchSpecRef patchspec)
     : Patch()
 {
-    PatchNodeSpec *nodespec = patchspec->get_root();
-    this->output = this->instantiate(nodespec);
-    this->parsed = true;
+    this->instantiate(*patchspec->get_template());
 }
 
 Patch::Patch(PatchSpecRef patchspec, std::unordered_map<std::string, NodeRef> inputs)
@@ -46,13 +45,18 @@ Patch::Patch(PatchSpecRef patchspec, std::unordered_map<std::string, NodeRef> in
 }
 
 Patch::Patch(PatchRef patch)
-    : Patch(patch->create_spec())
+    : Patch()
 {
+    this->instantiate(*patch->create_template());
 }
 
 Patch::Patch(PatchRef patch, std::unordered_map<std::string, NodeRef> inputs)
-    : Patch(patch->create_spec(), inputs)
+    : Patch(patch)
 {
+    for (auto input : inputs)
+    {
+        this->set_input(input.first, input.second);
+    }
 }
 
 Patch::Patch(std::string name)
@@ -61,13 +65,47 @@ Patch::Patch(std::string name)
     PatchSpecRef patchspec = PatchRegistry::global()->get(name);
     if (patchspec)
     {
-        PatchNodeSpec *nodespec = patchspec->get_root();
-        this->output = this->instantiate(nodespec);
+        this->instantiate(*patchspec->get_template());
+    }
+}
+
+/*------------------------------------------------------------------------
+ * Remove a node prepared for, or replaced in, a patch input's binding
+ * from the outputs of the bound node, unless the binding now holds it.
+ *-----------------------------------------------------------------------*/
+static void remove_queued_output(const NodeRef &node, Node *target, int slot)
+{
+    if (node && target->get_input(slot) != node)
+    {
+        node->remove_output(target, slot);
     }
 }
 
 Patch::~Patch()
 {
+    /*------------------------------------------------------------------------
+     * has_queued_inputs is only cleared by the rendering thread once it has
+     * finished applying this Patch's inputs, but may be cleared while this
+     * check is made, so the graph checks it again under its lock.
+     *-----------------------------------------------------------------------*/
+    if (this->graph && this->has_queued_inputs)
+    {
+        this->graph->cancel_patch_inputs(this);
+    }
+
+    /*------------------------------------------------------------------------
+     * Inputs that were never applied were still prepared, so are removed
+     * from the outputs that were added for them.
+     *-----------------------------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(this->queued_inputs_mutex);
+    this->_release_queued_inputs();
+    for (auto &input : this->queued_inputs)
+    {
+        for (auto &binding : input.bindings)
+        {
+            remove_queued_output(input.node, binding.first, binding.second);
+        }
+    }
 }
 
 signalflow_patch_state_t Patch::get_state()
@@ -80,70 +118,92 @@ void Patch::set_state(signalflow_patch_state_t state)
     this->state = state;
 }
 
-NodeRef Patch::instantiate(PatchNodeSpec *nodespec)
+void Patch::instantiate(const PatchTemplate &patch_template)
 {
     /*------------------------------------------------------------------------
-     * Recursively instantiate the subgraph specified in PatchNodeSpec.
-     * Does not currently support graphs that route one node to multiple
-     * inputs.
+     * Template nodes follow the nodes that feed them, so each node's inputs
+     * have already been created when it is reached.
      *-----------------------------------------------------------------------*/
-    NodeRegistry *registry = NodeRegistry::global();
-    NodeRef noderef;
+    const std::vector<PatchTemplateNode> &template_nodes = patch_template.get_nodes();
+    std::vector<NodeRef> noderefs(template_nodes.size());
 
-    if (!nodespec->get_input_name().empty() && this->inputs[nodespec->get_input_name()])
-    {
-        noderef = this->inputs[nodespec->get_input_name()];
-    }
-    else
+    for (size_t index = 0; index < template_nodes.size(); index++)
     {
-        Node *node = registry->create(nodespec->get_name());
-        noderef = NodeRef(node);
+        const PatchTemplateNode &template_node = template_nodes[index];
+
+        if (!template_node.input_name.empty())
+        {
+            auto existing = this->inputs.find(template_node.input_name);
+            if (existing != this->inputs.end() && existing->second)
+            {
+                noderefs[index] = existing->second;
+                continue;
+            }
+        }
+
+        NodeRef noderef = NodeRef(template_node.constructor());
+        noderefs[index] = noderef;
 
         /*------------------------------------------------------------------------
          * Update the patch's internal collection of node refs.
          *-----------------------------------------------------------------------*/
         this->nodes.insert(noderef);
 
-        for (auto input : nodespec->get_inputs())
+        for (auto property : template_node.properties)
         {
-            std::string input_name = input.first;
-            NodeRef input_node = this->instantiate(input.second);
-            noderef->set_input(input_name, input_node);
+            noderef->set_property(property.first, PropertyRef(property.second));
         }
 
-        if (nodespec->get_is_constant())
+        for (auto input : template_node.inputs)
         {
-            Constant *constant = (Constant *) node;
-            constant->value = nodespec->get_constant_value();
+            noderef->set_input(input.first, noderefs[input.second]);
+
+            const std::string &patch_input_name = template_nodes[input.second].input_name;
+            if (!patch_input_name.empty())
+            {
+                int slot = noderef->get_input_index(input.first);
+                this->input_bindings[patch_input_name].push_back(std::make_pair(noderef.get(), slot));
+            }
+        }
+
+        if (template_node.is_constant)
+        {
+            Constant *constant = (Constant *) noderef.get();
+            constant->value = template_node.value;
         }
 
-        if (!nodespec->get_input_name().empty())
+        if (!template_node.input_name.empty())
         {
-            this->inputs[nodespec->get_input_name()] = noderef;
+            this->inputs[template_node.input_name] = noderef;
         }
 
-        for (auto buffer_input : nodespec->get_buffer_inputs())
+        for (auto buffer_input : template_node.buffer_inputs)
         {
-            std::string patch_input_name = buffer_input.first;
-            std::string node_input_name = buffer_input.second;
             BufferRef placeholder = new Buffer();
-            noderef->set_buffer(node_input_name, placeholder);
-            this->buffer_inputs[patch_input_name] = placeholder;
+            noderef->set_buffer(buffer_input.second, placeholder);
+            this->buffer_inputs[buffer_input.first] = placeholder;
+            this->buffer_input_bindings[buffer_input.first].push_back(std::make_pair(noderef.get(), buffer_input.second));
         }
 
         noderef->set_patch(this);
     }
 
-    return noderef;
+    if (!noderefs.empty())
+    {
+        this->output = noderefs.back();
+    }
+    this->parsed = true;
+    this->has_bindings = true;
 }
 
 void Patch::set_input(std::string name, float value)
 {
-    if (this->inputs[name] == nullptr)
+    auto input = this->inputs.find(name);
+    if (input == this->inputs.end() || input->second == nullptr)
     {
         throw std::runtime_error("Patch has no such parameter: " + name);
     }
-    NodeRef current = this->inputs[name];
+    NodeRef current = input->second;
     if (current->name == "constant")
     {
         Constant *current_constant = (Constant *) current.get();
@@ -158,53 +218,289 @@ void Patch::set_input(std::string name, float value)
 void Patch::set_input(std::string name, NodeRef value)
 {
     /*------------------------------------------------------------------------
-     * Replace a named input with another node.
-     * Iterate over this patch's nodes, replacing the prior input with
-     * the new node. (Inefficient, should be rethought.)
+     * Replace a named input with another node, in every node input that it
+     * is bound to.
      *-----------------------------------------------------------------------*/
-    if (this->inputs[name] == nullptr)
+    auto input = this->inputs.find(name);
+    if (input == this->inputs.end() || input->second == nullptr)
     {
         throw std::runtime_error("Patch has no such parameter: " + name);
     }
-    NodeRef current = this->inputs[name];
-    bool found_input = false;
-    for (NodeRef node : this->nodes)
+    if (!this->has_bindings)
     {
-        for (auto param : node->inputs)
-        {
-            if ((param.second)->get() == current.get())
-            {
-                // Update routing
-                node->set_input(param.first, value);
-                found_input = true;
-            }
-        }
+        this->_create_bindings();
     }
-    if (!found_input)
+
+    auto bindings = this->input_bindings.find(name);
+    if (bindings == this->input_bindings.end())
     {
         throw std::runtime_error("Couldn't find input: " + name);
     }
-    this->inputs[name] = value;
+    for (auto &binding : bindings->second)
+    {
+        binding.first->set_input(binding.second, value);
+    }
+    input->second = value;
 }
 
 void Patch::set_input(std::string name, BufferRef value)
 {
-    if (this->buffer_inputs[name] == nullptr)
+    auto buffer_input = this->buffer_inputs.find(name);
+    if (buffer_input == this->buffer_inputs.end() || buffer_input->second == nullptr)
     {
         throw std::runtime_error("Patch has no such buffer parameter: " + name);
     }
-    BufferRef current = this->buffer_inputs[name];
+    if (!this->has_bindings)
+    {
+        this->_create_bindings();
+    }
+
+    auto bindings = this->buffer_input_bindings.find(name);
+    if (bindings != this->buffer_input_bindings.end())
+    {
+        for (auto &binding : bindings->second)
+        {
+            binding.first->set_buffer(binding.second, value);
+        }
+    }
+    buffer_input->second = value;
+}
+
+void Patch::_create_bindings()
+{
+    /*------------------------------------------------------------------------
+     * Find the node inputs that each patch input is connected to.
+     *-----------------------------------------------------------------------*/
+    std::unordered_map<Node *, std::string> input_names;
+    for (auto input : this->inputs)
+    {
+        if (input.second)
+        {
+            input_names[input.second.get()] = input.first;
+        }
+    }
+    std::unordered_map<Buffer *, std::string> buffer_input_names;
+    for (auto buffer_input : this->buffer_inputs)
+    {
+        if (buffer_input.second)
+        {
+            buffer_input_names[buffer_input.second.get()] = buffer_input.first;
+        }
+    }
+
+    this->input_bindings.clear();
+    this->buffer_input_bindings.clear();
     for (NodeRef node : this->nodes)
     {
+        for (size_t slot = 0; slot < node->input_slots.size(); slot++)
+        {
+            auto input_name = input_names.find(node->input_slots[slot]->get());
+            if (input_name != input_names.end())
+            {
+                this->input_bindings[input_name->second].push_back(std::make_pair(node.get(), (int) slot));
+            }
+        }
         for (auto param : node->buffers)
         {
-            if ((param.second)->get() == current.get())
+            auto buffer_input_name = buffer_input_names.find(param.second->get());
+            if (buffer_input_name != buffer_input_names.end())
             {
-                // Update routing
-                node->set_buffer(param.first, value);
+                this->buffer_input_bindings[buffer_input_name->second].push_back(std::make_pair(node.get(), param.first));
             }
         }
     }
+    this->has_bindings = true;
+}
+
+void Patch::queue_input(std::string name, float value)
+{
+    QueuedInput input;
+    input.name = name;
+    input.value = value;
+    this->_queue_input(input);
+}
+
+void Patch::queue_input(std::string name, NodeRef value)
+{
+    QueuedInput input;
+    input.name = name;
+    input.node = value;
+    this->_queue_input(input);
+}
+
+void Patch::queue_input(std::string name, BufferRef value)
+{
+    QueuedInput input;
+    input.name = name;
+    input.buffer = value;
+    this->_queue_input(input);
+}
+
+void Patch::_queue_input(QueuedInput input)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queued_inputs_mutex);
+        this->_release_queued_inputs();
+
+        /*------------------------------------------------------------------------
+         * Check and prepare the input now, so that an error is reported to
+         * the caller rather than on the audio thread, and so that applying
+         * it does not allocate. This is done under the lock, as the audio
+         * thread changes the Patch's inputs as it applies queued inputs.
+         *-----------------------------------------------------------------------*/
+        if (input.buffer)
+        {
+            auto buffer_input = this->buffer_inputs.find(input.name);
+            if (buffer_input == this->buffer_inputs.end() || buffer_input->second == nullptr)
+            {
+                throw std::runtime_error("Patch has no such buffer parameter: " + input.name);
+            }
+            if (!this->has_bindings)
+            {
+                this->_create_bindings();
+            }
+
+            auto bindings = this->buffer_input_bindings.find(input.name);
+            if (bindings != this->buffer_input_bindings.end())
+            {
+                input.buffer_bindings = bindings->second;
+            }
+        }
+        else
+        {
+            auto current = this->inputs.find(input.name);
+            if (current == this->inputs.end() || current->second == nullptr)
+            {
+                throw std::runtime_error("Patch has no such parameter: " + input.name);
+            }
+            if (!this->has_bindings)
+            {
+                this->_create_bindings();
+            }
+
+            if (!input.node)
+            {
+                /*------------------------------------------------------------------------
+                 * A value sets the Constant that the input will hold once the
+                 * inputs queued before it are applied. If it will not hold a
+                 * Constant, a new Constant is queued in its place.
+                 *-----------------------------------------------------------------------*/
+                NodeRef pending = current->second;
+                for (auto &queued_input : this->queued_inputs)
+                {
+                    if (queued_input.name == input.name && queued_input.node)
+                    {
+                        pending = queued_input.node;
+                    }
+                }
+                if (pending->name != "constant")
+                {
+                    AudioGraphContext context(this->graph);
+                    input.node = new Constant(input.value);
+                }
+            }
+
+            if (input.node)
+            {
+                auto bindings = this->input_bindings.find(input.name);
+                if (bindings == this->input_bindings.end())
+                {
+                    throw std::runtime_error("Couldn't find input: " + input.name);
+                }
+                try
+                {
+                    for (auto &binding : bindings->second)
+                    {
+                        binding.first->prepare_input(binding.second, input.node);
+                        input.bindings.push_back(binding);
+                    }
+                }
+                catch (...)
+                {
+                    for (auto &binding : input.bindings)
+                    {
+                        remove_queued_output(input.node, binding.first, binding.second);
+                    }
+                    throw;
+                }
+                input.replaced_nodes.resize(input.bindings.size());
+            }
+        }
+
+        this->queued_inputs.push_back(input);
+        if (!this->graph)
+        {
+            this->_apply_queued_inputs();
+            this->_release_queued_inputs();
+        }
+    }
+
+    if (this->graph)
+    {
+        this->graph->schedule_patch_inputs(this);
+    }
+}
+
+bool Patch::apply_queued_inputs()
+{
+    std::unique_lock<std::mutex> lock(this->queued_inputs_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return false;
+    }
+    this->_apply_queued_inputs();
+    return true;
+}
+
+void Patch::_apply_queued_inputs()
+{
+    for (auto &input : this->queued_inputs)
+    {
+        /*------------------------------------------------------------------------
+         * Keep the nodes or buffer that are replaced in the queued input, so
+         * that they are released with it rather than on this thread.
+         *-----------------------------------------------------------------------*/
+        if (input.node)
+        {
+            for (size_t index = 0; index < input.bindings.size(); index++)
+            {
+                auto &binding = input.bindings[index];
+                binding.first->apply_input(binding.second, input.node, input.replaced_nodes[index]);
+            }
+            this->inputs.find(input.name)->second.swap(input.node);
+        }
+        else if (input.buffer)
+        {
+            for (auto &binding : input.buffer_bindings)
+            {
+                binding.first->set_buffer(binding.second, input.buffer);
+            }
+            this->buffer_inputs.find(input.name)->second.swap(input.buffer);
+        }
+        else
+        {
+            NodeRef &current = this->inputs.find(input.name)->second;
+            if (current->name == "constant")
+            {
+                Constant *current_constant = (Constant *) current.get();
+                current_constant->value = input.value;
+            }
+        }
+    }
+    this->inputs_to_release.splice(this->inputs_to_release.end(), this->queued_inputs);
+}
+
+void Patch::_release_queued_inputs()
+{
+    for (auto &input : this->inputs_to_release)
+    {
+        for (size_t index = 0; index < input.replaced_nodes.size(); index++)
+        {
+            auto &binding = input.bindings[index];
+            remove_queued_output(input.replaced_nodes[index], binding.first, binding.second);
+        }
+    }
+    this->inputs_to_release.clear();
 }
 
 void Patch::disconnect()
@@ -245,16 +541,28 @@ NodeRef Patch::get_trigger_node()
 
 void Patch::node_state_changed(Node *node)
 {
-    if (node->get_state() == SIGNALFLOW_NODE_STATE_STOPPED && this->auto_free)
+    if (node->get_state() == SIGNALFLOW_NODE_STATE_STOPPED)
     {
         if (this->auto_free_node == nullptr || this->auto_free_node.get() == node)
         {
             this->set_state(SIGNALFLOW_PATCH_STATE_STOPPED);
-            this->disconnect();
+            if (this->auto_free)
+            {
+                this->disconnect();
+            }
         }
     }
 }
 
+void Patch::reset()
+{
+    for (NodeRef node : this->nodes)
+    {
+        node->trigger(SIGNALFLOW_TRIGGER_RESET);
+    }
+    this->set_state(SIGNALFLOW_PATCH_STATE_ACTIVE);
+}
+
 void Patch::trigger()
 {
     if (this->trigger_node == nullptr)
@@ -273,6 +581,7 @@ NodeRef Patch::add_input(std::string name, sample default_value)
     NodeRef placeholder(default_value);
     this->inputs[name] = placeholder;
     nodes.insert(placeholder);
+    this->has_bindings = false;
     return placeholder;
 }
 
@@ -280,6 +589,7 @@ BufferRef Patch::add_buffer_input(std::string name)
 {
     BufferRef placeholder = new Buffer();
     this->buffer_inputs[name] = placeholder;
+    this->has_bindings = false;
     return placeholder;
 }
 
@@ -313,6 +623,7 @@ NodeRef Patch::add_node(NodeRef node)
 {
     nodes.insert(node);
     node->patch = this;
+    this->has_bindings = false;
     return node;
 }
 void Patch::set_output(NodeRef out)
@@ -358,8 +669,12 @@ PatchSpecRef Patch::create_spec()
 
     PatchSpecRef spec = new PatchSpec();
     spec->set_name(this->name);
-    spec->output = this->_create_spec_from_node(root);
-    spec->nodespecs = this->nodespecs;
+    std::unordered_map<Node *, PatchNodeSpec *> created_nodespecs;
+    spec->set_output(this->_create_spec_from_node(root, created_nodespecs));
+    for (auto nodespec : this->nodespecs)
+    {
+        spec->add_node_spec(nodespec.second);
+    }
 
     for (auto node : nodes)
     {
@@ -372,11 +687,118 @@ PatchSpecRef Patch::create_spec()
     return spec;
 }
 
+/*----------------------------------------------------------------------------
+ * Append `node` to the template after the nodes that feed it, and return
+ * its index. As in create_spec(), only string properties are copied.
+ *----------------------------------------------------------------------------*/
+static int patch_add_node_to_template(PatchTemplate &patch_template,
+                                      const NodeRef &node,
+                                      std::unordered_map<Node *, int> &indices,
+                                      const std::unordered_map<Node *, std::string> &input_names,
+                                      const std::unordered_map<Buffer *, std::string> &buffer_input_names)
+{
+    auto existing = indices.find(node.get());
+    if (existing != indices.end())
+    {
+        return existing->second;
+    }
+
+    PatchTemplateNode template_node;
+    template_node.name = node->name;
+    template_node.constructor = NodeRegistry::global()->get_constructor(node->name);
+
+    if (node->name == "constant")
+    {
+        Constant *constant = (Constant *) node.get();
+        template_node.is_constant = true;
+        template_node.value = constant->value;
+    }
+    else
+    {
+        for (size_t slot = 0; slot < node->input_slots.size(); slot++)
+        {
+            NodeRef input_node = *(node->input_slots[slot]);
+            if (input_node)
+            {
+                int input_index = patch_add_node_to_template(patch_template, input_node, indices, input_names, buffer_input_names);
+                template_node.inputs.push_back(std::make_pair(node->input_names[slot], input_index));
+            }
+        }
+
+        for (auto property : node->properties)
+        {
+            StringProperty *string_property = dynamic_cast<StringProperty *>(property.second->get());
+            if (string_property)
+            {
+                template_node.properties.push_back(std::make_pair(property.first, string_property->string_value()));
+            }
+        }
+
+        for (auto buffer : node->buffers)
+        {
+            auto buffer_input_name = buffer_input_names.find(buffer.second->get());
+            if (buffer_input_name != buffer_input_names.end())
+            {
+                template_node.buffer_inputs.push_back(std::make_pair(buffer_input_name->second, buffer.first));
+            }
+        }
+    }
+
+    auto input_name = input_names.find(node.get());
+    if (input_name != input_names.end())
+    {
+        template_node.input_name = input_name->second;
+    }
+
+    int index = patch_template.add_node(template_node);
+    indices[node.get()] = index;
+    return index;
+}
+
+PatchTemplateRef Patch::create_template()
+{
+    if (this->output == nullptr)
+    {
+        throw std::runtime_error("Patch " + this->name + ": output is not set");
+    }
+
+    std::unordered_map<Node *, std::string> input_names;
+    for (auto input : this->inputs)
+    {
+        if (input.second)
+        {
+            input_names[input.second.get()] = input.first;
+        }
+    }
+    std::unordered_map<Buffer *, std::string> buffer_input_names;
+    for (auto buffer_input : this->buffer_inputs)
+    {
+        if (buffer_input.second)
+        {
+            buffer_input_names[buffer_input.second.get()] = buffer_input.first;
+        }
+    }
+
+    PatchTemplateRef patch_template = std::make_shared<PatchTemplate>();
+    std::unordered_map<Node *, int> indices;
+    patch_add_node_to_template(*patch_template, this->output, indices, input_names, buffer_input_names);
+
+    for (auto node : nodes)
+    {
+        if (indices.find(node.get()) == indices.end())
+        {
+            throw std::runtime_error("Patch contains unconnected node (" + node->name + ").");
+        }
+    }
+
+    return patch_template;
+}
+
 void Patch::_iterate_from_node(const NodeRef &node)
 {
-    for (auto input : node->inputs)
+    for (NodeRef *input : node->input_slots)
     {
-        NodeRef input_node = *(input.second);
+        NodeRef input_node = *input;
         if (input_node)
         {
             if (nodes.find(input_node) == nodes.end())
@@ -392,8 +814,19 @@ void Patch::_iterate_from_node(const NodeRef &node)
     }
 }
 
-PatchNodeSpec *Patch::_create_spec_from_node(const NodeRef &node)
+PatchNodeSpec *Patch::_create_spec_from_node(const NodeRef &node,
+                                             std::unordered_map<Node *, PatchNodeSpec *> &created_nodespecs)
 {
+    /*------------------------------------------------------------------------
+     * A node that feeds more than one input keeps a single spec (and ID),
+     * so that it remains shared in Patches created from the spec.
+     *-----------------------------------------------------------------------*/
+    auto existing = created_nodespecs.find(node.get());
+    if (existing != created_nodespecs.end())
+    {
+        return existing->second;
+    }
+
     PatchNodeSpec *nodespec = new PatchNodeSpec(node->name);
     nodespec->set_id(this->last_id++);
 
@@ -404,13 +837,22 @@ PatchNodeSpec *Patch::_create_spec_from_node(const NodeRef &node)
     }
     else
     {
-        for (auto input : node->inputs)
+        for (size_t slot = 0; slot < node->input_slots.size(); slot++)
         {
-            NodeRef input_node = *(input.second);
+            NodeRef input_node = *(node->input_slots[slot]);
             if (input_node)
             {
-                PatchNodeSpec *input_spec = this->_create_spec_from_node(input_node);
-                nodespec->add_input(input.first, input_spec);
+                PatchNodeSpec *input_spec = this->_create_spec_from_node(input_node, created_nodespecs);
+                nodespec->add_input(node->input_names[slot], input_spec);
+            }
+        }
+
+        for (auto property : node->properties)
+        {
+            StringProperty *string_property = dynamic_cast<StringProperty *>(property.second->get());
+            if (string_property)
+            {
+                nodespec->set_property(property.first, string_property->string_value());
             }
         }
 
@@ -433,10 +875,186 @@ PatchNodeSpec *Patch::_create_spec_from_node(const NodeRef &node)
 
     this->nodespecs[nodespec->get_id()] = nodespec;
     this->parsed_nodes.insert(node);
+    created_nodespecs[node.get()] = nodespec;
 
     return this->nodespecs[nodespec->get_id()];
 }
 
+/*------------------------------------------------------------------------
+ * OPTIMISATION
+ *-----------------------------------------------------------------------*/
+
+static void patch_collect_nodes(const NodeRef &node, std::set<NodeRef> &nodes)
+{
+    if (!node || nodes.find(node) != nodes.end())
+    {
+        return;
+    }
+    nodes.insert(node);
+    for (NodeRef *input : node->input_slots)
+    {
+        patch_collect_nodes(*input, nodes);
+    }
+}
+
+void Patch::optimise()
+{
+    if (this->output == nullptr)
+    {
+        throw std::runtime_error("Patch " + this->name + ": output is not set");
+    }
+
+    std::set<NodeRef> previous_nodes;
+    patch_collect_nodes(this->output, previous_nodes);
+    previous_nodes.insert(this->nodes.begin(), this->nodes.end());
+
+    std::map<Node *, NodeRef> optimised;
+    this->output = this->_optimise_node(this->output, optimised);
+
+    std::set<NodeRef> current_nodes;
+    patch_collect_nodes(this->output, current_nodes);
+
+    /*------------------------------------------------------------------------
+     * Nodes that have been fused or removed are detached from their inputs,
+     * which would otherwise still list them as outputs.
+     *-----------------------------------------------------------------------*/
+    for (NodeRef node : previous_nodes)
+    {
+        if (current_nodes.find(node) == current_nodes.end())
+        {
+            for (size_t slot = 0; slot < node->input_slots.size(); slot++)
+            {
+                NodeRef input_node = *(node->input_slots[slot]);
+                if (input_node)
+                {
+                    input_node->remove_output(node.get(), (int) slot);
+                }
+            }
+        }
+    }
+
+    this->nodes.clear();
+    for (NodeRef node : current_nodes)
+    {
+        this->add_node(node);
+    }
+    this->parsed = true;
+}
+
+bool Patch::_is_fusable(const NodeRef &node, signalflow_expression_op_t &op, std::vector<std::string> &input_names)
+{
+    if (node == this->trigger_node || node == this->auto_free_node || !this->_get_input_name(node).empty())
+    {
+        return false;
+    }
+    if (!ExpressionTree::get_node_operation(node->name, op, input_names))
+    {
+        return false;
+    }
+    for (auto input_name : input_names)
+    {
+        int slot = node->get_input_index(input_name);
+        if (slot < 0 || !node->get_input(slot))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ExpressionTree Patch::_create_expression(const NodeRef &node, std::vector<NodeRef> &leaves, bool is_root)
+{
+    signalflow_expression_op_t op;
+    std::vector<std::string> input_names;
+    if ((is_root || node->outputs.size() == 1) && this->_is_fusable(node, op, input_names))
+    {
+        std::vector<ExpressionTree> operands;
+        for (auto input_name : input_names)
+        {
+            operands.push_back(this->_create_expression(node->get_input(input_name), leaves, false));
+        }
+        return ExpressionTree(op, operands);
+    }
+
+    if (node->name == "constant" && this->_get_input_name(node).empty())
+    {
+        return ExpressionTree(node->get_value());
+    }
+
+    auto leaf = std::find(leaves.begin(), leaves.end(), node);
+    if (leaf != leaves.end())
+    {
+        return ExpressionTree::input((int) (leaf - leaves.begin()));
+    }
+    leaves.push_back(node);
+    return ExpressionTree::input((int) leaves.size() - 1);
+}
+
+NodeRef Patch::_optimise_node(const NodeRef &node, std::map<Node *, NodeRef> &optimised)
+{
+    auto previous = optimised.find(node.get());
+    if (previous != optimised.end())
+    {
+        return previous->second;
+    }
+
+    signalflow_expression_op_t op;
+    std::vector<std::string> input_names;
+    if (this->_is_fusable(node, op, input_names))
+    {
+        std::vector<NodeRef> leaves;
+        ExpressionTree tree = this->_create_expression(node, leaves, true);
+        NodeRef result;
+
+        if (tree.is_constant())
+        {
+            result = new Constant(tree.get_value());
+        }
+        else if (tree.get_num_operations() > 1)
+        {
+            for (NodeRef &leaf : leaves)
+            {
+                leaf = this->_optimise_node(leaf, optimised);
+            }
+            result = new Expression(tree, leaves);
+        }
+
+        if (result)
+        {
+            optimised[node.get()] = result;
+            return result;
+        }
+
+        /*------------------------------------------------------------------------
+         * A single operator is kept, replacing any inputs that have been
+         * folded to constants.
+         *-----------------------------------------------------------------------*/
+        for (size_t index = 0; index < input_names.size(); index++)
+        {
+            const ExpressionTree &operand = tree.get_operands()[index];
+            if (operand.is_constant() && node->get_input(input_names[index])->name != "constant")
+            {
+                node->set_input(input_names[index], new Constant(operand.get_value()));
+            }
+        }
+    }
+
+    optimised[node.get()] = node;
+    for (size_t slot = 0; slot < node->input_slots.size(); slot++)
+    {
+        NodeRef input_node = *(node->input_slots[slot]);
+        if (input_node)
+        {
+            NodeRef replacement = this->_optimise_node(input_node, optimised);
+            if (replacement != input_node)
+            {
+                node->set_input((int) slot, replacement);
+            }
+        }
+    }
+    return node;
+}
+
 template <class T>
 NodeRef PatchRefTemplate<T>::operator*(NodeRef other)
 {
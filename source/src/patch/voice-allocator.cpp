@@ -0,0 +1,286 @@
+#include "signalflow/patch/voice-allocator.h"
+
+#include "signalflow/core/graph.h"
+
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+namespace signalflow
+{
+
+VoiceAllocator::VoiceAllocator(PatchSpecRef patchspec, int num_voices, signalflow_voice_steal_policy_t steal_policy)
+    : steal_policy(steal_policy), note_counter(0)
+{
+    SIGNALFLOW_CHECK_GRAPH();
+
+    this->name = "voice-allocator";
+    this->skips_inputs = true;
+
+    if (!patchspec)
+    {
+        return;
+    }
+
+    if (num_voices < 1)
+    {
+        throw std::runtime_error("VoiceAllocator must have at least one voice");
+    }
+
+    /*------------------------------------------------------------------------
+     * Instantiate every voice up-front, and cache references to the inputs
+     * that are set per-note, so that note_on does not need to look them up.
+     * Voices are not resized after this point, as each voice's output is
+     * connected as one of this node's inputs, in the slot of its index.
+     *-----------------------------------------------------------------------*/
+    this->voices = std::vector<Voice>(num_voices);
+    for (int index = 0; index < num_voices; index++)
+    {
+        Voice &voice = this->voices[index];
+        voice.patch = new Patch(patchspec);
+        if (!voice.patch->output)
+        {
+            throw std::runtime_error("VoiceAllocator: Patch does not have an output");
+        }
+        voice.output = voice.patch->output;
+        voice.note_input = this->get_constant_input(voice.patch, "note");
+        voice.frequency_input = this->get_constant_input(voice.patch, "frequency");
+        voice.velocity_input = this->get_constant_input(voice.patch, "velocity");
+        voice.gate_input = this->get_constant_input(voice.patch, "gate");
+        voice.serial_input = new Constant(0);
+        this->create_input("voice" + std::to_string(index), voice.output);
+    }
+}
+
+NodeRef VoiceAllocator::get_constant_input(PatchRef patch, std::string name)
+{
+    auto input = patch->inputs.find(name);
+    if (input != patch->inputs.end() && input->second && input->second->is_constant)
+    {
+        return input->second;
+    }
+    return nullptr;
+}
+
+void VoiceAllocator::set_voice_value(Voice &voice, NodeRef input, float value)
+{
+    if (input)
+    {
+        this->graph->schedule_set_value(input, 0.0, value);
+    }
+}
+
+int VoiceAllocator::find_voice(int note)
+{
+    int index = -1;
+
+    /*------------------------------------------------------------------------
+     * Same-note retriggering takes priority over idle voices, so that
+     * repeated notes don't stack up.
+     *-----------------------------------------------------------------------*/
+    if (this->steal_policy == SIGNALFLOW_VOICE_STEAL_SAME_NOTE)
+    {
+        for (size_t i = 0; i < this->voices.size(); i++)
+        {
+            if (this->voices[i].is_active() && this->voices[i].note == note)
+            {
+                return i;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < this->voices.size(); i++)
+    {
+        if (!this->voices[i].is_active())
+        {
+            return i;
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * All voices are in use. Prefer to steal a voice that has already been
+     * released, falling back on all active voices if there are none.
+     *-----------------------------------------------------------------------*/
+    bool any_released = false;
+    for (auto &voice : this->voices)
+    {
+        any_released = any_released || voice.released;
+    }
+
+    for (size_t i = 0; i < this->voices.size(); i++)
+    {
+        Voice &voice = this->voices[i];
+        if (any_released && !voice.released)
+        {
+            continue;
+        }
+        if (index == -1)
+        {
+            index = i;
+        }
+        else if (this->steal_policy == SIGNALFLOW_VOICE_STEAL_QUIETEST)
+        {
+            if (voice.peak < this->voices[index].peak)
+                index = i;
+        }
+        else
+        {
+            if (voice.age < this->voices[index].age)
+                index = i;
+        }
+    }
+
+    return index;
+}
+
+int VoiceAllocator::note_on(int note, float velocity)
+{
+    if (this->voices.empty())
+    {
+        throw std::runtime_error("VoiceAllocator has no voices");
+    }
+
+    int index = this->find_voice(note);
+    Voice &voice = this->voices[index];
+
+    /*------------------------------------------------------------------------
+     * The voice is reset and its inputs set by the audio thread, at the start
+     * of the next block, in the order that the events are scheduled.
+     * Serial numbers are kept within the range that a float represents
+     * exactly, and are never 0, which is the serial of a voice that has
+     * not yet played.
+     *-----------------------------------------------------------------------*/
+    voice.serial = (voice.serial % (1 << 24)) + 1;
+    this->graph->schedule_patch_reset(voice.patch, 0.0);
+    this->set_voice_value(voice, voice.note_input, note);
+    this->set_voice_value(voice, voice.frequency_input, signalflow_midi_note_to_frequency(note));
+    this->set_voice_value(voice, voice.velocity_input, velocity);
+    this->set_voice_value(voice, voice.gate_input, 1.0);
+    this->set_voice_value(voice, voice.serial_input, voice.serial);
+
+    voice.note = note;
+    voice.released = false;
+    voice.age = ++this->note_counter;
+
+    /*------------------------------------------------------------------------
+     * Don't allow a voice to be stolen as the quietest before it has
+     * rendered its first block.
+     *-----------------------------------------------------------------------*/
+    voice.peak = std::numeric_limits<float>::max();
+
+    return index;
+}
+
+void VoiceAllocator::note_off(int note)
+{
+    for (auto &voice : this->voices)
+    {
+        if (voice.is_active() && !voice.released && voice.note == note)
+        {
+            this->set_voice_value(voice, voice.gate_input, 0.0);
+            voice.released = true;
+        }
+    }
+}
+
+void VoiceAllocator::all_notes_off()
+{
+    for (auto &voice : this->voices)
+    {
+        if (voice.is_active() && !voice.released)
+        {
+            this->set_voice_value(voice, voice.gate_input, 0.0);
+            voice.released = true;
+        }
+    }
+}
+
+int VoiceAllocator::get_num_voices()
+{
+    return this->voices.size();
+}
+
+int VoiceAllocator::get_num_active_voices()
+{
+    int count = 0;
+    for (auto &voice : this->voices)
+    {
+        if (voice.is_active())
+            count++;
+    }
+    return count;
+}
+
+PatchRef VoiceAllocator::get_voice(int index)
+{
+    if (index < 0 || index >= (int) this->voices.size())
+    {
+        throw std::runtime_error("Invalid voice index: " + std::to_string(index));
+    }
+    return this->voices[index].patch;
+}
+
+signalflow_voice_steal_policy_t VoiceAllocator::get_steal_policy()
+{
+    return this->steal_policy;
+}
+
+void VoiceAllocator::set_steal_policy(signalflow_voice_steal_policy_t steal_policy)
+{
+    this->steal_policy = steal_policy;
+}
+
+bool VoiceAllocator::skip_input(int index)
+{
+    return this->voices[index].is_idle();
+}
+
+void VoiceAllocator::process(Buffer &out, int num_frames)
+{
+    for (int channel = 0; channel < this->num_output_channels; channel++)
+    {
+        memset(out[channel], 0, num_frames * sizeof(sample));
+    }
+
+    bool is_silent = true;
+    for (auto &voice : this->voices)
+    {
+        /*------------------------------------------------------------------------
+         * Idle voices are not mixed into the output.
+         *-----------------------------------------------------------------------*/
+        if (voice.is_idle())
+        {
+            continue;
+        }
+
+        /*------------------------------------------------------------------------
+         * A voice whose output is flagged as silent contributes nothing.
+         * Otherwise, its output has already been upmixed to this node's
+         * input channel count.
+         *-----------------------------------------------------------------------*/
+        float peak = 0.0;
+        if (!voice.output->get_is_silent())
+        {
+            is_silent = false;
+            for (int channel = 0; channel < this->num_output_channels; channel++)
+            {
+                sample *voice_out = voice.output->out[channel];
+                for (int frame = 0; frame < num_frames; frame++)
+                {
+                    out[channel][frame] += voice_out[frame];
+                    peak = MAX(peak, fabsf(voice_out[frame]));
+                }
+            }
+        }
+        voice.peak = peak;
+
+        if (voice.patch->get_state() == SIGNALFLOW_PATCH_STATE_STOPPED)
+        {
+            voice.serial_stopped = (unsigned long) ((Constant *) voice.serial_input.get())->value;
+        }
+    }
+
+    this->is_silent = is_silent;
+}
+
+}
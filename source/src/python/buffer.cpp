@@ -10,7 +10,7 @@ void init_python_buffer(py::module &m)
          * Constructors
          *-------------------------------------------------------------------------------*/
         .def(py::init<>())
-        .def(py::init<std::string>())
+        .def(py::init<std::string>(), py::call_guard<py::gil_scoped_release>())
         .def(py::init<int, int>(), R"pbdoc(
             Init
             ----
@@ -71,8 +71,8 @@ void init_python_buffer(py::module &m)
         .def("fill", [](Buffer &buf, float sample) { buf.fill(sample); })
         .def("fill", [](Buffer &buf, const std::function<float(float)> f) { buf.fill(f); })
         .def("split", &Buffer::split)
-        .def("load", &Buffer::load)
-        .def("save", &Buffer::save);
+        .def("load", &Buffer::load, py::call_guard<py::gil_scoped_release>())
+        .def("save", &Buffer::save, py::call_guard<py::gil_scoped_release>());
 
     py::class_<Buffer2D, Buffer, BufferRefTemplate<Buffer2D>>(m, "Buffer2D")
         .def(py::init<std::vector<BufferRef>>())
@@ -85,4 +85,11 @@ void init_python_buffer(py::module &m)
         .def(py::init<int>())
         .def(py::init<std::string>())
         .def(py::init<std::string, int>());
+
+    py::class_<WavetableBuffer, Buffer, BufferRefTemplate<WavetableBuffer>>(m, "WavetableBuffer")
+        .def(py::init<BufferRef>())
+        .def(py::init<std::vector<float>>())
+        .def(py::init<std::string>())
+        .def(py::init<std::string, int>())
+        .def_property_readonly("num_levels", &WavetableBuffer::get_num_levels);
 }
@@ -11,5 +11,6 @@ void init_python_config(py::module &m)
         .def_property("input_buffer_size", &AudioGraphConfig::get_input_buffer_size, &AudioGraphConfig::set_input_buffer_size)
         .def_property("output_buffer_size", &AudioGraphConfig::get_output_buffer_size, &AudioGraphConfig::set_output_buffer_size)
         .def_property("input_device_name", &AudioGraphConfig::get_input_device_name, &AudioGraphConfig::set_input_device_name)
-        .def_property("output_device_name", &AudioGraphConfig::get_output_device_name, &AudioGraphConfig::set_output_device_name);
+        .def_property("output_device_name", &AudioGraphConfig::get_output_device_name, &AudioGraphConfig::set_output_device_name)
+        .def_property("flush_denormals", &AudioGraphConfig::get_flush_denormals, &AudioGraphConfig::set_flush_denormals);
 }
@@ -21,6 +21,11 @@ void init_python_constants(py::module &m)
         .value("SIGNALFLOW_NODE_STATE_STOPPED", SIGNALFLOW_NODE_STATE_STOPPED, "Stopped")
         .export_values();
 
+    py::enum_<signalflow_input_rate_t>(m, "signalflow_input_rate_t", py::arithmetic(), "signalflow_input_rate_t")
+        .value("SIGNALFLOW_INPUT_RATE_AUDIO", SIGNALFLOW_INPUT_RATE_AUDIO, "Audio rate")
+        .value("SIGNALFLOW_INPUT_RATE_CONTROL", SIGNALFLOW_INPUT_RATE_CONTROL, "Control rate")
+        .export_values();
+
     m.attr("SIGNALFLOW_MAX_CHANNELS") = SIGNALFLOW_MAX_CHANNELS;
     m.attr("SIGNALFLOW_DEFAULT_FFT_SIZE") = SIGNALFLOW_DEFAULT_FFT_SIZE;
     m.attr("SIGNALFLOW_MAX_FFT_SIZE") = SIGNALFLOW_MAX_FFT_SIZE;
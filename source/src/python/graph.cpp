@@ -1,7 +1,77 @@
 #include "signalflow/python/python.h"
 
+/*--------------------------------------------------------------------------------
+ * Render a block of the graph's output into planar memory, with channel `c` at
+ * `data + c * stride`. Must be called with the GIL released.
+ *-------------------------------------------------------------------------------*/
+static void render_block_to_memory(AudioGraph &graph, float *data, int num_channels, int num_frames, int stride)
+{
+    graph.render(num_frames);
+    NodeRef output = graph.get_output();
+    for (int channel = 0; channel < num_channels; channel++)
+    {
+        memcpy(data + channel * stride, output->out[channel], num_frames * sizeof(float));
+    }
+}
+
+/*--------------------------------------------------------------------------------
+ * Iterator returned by AudioGraph.stream(), which renders each block into the
+ * same preallocated array. Declared in an anonymous namespace, as pybind11
+ * types have hidden visibility.
+ *-------------------------------------------------------------------------------*/
+namespace
+{
+class AudioGraphStream
+{
+public:
+    AudioGraphStream(AudioGraph *graph, int block_size, int num_blocks)
+        : graph(graph), block_size(block_size), num_blocks(num_blocks), block_index(0)
+    {
+        if (block_size < 1 || block_size > graph->get_output()->get_output_buffer_length())
+        {
+            throw std::runtime_error("AudioGraph: Invalid block size (" + std::to_string(block_size) + ")");
+        }
+        int num_channels = graph->get_output()->get_num_input_channels();
+        this->block = py::array_t<float>({ num_channels, block_size });
+    }
+
+    py::array_t<float> next()
+    {
+        if (this->num_blocks > 0 && this->block_index >= this->num_blocks)
+        {
+            throw py::stop_iteration();
+        }
+
+        float *data = this->block.mutable_data();
+        int num_channels = (int) this->block.shape(0);
+        {
+            py::gil_scoped_release release;
+            render_block_to_memory(*this->graph, data, num_channels, this->block_size, this->block_size);
+        }
+        this->block_index++;
+        return this->block;
+    }
+
+private:
+    AudioGraph *graph;
+    int block_size;
+    int num_blocks;
+    int block_index;
+    py::array_t<float> block;
+};
+
+/*--------------------------------------------------------------------------------
+ * Contexts entered with `with graph:`, which are exited in reverse order.
+ *-------------------------------------------------------------------------------*/
+thread_local std::vector<std::unique_ptr<AudioGraphContext>> graph_contexts;
+}
+
 void init_python_graph(py::module &m)
 {
+    py::class_<AudioGraphStream>(m, "AudioGraphStream")
+        .def("__iter__", [](AudioGraphStream &stream) -> AudioGraphStream & { return stream; })
+        .def("__next__", &AudioGraphStream::next);
+
     /*--------------------------------------------------------------------------------
      * Graph
      *-------------------------------------------------------------------------------*/
@@ -18,6 +88,7 @@ void init_python_graph(py::module &m)
         .def_property("sample_rate", &AudioGraph::get_sample_rate, &AudioGraph::set_sample_rate)
         .def_property_readonly("node_count", &AudioGraph::get_node_count)
         .def_property_readonly("cpu_usage", &AudioGraph::get_cpu_usage)
+        .def_property_readonly("time", &AudioGraph::get_time)
         .def_property_readonly("output", &AudioGraph::get_output)
         .def_property_readonly("outputs", &AudioGraph::get_outputs)
         .def_property_readonly("status", &AudioGraph::get_status)
@@ -26,14 +97,80 @@ void init_python_graph(py::module &m)
         /*--------------------------------------------------------------------------------
          * Methods
          *-------------------------------------------------------------------------------*/
+        .def_static("get_current", &AudioGraph::get_current, py::return_value_policy::reference, R"pbdoc(
+            Returns the graph that new nodes, patches and buffers created on this thread are bound to.
+        )pbdoc")
+        .def("make_current", &AudioGraph::make_current, R"pbdoc(
+            Bind nodes, patches and buffers subsequently created on this thread to this graph.
+        )pbdoc")
+        .def("__enter__", [](AudioGraph &graph) -> AudioGraph & {
+            graph_contexts.emplace_back(new AudioGraphContext(&graph));
+            return graph;
+        }, py::return_value_policy::reference)
+        .def("__exit__", [](AudioGraph &graph, py::args args) {
+            if (!graph_contexts.empty())
+            {
+                graph_contexts.pop_back();
+            }
+        })
+
         .def("start", &AudioGraph::start)
         .def("stop", [](AudioGraph &graph) { graph.stop(); })
         .def("clear", &AudioGraph::clear)
 
         .def("show_structure", [](AudioGraph &graph) { graph.show_structure(); })
         .def("show_status", &AudioGraph::show_status)
-        .def("render", [](AudioGraph &graph, int num_frames) { graph.render(num_frames); })
-        .def("render_to_buffer", [](AudioGraph &graph, BufferRef buffer) { graph.render_to_buffer(buffer); })
+        .def("render", [](AudioGraph &graph, int num_frames) { graph.render(num_frames); }, py::call_guard<py::gil_scoped_release>())
+        .def("render_to_buffer", [](AudioGraph &graph, BufferRef buffer) { graph.render_to_buffer(buffer); }, py::call_guard<py::gil_scoped_release>())
+        .def("schedule_trigger", &AudioGraph::schedule_trigger, "node"_a, "time"_a, "name"_a = SIGNALFLOW_DEFAULT_TRIGGER, "value"_a = 1.0, R"pbdoc(
+            Trigger a node at the given time on the graph's clock, in seconds, accurate to the sample.
+        )pbdoc")
+        .def("schedule_set_input", &AudioGraph::schedule_set_input, "node"_a, "time"_a, "name"_a, "value"_a, R"pbdoc(
+            Set a node's input to a value at the given time on the graph's clock, in seconds, accurate to the sample.
+            The input must currently be set to a fixed value, rather than to another node.
+        )pbdoc")
+        .def(
+            "render_to_array", [](AudioGraph &graph, py::array array, int block_size) {
+                /*--------------------------------------------------------------------------------
+                 * The array is written in-place, so must not be converted to a copy.
+                 *-------------------------------------------------------------------------------*/
+                if (!py::array_t<float, py::array::c_style>::check_(array) || !array.writeable() || array.ndim() != 2)
+                {
+                    throw std::runtime_error("AudioGraph: render_to_array requires a writeable, C-contiguous float32 array of [channels, frames]");
+                }
+                int num_channels = (int) array.shape(0);
+                int num_frames = (int) array.shape(1);
+                if (num_channels > graph.get_output()->get_num_input_channels())
+                {
+                    throw std::runtime_error("Array cannot have more channels than the audio graph (" + std::to_string(num_channels) + " != " + std::to_string(graph.get_output()->get_num_input_channels()) + ")");
+                }
+                if (block_size < 1 || block_size > graph.get_output()->get_output_buffer_length())
+                {
+                    throw std::runtime_error("AudioGraph: Invalid block size (" + std::to_string(block_size) + ")");
+                }
+                float *data = (float *) array.mutable_data();
+
+                py::gil_scoped_release release;
+                for (int frame = 0; frame < num_frames; frame += block_size)
+                {
+                    int block_frames = MIN(block_size, num_frames - frame);
+                    render_block_to_memory(graph, data + frame, num_channels, block_frames, num_frames);
+                }
+            },
+            "array"_a, "block_size"_a = SIGNALFLOW_DEFAULT_BLOCK_SIZE, R"pbdoc(
+            Render the graph's output into a [channels, frames] float32 array, in-place,
+            in blocks of block_size frames. The GIL is released while rendering.
+        )pbdoc")
+        .def(
+            "stream", [](AudioGraph &graph, int block_size, int num_blocks) {
+                return new AudioGraphStream(&graph, block_size, num_blocks);
+            },
+            "block_size"_a = SIGNALFLOW_DEFAULT_BLOCK_SIZE, "num_blocks"_a = 0, py::keep_alive<0, 1>(), R"pbdoc(
+            Returns an iterator that renders the graph's output block by block, with the
+            GIL released. Each block is rendered into the same [channels, block_size]
+            array, which is overwritten on the next iteration: copy it to retain it.
+            If num_blocks is zero, the iterator is unbounded.
+        )pbdoc")
         .def(
             "render_subgraph", [](AudioGraph &graph, NodeRef node, int num_frames, bool reset) {
                 if (reset)
@@ -42,7 +179,7 @@ void init_python_graph(py::module &m)
                 }
                 graph.render_subgraph(node, num_frames);
             },
-            "node"_a, "num_frames"_a = SIGNALFLOW_DEFAULT_BLOCK_SIZE, "reset"_a = false)
+            "node"_a, "num_frames"_a = SIGNALFLOW_DEFAULT_BLOCK_SIZE, "reset"_a = false, py::call_guard<py::gil_scoped_release>())
         .def("reset_subgraph", &AudioGraph::reset_subgraph)
         .def("play", [](AudioGraph &graph, NodeRef node) { graph.play(node); })
         .def("play", [](AudioGraph &graph, PatchRef patch) { graph.play(patch); })
@@ -13,6 +13,33 @@ struct std::hash<Node>
     }
 };
 
+/*--------------------------------------------------------------------------------
+ * Arithmetic and comparison operators create the node that performs the
+ * operation in the graph of the left-hand operand, along with any Constant
+ * created for a numeric operand, so that operators can be applied to the
+ * nodes of a graph other than the current one.
+ *-------------------------------------------------------------------------------*/
+template <class T>
+static NodeRef operator_node(NodeRef a, NodeRef b)
+{
+    AudioGraphContext context(a->get_graph());
+    return new T(a, b);
+}
+
+template <class T>
+static NodeRef operator_node(NodeRef a, float b)
+{
+    AudioGraphContext context(a->get_graph());
+    return new T(a, NodeRef(b));
+}
+
+template <class T>
+static NodeRef operator_node_reflected(NodeRef a, float b)
+{
+    AudioGraphContext context(a->get_graph());
+    return new T(NodeRef(b), a);
+}
+
 void init_python_node(py::module &m)
 {
     /*--------------------------------------------------------------------------------
@@ -30,24 +57,24 @@ void init_python_node(py::module &m)
         .def(py::init<>([](PatchRef patch) { return patch->output; }))
 
         /*--------------------------------------------------------------------------------
-         * Operators
+         * Operators. See operator_node() above. Numeric operands are matched first,
+         * so that they are not implicitly converted to a Constant in the current graph.
          *-------------------------------------------------------------------------------*/
-        .def("__add__", [](NodeRef a, NodeRef b) { return a + b; })
-        .def("__add__", [](NodeRef a, float b) { return a + NodeRef(b); })
-        .def("__radd__", [](NodeRef a, float b) { return NodeRef(b) + a; })
-        .def("__sub__", [](NodeRef a, NodeRef b) { return a - b; })
-        .def("__sub__", [](NodeRef a, float b) { return a - NodeRef(b); })
-        .def("__rsub__", [](NodeRef a, float b) { return NodeRef(b) - a; })
-        .def("__mul__", [](NodeRef a, NodeRef b) { return a * b; })
-        .def("__mul__", [](NodeRef a, float b) { return a * NodeRef(b); })
-        .def("__rmul__", [](NodeRef a, float b) { return NodeRef(b) * a; })
-        .def("__truediv__", [](NodeRef a, NodeRef b) { return a / b; })
-        .def("__truediv__", [](NodeRef a, float b) { return a / NodeRef(b); })
-        .def("__rtruediv__", [](NodeRef a, float b) { return NodeRef(b) / a; })
-        .def("__pow__", [](NodeRef a, NodeRef b) { return new Pow(a, b); })
-        .def("__pow__", [](NodeRef a, float b) { return new Pow(a, b); })
-        .def("__rpow__", [](NodeRef a, float b) { return new Pow(b, a); })
-        .def("__sub__", [](NodeRef a, float b) { return new Pow(b, a); })
+        .def("__add__", [](NodeRef a, float b) { return operator_node<Add>(a, b); }, py::is_operator())
+        .def("__add__", [](NodeRef a, NodeRef b) { return operator_node<Add>(a, b); }, py::is_operator())
+        .def("__radd__", [](NodeRef a, float b) { return operator_node_reflected<Add>(a, b); }, py::is_operator())
+        .def("__sub__", [](NodeRef a, float b) { return operator_node<Subtract>(a, b); }, py::is_operator())
+        .def("__sub__", [](NodeRef a, NodeRef b) { return operator_node<Subtract>(a, b); }, py::is_operator())
+        .def("__rsub__", [](NodeRef a, float b) { return operator_node_reflected<Subtract>(a, b); }, py::is_operator())
+        .def("__mul__", [](NodeRef a, float b) { return operator_node<Multiply>(a, b); }, py::is_operator())
+        .def("__mul__", [](NodeRef a, NodeRef b) { return operator_node<Multiply>(a, b); }, py::is_operator())
+        .def("__rmul__", [](NodeRef a, float b) { return operator_node_reflected<Multiply>(a, b); }, py::is_operator())
+        .def("__truediv__", [](NodeRef a, float b) { return operator_node<Divide>(a, b); }, py::is_operator())
+        .def("__truediv__", [](NodeRef a, NodeRef b) { return operator_node<Divide>(a, b); }, py::is_operator())
+        .def("__rtruediv__", [](NodeRef a, float b) { return operator_node_reflected<Divide>(a, b); }, py::is_operator())
+        .def("__pow__", [](NodeRef a, float b) { return operator_node<Pow>(a, b); }, py::is_operator())
+        .def("__pow__", [](NodeRef a, NodeRef b) { return operator_node<Pow>(a, b); }, py::is_operator())
+        .def("__rpow__", [](NodeRef a, float b) { return operator_node_reflected<Pow>(a, b); }, py::is_operator())
         .def("__getitem__", [](NodeRef a, int index) { return new ChannelSelect(a, index); })
         .def("__getitem__", [](NodeRef a, py::slice slice) {
             ssize_t start, stop, step, slicelength;
@@ -57,8 +84,26 @@ void init_python_node(py::module &m)
             }
             return new ChannelSelect(a, start, stop, step);
         })
-        .def("__setattr__", [](NodeRef a, std::string attr, NodeRef value) { a->set_input(attr, value); })
-        .def("__getattr__", [](NodeRef a, std::string attr) { return a->get_input(attr); })
+        .def("__setattr__", [](NodeRef a, std::string attr, float value) { a->set_input(attr, value); })
+        .def("__setattr__", [](NodeRef a, std::string attr, NodeRef value) {
+            int index = a->get_input_index(attr);
+            if (index >= 0)
+            {
+                a->set_input(index, value);
+            }
+            else
+            {
+                a->set_input(attr, value);
+            }
+        })
+        .def("__getattr__", [](NodeRef a, std::string attr) {
+            int index = a->get_input_index(attr);
+            if (index >= 0)
+            {
+                return a->get_input(index);
+            }
+            return a->get_input(attr);
+        })
 
         /*--------------------------------------------------------------------------------
          * Need to define an explicit hashing function because when we overwrite __eq__,
@@ -71,13 +116,20 @@ void init_python_node(py::module &m)
          *-------------------------------------------------------------------------------*/
         .def(hash(py::self))
 
-        .def("__eq__", [](NodeRef a, NodeRef b) { return new Equal(a, b); })
-        .def("__ne__", [](NodeRef a, NodeRef b) { return new NotEqual(a, b); })
-        .def("__gt__", [](NodeRef a, NodeRef b) { return new GreaterThan(a, b); })
-        .def("__ge__", [](NodeRef a, NodeRef b) { return new GreaterThanOrEqual(a, b); })
-        .def("__lt__", [](NodeRef a, NodeRef b) { return new LessThan(a, b); })
-        .def("__le__", [](NodeRef a, NodeRef b) { return new LessThanOrEqual(a, b); })
-        .def("__mod__", [](NodeRef a, NodeRef b) { return new Modulo(a, b); })
+        .def("__eq__", [](NodeRef a, float b) { return operator_node<Equal>(a, b); }, py::is_operator())
+        .def("__eq__", [](NodeRef a, NodeRef b) { return operator_node<Equal>(a, b); }, py::is_operator())
+        .def("__ne__", [](NodeRef a, float b) { return operator_node<NotEqual>(a, b); }, py::is_operator())
+        .def("__ne__", [](NodeRef a, NodeRef b) { return operator_node<NotEqual>(a, b); }, py::is_operator())
+        .def("__gt__", [](NodeRef a, float b) { return operator_node<GreaterThan>(a, b); }, py::is_operator())
+        .def("__gt__", [](NodeRef a, NodeRef b) { return operator_node<GreaterThan>(a, b); }, py::is_operator())
+        .def("__ge__", [](NodeRef a, float b) { return operator_node<GreaterThanOrEqual>(a, b); }, py::is_operator())
+        .def("__ge__", [](NodeRef a, NodeRef b) { return operator_node<GreaterThanOrEqual>(a, b); }, py::is_operator())
+        .def("__lt__", [](NodeRef a, float b) { return operator_node<LessThan>(a, b); }, py::is_operator())
+        .def("__lt__", [](NodeRef a, NodeRef b) { return operator_node<LessThan>(a, b); }, py::is_operator())
+        .def("__le__", [](NodeRef a, float b) { return operator_node<LessThanOrEqual>(a, b); }, py::is_operator())
+        .def("__le__", [](NodeRef a, NodeRef b) { return operator_node<LessThanOrEqual>(a, b); }, py::is_operator())
+        .def("__mod__", [](NodeRef a, float b) { return operator_node<Modulo>(a, b); }, py::is_operator())
+        .def("__mod__", [](NodeRef a, NodeRef b) { return operator_node<Modulo>(a, b); }, py::is_operator())
 
         /*--------------------------------------------------------------------------------
          * Properties
@@ -87,13 +139,17 @@ void init_python_node(py::module &m)
         .def_property_readonly("num_input_channels", &Node::get_num_input_channels)
         .def_property_readonly("num_output_channels_allocated", &Node::get_num_output_channels_allocated)
         .def_property_readonly("patch", &Node::get_patch)
+        .def_property_readonly("graph", &Node::get_graph, py::return_value_policy::reference)
         .def_property_readonly("state", &Node::get_state)
+        .def_property_readonly("is_silent", &Node::get_is_silent)
+        .def_property_readonly("is_control_rate", &Node::get_is_control_rate)
+        .def_property_readonly("denormal_count", &Node::get_denormal_count)
         .def_property_readonly("value", &Node::get_value)
         .def_property_readonly("inputs", [](Node &node) {
-            std::unordered_map<std::string, NodeRef> inputs(node.inputs.size());
-            for (auto input : node.inputs)
+            std::unordered_map<std::string, NodeRef> inputs(node.input_slots.size());
+            for (size_t index = 0; index < node.input_slots.size(); index++)
             {
-                inputs[input.first] = *(input.second);
+                inputs[node.input_names[index]] = *(node.input_slots[index]);
             }
             return inputs;
         })
@@ -121,23 +177,28 @@ void init_python_node(py::module &m)
         .def("poll", [](Node &node, float frequency, std::string label) { node.poll(frequency, label); })
         .def("set_input", [](Node &node, std::string name, float value) { node.set_input(name, value); })
         .def("set_input", [](Node &node, std::string name, NodeRef noderef) { node.set_input(name, noderef); })
-        .def("get_input", &Node::get_input)
+        .def("get_input", [](Node &node, std::string name) { return node.get_input(name); })
+        .def("get_input_rate", [](Node &node, std::string name) { return node.get_input_rate(name); })
         .def("add_input", &Node::add_input)
         .def("trigger", [](Node &node) { node.trigger(); })
         .def("trigger", [](Node &node, std::string name) { node.trigger(name); })
         .def("trigger", [](Node &node, std::string name, float value) { node.trigger(name, value); })
-        .def("process", [](Node &node, int num_frames) {
-            node.process(num_frames);
-            node.last_num_frames = num_frames;
-        })
-        .def("process", [](Node &node, Buffer &buffer) {
-            if (node.get_num_output_channels() != buffer.get_num_channels())
-            {
-                throw std::runtime_error("Buffer and Node output channels don't match");
-            }
-            node.process(buffer, buffer.get_num_frames());
-            node.last_num_frames = buffer.get_num_frames();
-        })
+        .def(
+            "process", [](Node &node, int num_frames) {
+                node.process(num_frames);
+                node.last_num_frames = num_frames;
+            },
+            py::call_guard<py::gil_scoped_release>())
+        .def(
+            "process", [](Node &node, Buffer &buffer) {
+                if (node.get_num_output_channels() != buffer.get_num_channels())
+                {
+                    throw std::runtime_error("Buffer and Node output channels don't match");
+                }
+                node.process(buffer, buffer.get_num_frames());
+                node.last_num_frames = buffer.get_num_frames();
+            },
+            py::call_guard<py::gil_scoped_release>())
         .def("scale", [](NodeRef node, float from, float to) { return node.scale(from, to); })
         .def("scale", [](NodeRef node, float from, float to, signalflow_scale_t scale) {
             return node.scale(from, to, scale);
@@ -154,6 +215,33 @@ void init_python_node(py::module &m)
     py::class_<StochasticNode, Node, NodeRefTemplate<StochasticNode>>(m, "StochasticNode")
         .def("set_seed", &StochasticNode::set_seed);
 
+    py::class_<StreamInput, Node, NodeRefTemplate<StreamInput>>(m, "StreamInput")
+        .def(py::init<int, int>(), "num_channels"_a = 1, "capacity"_a = SIGNALFLOW_STREAM_INPUT_DEFAULT_CAPACITY)
+        .def(
+            "write", [](StreamInput &node, py::array_t<float, py::array::c_style | py::array::forcecast> array) {
+                /*--------------------------------------------------------------------------------
+                 * Accepts a 1D array of mono frames, or a 2D array of [channels, frames].
+                 *-------------------------------------------------------------------------------*/
+                if (array.ndim() != 1 && array.ndim() != 2)
+                {
+                    throw std::runtime_error("StreamInput: array must have 1 or 2 dimensions");
+                }
+                int num_channels = (array.ndim() == 1) ? 1 : (int) array.shape(0);
+                int num_frames = (int) array.shape(array.ndim() - 1);
+                const float *data = array.data();
+
+                py::gil_scoped_release release;
+                return node.write(data, num_channels, num_frames);
+            },
+            "array"_a, R"pbdoc(
+            Queue frames for output, returning the number of frames queued.
+            Frames that do not fit in the queue are discarded.
+        )pbdoc")
+        .def_property_readonly("num_frames_queued", &StreamInput::get_num_frames_queued)
+        .def_property_readonly("num_frames_free", &StreamInput::get_num_frames_free)
+        .def_property_readonly("capacity", &StreamInput::get_capacity)
+        .def_property_readonly("num_underruns", &StreamInput::get_num_underruns);
+
     py::enum_<signalflow_filter_type_t>(m, "signalflow_filter_type_t", py::arithmetic(), "Filter type")
         .value("SIGNALFLOW_FILTER_TYPE_LOW_PASS", SIGNALFLOW_FILTER_TYPE_LOW_PASS, "Low-pass filter")
         .value("SIGNALFLOW_FILTER_TYPE_HIGH_PASS", SIGNALFLOW_FILTER_TYPE_HIGH_PASS, "High-pass filter")
@@ -164,6 +252,37 @@ void init_python_node(py::module &m)
         .value("SIGNALFLOW_FILTER_TYPE_HIGH_SHELF", SIGNALFLOW_FILTER_TYPE_HIGH_SHELF, "High-shelf filter")
         .export_values();
 
+    py::enum_<signalflow_fdn_matrix_t>(m, "signalflow_fdn_matrix_t", py::arithmetic(), "FDN feedback matrix type")
+        .value("SIGNALFLOW_FDN_MATRIX_HADAMARD", SIGNALFLOW_FDN_MATRIX_HADAMARD, "Hadamard matrix")
+        .value("SIGNALFLOW_FDN_MATRIX_HOUSEHOLDER", SIGNALFLOW_FDN_MATRIX_HOUSEHOLDER, "Householder matrix")
+        .export_values();
+
+    py::enum_<signalflow_mixer_preset_t>(m, "signalflow_mixer_preset_t", py::arithmetic(), "MatrixMixer preset")
+        .value("SIGNALFLOW_MIXER_PRESET_NONE", SIGNALFLOW_MIXER_PRESET_NONE, "All gains zero")
+        .value("SIGNALFLOW_MIXER_PRESET_IDENTITY", SIGNALFLOW_MIXER_PRESET_IDENTITY, "Each input to the output with the same index")
+        .value("SIGNALFLOW_MIXER_PRESET_SPREAD", SIGNALFLOW_MIXER_PRESET_SPREAD, "Inputs spread evenly across outputs")
+        .value("SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1", SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1, "5.1 to stereo downmix")
+        .value("SIGNALFLOW_MIXER_PRESET_DOWNMIX_7_1", SIGNALFLOW_MIXER_PRESET_DOWNMIX_7_1, "7.1 to stereo downmix")
+        .export_values();
+
+    py::class_<MatrixMixer, Node, NodeRefTemplate<MatrixMixer>>(m, "MatrixMixer")
+        .def(py::init<int, NodeRef, signalflow_mixer_preset_t, float>(), py::call_guard<py::gil_scoped_release>(), "channels"_a = 2, "input"_a = 0, "preset"_a = SIGNALFLOW_MIXER_PRESET_SPREAD, "smoothing_time"_a = 0.02)
+        .def("set_gain", &MatrixMixer::set_gain, "input_channel"_a, "output_channel"_a, "gain"_a)
+        .def("get_gain", &MatrixMixer::get_gain, "input_channel"_a, "output_channel"_a)
+        .def("set_pan", &MatrixMixer::set_pan, "input_channel"_a, "pan"_a)
+        .def("set_preset", &MatrixMixer::set_preset, "preset"_a)
+        .def("set_gains", &MatrixMixer::set_gains, "gains"_a)
+        .def_property_readonly("gains", &MatrixMixer::get_gains)
+        .def_property_readonly("num_routes", &MatrixMixer::get_num_routes);
+
+    py::class_<Expression, Node, NodeRefTemplate<Expression>>(m, "Expression")
+        .def(py::init<std::string, std::vector<NodeRef>>(), py::call_guard<py::gil_scoped_release>(), "expression"_a = "0", "inputs"_a = std::vector<NodeRef>())
+        .def_property_readonly("expression", [](Expression &node) { return node.get_expression().to_string(); })
+        .def_static("fuse", &Expression::fuse, "node"_a, R"pbdoc(
+            Returns a single Expression that computes the same output as `node` and the tree of operator nodes that feed it.
+            Operator nodes that are connected to nothing else are merged in; other nodes become its inputs.
+        )pbdoc");
+
     py::implicitly_convertible<int, Node>();
     py::implicitly_convertible<float, Node>();
 
@@ -9,10 +9,10 @@ void init_python_patch(py::module &m)
         /*--------------------------------------------------------------------------------
          * Constructors
          *-------------------------------------------------------------------------------*/
-        .def(py::init<PatchSpecRef, std::unordered_map<std::string, NodeRef>>())
-        .def(py::init<PatchSpecRef>())
-        .def(py::init<PatchRef, std::unordered_map<std::string, NodeRef>>())
-        .def(py::init<PatchRef>())
+        .def(py::init<PatchSpecRef, std::unordered_map<std::string, NodeRef>>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<PatchSpecRef>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<PatchRef, std::unordered_map<std::string, NodeRef>>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<PatchRef>(), py::call_guard<py::gil_scoped_release>())
         .def(py::init<>())
 
         /*--------------------------------------------------------------------------------
@@ -38,6 +38,9 @@ void init_python_patch(py::module &m)
         .def("set_input", [](Patch &patch, std::string name, float value) { patch.set_input(name, value); })
         .def("set_input", [](Patch &patch, std::string name, NodeRef node) { patch.set_input(name, node); })
         .def("set_input", [](Patch &patch, std::string name, BufferRef buffer) { patch.set_input(name, buffer); })
+        .def("queue_input", [](Patch &patch, std::string name, float value) { patch.queue_input(name, value); })
+        .def("queue_input", [](Patch &patch, std::string name, NodeRef node) { patch.queue_input(name, node); })
+        .def("queue_input", [](Patch &patch, std::string name, BufferRef buffer) { patch.queue_input(name, buffer); })
 
         .def("get_auto_free", &Patch::get_auto_free)
         .def("set_auto_free", &Patch::set_auto_free)
@@ -69,16 +72,43 @@ void init_python_patch(py::module &m)
         .def("add_buffer_input", &Patch::add_buffer_input)
         .def("add_node", &Patch::add_node)
         .def("set_output", &Patch::set_output)
-        .def("create_spec", &Patch::create_spec);
+        .def("create_spec", &Patch::create_spec)
+        .def("optimise", &Patch::optimise);
+
+    /*--------------------------------------------------------------------------------
+     * VoiceAllocator
+     *-------------------------------------------------------------------------------*/
+    py::enum_<signalflow_voice_steal_policy_t>(m, "signalflow_voice_steal_policy_t", py::arithmetic(), "signalflow_voice_steal_policy_t")
+        .value("SIGNALFLOW_VOICE_STEAL_OLDEST", SIGNALFLOW_VOICE_STEAL_OLDEST, "Steal the oldest voice")
+        .value("SIGNALFLOW_VOICE_STEAL_QUIETEST", SIGNALFLOW_VOICE_STEAL_QUIETEST, "Steal the quietest voice")
+        .value("SIGNALFLOW_VOICE_STEAL_SAME_NOTE", SIGNALFLOW_VOICE_STEAL_SAME_NOTE, "Retrigger the voice playing the same note")
+        .export_values();
+
+    py::class_<VoiceAllocator, Node, NodeRefTemplate<VoiceAllocator>>(m, "VoiceAllocator")
+        .def(py::init<PatchSpecRef, int, signalflow_voice_steal_policy_t>(), py::call_guard<py::gil_scoped_release>(), "patchspec"_a, "num_voices"_a = SIGNALFLOW_VOICE_ALLOCATOR_DEFAULT_NUM_VOICES, "steal_policy"_a = SIGNALFLOW_VOICE_STEAL_OLDEST)
+        .def("note_on", &VoiceAllocator::note_on, "note"_a, "velocity"_a = 1.0)
+        .def("note_off", &VoiceAllocator::note_off, "note"_a)
+        .def("all_notes_off", &VoiceAllocator::all_notes_off)
+        .def("get_voice", &VoiceAllocator::get_voice)
+        .def_property_readonly("num_voices", &VoiceAllocator::get_num_voices)
+        .def_property_readonly("num_active_voices", &VoiceAllocator::get_num_active_voices)
+        .def("get_steal_policy", &VoiceAllocator::get_steal_policy)
+        .def("set_steal_policy", &VoiceAllocator::set_steal_policy)
+        .def_property_readonly("steal_policy", &VoiceAllocator::get_steal_policy);
 
     py::class_<PatchSpec, PatchSpecRefTemplate<PatchSpec>>(m, "PatchSpec")
-        .def(py::init<std::string>())
+        .def(py::init<>())
+        .def(py::init<std::string>(), py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("name", &PatchSpec::get_name)
         .def("print", [](PatchSpec &patchspec) { patchspec.print(); })
-        .def("load", &PatchSpec::load)
-        .def("save", &PatchSpec::save)
+        .def("load", &PatchSpec::load, py::call_guard<py::gil_scoped_release>())
+        .def("save", &PatchSpec::save, py::call_guard<py::gil_scoped_release>())
+        .def("save_binary", &PatchSpec::save_binary, py::call_guard<py::gil_scoped_release>())
         .def("to_json", &PatchSpec::to_json)
-        .def("from_json", &PatchSpec::from_json);
+        .def("to_binary", [](PatchSpec &patchspec) { return py::bytes(patchspec.to_binary()); })
+        .def("from_binary", [](PatchSpec &patchspec, py::bytes data) { patchspec.from_binary(data); })
+        .def("optimise", &PatchSpec::optimise)
+        .def("from_json", &PatchSpec::from_json, py::call_guard<py::gil_scoped_release>());
 
     py::class_<PatchRegistry>(m, "PatchRegistry")
         .def(py::init(&PatchRegistry::global))
@@ -1,5 +1,6 @@
-from signalflow import AudioGraph, AudioOut_Dummy, Buffer, SineOscillator, Line, Constant, Add
-from . import process_tree, count_zero_crossings
+from signalflow import AudioGraph, AudioOut_Dummy, Buffer, SineOscillator, Line, Constant, Add, EnvelopeASR, StreamInput
+from signalflow import SineLFO, Maximiser, FFT, IFFT, SIGNALFLOW_INPUT_RATE_AUDIO, SIGNALFLOW_INPUT_RATE_CONTROL
+from . import process_tree, count_zero_crossings, graph
 import pytest
 import numpy as np
 
@@ -94,3 +95,280 @@ def test_graph_clear():
     graph.clear()
     graph.render_to_buffer(buffer)
     assert np.all(buffer.data[0] == 0)
+
+def test_graph_silence_propagation(graph):
+    sine = SineOscillator(440)
+    envelope = EnvelopeASR(0.0, 0.0, 0.01)
+    output = sine * envelope
+    graph.play(output)
+
+    graph.render(256)
+    assert not output.is_silent
+    assert graph.node_count == 4
+
+    #--------------------------------------------------------------------------------
+    # Once the envelope has stopped, the sine subgraph is no longer rendered.
+    #--------------------------------------------------------------------------------
+    buf = Buffer(1, 1024)
+    graph.render_to_buffer(buf)
+    assert envelope.is_silent
+    assert output.is_silent
+    assert graph.node_count == 3
+    assert np.all(buf.data[0][512:] == 0)
+
+def test_graph_control_rate(graph):
+    lfo = SineLFO(2, 0.0, 1.0)
+    ceiling = lfo * 0.5 + 0.5
+    maximiser = Maximiser(SineOscillator(440), ceiling=ceiling)
+    graph.play(maximiser)
+    assert maximiser.get_input_rate("ceiling") == SIGNALFLOW_INPUT_RATE_CONTROL
+    assert maximiser.get_input_rate("input") == SIGNALFLOW_INPUT_RATE_AUDIO
+
+    #--------------------------------------------------------------------------------
+    # The LFO only feeds a control-rate input (via stateless operators), so it is
+    # rendered once per block, and holds its value across the block.
+    #--------------------------------------------------------------------------------
+    block_size = 256
+    values = []
+    for block in range(16):
+        graph.render(block_size)
+        assert lfo.is_control_rate
+        assert ceiling.is_control_rate
+        assert not maximiser.is_control_rate
+        assert np.all(ceiling.output_buffer[0][:block_size] == ceiling.output_buffer[0][0])
+        values.append(lfo.output_buffer[0][0])
+
+    times = np.arange(16) * block_size / graph.sample_rate
+    expected = (np.sin(2 * np.pi * 2 * times) + 1) / 2
+    assert np.allclose(values, expected, atol=1e-4)
+
+    #--------------------------------------------------------------------------------
+    # Once the LFO also feeds an audio-rate input, it is rendered at audio rate.
+    #--------------------------------------------------------------------------------
+    graph.play(lfo)
+    graph.render(block_size)
+    assert not lfo.is_control_rate
+    assert ceiling.is_control_rate
+    assert lfo.output_buffer[0][block_size - 1] != lfo.output_buffer[0][0]
+
+def test_graph_schedule(graph):
+    sine = SineOscillator(440)
+    add = Add(sine, 0)
+    graph.play(add)
+
+    #--------------------------------------------------------------------------------
+    # Events within a block take effect at the exact frame scheduled, however the
+    # block is divided.
+    #--------------------------------------------------------------------------------
+    reset_frame = 300
+    input_frame = 700
+    graph.schedule_set_input(add, input_frame / graph.sample_rate, "input1", 2.0)
+    graph.schedule_trigger(sine, reset_frame / graph.sample_rate, "reset")
+    with pytest.raises(Exception):
+        graph.schedule_set_input(add, 0.0, "nonexistent", 1.0)
+
+    buffer = Buffer(1, 1024)
+    graph.render_to_buffer(buffer)
+    assert graph.time == pytest.approx(1024 / graph.sample_rate)
+
+    expected = np.sin(2 * np.pi * 440 * np.arange(1024) / graph.sample_rate)
+    expected[reset_frame:] = np.sin(2 * np.pi * 440 * np.arange(1024 - reset_frame) / graph.sample_rate)
+    expected[input_frame:] += 2.0
+    assert np.allclose(buffer.data[0], expected, atol=1e-4)
+
+    #--------------------------------------------------------------------------------
+    # Events in the past take effect at the start of the next block.
+    #--------------------------------------------------------------------------------
+    graph.schedule_set_input(add, 0.0, "input1", 0.0)
+    graph.render_to_buffer(buffer)
+    assert np.all(np.abs(buffer.data[0]) <= 1.0)
+
+    #--------------------------------------------------------------------------------
+    # Every node in the graph holds the whole block, not just the last sub-block.
+    #--------------------------------------------------------------------------------
+    constant = add.get_input("input1")
+    graph.schedule_set_input(add, graph.time + 100 / graph.sample_rate, "input1", 3.0)
+    graph.render(256)
+    assert np.all(constant.output_buffer[0][:100] == 0.0)
+    assert np.all(constant.output_buffer[0][100:256] == 3.0)
+    assert np.all(add.output_buffer[0][100:256] > 1.0)
+
+    #--------------------------------------------------------------------------------
+    # Only inputs that are Constants can be scheduled.
+    #--------------------------------------------------------------------------------
+    with pytest.raises(RuntimeError):
+        graph.schedule_set_input(add, 0.0, "input0", 1.0)
+
+def test_graph_schedule_fft(graph):
+    reference = Add(IFFT(FFT(SineOscillator(440))), 0)
+    add = Add(IFFT(FFT(SineOscillator(440))), 0)
+    graph.play(reference)
+    graph.play(add)
+
+    #--------------------------------------------------------------------------------
+    # FFT nodes process whole blocks, so a block that they are rendered in is not
+    # divided, and events within it are dispatched at its start.
+    #--------------------------------------------------------------------------------
+    for block in range(4):
+        graph.schedule_set_input(add, graph.time + 100 / graph.sample_rate, "input1", block)
+        graph.render(512)
+        assert np.allclose(add.output_buffer[0][:512], reference.output_buffer[0][:512] + block)
+    assert np.any(reference.output_buffer[0][:512] != 0)
+
+def test_graph_stream(graph):
+    constant = Constant(0.5)
+    graph.play(constant)
+
+    blocks = []
+    for block in graph.stream(block_size=128, num_blocks=4):
+        assert block.shape == (2, 128)
+        assert block.dtype == np.float32
+        blocks.append(block)
+    assert len(blocks) == 4
+    assert np.all(blocks[-1][0] == 0.5)
+
+    #--------------------------------------------------------------------------------
+    # Each block is rendered into the same array.
+    #--------------------------------------------------------------------------------
+    assert all(block is blocks[0] for block in blocks)
+
+    array = np.zeros((2, 1000), dtype=np.float32)
+    graph.render_to_array(array, block_size=256)
+    assert np.all(array[0] == 0.5)
+
+    with pytest.raises(RuntimeError):
+        graph.render_to_array(np.zeros((2, 1000), dtype=np.float64))
+    with pytest.raises(RuntimeError):
+        graph.render_to_array(array, block_size=1000000)
+
+def test_graph_stream_input(graph):
+    stream_input = StreamInput(2, capacity=1000)
+    assert stream_input.capacity == 1024
+    graph.play(stream_input)
+
+    data = np.random.uniform(-1, 1, (2, 700)).astype(np.float32)
+    assert stream_input.write(data) == 700
+    assert stream_input.write(data) == 324
+    assert stream_input.num_frames_queued == 1024
+
+    array = np.zeros((2, 1200), dtype=np.float32)
+    graph.render_to_array(array, block_size=256)
+    assert np.array_equal(array[:, :700], data)
+    assert np.array_equal(array[:, 700:1024], data[:, :324])
+    assert np.all(array[:, 1024:] == 0)
+    assert stream_input.num_frames_queued == 0
+    assert stream_input.num_underruns == 1
+
+    #--------------------------------------------------------------------------------
+    # Mono input is repeated across channels.
+    #--------------------------------------------------------------------------------
+    stream_input.write(np.ones(256))
+    block = next(graph.stream(block_size=256))
+    assert np.all(block == 1)
+
+    #--------------------------------------------------------------------------------
+    # Resetting discards the frames queued so far, but not those written after.
+    #--------------------------------------------------------------------------------
+    stream_input.write(np.ones(256))
+    stream_input.trigger("reset")
+    assert stream_input.num_frames_queued == 0
+    stream_input.write(np.ones(128) * 0.5)
+    block = next(graph.stream(block_size=256))
+    assert np.all(block[:, :128] == 0.5)
+    assert np.all(block[:, 128:] == 0)
+
+def test_graph_flush_denormals(graph):
+    #--------------------------------------------------------------------------------
+    # The product of these constants is in the denormal range.
+    #--------------------------------------------------------------------------------
+    product = Constant(1e-30) * Constant(1e-10)
+    graph.play(product)
+    assert graph.config.flush_denormals
+    graph.render(256)
+    assert np.all(product.output_buffer[0][:256] == 0)
+
+    #--------------------------------------------------------------------------------
+    # The calling thread's floating-point state is restored after rendering.
+    #--------------------------------------------------------------------------------
+    assert np.float32(1e-30) * np.float32(1e-10) > 0
+
+    graph.config.flush_denormals = False
+    graph.render(256)
+    assert np.all(product.output_buffer[0][:256] > 0)
+
+def test_graph_multiple():
+    graph_a = AudioGraph(output_device=AudioOut_Dummy(1))
+    graph_b = AudioGraph(output_device=AudioOut_Dummy(1))
+    graph_a.sample_rate = 1000
+    graph_b.sample_rate = 2000
+
+    #--------------------------------------------------------------------------------
+    # The most recently created graph is current.
+    #--------------------------------------------------------------------------------
+    assert AudioGraph.get_current() is graph_b
+    sine_b = SineOscillator(100)
+    assert sine_b.graph is graph_b
+
+    with graph_a:
+        assert AudioGraph.get_current() is graph_a
+        sine_a = SineOscillator(100)
+        assert sine_a.graph is graph_a
+    assert AudioGraph.get_current() is graph_b
+
+    graph_a.play(sine_a)
+    graph_b.play(sine_b)
+    output_a = np.zeros((1, 1000), dtype=np.float32)
+    output_b = np.zeros((1, 1000), dtype=np.float32)
+    graph_a.render_to_array(output_a)
+    graph_b.render_to_array(output_b)
+    assert count_zero_crossings(output_a[0]) == pytest.approx(100, abs=1)
+    assert count_zero_crossings(output_b[0]) == pytest.approx(50, abs=1)
+
+    #--------------------------------------------------------------------------------
+    # Nodes cannot be connected to nodes in another graph.
+    #--------------------------------------------------------------------------------
+    with pytest.raises(RuntimeError):
+        sine_a.set_input("frequency", sine_b)
+    with pytest.raises(RuntimeError):
+        graph_b.play(sine_a)
+    sine_a.frequency = 200
+    assert sine_a.frequency.graph is graph_a
+
+    #--------------------------------------------------------------------------------
+    # Operators create their nodes in the graph of the left-hand operand.
+    #--------------------------------------------------------------------------------
+    scaled = sine_a * 0.5 + 1
+    assert scaled.graph is graph_a
+    assert scaled.inputs["input1"].graph is graph_a
+
+    del graph_b
+    assert AudioGraph.get_current() is graph_a
+    del graph_a
+
+def test_graph_multiple_threads():
+    #--------------------------------------------------------------------------------
+    # Each thread renders its own graph, which should give the same output
+    # as rendering serially.
+    #--------------------------------------------------------------------------------
+    import threading
+
+    def render(results, index):
+        graph = AudioGraph(output_device=AudioOut_Dummy(1))
+        with graph:
+            sine = SineOscillator(100 * (index + 1))
+            graph.play(sine)
+            output = np.zeros((1, 44100), dtype=np.float32)
+            graph.render_to_array(output)
+            results[index] = output
+
+    serial = {}
+    for index in range(4):
+        render(serial, index)
+    threaded = {}
+    threads = [threading.Thread(target=render, args=(threaded, index)) for index in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for index in range(4):
+        assert np.array_equal(serial[index], threaded[index])
@@ -48,6 +48,31 @@ def test_node_set_input(graph):
     process_tree(a, num_frames=1024)
     assert frequency.output_buffer[0][0] == 1760
 
+def test_node_input_slots(graph):
+    a = SineOscillator(440)
+    line = Line(0, 1, 1.0)
+    a.frequency = line
+    assert a.frequency is line
+    assert a.inputs["frequency"] is line
+    with pytest.raises(Exception):
+        a.amplitude
+
+    #--------------------------------------------------------------------------------
+    # Removing an input from a variable-input node moves the inputs that follow
+    # it to earlier slots, which must still be found by name.
+    #--------------------------------------------------------------------------------
+    nodes = [sf.Constant(n) for n in range(3)]
+    for node in nodes:
+        graph.play(node)
+    graph.stop(nodes[0])
+    buffer = sf.Buffer(1, 256)
+    graph.render_to_buffer(buffer)
+    assert np.all(buffer.data[0] == 3)
+    graph.stop(nodes[1])
+    graph.render_to_buffer(buffer)
+    assert np.all(buffer.data[0] == 2)
+    graph.stop(nodes[2])
+
 def test_node_buffer(graph):
     buf_in = sf.Buffer(([0.0] * 99) + ([1.0]))
     player = sf.BufferPlayer(buf_in, loop=False)
@@ -1,7 +1,9 @@
-from signalflow import Constant, ChannelArray, Sum
+from signalflow import Constant, ChannelArray, Sum, SineOscillator, Expression, Clip, ScaleLinExp
+from signalflow import Add, Multiply, Wrap, Fold, Sin, Round, GreaterThan, If
 import numpy as np
+import pytest
 
-from . import process_tree
+from . import process_tree, graph
 
 def test_add():
     a = Constant(1)
@@ -188,3 +190,108 @@ def test_sum():
     assert a.num_output_channels == 1
     process_tree(a)
     assert np.all(a.output_buffer[0] == 10)
+
+def test_operators_input_kinds(graph):
+    #--------------------------------------------------------------------------------
+    # Operators are processed by a loop specialised for each combination of
+    # constant and audio-rate inputs, and for common channel counts.
+    #--------------------------------------------------------------------------------
+    for num_channels in [1, 2, 3, 8]:
+        values = np.arange(1, num_channels + 1)
+        a = ChannelArray([float(value) for value in values])
+        b = SineOscillator([440] * num_channels)
+        c = Constant(2)
+
+        for node, expected in [(a * c, values * 2),
+                               (c - a, 2 - values),
+                               (a + a, values * 2)]:
+            graph.render_subgraph(node, reset=True)
+            assert node.num_output_channels == num_channels
+            for channel in range(num_channels):
+                assert np.all(node.output_buffer[channel] == expected[channel])
+
+        node = b / c
+        graph.render_subgraph(node, reset=True)
+        for channel in range(num_channels):
+            assert np.allclose(node.output_buffer[channel], b.output_buffer[channel] / 2)
+
+def test_expression(graph):
+    sine = SineOscillator([220, 330])
+    scale = Constant(0.5)
+
+    expression = Expression("(clip (add (multiply $0 $1) 0.2) -0.25 0.5)", [sine, scale])
+    graph.render_subgraph(expression, reset=True)
+    assert expression.num_output_channels == 2
+    result = np.copy(expression.output_buffer[:2])
+
+    reference = Clip(Add(Multiply(sine, scale), 0.2), -0.25, 0.5)
+    graph.render_subgraph(reference, reset=True)
+    assert np.array_equal(result, reference.output_buffer[:2])
+
+    #--------------------------------------------------------------------------------
+    # Operations on constants are folded when the expression is parsed.
+    #--------------------------------------------------------------------------------
+    expression = Expression("(scale-lin-exp (subtract 1 0.5) 0 1 100 400)")
+    graph.render_subgraph(expression, reset=True)
+    assert np.all(expression.output_buffer[0] == 200)
+
+    with pytest.raises(Exception):
+        Expression("(add $0)")
+    with pytest.raises(Exception):
+        Expression("(sinh $0)")
+
+    #--------------------------------------------------------------------------------
+    # Each operation matches the output of its node.
+    #--------------------------------------------------------------------------------
+    expression = Expression("(if (greater-than $0 0) (fold (sin (multiply $0 4)) -0.5 0.5) (round (wrap (multiply $0 3) -0.5 0.5)))", [sine])
+    graph.render_subgraph(expression, reset=True)
+    result = np.copy(expression.output_buffer[:2])
+    reference = If(GreaterThan(sine, 0),
+                   Fold(Sin(Multiply(sine, 4)), -0.5, 0.5),
+                   Round(Wrap(Multiply(sine, 3), -0.5, 0.5)))
+    graph.render_subgraph(reference, reset=True)
+    assert np.array_equal(result, reference.output_buffer[:2])
+
+    #--------------------------------------------------------------------------------
+    # Replacing a constant input with a node takes effect from the next block.
+    #--------------------------------------------------------------------------------
+    expression = Expression("(multiply $0 $1)", [sine, Constant(2)])
+    graph.render_subgraph(expression, reset=True)
+    assert np.array_equal(expression.output_buffer[:2], sine.output_buffer[:2] * 2)
+    expression.set_input("input1", sine)
+    graph.render_subgraph(expression, reset=True)
+    assert np.array_equal(expression.output_buffer[:2], sine.output_buffer[:2] * sine.output_buffer[:2])
+
+def test_expression_fuse(graph):
+    #--------------------------------------------------------------------------------
+    # Operators create the node that performs the operation, and can then be
+    # fused into a single Expression.
+    #--------------------------------------------------------------------------------
+    sine = SineOscillator([220, 330])
+    scale = Constant(0.5)
+    assert (sine * scale).name == "multiply"
+    assert (sine + 1).name == "add"
+
+    node = Expression.fuse((sine * scale + 0.2 > 0) * 2 - 1)
+    assert node.name == "expression"
+    assert node.expression == "(subtract (multiply (greater-than (add (multiply $0 $1) 0.200000003) 0) 2) 1)"
+    assert node.inputs["input0"] is sine
+    assert node.inputs["input1"] is scale
+
+    graph.render_subgraph(node, reset=True)
+    result = np.copy(node.output_buffer[:2])
+    assert np.array_equal(result, np.where(sine.output_buffer[:2] * 0.5 + np.float32(0.2) > 0, 1, -1))
+
+    #--------------------------------------------------------------------------------
+    # A node that is also read by another node is kept as an input.
+    #--------------------------------------------------------------------------------
+    product = sine * 2
+    node = product + 1
+    other = product - 1
+    assert Expression.fuse(node).expression == "(add $0 1)"
+    assert Expression.fuse(node).inputs["input0"] is product
+
+    #--------------------------------------------------------------------------------
+    # Nodes that are not operators are returned unchanged.
+    #--------------------------------------------------------------------------------
+    assert Expression.fuse(sine) is sine
@@ -1,4 +1,4 @@
-from signalflow import Buffer, BufferPlayer, BufferRecorder, SineOscillator
+from signalflow import Buffer, BufferPlayer, BufferRecorder, SineOscillator, FeedbackBufferReader, FeedbackBufferWriter
 from signalflow import SIGNALFLOW_NODE_STATE_ACTIVE, SIGNALFLOW_NODE_STATE_STOPPED
 from . import graph
 from . import process_tree
@@ -49,4 +49,29 @@ def test_buffer_recorder(graph):
     process_tree(recorder2, num_frames=len(record_buf))
     assert recorder2.state == SIGNALFLOW_NODE_STATE_ACTIVE
     sine_rendered2 = 0.5 * sine_rendered2 + np.sin(np.arange(len(record_buf)) * np.pi * 2 * 2000 / graph.sample_rate)
-    assert list(record_buf.data[0]) == pytest.approx(sine_rendered2, abs=0.001)
\ No newline at end of file
+    assert list(record_buf.data[0]) == pytest.approx(sine_rendered2, abs=0.001)
+
+def test_feedback_buffer_short_delay(graph):
+    #--------------------------------------------------------------------------------
+    # A feedback loop whose delay is much shorter than the block size should
+    # still echo at exactly the requested delay, within a single block.
+    #--------------------------------------------------------------------------------
+    delay_samples = 10
+    impulse = Buffer(np.array([1.0] + [0.0] * 1023))
+    feedback_buf = Buffer(1, 64)
+    player = BufferPlayer(impulse, loop=False)
+    reader = FeedbackBufferReader(feedback_buf)
+    output = player + reader
+    writer = FeedbackBufferWriter(feedback_buf, output * 0.5, delay_samples / graph.sample_rate)
+    graph.play(output)
+    graph.add_node(writer)
+    graph.render(256)
+
+    expected = np.zeros(256)
+    expected[::delay_samples] = 0.5 ** np.arange(len(expected[::delay_samples]))
+    assert list(output.output_buffer[0][:256]) == pytest.approx(expected)
+
+    graph.render(256)
+    next_index = (256 + delay_samples - 1) // delay_samples * delay_samples
+    assert output.output_buffer[0][next_index - 256] == pytest.approx(0.5 ** (next_index // delay_samples))
+    graph.stop(output)
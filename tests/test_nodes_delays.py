@@ -1,4 +1,5 @@
-from signalflow import Impulse, CombDelay, OneTapDelay, Buffer
+from signalflow import Impulse, CombDelay, AllpassDelay, OneTapDelay, FDNReverb, Constant, Buffer
+from signalflow import SIGNALFLOW_FDN_MATRIX_HADAMARD, SIGNALFLOW_FDN_MATRIX_HOUSEHOLDER
 from . import graph
 from . import process_tree
 
@@ -58,4 +59,64 @@ def test_one_tap_delay(graph):
     assert np.all(b.data[0][:9] == 0.0)
     assert b.data[0][9] == 0.5
     assert b.data[0][10] == 0.5
-    assert np.all(b.data[0][11:] == 0.0)
\ No newline at end of file
+    assert np.all(b.data[0][11:] == 0.0)
+
+    #--------------------------------------------------------------------------------
+    # Delays longer than max_delay_time are clamped to it
+    #--------------------------------------------------------------------------------
+    i = Impulse(0)
+    a = OneTapDelay(i, 2.0, 0.5)
+    process_tree(a, buffer=b)
+    assert np.all(b.data[0][:50] == 0.0)
+    assert b.data[0][50] == 1.0
+    assert np.all(b.data[0][51:] == 0.0)
+
+def test_delays_fixed_and_modulated(graph):
+    graph.sample_rate = 100
+
+    #--------------------------------------------------------------------------------
+    # Fixed delays are read from the delay line in blocks, and modulated delays
+    # sample by sample. Passing the same delay time as an audio-rate input
+    # should produce identical output.
+    #--------------------------------------------------------------------------------
+    for delay_time in [0.03, 0.045, 0.2]:
+        for cls, args in [(CombDelay, [0.5]), (AllpassDelay, [0.5]), (OneTapDelay, [])]:
+            outputs = []
+            for delay in [Constant(delay_time), Constant(delay_time) + 0.0]:
+                i = Impulse(0)
+                a = cls(i, delay, *args)
+                b = Buffer(1, 100)
+                process_tree(a, buffer=b)
+                outputs.append(b.data[0].copy())
+            assert np.allclose(outputs[0], outputs[1])
+            assert np.any(outputs[0][1:] != 0.0)
+
+def test_fdn_reverb(graph):
+    #--------------------------------------------------------------------------------
+    # The impulse response should be diffuse and should decay by 60dB over the
+    # decay time, for every matrix type and number of lines.
+    #--------------------------------------------------------------------------------
+    decay_time = 0.5
+    num_frames = graph.sample_rate
+    for matrix_type in [SIGNALFLOW_FDN_MATRIX_HADAMARD, SIGNALFLOW_FDN_MATRIX_HOUSEHOLDER]:
+        for num_lines in [8, 16, 32]:
+            i = Impulse(0)
+            a = FDNReverb(i, decay_time=decay_time, damping=0.0, num_lines=num_lines, matrix_type=matrix_type)
+            assert a.num_output_channels == 2
+            b = Buffer(2, num_frames)
+            a.play()
+            graph.render_to_buffer(b)
+            a.stop()
+
+            output = b.data[0] + b.data[1]
+            assert np.all(np.isfinite(output))
+
+            window = graph.sample_rate // 10
+            early = np.sqrt(np.mean(output[window:window * 2] ** 2))
+            late = np.sqrt(np.mean(output[window * 6:window * 7] ** 2))
+            decay_db = 20 * np.log10(late / early)
+            expected_db = -60 * (window * 5 / graph.sample_rate) / decay_time
+            assert abs(decay_db - expected_db) < 10
+
+    with pytest.raises(Exception):
+        FDNReverb(i, num_lines=12)
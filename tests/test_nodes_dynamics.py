@@ -0,0 +1,107 @@
+from signalflow import Limiter, Compressor, Gate, SineOscillator, BufferPlayer, Constant, ChannelArray, Buffer
+from . import graph
+from . import process_tree
+
+import numpy as np
+
+def test_limiter(graph):
+    #--------------------------------------------------------------------------------
+    # Output is delayed by the look-ahead, and never exceeds the ceiling.
+    #--------------------------------------------------------------------------------
+    graph.sample_rate = 1000
+    sine = SineOscillator(10) * 2
+    limiter = Limiter(sine, ceiling=0.5, release_time=0.1, lookahead_time=0.01)
+    buffer = Buffer(1, 2000)
+    process_tree(limiter, buffer=buffer)
+    assert np.max(np.abs(buffer.data[0])) <= 0.5 + 1e-6
+    assert np.max(np.abs(buffer.data[0])) > 0.45
+    assert np.all(buffer.data[0][:10] == 0.0)
+
+    #--------------------------------------------------------------------------------
+    # Signals below the ceiling pass through unchanged, after the delay.
+    #--------------------------------------------------------------------------------
+    sine = SineOscillator(10) * 0.25
+    limiter = Limiter(sine, ceiling=0.5, lookahead_time=0.01)
+    expected = Buffer(1, 2000)
+    process_tree(sine, buffer=expected)
+    process_tree(limiter, buffer=buffer)
+    assert np.allclose(buffer.data[0][10:], expected.data[0][:-10], atol=1e-4)
+
+def test_limiter_impulse(graph):
+    #--------------------------------------------------------------------------------
+    # A single-sample peak is caught by the look-ahead, with the gain ramping
+    # down over the look-ahead period before it.
+    #--------------------------------------------------------------------------------
+    graph.sample_rate = 1000
+    samples = np.full(1000, 0.1)
+    samples[500] = 4.0
+    player = BufferPlayer(Buffer([samples]))
+    limiter = Limiter(player, ceiling=0.5, release_time=0.05, lookahead_time=0.01)
+    buffer = Buffer(1, 1000)
+    process_tree(limiter, buffer=buffer)
+    assert np.max(buffer.data[0]) <= 0.5 + 1e-6
+    assert np.isclose(buffer.data[0][510], 0.5)
+    assert np.all(np.diff(buffer.data[0][499:510]) < 0)
+    assert np.all(np.diff(buffer.data[0][511:600]) > 0)
+
+def test_limiter_linked(graph):
+    graph.sample_rate = 1000
+    stereo = ChannelArray([SineOscillator(10) * 2, SineOscillator(10) * 0.25])
+
+    #--------------------------------------------------------------------------------
+    # Linked: the quieter channel is attenuated with the louder one.
+    #--------------------------------------------------------------------------------
+    limiter = Limiter(stereo, ceiling=0.5, lookahead_time=0.0)
+    buffer = Buffer(2, 1000)
+    process_tree(limiter, buffer=buffer)
+    assert np.allclose(buffer.data[0] / 8, buffer.data[1], atol=1e-6)
+
+    #--------------------------------------------------------------------------------
+    # Unlinked: the quieter channel is untouched.
+    #--------------------------------------------------------------------------------
+    limiter = Limiter(stereo, ceiling=0.5, lookahead_time=0.0, linked=False)
+    process_tree(limiter, buffer=buffer)
+    assert np.max(np.abs(buffer.data[0])) <= 0.5 + 1e-6
+    assert np.isclose(np.max(np.abs(buffer.data[1])), 0.25, atol=1e-3)
+
+def test_compressor(graph):
+    #--------------------------------------------------------------------------------
+    # With instantaneous attack and release, a constant level above the
+    # threshold is reduced by the ratio in dB.
+    #--------------------------------------------------------------------------------
+    compressor = Compressor(Constant(0.8), threshold=0.2, ratio=4, attack_time=0, release_time=0)
+    buffer = Buffer(1, 1024)
+    process_tree(compressor, buffer=buffer)
+    expected = 0.2 * (0.8 / 0.2) ** 0.25
+    assert np.allclose(buffer.data[0], expected)
+
+    compressor = Compressor(Constant(0.1), threshold=0.2, ratio=4, attack_time=0, release_time=0)
+    process_tree(compressor, buffer=buffer)
+    assert np.allclose(buffer.data[0], 0.1)
+
+def test_compressor_sidechain(graph):
+    sidechain = Constant(0.8)
+    compressor = Compressor(Constant(0.1), threshold=0.2, ratio=2, attack_time=0, release_time=0, sidechain=sidechain)
+    buffer = Buffer(1, 1024)
+    process_tree(compressor, buffer=buffer)
+    assert np.allclose(buffer.data[0], 0.1 * (0.2 / 0.8) ** 0.5)
+
+def test_gate(graph):
+    graph.sample_rate = 1000
+    gate = Gate(Constant(0.05), threshold=0.1, attack_time=0, release_time=0)
+    buffer = Buffer(1, 100)
+    process_tree(gate, buffer=buffer)
+    assert np.all(buffer.data[0] == 0.0)
+
+    gate = Gate(Constant(0.05), threshold=0.1, attack_time=0, release_time=0, sidechain=Constant(0.2))
+    process_tree(gate, buffer=buffer)
+    assert np.all(buffer.data[0] == 0.05)
+
+    #--------------------------------------------------------------------------------
+    # The gate opens smoothly over the attack time.
+    #--------------------------------------------------------------------------------
+    gate = Gate(Constant(0.5), threshold=0.1, attack_time=0.01, release_time=0.01)
+    process_tree(gate, buffer=buffer)
+    assert np.all(np.diff(buffer.data[0]) >= 0)
+    assert buffer.data[0][0] < 0.1
+    assert buffer.data[0][-1] > 0.49
@@ -1,5 +1,5 @@
 from signalflow import Buffer, EnvelopeASR
-from signalflow import SineOscillator, Impulse, FFT, IFFT
+from signalflow import SineOscillator, Impulse, WhiteNoise, FFT, IFFT, FFTFindPeaks, FFTTonality, FFTSpectralFeatures
 
 try:
     from signalflow import FFTConvolve
@@ -150,3 +150,52 @@ def test_fft_convolve_split(graph):
         process_tree(ifft, buffer_out)
         output_samples = np.concatenate((output_samples, buffer_out.data[0]))
     assert np.all(np.abs(output_samples - buffer_ir.data[0]) < 0.000001)
+
+def test_fft_find_peaks(graph):
+    #--------------------------------------------------------------------------------
+    # Peaks are returned loudest first, regardless of frequency.
+    #--------------------------------------------------------------------------------
+    fft = FFT(SineOscillator(440) * 0.25 + SineOscillator(3000) * 0.5, fft_size=fft_size, hop_size=fft_size)
+    peaks = FFTFindPeaks(fft, prominence=10, count=2)
+    buffer = Buffer(4, fft_size)
+    process_tree(peaks, buffer)
+
+    frequencies = buffer.data[0:2, -1]
+    assert np.all(np.abs(frequencies - [3000, 440]) < 5)
+    magnitudes = buffer.data[2:4, -1]
+    assert magnitudes[0] > magnitudes[1] > 0
+
+def test_fft_tonality(graph):
+    #--------------------------------------------------------------------------------
+    # Removing the smoothed envelope leaves the tonal peak, and passes
+    # the phases through unchanged.
+    #--------------------------------------------------------------------------------
+    fft = FFT(SineOscillator(1000) + WhiteNoise() * 0.01, fft_size=fft_size, hop_size=fft_size)
+    tonality = FFTTonality(fft, level=1.0, smoothing=0.9)
+    buffer = Buffer(1, fft_size + 2)
+    process_tree(tonality, buffer)
+    magnitudes = buffer.data[0][:num_bins]
+    peak_bin = int(round(1000 * fft_size / graph.sample_rate))
+    assert np.argmax(magnitudes) == peak_bin
+    assert np.median(magnitudes) == 0.0
+    assert np.all(buffer.data[0][num_bins:] == fft.output_buffer[0][num_bins:fft_size + 2])
+
+def test_fft_spectral_features(graph):
+    buffer = Buffer(4, fft_size)
+
+    fft = FFT(SineOscillator(1000), fft_size=fft_size, hop_size=fft_size)
+    features = FFTSpectralFeatures(fft)
+    process_tree(features, buffer)
+    centroid, flux, rolloff, flatness = buffer.data[:, -1]
+    assert abs(centroid - 1000) < 100
+    assert flux > 0
+    assert abs(rolloff - 1000) < 50
+    assert flatness < 0.01
+
+    fft = FFT(WhiteNoise(), fft_size=fft_size, hop_size=fft_size)
+    features = FFTSpectralFeatures(fft, rolloff=0.5)
+    process_tree(features, buffer)
+    centroid, flux, rolloff, flatness = buffer.data[:, -1]
+    assert abs(centroid - graph.sample_rate / 4) < 1000
+    assert abs(rolloff - graph.sample_rate / 4) < 2500
+    assert 0.3 < flatness < 0.8
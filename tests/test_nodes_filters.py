@@ -0,0 +1,75 @@
+from signalflow import BiquadFilter, SVFFilter, EQ, Buffer, BufferPlayer, Line
+from signalflow import SIGNALFLOW_FILTER_TYPE_LOW_PASS, SIGNALFLOW_FILTER_TYPE_HIGH_PASS
+from . import graph
+
+import numpy as np
+import scipy.signal
+import pytest
+
+def render_filter(graph, filter_class, input_data, *args):
+    graph.sample_rate = 44100
+    input_buffer = Buffer(input_data)
+    player = BufferPlayer(input_buffer)
+    flt = filter_class(player, *args)
+    output_buffer = Buffer(len(input_data), len(input_data[0]))
+    graph.play(flt)
+    graph.render_to_buffer(output_buffer)
+    graph.stop(flt)
+    return output_buffer
+
+def test_nodes_filters_biquad(graph):
+    np.random.seed(0)
+    data = np.random.uniform(-1, 1, (2, 4096)).astype(np.float32)
+    output_buffer = render_filter(graph, BiquadFilter, data, SIGNALFLOW_FILTER_TYPE_LOW_PASS, 1000, 0.707)
+    output = output_buffer.data
+
+    K = np.tan(np.pi * 1000 / 44100)
+    Q = 0.707
+    norm = 1 / (1 + K / Q + K * K)
+    a0 = K * K * norm
+    b = [a0, 2 * a0, a0]
+    a = [1, 2 * (K * K - 1) * norm, (1 - K / Q + K * K) * norm]
+    for channel in range(2):
+        expected = scipy.signal.lfilter(b, a, data[channel])
+        assert np.all(np.abs(output[channel] - expected) < 0.0001)
+
+def test_nodes_filters_svf(graph):
+    np.random.seed(0)
+    data = np.random.uniform(-1, 1, (1, 4096)).astype(np.float32)
+    output_buffer = render_filter(graph, SVFFilter, data, "high_pass", 2000, 0.5)
+    output = output_buffer.data
+
+    g = np.tan(np.pi * 2000 / 44100)
+    k = 2 - 2 * 0.5
+    D = 1 + g * k + g * g
+    b = np.array([1, -2, 1]) / D
+    a = [1, (2 * g * g - 2) / D, (1 - g * k + g * g) / D]
+    expected = scipy.signal.lfilter(b, a, data[0])
+    assert np.all(np.abs(output[0] - expected) < 0.0001)
+
+def test_nodes_filters_eq_unity(graph):
+    #--------------------------------------------------------------------------------
+    # With unity gain on each band, the EQ outputs its input delayed by 3 samples.
+    #--------------------------------------------------------------------------------
+    np.random.seed(0)
+    data = np.random.uniform(-1, 1, (2, 4096)).astype(np.float32)
+    output_buffer = render_filter(graph, EQ, data, 1.0, 1.0, 1.0, 400, 4000)
+    output = output_buffer.data
+    for channel in range(2):
+        assert np.all(np.abs(output[channel][3:] - data[channel][:-3]) < 0.0001)
+
+def test_nodes_filters_coefficient_smoothing(graph):
+    #--------------------------------------------------------------------------------
+    # Sweeping the cutoff should not produce a step at block boundaries:
+    # the DC response of a low-pass filter remains smooth.
+    #--------------------------------------------------------------------------------
+    graph.sample_rate = 44100
+    data = np.ones((1, 44100), dtype=np.float32)
+    input_buffer = Buffer(data)
+    player = BufferPlayer(input_buffer)
+    flt = BiquadFilter(player, SIGNALFLOW_FILTER_TYPE_HIGH_PASS, Line(100, 10000, 1.0), 0.707)
+    output_buffer = Buffer(1, 44100)
+    graph.play(flt)
+    graph.render_to_buffer(output_buffer)
+    graph.stop(flt)
+    assert np.max(np.abs(np.diff(output_buffer.data[0][4410:]))) < 0.001
@@ -30,10 +30,16 @@ def test_nodes_oscillators_saw(graph):
     graph.sample_rate = 16
     graph.render_subgraph(a, graph.sample_rate)
 
+    #--------------------------------------------------------------------------------
+    # Bandlimited with polyBLEP, so the sample at each discontinuity sits at
+    # its midpoint.
+    #--------------------------------------------------------------------------------
     expected0 = np.arange(-1, 1, 2 / graph.sample_rate)
+    expected0[0] = 0
     assert list(a.output_buffer[0]) == pytest.approx(expected0)
 
     expected1 = np.concatenate((np.arange(-1, 1, 4 / graph.sample_rate), np.arange(-1, 1, 4 / graph.sample_rate)))
+    expected1[0] = expected1[8] = 0
     assert list(a.output_buffer[1]) == pytest.approx(expected1)
 
 def test_nodes_oscillators_triangle(graph):
@@ -41,7 +47,12 @@ def test_nodes_oscillators_triangle(graph):
     graph.sample_rate = 16
     graph.render_subgraph(a, graph.sample_rate)
 
+    #--------------------------------------------------------------------------------
+    # Bandlimited with polyBLAMP, so the corners are rounded by 8 * dt / 6.
+    #--------------------------------------------------------------------------------
     expected0 = np.concatenate((np.arange(-1, 1, 4 / graph.sample_rate), np.arange(1, -1, -4 / graph.sample_rate)))
+    expected0[0] += 8 / 6 / graph.sample_rate
+    expected0[8] -= 8 / 6 / graph.sample_rate
     assert list(a.output_buffer[0][:graph.sample_rate]) == pytest.approx(expected0, rel=0.00001)
 
     expected1 = np.concatenate((
@@ -50,6 +61,8 @@ def test_nodes_oscillators_triangle(graph):
         np.arange(-1, 1, 8 / graph.sample_rate),
         np.arange(1, -1, -8 / graph.sample_rate)
     ))
+    expected1[[0, 8]] += 16 / 6 / graph.sample_rate
+    expected1[[4, 12]] -= 16 / 6 / graph.sample_rate
     assert list(a.output_buffer[1][:graph.sample_rate]) == pytest.approx(expected1, rel=0.00001)
 
 def test_nodes_oscillators_square(graph):
@@ -61,6 +74,7 @@ def test_nodes_oscillators_square(graph):
         np.full(graph.sample_rate // 2, 1),
         np.full(graph.sample_rate // 2, -1)
     ))
+    expected0[[0, 8]] = 0
     assert list(a.output_buffer[0][:graph.sample_rate]) == pytest.approx(expected0)
 
     expected0 = np.concatenate((
@@ -69,8 +83,62 @@ def test_nodes_oscillators_square(graph):
         np.full(graph.sample_rate // 4, 1),
         np.full(graph.sample_rate // 4, -1)
     ))
+    expected0[[0, 4, 8, 12]] = 0
     assert list(a.output_buffer[1][:graph.sample_rate]) == pytest.approx(expected0)
 
+def get_alias_to_harmonic_ratio(graph, node, frequency):
+    output_buffer = sf.Buffer(1, graph.sample_rate)
+    graph.play(node)
+    graph.render_to_buffer(output_buffer)
+    graph.stop(node)
+    spectrum = np.abs(np.fft.rfft(output_buffer.data[0])) ** 2
+    harmonic_energy = np.sum(spectrum[np.arange(0, len(spectrum), int(frequency))])
+    alias_energy = np.sum(spectrum) - harmonic_energy
+    return 10 * np.log10(alias_energy / harmonic_energy)
+
+def test_nodes_oscillators_aliasing(graph):
+    #--------------------------------------------------------------------------------
+    # At sample_rate / 12.5, harmonics fall on multiples of the fundamental,
+    # and anything reflected about Nyquist falls exactly between them.
+    # A naive sawtooth at this frequency has an alias ratio of around -11dB.
+    #--------------------------------------------------------------------------------
+    frequency = graph.sample_rate / 12.5
+    assert get_alias_to_harmonic_ratio(graph, sf.SawOscillator(frequency), frequency) < -20
+    assert get_alias_to_harmonic_ratio(graph, sf.SquareOscillator(frequency), frequency) < -20
+    assert get_alias_to_harmonic_ratio(graph, sf.TriangleOscillator(frequency), frequency) < -40
+
+    wavetable = sf.Wavetable(sf.WavetableBuffer("saw"), frequency)
+    assert get_alias_to_harmonic_ratio(graph, wavetable, frequency) < -50
+
+def test_nodes_oscillators_wavetable_buffer(graph):
+    buffer = sf.WavetableBuffer("saw", 1024)
+    assert buffer.num_frames == 1024
+    assert buffer.num_levels == 10
+
+    with pytest.raises(Exception):
+        sf.WavetableBuffer("saw", 1000)
+
+    #--------------------------------------------------------------------------------
+    # At a frequency of sample_rate / 4, only harmonics 1 and 2 fit below Nyquist.
+    #--------------------------------------------------------------------------------
+    frequency = graph.sample_rate / 4
+    a = sf.Wavetable(buffer, frequency)
+    output_buffer = sf.Buffer(1, 4096)
+    graph.play(a)
+    graph.render_to_buffer(output_buffer)
+    spectrum = np.abs(np.fft.rfft(output_buffer.data[0]))
+    fundamental_bin = 4096 // 4
+    assert np.sum(spectrum[fundamental_bin + 1:] ** 2) < 0.0001 * np.sum(spectrum ** 2)
+
+    #--------------------------------------------------------------------------------
+    # At low frequencies, all harmonics are retained.
+    #--------------------------------------------------------------------------------
+    graph.stop(a)
+    b = sf.Wavetable(buffer, graph.sample_rate / 1024)
+    graph.play(b)
+    graph.render_to_buffer(output_buffer)
+    expected = np.tile(np.arange(-1, 1, 2 / 1024), 4)
+    assert np.mean(np.abs(output_buffer.data[0] - expected)) < 0.02
 
 def test_nodes_oscillators_impulse(graph):
     a = sf.Impulse([0, 1, 2])
@@ -1,5 +1,7 @@
 import signalflow as sf
 from . import graph
+from . import process_tree
+import numpy as np
 import math
 
 import pytest
@@ -15,4 +17,73 @@ def test_nodes_multichannel_pan(graph):
     graph.reset_subgraph(b)
     graph.render_subgraph(b)
     assert all(b.output_buffer[0] == 0.5 * math.sqrt(0.5))
-    assert all(b.output_buffer[1] == 0.5 * math.sqrt(0.5))
\ No newline at end of file
+    assert all(b.output_buffer[1] == 0.5 * math.sqrt(0.5))
+
+def test_nodes_multichannel_pan_multichannel(graph):
+    a = 1.0
+    b = sf.LinearPanner(4, a, 0.0)
+    graph.render_subgraph(b)
+    assert b.num_output_channels == 4
+    assert np.allclose(b.output_buffer[0], 0.0)
+    assert np.allclose(b.output_buffer[1], math.sqrt(0.5))
+    assert np.allclose(b.output_buffer[2], math.sqrt(0.5))
+    assert np.allclose(b.output_buffer[3], 0.0)
+
+def test_nodes_matrix_mixer_identity(graph):
+    a = sf.ChannelArray([1, 2, 3])
+    mixer = sf.MatrixMixer(3, a, sf.SIGNALFLOW_MIXER_PRESET_IDENTITY)
+    graph.render_subgraph(mixer)
+    assert mixer.num_routes == 3
+    for channel in range(3):
+        assert np.all(mixer.output_buffer[channel] == channel + 1)
+
+def test_nodes_matrix_mixer_spread(graph):
+    #--------------------------------------------------------------------------------
+    # Each input is panned with equal power: its gains sum in square to 1.
+    #--------------------------------------------------------------------------------
+    a = sf.ChannelArray([1] * 5)
+    mixer = sf.MatrixMixer(4, a)
+    gains = np.array(mixer.gains)
+    assert gains.shape == (4, 5)
+    assert np.allclose(np.sum(gains ** 2, axis=0), 1.0)
+    assert gains[0][0] == 1.0
+    assert gains[3][4] == 1.0
+    assert mixer.num_routes == 8
+
+def test_nodes_matrix_mixer_downmix(graph):
+    a = sf.ChannelArray([1, 2, 4, 8, 16, 32])
+    mixer = sf.MatrixMixer(2, a, sf.SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1)
+    graph.render_subgraph(mixer)
+    assert np.allclose(mixer.output_buffer[0], 1 + (4 + 16) * math.sqrt(0.5))
+    assert np.allclose(mixer.output_buffer[1], 2 + (4 + 32) * math.sqrt(0.5))
+
+    with pytest.raises(Exception):
+        sf.MatrixMixer(4, a, sf.SIGNALFLOW_MIXER_PRESET_DOWNMIX_5_1)
+
+def test_nodes_matrix_mixer_set_gain(graph):
+    #--------------------------------------------------------------------------------
+    # Gain changes ramp linearly over the smoothing time, and routes that
+    # fade out are dropped.
+    #--------------------------------------------------------------------------------
+    graph.sample_rate = 1000
+    a = sf.ChannelArray([1, 1])
+    mixer = sf.MatrixMixer(2, a, sf.SIGNALFLOW_MIXER_PRESET_IDENTITY, smoothing_time=0.1)
+    mixer.set_gain(0, 0, 0.0)
+    mixer.set_gain(1, 0, 1.0)
+    assert mixer.get_gain(1, 0) == 1.0
+    buffer = sf.Buffer(2, 200)
+    process_tree(mixer, buffer=buffer)
+    assert np.allclose(buffer.data[0], 1.0)
+    assert np.allclose(buffer.data[1], 1.0)
+    assert mixer.num_routes == 2
+
+    mixer.set_gains([[0, 0], [0, 0.5]])
+    process_tree(mixer, buffer=buffer)
+    assert np.allclose(buffer.data[1][:100], np.linspace(0.995, 0.5, 100))
+    assert np.allclose(buffer.data[1][100:], 0.5)
+    assert np.allclose(buffer.data[0][:100], np.linspace(0.99, 0, 100))
+    assert np.all(buffer.data[0][100:] == 0)
+    assert mixer.num_routes == 1
+
+    with pytest.raises(Exception):
+        mixer.set_gain(2, 0, 1.0)
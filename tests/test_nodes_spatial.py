@@ -0,0 +1,146 @@
+from signalflow import VBAPPanner, AmbisonicEncoder, AmbisonicDecoder, ChannelArray
+from . import graph
+
+import numpy as np
+import pytest
+
+def direction(azimuth, elevation):
+    azimuth, elevation = np.radians(azimuth), np.radians(elevation)
+    return np.array([np.cos(azimuth) * np.cos(elevation), np.sin(azimuth) * np.cos(elevation), np.sin(elevation)])
+
+def render_gains(graph, node):
+    graph.reset_subgraph(node)
+    graph.render_subgraph(node)
+    return np.copy(node.output_buffer[:node.num_output_channels, -1])
+
+def test_vbap_stereo(graph):
+    panner = VBAPPanner([30, -30], input=1.0, azimuth=30)
+    gains = render_gains(graph, panner)
+    assert np.allclose(gains, [1, 0])
+
+    panner = VBAPPanner([30, -30], input=1.0, azimuth=0)
+    gains = render_gains(graph, panner)
+    assert np.allclose(gains, [np.sqrt(0.5), np.sqrt(0.5)])
+
+def test_vbap_horizontal(graph):
+    speakers = [45, 135, -135, -45]
+    for azimuth in [0, 60, 90, 170, -100]:
+        panner = VBAPPanner(speakers, input=1.0, azimuth=azimuth)
+        gains = render_gains(graph, panner)
+        assert np.isclose(np.sum(gains ** 2), 1.0, atol=1e-5)
+        assert np.count_nonzero(gains > 1e-6) <= 2
+        panned = np.sum([gain * direction(speaker, 0) for gain, speaker in zip(gains, speakers)], axis=0)
+        assert np.allclose(panned / np.linalg.norm(panned), direction(azimuth, 0), atol=1e-4)
+
+def test_vbap_dome(graph):
+    azimuths = [0, 45, 90, 135, 180, -135, -90, -45, 0, 90, 180, -90, 0]
+    elevations = [0] * 8 + [45] * 4 + [90]
+
+    #--------------------------------------------------------------------------------
+    # A source in the direction of a speaker feeds only that speaker.
+    #--------------------------------------------------------------------------------
+    panner = VBAPPanner(azimuths, elevations, input=1.0, azimuth=90, elevation=45)
+    gains = render_gains(graph, panner)
+    assert np.isclose(gains[9], 1.0)
+    assert np.isclose(np.sum(gains), 1.0)
+
+    #--------------------------------------------------------------------------------
+    # Sources between speakers feed up to three, with unit power, and the
+    # weighted sum of speaker directions points towards the source.
+    #--------------------------------------------------------------------------------
+    speakers = [direction(a, e) for a, e in zip(azimuths, elevations)]
+    sources = [(10, 10), (-100, 30), (160, 70), (-30, 5)]
+    azimuth = ChannelArray([source[0] for source in sources])
+    elevation = ChannelArray([source[1] for source in sources])
+    panner = VBAPPanner(azimuths, elevations, input=1.0, azimuth=azimuth, elevation=elevation)
+    assert panner.num_output_channels == 13
+    assert panner.num_input_channels == 4
+    for index, source in enumerate(sources):
+        input = np.zeros(4)
+        input[index] = 1.0
+        panner.set_input("input", ChannelArray(list(input)))
+        gains = render_gains(graph, panner)
+        assert np.isclose(np.sum(gains ** 2), 1.0, atol=1e-5)
+        assert np.count_nonzero(gains > 1e-6) <= 3
+        panned = np.sum([gain * speaker for gain, speaker in zip(gains, speakers)], axis=0)
+        assert np.allclose(panned / np.linalg.norm(panned), direction(*source), atol=1e-4)
+
+    #--------------------------------------------------------------------------------
+    # Sources below the dome are panned to the nearest speakers on its rim.
+    #--------------------------------------------------------------------------------
+    panner = VBAPPanner(azimuths, elevations, input=1.0, azimuth=10, elevation=-30)
+    gains = render_gains(graph, panner)
+    assert np.isclose(np.sum(gains ** 2), 1.0, atol=1e-5)
+    assert list(np.nonzero(gains > 1e-6)[0]) == [0, 1]
+
+def test_vbap_moving_source(graph):
+    #--------------------------------------------------------------------------------
+    # When a source moves, its gains ramp across the next block.
+    #--------------------------------------------------------------------------------
+    panner = VBAPPanner([30, -30], input=1.0, azimuth=30)
+    graph.render_subgraph(panner)
+    assert np.all(panner.output_buffer[0] == 1.0)
+
+    panner.set_input("azimuth", -30)
+    graph.reset_subgraph(panner)
+    graph.render_subgraph(panner)
+    assert np.all(np.diff(panner.output_buffer[0]) < 0)
+    assert np.all(np.diff(panner.output_buffer[1]) > 0)
+    assert np.isclose(panner.output_buffer[0][-1], 0.0)
+    assert np.isclose(panner.output_buffer[1][-1], 1.0)
+
+def test_vbap_invalid_layout(graph):
+    with pytest.raises(Exception):
+        VBAPPanner([30, -30], [0])
+
+def test_ambisonic_encoder(graph):
+    encoder = AmbisonicEncoder(1, input=1.0, azimuth=90)
+    gains = render_gains(graph, encoder)
+    assert np.allclose(gains, [1, 1, 0, 0], atol=1e-6)
+
+    encoder = AmbisonicEncoder(1, input=1.0, azimuth=0, elevation=90)
+    gains = render_gains(graph, encoder)
+    assert np.allclose(gains, [1, 0, 1, 0], atol=1e-6)
+
+    #--------------------------------------------------------------------------------
+    # Second-order components (ACN 4..8) for a horizontal source at 45 degrees,
+    # and the sum of two sources.
+    #--------------------------------------------------------------------------------
+    encoder = AmbisonicEncoder(2, input=1.0, azimuth=45)
+    gains = render_gains(graph, encoder)
+    assert len(gains) == 9
+    assert np.allclose(gains[4:], [np.sqrt(3) / 2, 0, -0.5, 0, 0], atol=1e-6)
+
+    encoder = AmbisonicEncoder(1, input=1.0, azimuth=ChannelArray([0, 180]))
+    gains = render_gains(graph, encoder)
+    assert np.allclose(gains, [2, 0, 0, 0], atol=1e-6)
+
+    with pytest.raises(Exception):
+        AmbisonicEncoder(8)
+
+def test_ambisonic_decoder(graph):
+    #--------------------------------------------------------------------------------
+    # First-order sampling decoder, horizontal: (1 + 2 cos(angle)) / 4.
+    #--------------------------------------------------------------------------------
+    encoder = AmbisonicEncoder(1, input=1.0, azimuth=0)
+    decoder = AmbisonicDecoder([0, 90, 180, -90], input=encoder, max_re=False)
+    gains = render_gains(graph, decoder)
+    assert np.allclose(gains, [0.75, 0.25, -0.25, 0.25], atol=1e-6)
+
+    #--------------------------------------------------------------------------------
+    # First-order sampling decoder, octahedron: (1 + 3 cos(angle)) / 6.
+    #--------------------------------------------------------------------------------
+    decoder = AmbisonicDecoder([0, 90, 180, -90, 0, 0], [0, 0, 0, 0, 90, -90], input=encoder, max_re=False)
+    gains = render_gains(graph, decoder)
+    assert np.allclose(gains, np.array([4, 1, -2, 1, 1, 1]) / 6, atol=1e-6)
+
+    #--------------------------------------------------------------------------------
+    # Max-rE weighting narrows the spread: less energy reaches the rear.
+    #--------------------------------------------------------------------------------
+    encoder = AmbisonicEncoder(3, input=1.0, azimuth=0)
+    speakers = list(range(-180, 180, 45))
+    basic = render_gains(graph, AmbisonicDecoder(speakers, input=encoder, max_re=False))
+    weighted = render_gains(graph, AmbisonicDecoder(speakers, input=encoder, max_re=True))
+    assert np.argmax(basic) == 4
+    assert np.argmax(weighted) == 4
+    assert np.abs(weighted[0]) < np.abs(basic[0])
@@ -94,3 +94,41 @@ def test_random_exponential_seed(graph):
 def test_random_coin_seed(graph):
     _test_stochastic_node(graph, sf.RandomCoin(0.5),
                           lambda values: np.all((values == 0) | (values == 1)))
+
+def test_stochastic_node_block_size(graph):
+    # Values depend only on the seed and the number of frames rendered, not on
+    # how the frames are divided into blocks
+    for node_class in [sf.WhiteNoise, sf.RandomUniform, sf.RandomGaussian, sf.RandomImpulse]:
+        node = node_class()
+        node.set_seed(123)
+        graph.render_subgraph(node, 1024, reset=True)
+        expected = node.output_buffer[0][:1024].copy()
+
+        node.set_seed(123)
+        values = []
+        for block_size in [1, 7, 64, 200, 256, 496]:
+            graph.render_subgraph(node, block_size, reset=True)
+            values.append(node.output_buffer[0][:block_size].copy())
+        assert np.array_equal(expected, np.concatenate(values))
+
+def test_stochastic_node_channels(graph):
+    # Each channel has an independent sequence, which does not depend on the
+    # number of channels
+    a = sf.WhiteNoise(min=[-1, -1])
+    a.set_seed(123)
+    graph.render_subgraph(a, reset=True)
+    assert not np.array_equal(a.output_buffer[0], a.output_buffer[1])
+
+    b = sf.WhiteNoise(min=[-1, -1, -1])
+    b.set_seed(123)
+    graph.render_subgraph(b, reset=True)
+    assert np.array_equal(a.output_buffer[0], b.output_buffer[0])
+    assert np.array_equal(a.output_buffer[1], b.output_buffer[1])
+
+def test_white_noise_distribution(graph):
+    a = sf.WhiteNoise()
+    b = Buffer(1, graph.sample_rate)
+    process_tree(a, buffer=b)
+    assert np.all(b.data[0] > -1) and np.all(b.data[0] < 1)
+    assert abs(np.mean(b.data[0])) < 0.02
+    assert abs(np.var(b.data[0]) - 1 / 3) < 0.02
@@ -1,7 +1,10 @@
 from signalflow import PatchSpec, Patch, Buffer, BufferPlayer
-from signalflow import Multiply, SineOscillator, EnvelopeASR, SquareOscillator, Sum, Add
+from signalflow import Multiply, SineOscillator, EnvelopeASR, EnvelopeADSR, SquareOscillator, Sum, Add, Clip, Constant, Expression, Line
+from signalflow import VoiceAllocator, SIGNALFLOW_VOICE_STEAL_SAME_NOTE, SIGNALFLOW_VOICE_STEAL_QUIETEST
 from . import graph
 import numpy as np
+import pytest
+import json
 
 def test_patch(graph):
     prototype = Patch()
@@ -60,3 +63,319 @@ def test_patch_free(graph):
     patch = Patch(spec)
     patch.auto_free = True
 
+def create_operator_patch():
+    prototype = Patch()
+    frequency = prototype.add_input("frequency", 440)
+    sine = prototype.add_node(SineOscillator(frequency))
+    output = Clip((sine * 0.5 + 0.2) * (Constant(2) * 3) - 1, -0.5, 0.5)
+    prototype.set_output(output)
+    return prototype
+
+def render_patch(graph, patch):
+    buffer = Buffer(1, 1000)
+    graph.play(patch)
+    graph.render_to_buffer(buffer)
+    graph.stop(patch)
+    return buffer.data[0].copy()
+
+def test_patch_optimise_spec(graph, tmp_path):
+    spec = create_operator_patch().create_spec()
+    reference = Patch(spec)
+    spec.optimise()
+    patch = Patch(spec)
+
+    #--------------------------------------------------------------------------------
+    # Constant * constant is folded, and the remaining operators are fused into
+    # a single expression, leaving the patch input, the sine and the expression.
+    #--------------------------------------------------------------------------------
+    assert len(reference.nodes) == 15
+    assert len(patch.nodes) == 3
+    assert patch.output.name == "expression"
+    assert np.array_equal(render_patch(graph, reference), render_patch(graph, patch))
+
+    patch.set_input("frequency", 220)
+    reference.set_input("frequency", 220)
+    assert np.array_equal(render_patch(graph, reference), render_patch(graph, patch))
+
+    path = str(tmp_path / "optimised.json")
+    spec.save(path)
+    loaded = Patch(PatchSpec(path))
+    assert loaded.output.name == "expression"
+    reference = Patch(create_operator_patch())
+    assert np.array_equal(render_patch(graph, reference), render_patch(graph, loaded))
+
+def test_patch_optimise_live(graph):
+    reference = Patch(create_operator_patch())
+
+    patch = Patch()
+    sine = patch.add_node(SineOscillator(patch.add_input("frequency", 440)))
+    envelope = patch.add_node(EnvelopeASR(0.0, 1.0, 0.0))
+    shared = sine * 0.5
+    patch.set_output(Clip((shared + 0.2) * (Constant(2) * 3) - 1, -0.5, 0.5) * envelope + shared * 0)
+    patch.set_auto_free_node(envelope)
+    patch.optimise()
+
+    #--------------------------------------------------------------------------------
+    # The shared multiply is kept, so that it is still only computed once, and
+    # the envelope is kept as the same node.
+    #--------------------------------------------------------------------------------
+    assert patch.output.name == "expression"
+    assert patch.auto_free_node in patch.nodes
+    assert sum(node.name == "multiply" for node in patch.nodes) == 1
+    assert sum(node.name == "expression" for node in patch.nodes) == 1
+
+    assert np.array_equal(render_patch(graph, patch), render_patch(graph, reference))
+
+def test_patch_binary(graph, tmp_path):
+    spec = create_operator_patch().create_spec()
+    reference = Patch(spec)
+
+    #--------------------------------------------------------------------------------
+    # The binary form restores every node, including constants, so that it
+    # round-trips exactly.
+    #--------------------------------------------------------------------------------
+    data = spec.to_binary()
+    assert data[:4] == b"SFPS"
+    loaded = PatchSpec()
+    loaded.from_binary(data)
+    assert loaded.to_binary() == data
+    assert loaded.to_json() == spec.to_json()
+
+    path = str(tmp_path / "patch.sfpatch")
+    spec.save_binary(path)
+    patch = Patch(PatchSpec(path))
+    assert len(patch.nodes) == len(reference.nodes)
+    assert np.array_equal(render_patch(graph, reference), render_patch(graph, patch))
+
+    patch.set_input("frequency", 220)
+    reference.set_input("frequency", 220)
+    assert np.array_equal(render_patch(graph, reference), render_patch(graph, patch))
+
+    with pytest.raises(Exception):
+        PatchSpec().from_binary(data[:-8])
+
+def test_patch_template_shared_node(graph):
+    prototype = Patch()
+    sine = prototype.add_node(SineOscillator(prototype.add_input("frequency", 440)))
+    prototype.set_output(Add(Multiply(sine, 0.5), Multiply(sine, 0.25)))
+
+    #--------------------------------------------------------------------------------
+    # A node that feeds two inputs is shared in copies of the patch, rather
+    # than duplicated.
+    #--------------------------------------------------------------------------------
+    duplicate = Patch(prototype)
+    assert sum(node.name == "sine" for node in duplicate.nodes) == 1
+    assert len(duplicate.nodes) == 7
+
+    spawned = [Patch(prototype.create_spec()) for n in range(2)]
+    assert all(len(patch.nodes) == 7 for patch in spawned)
+    assert spawned[0].output is not spawned[1].output
+    assert np.array_equal(render_patch(graph, duplicate), render_patch(graph, spawned[0]))
+
+    spec = prototype.create_spec()
+    loaded = PatchSpec()
+    loaded.from_binary(spec.to_binary())
+    assert len(Patch(loaded).nodes) == 7
+    assert sum(node["node"] == "sine" for node in json.loads(spec.to_json())["nodes"]) == 1
+
+def test_patch_set_input_bindings(graph):
+    prototype = Patch()
+    value = prototype.add_input("value", 1)
+    buffer = prototype.add_buffer_input("buffer")
+    doubled = prototype.add_node(Multiply(value, 2))
+    incremented = prototype.add_node(Add(value, 1))
+    player = prototype.add_node(BufferPlayer(buffer, loop=True))
+    prototype.set_output(prototype.add_node(Add(Add(doubled, incremented), player)))
+
+    for patch in [Patch(prototype), Patch(prototype.create_spec())]:
+        #--------------------------------------------------------------------------------
+        # Rebinding an input reconnects every node input that it feeds, and can
+        # be repeated.
+        #--------------------------------------------------------------------------------
+        graph.play(patch)
+        for value in [2, 3]:
+            patch.set_input("value", Constant(value))
+            patch.set_input("buffer", Buffer([value, value]))
+            output = Buffer(1, 1000)
+            graph.render_to_buffer(output)
+            assert np.all(output.data[0] == value * 4 + 1)
+        graph.stop(patch)
+
+        with pytest.raises(Exception):
+            patch.set_input("amplitude", Constant(1))
+
+def test_patch_set_input_after_node_changes(graph):
+    patch = Patch()
+    value = patch.add_input("value", 1)
+    total = patch.add_node(Sum([value]))
+    expression = patch.add_node(Expression("(multiply $0 2)", [total]))
+    patch.set_output(expression)
+    patch.set_input("value", Constant(2))
+
+    #--------------------------------------------------------------------------------
+    # An input added to a node after the patch's inputs have been bound is
+    # bound too.
+    #--------------------------------------------------------------------------------
+    total.add_input(patch.inputs["value"])
+    patch.set_input("value", Constant(3))
+    assert total.inputs["input0"] is patch.inputs["value"]
+    assert total.inputs["input1"] is patch.inputs["value"]
+    assert np.all(render_patch(graph, patch) == 12)
+
+    #--------------------------------------------------------------------------------
+    # Replacing a constant input of an Expression recompiles it.
+    #--------------------------------------------------------------------------------
+    patch = Patch()
+    value = patch.add_input("value", 1)
+    patch.set_output(patch.add_node(Expression("(multiply $0 2)", [value])))
+    patch.set_input("value", Line(0, 1, 1.0))
+    output = render_patch(graph, patch)
+    assert output[0] == 0
+    assert np.all(np.diff(output) > 0)
+
+def test_patch_queue_input(graph):
+    prototype = Patch()
+    a = prototype.add_input("a", 1)
+    b = prototype.add_input("b", 2)
+    prototype.set_output(prototype.add_node(Add(a, b)))
+    patch = Patch(prototype)
+    graph.play(patch)
+
+    #--------------------------------------------------------------------------------
+    # Queued inputs are applied together at the start of the next block.
+    #--------------------------------------------------------------------------------
+    a = patch.inputs["a"]
+    patch.queue_input("a", Constant(10))
+    patch.queue_input("b", 20)
+    assert patch.inputs["a"] is a
+    buffer = Buffer(1, 256)
+    graph.render_to_buffer(buffer)
+    assert np.all(buffer.data[0] == 30)
+
+    with pytest.raises(Exception):
+        patch.queue_input("c", 1)
+    graph.stop(patch)
+
+def test_patch_queue_input_expression(graph):
+    patch = Patch()
+    a = patch.add_input("a", 1)
+    b = patch.add_input("b", 2)
+    patch.set_output(a * b + 1)
+    patch.optimise()
+    assert patch.output.name == "expression"
+    graph.play(patch)
+
+    #--------------------------------------------------------------------------------
+    # An input that is no longer a Constant is read per sample once it is set,
+    # and a value queued after it replaces it with a new Constant.
+    #--------------------------------------------------------------------------------
+    buffer = Buffer(1, 256)
+    patch.queue_input("a", Constant(3) + 0)
+    graph.render_to_buffer(buffer)
+    assert np.all(buffer.data[0] == 7)
+
+    patch.queue_input("a", 4)
+    graph.render_to_buffer(buffer)
+    assert np.all(buffer.data[0] == 9)
+    assert patch.inputs["a"].name == "constant"
+    graph.stop(patch)
+
+def create_voice_spec():
+    prototype = Patch()
+    frequency = prototype.add_input("frequency", 440)
+    velocity = prototype.add_input("velocity", 1)
+    gate = prototype.add_input("gate", 0)
+    sine = prototype.add_node(SineOscillator(frequency))
+    envelope = prototype.add_node(EnvelopeADSR(0.001, 0.0, 1.0, 0.01, gate))
+    output = prototype.add_node(sine * envelope * velocity)
+    prototype.set_output(output)
+    return prototype.create_spec()
+
+def test_patch_voice_allocator(graph):
+    allocator = VoiceAllocator(create_voice_spec(), 2)
+    assert allocator.num_voices == 2
+    assert allocator.num_active_voices == 0
+    graph.play(allocator)
+
+    buf = Buffer(1, 1024)
+    graph.render_to_buffer(buf)
+    assert np.all(buf.data[0] == 0)
+
+    assert allocator.note_on(69) == 0
+    graph.render_to_buffer(buf)
+    assert allocator.num_active_voices == 1
+    expected = np.sin(np.arange(1024) * np.pi * 2 * 440 / graph.sample_rate)
+    assert np.allclose(buf.data[0][100:], expected[100:], atol=0.0001)
+
+    #--------------------------------------------------------------------------------
+    # Once all voices are in use, the oldest is stolen and reset.
+    #--------------------------------------------------------------------------------
+    assert allocator.note_on(72) == 1
+    assert allocator.note_on(76) == 0
+    assert allocator.num_active_voices == 2
+
+    #--------------------------------------------------------------------------------
+    # Released voices become idle when their envelope completes.
+    #--------------------------------------------------------------------------------
+    allocator.note_off(72)
+    graph.render_to_buffer(buf)
+    assert allocator.num_active_voices == 1
+    allocator.all_notes_off()
+    graph.render_to_buffer(buf)
+    assert allocator.num_active_voices == 0
+    graph.render_to_buffer(buf)
+    assert np.all(buf.data[0] == 0)
+
+    #--------------------------------------------------------------------------------
+    # An idle voice is re-triggered by the next note.
+    #--------------------------------------------------------------------------------
+    allocator.note_on(69)
+    graph.render_to_buffer(buf)
+    assert allocator.num_active_voices == 1
+    assert np.allclose(buf.data[0][100:], expected[100:], atol=0.0001)
+
+def test_patch_voice_allocator_idle_voices(graph):
+    allocator = VoiceAllocator(create_voice_spec(), 64)
+    graph.play(allocator)
+    buf = Buffer(1, 1024)
+
+    #--------------------------------------------------------------------------------
+    # Idle voices are not rendered, so each block only renders the voices in use.
+    #--------------------------------------------------------------------------------
+    graph.render_to_buffer(buf)
+    idle_node_count = graph.node_count
+    assert idle_node_count < 64
+
+    allocator.note_on(60)
+    graph.render_to_buffer(buf)
+    voice_node_count = graph.node_count - idle_node_count
+    assert voice_node_count > 0
+    allocator.note_on(64)
+    graph.render_to_buffer(buf)
+    assert graph.node_count == idle_node_count + 2 * voice_node_count
+
+    allocator.all_notes_off()
+    graph.render_to_buffer(buf)
+    graph.render_to_buffer(buf)
+    assert allocator.num_active_voices == 0
+    assert graph.node_count == idle_node_count
+
+def test_patch_voice_allocator_steal_policy(graph):
+    allocator = VoiceAllocator(create_voice_spec(), 2, SIGNALFLOW_VOICE_STEAL_SAME_NOTE)
+    graph.play(allocator)
+    buf = Buffer(1, 1024)
+    assert allocator.note_on(60) == 0
+    assert allocator.note_on(60) == 0
+    assert allocator.num_active_voices == 1
+
+    allocator.set_steal_policy(SIGNALFLOW_VOICE_STEAL_QUIETEST)
+    assert allocator.steal_policy == SIGNALFLOW_VOICE_STEAL_QUIETEST
+    assert allocator.note_on(62, 0.1) == 1
+    graph.render_to_buffer(buf)
+    assert allocator.note_on(64) == 1
+
+    #--------------------------------------------------------------------------------
+    # Released voices are stolen in preference to held voices.
+    #--------------------------------------------------------------------------------
+    allocator.note_off(60)
+    assert allocator.note_on(65) == 0